@@ -31,12 +31,27 @@
     - prsm_activate_ssoftmax_d
     - prsm_activate_lsoftmax
     - prsm_activate_lsoftmax_d
+    - prsm_activate_get_func
+    - prsm_activate_get_func_d
 */
 
 #include "prisma/core/core.h"
 #include "prisma/core/math.h"
 #include "prisma/core/tensor.h"
 
+// element-wise activations that can be selected at runtime (e.g., by layers)
+enum PrismaActivation {
+    PRSM_ACTIVATION_LINEAR,
+    PRSM_ACTIVATION_SIGMOID,
+    PRSM_ACTIVATION_TANH,
+    PRSM_ACTIVATION_RELU,
+    PRSM_ACTIVATION_LRELU,
+    PRSM_ACTIVATION_COUNT
+};
+
+// element-wise activation function
+typedef prsm_float (*prsm_activate_fn)(prsm_float);
+
 /**
  * @brief  Sigmoid activation
  * @param  out output tensor
@@ -293,5 +308,21 @@ extern prsm_tensor_t *prsm_activate_lsoftmax(prsm_tensor_t *out, const prsm_tens
  */
 extern prsm_tensor_t *prsm_activate_lsoftmax_d(prsm_tensor_t *out, const prsm_tensor_t *const in);
 
+/**
+ * @brief  Returns the element-wise activation function
+ * @param  act activation
+ * @returns prsm_activate_fn
+ */
+extern prsm_activate_fn prsm_activate_get_func(const enum PrismaActivation act);
+
+/**
+ * @brief  Returns the activation derivative expressed through the activation output: f'(x) = g(f(x))
+ * @param  act activation
+ * @returns prsm_activate_fn
+ *
+ * @note backward passes use it with stored outputs, so pre-activations need not be kept
+ */
+extern prsm_activate_fn prsm_activate_get_func_d(const enum PrismaActivation act);
+
 #endif // PRISMA_CORE_ACTIVATION_H
 
@@ -0,0 +1,376 @@
+#ifndef PRISMA_CORE_AUTOGRAD_H
+#define PRISMA_CORE_AUTOGRAD_H
+
+/** AUTOGRAD MODULE
+ * This module implements reverse-mode automatic differentiation over prisma tensor ops.
+ *
+ * Operations are recorded on a tape as they are executed. Every node owns its output and gradient buffers,
+ * which are kept between passes: after `prsm_autograd_reset`, recording the same graph again replays the tape
+ * and reuses the buffers, so a training step does not allocate. Backward reads the values computed by the
+ * forward pass (activations, softmax probabilities) instead of recomputing them.
+ *
+ * Activation checkpointing trades compute for memory: nodes recorded between `prsm_autograd_checkpoint_begin`
+ * and `prsm_autograd_checkpoint_end` form a segment whose activations are freed as soon as the segment is
+ * recorded; only its last node (the segment output) is kept. When backward reaches the segment output, the
+ * segment is recomputed from its kept inputs, propagated, and freed again. A network of L layers split into
+ * segments of about sqrt(L) layers holds sqrt(L) segment outputs plus one segment at a time, so peak activation
+ * memory grows with sqrt(L) instead of L, for the cost of about one extra forward pass. Buffers of checkpointed
+ * nodes are allocated again on every pass, since keeping them would defeat the purpose.
+ *
+ * Activation stashing compresses the values kept for backward. With `prsm_autograd_set_stash`, a replayed
+ * pass compresses a value as soon as its last reader (learned in the previous pass) has been computed, and
+ * frees the float buffer. The stash holds only what backward reads: fp16 or block-quantized 8-bit values
+ * (one scale per `PRSM_AUTOGRAD_STASH_BLOCK` values) where the value is needed, one bit per element for
+ * relu outputs that only feed the relu derivative, and nothing for values backward never reads, e.g. the
+ * pre-activation of a separate activation node. Element-wise backward kernels decode the stash tile by tile
+ * in their loops; matrix products decode their operand into a scratch buffer owned by the tape.
+
+ * Functions:
+    - prsm_autograd_create
+    - prsm_autograd_destroy
+    - prsm_autograd_reset
+    - prsm_autograd_leaf
+    - prsm_autograd_matmul
+    - prsm_autograd_add
+    - prsm_autograd_sub
+    - prsm_autograd_mul
+    - prsm_autograd_add_rows
+    - prsm_autograd_dense
+    - prsm_autograd_sigmoid
+    - prsm_autograd_tanh
+    - prsm_autograd_relu
+    - prsm_autograd_softmax
+    - prsm_autograd_mse
+    - prsm_autograd_softmax_cce
+    - prsm_autograd_checkpoint_begin
+    - prsm_autograd_checkpoint_end
+    - prsm_autograd_checkpoint_stats
+    - prsm_autograd_set_stash
+    - prsm_autograd_value
+    - prsm_autograd_grad
+    - prsm_autograd_backward
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/math.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/activation.h"
+
+// maximum number of dimensions of a stashed value
+#define PRSM_AUTOGRAD_MAX_DIMS 8
+
+// values per scale of 8-bit stashes; backward kernels decode stashes in tiles of this size
+#define PRSM_AUTOGRAD_STASH_BLOCK 64
+
+enum PrismaAutogradOp {
+    PRSM_AUTOGRAD_OP_LEAF,          // input or parameter
+    PRSM_AUTOGRAD_OP_MATMUL,        // lhs(N, K) * rhs(K, M)
+    PRSM_AUTOGRAD_OP_ADD,           // lhs + rhs
+    PRSM_AUTOGRAD_OP_SUB,           // lhs - rhs
+    PRSM_AUTOGRAD_OP_MUL,           // lhs * rhs (element-wise)
+    PRSM_AUTOGRAD_OP_ADD_ROWS,      // lhs(N, M) + rhs(M) added to every row
+    PRSM_AUTOGRAD_OP_DENSE,         // activation(lhs(N, K) * rhs(K, M) + bias(M)) computed by a single gemm
+    PRSM_AUTOGRAD_OP_SIGMOID,       // sigmoid(lhs)
+    PRSM_AUTOGRAD_OP_TANH,          // tanh(lhs)
+    PRSM_AUTOGRAD_OP_RELU,          // relu(lhs)
+    PRSM_AUTOGRAD_OP_SOFTMAX,       // row-wise softmax(lhs)
+    PRSM_AUTOGRAD_OP_MSE,           // mean((lhs - rhs)^2)
+    PRSM_AUTOGRAD_OP_SOFTMAX_CCE,   // mean categorical cross entropy of row-wise softmax(lhs) and target rhs
+    PRSM_AUTOGRAD_OP_COUNT          // number of ops
+};
+
+enum PrismaAutogradStashFormat {
+    PRSM_AUTOGRAD_STASH_FLOAT,      // values are kept as they are
+    PRSM_AUTOGRAD_STASH_FP16,       // half precision
+    PRSM_AUTOGRAD_STASH_INT8,       // 8-bit with one scale per block of `PRSM_AUTOGRAD_STASH_BLOCK` values
+    PRSM_AUTOGRAD_STASH_MASK,       // one bit per value (value > 0); chosen for relu outputs
+    PRSM_AUTOGRAD_STASH_DROP,       // nothing; chosen for values backward does not read
+    PRSM_AUTOGRAD_STASH_COUNT       // number of formats
+};
+
+// compressed node value kept for the backward pass
+struct PrismaAutogradStash {
+    enum PrismaAutogradStashFormat format;
+    size_t ndim;
+    size_t shape[PRSM_AUTOGRAD_MAX_DIMS];
+    size_t bytes;               // number of bytes used
+    size_t capacity;            // number of bytes `data` can hold; kept between passes
+    uint8_t *data;              // fp16: uint16_t values; int8: float scales followed by int8_t values; mask: bits
+};
+
+// tape node
+struct PrismaAutogradNode {
+    enum PrismaAutogradOp op;
+    size_t lhs;                 // first input node
+    size_t rhs;                 // second input node
+    size_t bias;                // third input node (dense)
+    enum PrismaActivation activation; // fused activation (dense)
+    bool requires_grad;         // gradient is propagated through this node
+    prsm_tensor_t *value;       // output: owned by the tape, borrowed for leaves
+    prsm_tensor_t *grad;        // gradient of the output; allocated on first backward
+    prsm_tensor_t *aux;         // forward intermediate reused by backward, e.g. softmax probabilities
+    bool checkpointed;          // inside a checkpointed segment: buffers are freed and recomputed by backward
+    bool needs_value;           // backward reads the value
+    bool needs_mask;            // backward reads the sign of the value (relu derivative)
+    size_t last_use;            // last node reading the value in the previous pass; 0 if unknown
+    size_t last_use_next;       // last node reading the value in the current pass
+    bool stashed;               // value is freed and `stash` holds what backward needs
+    struct PrismaAutogradStash stash;
+};
+
+// checkpointed segment: nodes [first, last) are recomputed during backward, the output `last` is kept
+struct PrismaAutogradSegment {
+    size_t first;
+    size_t last;
+};
+
+// activation checkpointing statistics of the current pass
+typedef struct PrismaAutogradCheckpointStats {
+    size_t stored_bytes;        // activations currently held by the tape
+    size_t saved_bytes;         // activations freed by checkpointing and by stash compression
+    size_t forward_flops;       // estimated floating point operations of the forward pass
+    size_t recompute_flops;     // estimated floating point operations spent recomputing segments in backward
+    size_t stashed_bytes;       // compressed activations held for backward; also counted in `stored_bytes`
+} prsm_autograd_checkpoint_stats_t;
+
+typedef struct PrismaAutograd {
+    size_t len;                         // number of recorded nodes
+    size_t capacity;                    // number of allocated nodes
+    size_t cursor;                      // number of nodes recorded in the current pass
+    struct PrismaAutogradNode *nodes;
+
+    // activation checkpointing
+    bool checkpointing;                 // a segment is open
+    size_t checkpoint_from;             // first node of the open segment
+    size_t num_segments;                // number of segments closed in the current pass
+    size_t segments_capacity;           // number of allocated segments
+    struct PrismaAutogradSegment *segments;
+    prsm_autograd_checkpoint_stats_t stats;
+
+    // activation stashing
+    enum PrismaAutogradStashFormat stash;   // format of stashed values
+    bool diverged;                          // the current pass recorded nodes the previous pass did not
+    prsm_tensor_t *scratch[3];              // decoded operands of a node
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_autograd_t;
+
+/**
+ * @brief  Creates an empty tape
+ * @param  alloctr allocator instance
+ * @returns valid `prsm_autograd_t*`
+ */
+extern prsm_autograd_t *prsm_autograd_create(struct VitaBaseAllocatorType *const alloctr);
+
+/**
+ * @brief  Frees the tape with all buffers it owns
+ * @param  tape tape instance
+ * @returns None
+ */
+extern void prsm_autograd_destroy(prsm_autograd_t *tape);
+
+/**
+ * @brief  Starts a new pass keeping the recorded nodes and their buffers
+ * @param  tape tape instance
+ * @returns None
+ *
+ * @note if the next pass records the same ops on the same inputs, the buffers are reused
+ * @note if the graph differs, nodes are re-recorded starting from the first mismatch
+ */
+extern void prsm_autograd_reset(prsm_autograd_t *const tape);
+
+/**
+ * @brief  Records an input or a parameter
+ * @param  tape tape instance
+ * @param  t tensor; borrowed, must stay valid until the backward pass is done
+ * @param  requires_grad compute gradient for this tensor
+ * @returns node id
+ */
+extern size_t prsm_autograd_leaf(prsm_autograd_t *const tape, prsm_tensor_t *const t, const bool requires_grad);
+
+/**
+ * @brief  Records and computes matrix multiplication
+ * @param  tape tape instance
+ * @param  lhs matrix node of shape (N, K)
+ * @param  rhs matrix node of shape (K, M)
+ * @returns node id of shape (N, M)
+ */
+extern size_t prsm_autograd_matmul(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs);
+
+/**
+ * @brief  Records and computes element-wise addition
+ * @param  tape tape instance
+ * @param  lhs node
+ * @param  rhs node of the same shape
+ * @returns node id
+ */
+extern size_t prsm_autograd_add(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs);
+
+/**
+ * @brief  Records and computes element-wise subtraction
+ * @param  tape tape instance
+ * @param  lhs node
+ * @param  rhs node of the same shape
+ * @returns node id
+ */
+extern size_t prsm_autograd_sub(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs);
+
+/**
+ * @brief  Records and computes element-wise multiplication
+ * @param  tape tape instance
+ * @param  lhs node
+ * @param  rhs node of the same shape
+ * @returns node id
+ */
+extern size_t prsm_autograd_mul(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs);
+
+/**
+ * @brief  Records and computes addition of a vector to every row of a matrix (bias)
+ * @param  tape tape instance
+ * @param  lhs matrix node of shape (N, M)
+ * @param  rhs node with M elements
+ * @returns node id of shape (N, M)
+ */
+extern size_t prsm_autograd_add_rows(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs);
+
+/**
+ * @brief  Records and computes a fully connected layer: activation(in * w + b)
+ * @param  tape tape instance
+ * @param  in matrix node of shape (N, K)
+ * @param  w matrix node of shape (K, M)
+ * @param  b node with M elements
+ * @param  activation activation fused into the gemm epilogue
+ * @returns node id of shape (N, M)
+ *
+ * @note the output is stored once: bias and activation are applied by the gemm epilogue
+ * @note backward computes the activation derivative from the stored output
+ */
+extern size_t prsm_autograd_dense(prsm_autograd_t *const tape, const size_t in, const size_t w, const size_t b, const enum PrismaActivation activation);
+
+/**
+ * @brief  Records and computes sigmoid activation
+ * @param  tape tape instance
+ * @param  in node
+ * @returns node id
+ */
+extern size_t prsm_autograd_sigmoid(prsm_autograd_t *const tape, const size_t in);
+
+/**
+ * @brief  Records and computes tanh activation
+ * @param  tape tape instance
+ * @param  in node
+ * @returns node id
+ */
+extern size_t prsm_autograd_tanh(prsm_autograd_t *const tape, const size_t in);
+
+/**
+ * @brief  Records and computes relu activation
+ * @param  tape tape instance
+ * @param  in node
+ * @returns node id
+ */
+extern size_t prsm_autograd_relu(prsm_autograd_t *const tape, const size_t in);
+
+/**
+ * @brief  Records and computes numerically stable softmax of every row
+ * @param  tape tape instance
+ * @param  in matrix node of shape (N, M)
+ * @returns node id of shape (N, M)
+ */
+extern size_t prsm_autograd_softmax(prsm_autograd_t *const tape, const size_t in);
+
+/**
+ * @brief  Records and computes mean squared error
+ * @param  tape tape instance
+ * @param  input predicted values node
+ * @param  target target values node of the same shape
+ * @returns scalar node id
+ */
+extern size_t prsm_autograd_mse(prsm_autograd_t *const tape, const size_t input, const size_t target);
+
+/**
+ * @brief  Records and computes categorical cross entropy of row-wise softmax averaged over rows
+ * @param  tape tape instance
+ * @param  logits matrix node of shape (N, M)
+ * @param  target probabilities node of shape (N, M), usually one-hot encoded
+ * @returns scalar node id
+ *
+ * @note fused: the backward pass uses the stored probabilities, i.e., (softmax - target)/N
+ * @note gradient is not propagated to `target`
+ */
+extern size_t prsm_autograd_softmax_cce(prsm_autograd_t *const tape, const size_t logits, const size_t target);
+
+/**
+ * @brief  Opens a checkpointed segment: nodes recorded until `prsm_autograd_checkpoint_end` are recomputed by backward
+ * @param  tape tape instance
+ * @returns None
+ *
+ * @note segments cannot be nested
+ */
+extern void prsm_autograd_checkpoint_begin(prsm_autograd_t *const tape);
+
+/**
+ * @brief  Closes the open segment and frees the activations of all its nodes but the last one
+ * @param  tape tape instance
+ * @returns None
+ *
+ * @note only the last node of the segment may be used by nodes recorded afterwards
+ * @note values and gradients of the other nodes of the segment are `NULL` outside of backward
+ */
+extern void prsm_autograd_checkpoint_end(prsm_autograd_t *const tape);
+
+/**
+ * @brief  Reports memory saved by checkpointing against the extra compute of the current pass
+ * @param  tape tape instance
+ * @returns prsm_autograd_checkpoint_stats_t
+ *
+ * @note statistics are reset by `prsm_autograd_reset`
+ */
+extern prsm_autograd_checkpoint_stats_t prsm_autograd_checkpoint_stats(const prsm_autograd_t *const tape);
+
+/**
+ * @brief  Sets the format of stashed activations
+ * @param  tape tape instance
+ * @param  format `PRSM_AUTOGRAD_STASH_FLOAT` (disabled), `PRSM_AUTOGRAD_STASH_FP16` or `PRSM_AUTOGRAD_STASH_INT8`
+ * @returns None
+ *
+ * @note values are compressed from the second pass on, while the tape replays the graph of the previous pass
+ * @note values of stashed nodes are `NULL`; nodes no other node reads, e.g. the loss, are never stashed
+ * @note a value reduced to a mask or dropped cannot be read by a node the previous pass did not record
+ */
+extern void prsm_autograd_set_stash(prsm_autograd_t *const tape, const enum PrismaAutogradStashFormat format);
+
+/**
+ * @brief  Returns the value of a node
+ * @param  tape tape instance
+ * @param  node node id
+ * @returns prsm_tensor_t*
+ *
+ * @note the tensor is owned by the tape (except for leaves)
+ */
+extern prsm_tensor_t *prsm_autograd_value(const prsm_autograd_t *const tape, const size_t node);
+
+/**
+ * @brief  Returns the gradient of a node computed by the last backward pass
+ * @param  tape tape instance
+ * @param  node node id
+ * @returns prsm_tensor_t* or `NULL` if the node does not require gradient
+ *
+ * @note the tensor is owned by the tape and is overwritten by the next backward pass
+ */
+extern prsm_tensor_t *prsm_autograd_grad(const prsm_autograd_t *const tape, const size_t node);
+
+/**
+ * @brief  Computes gradients of `root` with respect to all nodes recorded before it
+ * @param  tape tape instance
+ * @param  root output node, usually a scalar loss
+ * @returns None
+ *
+ * @note the gradient of `root` is seeded with ones
+ * @note gradients are overwritten, not accumulated across backward calls
+ */
+extern void prsm_autograd_backward(prsm_autograd_t *const tape, const size_t root);
+
+#endif // PRISMA_CORE_AUTOGRAD_H
+
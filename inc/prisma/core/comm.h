@@ -0,0 +1,130 @@
+#ifndef PRISMA_CORE_COMM_H
+#define PRISMA_CORE_COMM_H
+
+/** COMM MODULE
+ * This module implements collective communication between training processes on one machine.
+ *
+ * A communicator connects `size` processes, each identified by its rank, through a named shared memory
+ * object (`shm_open` on POSIX, a named file mapping on Windows). The mapping holds one slot per rank and a
+ * result slot; rank slots are exposed as prisma tensor views. Processes synchronize with a lock-free
+ * sense-reversing barrier on a counter in the mapping: no locks, no kernel objects, only atomics.
+ *
+ * All-reduce uses reduce-scatter followed by all-gather: every rank copies its tensors into its slot, then
+ * reduces its own 1/size of the elements across all slots into the result slot, and finally every rank
+ * copies the result back. Each element is summed by exactly one rank in rank order, so all ranks receive
+ * bit-identical sums. Tensors larger than a slot are processed in slot-sized rounds.
+ *
+ * The interface (rank, size, barrier, all-reduce, broadcast) does not expose the transport, so a
+ * multi-node implementation can replace the shared memory one without changing the training code.
+
+ * Functions:
+    - prsm_comm_open
+    - prsm_comm_close
+    - prsm_comm_unlink
+    - prsm_comm_is_null
+    - prsm_comm_buffer
+    - prsm_comm_barrier
+    - prsm_comm_allreduce
+    - prsm_comm_broadcast
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+
+typedef struct PrismaComm {
+    size_t rank;                // rank of this process: [0, size)
+    size_t size;                // number of processes
+    size_t capacity;            // elements per slot
+    size_t stride;              // elements between slots; slots start on separate cache lines
+    size_t slot_shape[1];       // shape of slot views
+
+    void *base;                 // mapping
+    size_t bytes;               // mapping size
+    size_t *arrived;            // barrier: number of ranks that arrived
+    size_t *generation;         // barrier: number of completed barriers
+    prsm_float *slots;          // `size` rank slots followed by the result slot
+
+    // platform specific handles
+#if defined(_WIN32) || defined(_WIN64)
+    void *hmap;
+#else
+    int fd;
+#endif
+} prsm_comm_t;
+
+/**
+ * @brief  Connects to (or creates) a shared memory communicator
+ * @param  comm communicator instance
+ * @param  name shared memory object name; on POSIX it must start with '/'
+ * @param  rank rank of this process
+ * @param  size number of processes
+ * @param  capacity elements per slot
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success, PRSM_STATUS_ERROR_IO otherwise
+ *
+ * @note every rank must pass the same `name`, `size` and `capacity`
+ * @note a stale object left by a crashed run must be removed with `prsm_comm_unlink()` before the ranks start
+ */
+extern enum PrismaStatus prsm_comm_open(prsm_comm_t *const comm, const char *const name, const size_t rank, const size_t size, const size_t capacity);
+
+/**
+ * @brief  Disconnects from the communicator
+ * @param  comm communicator instance
+ * @returns None
+ */
+extern void prsm_comm_close(prsm_comm_t *const comm);
+
+/**
+ * @brief  Removes the shared memory object name; processes that are connected keep their mapping
+ * @param  name shared memory object name
+ * @returns None
+ *
+ * @note on Windows the object is removed with the last handle, so this is a no-op
+ */
+extern void prsm_comm_unlink(const char *const name);
+
+/**
+ * @brief  Checks if communicator is connected
+ * @param  comm communicator instance
+ * @returns ditto
+ */
+extern bool prsm_comm_is_null(const prsm_comm_t *const comm);
+
+/**
+ * @brief  Returns a view of a rank slot in shared memory
+ * @param  comm communicator instance
+ * @param  rank rank
+ * @returns prsm_tensor_t vector view of `capacity` elements
+ *
+ * @note slots are overwritten by collectives
+ */
+extern prsm_tensor_t prsm_comm_buffer(prsm_comm_t *const comm, const size_t rank);
+
+/**
+ * @brief  Waits until all ranks reach the barrier
+ * @param  comm communicator instance
+ * @returns None
+ */
+extern void prsm_comm_barrier(prsm_comm_t *const comm);
+
+/**
+ * @brief  Sums tensors element-wise across all ranks in place
+ * @param  comm communicator instance
+ * @param  tensors tensors; every rank must pass tensors of the same sizes in the same order
+ * @param  count number of tensors
+ * @returns None
+ *
+ * @note every rank receives bit-identical sums
+ */
+extern void prsm_comm_allreduce(prsm_comm_t *const comm, prsm_tensor_t *const tensors[], const size_t count);
+
+/**
+ * @brief  Copies tensors of the root rank into the tensors of all other ranks
+ * @param  comm communicator instance
+ * @param  tensors tensors; every rank must pass tensors of the same sizes in the same order
+ * @param  count number of tensors
+ * @param  root source rank
+ * @returns None
+ */
+extern void prsm_comm_broadcast(prsm_comm_t *const comm, prsm_tensor_t *const tensors[], const size_t count, const size_t root);
+
+#endif // PRISMA_CORE_COMM_H
@@ -0,0 +1,497 @@
+#ifndef PRISMA_CORE_CONV_H
+#define PRISMA_CORE_CONV_H
+
+/** CONV MODULE
+ * This module implements 2D convolution kernels on NCHW tensors.
+ *
+ * Convolution is lowered to a matrix multiplication: every image is unfolded with im2col into a
+ * (C/groups * KH * KW, OH * OW) matrix per group, which is multiplied by the weights viewed as
+ * (OC/groups, C/groups * KH * KW). The backward pass reuses the same buffer for the columns and their
+ * gradient, which is folded back with col2im.
+ *
+ * During training, `prsm_conv2d_forward_ex()` can keep the columns of the whole batch in the workspace so
+ * that `prsm_conv2d_backward_ex()` does not unfold the input again. The weight gradient is split into tasks
+ * of (image, block of output channels); every thread accumulates into its own copy of dW, and the copies
+ * are summed per output channel once all tasks are done, so no task ever waits on a lock. The summation
+ * order only depends on the number of threads, which keeps results reproducible.
+ *
+ * im2col inflates the input by KH * KW, which dominates for layers with few channels. Such layers run a
+ * direct convolution on a channel-blocked NCHW[8|16]c layout instead: channels are split into blocks stored
+ * innermost, so every weight load is a contiguous vector of output channels and a register tile of output
+ * pixels is accumulated without materializing any columns. The forward pass picks the algorithm per layer
+ * shape with `prsm_conv2d_select_algorithm()`.
+ *
+ * 3x3 stride 1 layers with enough channels run Winograd F(2x2,3x3) or F(4x4,3x3): weights and input tiles
+ * are transformed once, every transform-domain position becomes an independent (OC, C) x (C, tiles) gemm
+ * and the results are transformed back, which needs 2.25x (F2) or 4x (F4) fewer multiplications. The
+ * transforms amplify rounding errors, so a variant is only used while its error estimate stays below
+ * the tolerance set by `prsm_conv2d_set_winograd_tolerance()`.
+ *
+ * Depthwise convolutions (groups == in_channels == out_channels) do too little work per loaded value for
+ * gemm lowering to pay off. They run on NCHWc, where every kernel tap is one vector multiply-add across a
+ * channel block. A depthwise convolution followed by a 1x1 convolution can be fused: the depthwise output
+ * is produced in bands of rows that fit in L1 and consumed by the pointwise convolution right away.
+ *
+ * Upsampling layers never scatter. Output pixels of a transposed convolution with stride S split into S x S
+ * phases; within a phase, every output pixel reads the same subset of kernel taps at fixed input offsets, so
+ * each phase is an ordinary gather im2col + gemm with a sub-kernel, and every output pixel is written once.
+ * Nearest upsampling followed by a convolution is fused the same way: the taps of a phase that land on the
+ * same input pixel are summed into one folded weight beforehand (a 3x3 kernel after 2x upsampling becomes
+ * four 2x2 kernels, 2.25x fewer multiplications), and the upsampled tensor never exists. Bilinear upsampling
+ * clamps to the image borders, which breaks the folding there: every thread interpolates one channel at a time
+ * into its own scratch plane and gathers the columns from it.
+
+ * Functions:
+    - prsm_conv2d_out_dim
+    - prsm_conv2d_workspace_size
+    - prsm_conv2d_workspace_size_ex
+    - prsm_conv2d_im2col
+    - prsm_conv2d_col2im
+    - prsm_conv2d_forward
+    - prsm_conv2d_forward_ex
+    - prsm_conv2d_backward
+    - prsm_conv2d_backward_ex
+    - prsm_conv2d_select_algorithm
+    - prsm_conv2d_to_nchwc
+    - prsm_conv2d_from_nchwc
+    - prsm_conv2d_pack_weights
+    - prsm_conv2d_direct
+    - prsm_conv2d_set_winograd_tolerance
+    - prsm_conv2d_get_winograd_tolerance
+    - prsm_conv2d_winograd_weights
+    - prsm_conv2d_winograd
+    - prsm_conv2d_pack_depthwise
+    - prsm_conv2d_depthwise
+    - prsm_conv2d_depthwise_pointwise
+    - prsm_conv2d_separable_forward
+    - prsm_conv2d_transpose_out_dim
+    - prsm_conv2d_transpose_workspace_size
+    - prsm_conv2d_transpose
+    - prsm_conv2d_transpose_backward
+    - prsm_conv2d_upsample_workspace_size
+    - prsm_conv2d_upsample_conv
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+#include "prisma/core/activation.h"
+
+// convolution geometry; index 0 is height, index 1 is width
+typedef struct PrismaConv2dParams {
+    size_t in_channels;
+    size_t out_channels;
+    size_t groups;          // in_channels and out_channels must be divisible by groups
+    size_t kernel[2];
+    size_t stride[2];
+    size_t padding[2];      // zero padding on each side
+    size_t dilation[2];     // 1 for a dense kernel
+} prsm_conv2d_params_t;
+
+// convolution algorithms
+enum PrismaConvAlgorithm {
+    PRSM_CONV_ALGORITHM_IM2COL,     // im2col + gemm
+    PRSM_CONV_ALGORITHM_DIRECT,     // direct convolution on NCHWc
+    PRSM_CONV_ALGORITHM_WINOGRAD_2, // Winograd F(2x2,3x3)
+    PRSM_CONV_ALGORITHM_WINOGRAD_4, // Winograd F(4x4,3x3)
+    PRSM_CONV_ALGORITHM_DEPTHWISE,  // depthwise convolution on NCHWc
+    PRSM_CONV_ALGORITHM_COUNT
+};
+
+// upsampling modes of a fused upsampling and convolution
+enum PrismaConvUpsample {
+    PRSM_CONV_UPSAMPLE_NEAREST,     // repeat every pixel scale x scale times
+    PRSM_CONV_UPSAMPLE_BILINEAR,    // interpolate between the 4 nearest pixel centers
+    PRSM_CONV_UPSAMPLE_COUNT
+};
+
+/**
+ * @brief  Returns the output size of a convolution along one dimension
+ * @param  in input size
+ * @param  kernel kernel size
+ * @param  stride stride
+ * @param  padding zero padding on each side
+ * @param  dilation kernel dilation
+ * @returns size_t
+ */
+extern size_t prsm_conv2d_out_dim(const size_t in, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation);
+
+/**
+ * @brief  Returns the number of elements the workspace needs for an input of size (H, W)
+ * @param  params convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @returns size_t
+ *
+ * @note covers forward (with the selected algorithm) and backward passes
+ * @note backward keeps one copy of the weight gradient per thread (`prsm_parallel_get_num_threads()`)
+ */
+extern size_t prsm_conv2d_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w);
+
+/**
+ * @brief  Returns the number of elements the workspace needs for a batch of N inputs of size (H, W)
+ * @param  params convolution parameters
+ * @param  in_n batch size
+ * @param  in_h input height
+ * @param  in_w input width
+ * @param  keep_columns whether forward keeps the columns of every image for backward
+ * @returns size_t
+ *
+ * @note equals `prsm_conv2d_workspace_size()` if `keep_columns==false`
+ */
+extern size_t prsm_conv2d_workspace_size_ex(const prsm_conv2d_params_t *const params, const size_t in_n, const size_t in_h, const size_t in_w, const bool keep_columns);
+
+/**
+ * @brief  Unfolds an image into columns: (C, H, W) => (C * KH * KW, OH * OW)
+ * @param  out output matrix
+ * @param  in image of shape (C, H, W)
+ * @param  params convolution parameters
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note padded positions are zeros
+ */
+extern prsm_tensor_t *prsm_conv2d_im2col(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_conv2d_params_t *const params);
+
+/**
+ * @brief  Folds columns back into an image accumulating overlapping positions: (C * KH * KW, OH * OW) => (C, H, W)
+ * @param  out image of shape (C, H, W); values are added to it
+ * @param  col columns matrix
+ * @param  params convolution parameters
+ * @returns None
+ */
+extern void prsm_conv2d_col2im(prsm_tensor_t *const out, const prsm_tensor_t *const col, const prsm_conv2d_params_t *const params);
+
+/**
+ * @brief  Convolution forward pass: out = activation(conv(in, w) + b)
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C/groups, KH, KW)
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied in the gemm epilogue
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor; resized if smaller than `prsm_conv2d_workspace_size()`
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note a preallocated workspace makes steady-state calls allocation free
+ * @note the algorithm is chosen by `prsm_conv2d_select_algorithm()`; direct convolution repacks one image at a time
+ */
+extern prsm_tensor_t *prsm_conv2d_forward(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Convolution forward pass that can keep the im2col columns for the backward pass
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C/groups, KH, KW)
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied in the gemm epilogue
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor; resized if smaller than `prsm_conv2d_workspace_size_ex()`
+ * @param  keep_columns run im2col + gemm and keep the columns of every image in the workspace
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note equals `prsm_conv2d_forward()` if `keep_columns==false`
+ * @note the kept columns stay valid until the workspace is used by another call
+ */
+extern prsm_tensor_t *prsm_conv2d_forward_ex(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const bool keep_columns);
+
+/**
+ * @brief  Convolution backward pass with respect to the convolution output (before activation)
+ * @param  dx gradient of the input of shape (N, C, H, W) or `NULL` to skip
+ * @param  dw gradient of the weights of shape (OC, C/groups, KH, KW)
+ * @param  db gradient of the bias of shape (OC) or `NULL` to skip
+ * @param  dout gradient of the output of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C/groups, KH, KW)
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor; resized if smaller than `prsm_conv2d_workspace_size()`
+ * @returns None
+ *
+ * @note gradients are overwritten, not accumulated
+ * @note dw = dout * col_T and dcol = w_T * dout are computed without transposing any tensor
+ * @note dw is parallelized over (image, output channel block) tasks with per-thread accumulators
+ */
+extern void prsm_conv2d_backward(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Convolution backward pass that can reuse the columns kept by the forward pass
+ * @param  dx gradient of the input of shape (N, C, H, W) or `NULL` to skip
+ * @param  dw gradient of the weights of shape (OC, C/groups, KH, KW)
+ * @param  db gradient of the bias of shape (OC) or `NULL` to skip
+ * @param  dout gradient of the output of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C/groups, KH, KW)
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor; resized if smaller than `prsm_conv2d_workspace_size_ex()`
+ * @param  reuse_columns read the columns kept by `prsm_conv2d_forward_ex()` instead of unfolding `in`
+ * @returns None
+ *
+ * @note equals `prsm_conv2d_backward()` if `reuse_columns==false`
+ * @note with `reuse_columns==true`, the workspace must come straight from `prsm_conv2d_forward_ex()` with
+ * `keep_columns==true` on the same input
+ */
+extern void prsm_conv2d_backward_ex(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const bool reuse_columns);
+
+/**
+ * @brief  Chooses the convolution algorithm for a layer shape: im2col + gemm, direct, depthwise, Winograd F(2x2,3x3)
+ *         or Winograd F(4x4,3x3)
+ * @param  params convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @returns enum PrismaConvAlgorithm
+ *
+ * @note depthwise layers (groups == in_channels == out_channels) always use the depthwise kernel
+ * @note Winograd is chosen for ungrouped 3x3 stride 1 layers with enough channels if its error estimate is within tolerance
+ * @note direct convolution is chosen for ungrouped, non-pointwise layers with few input channels or
+ *       when the im2col buffer of one image would not fit in the last level cache
+ */
+extern enum PrismaConvAlgorithm prsm_conv2d_select_algorithm(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w);
+
+/**
+ * @brief  Converts NCHW to channel-blocked NCHWc layout: (N, C, H, W) => (N, ceil(C/block), H, W, block)
+ * @param  out output tensor
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  block channel block size: 8 or 16
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note channels of the last block beyond C are zeros
+ */
+extern prsm_tensor_t *prsm_conv2d_to_nchwc(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t block);
+
+/**
+ * @brief  Converts channel-blocked NCHWc layout to NCHW: (N, CB, H, W, block) => (N, C, H, W)
+ * @param  out output tensor
+ * @param  in input tensor of shape (N, CB, H, W, block)
+ * @param  channels number of channels C; C <= CB * block
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_conv2d_from_nchwc(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t channels);
+
+/**
+ * @brief  Packs weights for direct convolution: (OC, C, KH, KW) => (ceil(OC/block), ceil(C/block), KH, KW, block, block)
+ * @param  out output tensor
+ * @param  w weights of shape (OC, C, KH, KW)
+ * @param  block channel block size: 8 or 16
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note the innermost dimension is the output channel, so one input channel's weights form a contiguous vector
+ */
+extern prsm_tensor_t *prsm_conv2d_pack_weights(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t block);
+
+/**
+ * @brief  Direct convolution on channel-blocked tensors: out = activation(conv(in, w) + b)
+ * @param  out output tensor of shape (N, ceil(OC/block), OH, OW, block)
+ * @param  in input tensor of shape (N, ceil(C/block), H, W, block)
+ * @param  w packed weights from `prsm_conv2d_pack_weights()`
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters; `groups` must be 1
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note output pixels are computed in register tiles of a row; no workspace is needed
+ */
+extern prsm_tensor_t *prsm_conv2d_direct(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params);
+
+/**
+ * @brief  Sets the relative error Winograd convolution may introduce; variants above it fall back to other algorithms
+ * @param  rtol relative tolerance; 0 disables Winograd
+ * @returns None
+ */
+extern void prsm_conv2d_set_winograd_tolerance(const prsm_float rtol);
+
+/**
+ * @brief  Returns the relative error Winograd convolution may introduce
+ * @returns prsm_float
+ */
+extern prsm_float prsm_conv2d_get_winograd_tolerance(void);
+
+/**
+ * @brief  Transforms 3x3 weights for Winograd F(m x m, 3x3): U = G * w * G_T, (OC, C, 3, 3) => ((m + 2)^2, OC, C)
+ * @param  out output tensor
+ * @param  w weights of shape (OC, C, 3, 3)
+ * @param  m output tile size: 2 or 4
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note precompute once for inference and pass to `prsm_conv2d_winograd()`
+ */
+extern prsm_tensor_t *prsm_conv2d_winograd_weights(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t m);
+
+/**
+ * @brief  Winograd convolution: out = activation(conv(in, w) + b)
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  u transformed weights from `prsm_conv2d_winograd_weights()`
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters: 3x3 kernel, stride 1, dilation 1, groups 1
+ * @param  m output tile size: 2 or 4
+ * @param  workspace scratch tensor for the transformed tiles of one image; resized if too small
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_conv2d_winograd(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const u, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t m, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Packs depthwise weights: (C, 1, KH, KW) => (ceil(C/block), KH, KW, block)
+ * @param  out output tensor
+ * @param  w weights of shape (C, 1, KH, KW)
+ * @param  block channel block size: 8 or 16
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_conv2d_pack_depthwise(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t block);
+
+/**
+ * @brief  Depthwise convolution on channel-blocked tensors: out = activation(conv(in, w) + b)
+ * @param  out output tensor of shape (N, CB, OH, OW, block)
+ * @param  in input tensor of shape (N, CB, H, W, block)
+ * @param  w packed weights from `prsm_conv2d_pack_depthwise()`
+ * @param  b bias of shape (C) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters; groups == in_channels == out_channels
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_conv2d_depthwise(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params);
+
+/**
+ * @brief  Fused depthwise and pointwise convolution on channel-blocked tensors:
+ *         out = pw_activation(conv1x1(dw_activation(depthwise(in, dw_w) + dw_b), pw_w) + pw_b)
+ * @param  out output tensor of shape (N, ceil(out_channels/block), OH, OW, block)
+ * @param  in input tensor of shape (N, CB, H, W, block)
+ * @param  dw_w packed depthwise weights from `prsm_conv2d_pack_depthwise()`
+ * @param  dw_b depthwise bias of shape (C) or `NULL`
+ * @param  dw_activation activation of the depthwise convolution
+ * @param  pw_w packed pointwise weights from `prsm_conv2d_pack_weights()` of shape (OCB, CB, 1, 1, block, block)
+ * @param  pw_b pointwise bias of shape (out_channels) or `NULL`
+ * @param  pw_activation activation of the pointwise convolution
+ * @param  params depthwise convolution parameters
+ * @param  out_channels number of pointwise output channels
+ * @param  workspace scratch tensor for per-thread bands of the intermediate tensor; resized if too small
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note the intermediate tensor is never materialized
+ */
+extern prsm_tensor_t *prsm_conv2d_depthwise_pointwise(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, const size_t out_channels, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Depthwise separable convolution on NCHW tensors through the fused kernel, repacking one image at a time
+ * @param  out output tensor of shape (N, out_channels, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  dw_w depthwise weights of shape (C, 1, KH, KW)
+ * @param  dw_b depthwise bias of shape (C) or `NULL`
+ * @param  dw_activation activation of the depthwise convolution
+ * @param  pw_w pointwise weights of shape (out_channels, C, 1, 1)
+ * @param  pw_b pointwise bias of shape (out_channels) or `NULL`
+ * @param  pw_activation activation of the pointwise convolution
+ * @param  params depthwise convolution parameters
+ * @param  workspace scratch tensor; resized if too small
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_conv2d_separable_forward(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Calculates the output size of a transposed convolution along one dimension
+ * @param  in input size
+ * @param  kernel kernel size
+ * @param  stride stride
+ * @param  padding padding removed from each side of the full output
+ * @param  dilation dilation
+ * @param  output_padding extra rows/columns added to one side; less than the stride
+ * @returns size_t: (in - 1) * stride - 2 * padding + dilation * (kernel - 1) + 1 + output_padding, or 0 if negative
+ */
+extern size_t prsm_conv2d_transpose_out_dim(const size_t in, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation, const size_t output_padding);
+
+/**
+ * @brief  Returns the number of elements the workspace of a transposed convolution needs for inputs of size (H, W)
+ * @param  params transposed convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @param  output_padding extra output rows and columns or `NULL` for none
+ * @returns size_t
+ *
+ * @note `prsm_conv2d_transpose_backward()` needs `prsm_conv2d_workspace_size()` of the mirrored convolution instead
+ */
+extern size_t prsm_conv2d_transpose_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w, const size_t output_padding[2]);
+
+/**
+ * @brief  Transposed convolution: (N, C, H, W) => (N, OC, OH, OW), out = activation(conv_transpose(in, w) + b)
+ * @param  out output tensor
+ * @param  in input tensor of shape (N, in_channels, H, W)
+ * @param  w weights of shape (in_channels, out_channels/groups, KH, KW)
+ * @param  b bias of shape (out_channels) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params transposed convolution parameters: channels are those of `in` and `out`
+ * @param  output_padding extra output rows and columns (less than the stride) or `NULL` for none
+ * @param  workspace scratch tensor; resized if too small
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note every output pixel is computed once from the input pixels it depends on; nothing is scattered
+ */
+extern prsm_tensor_t *prsm_conv2d_transpose(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t output_padding[2], prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Transposed convolution backward pass
+ * @param  dx gradient of the input or `NULL`
+ * @param  dw gradient of the weights
+ * @param  db gradient of the bias or `NULL`
+ * @param  dout gradient of the output before the activation
+ * @param  in input of the forward pass
+ * @param  w weights of shape (in_channels, out_channels/groups, KH, KW)
+ * @param  params transposed convolution parameters
+ * @param  workspace scratch tensor; resized if too small
+ * @returns None
+ *
+ * @note a transposed convolution is the input gradient of the mirrored convolution (out_channels => in_channels),
+ * so dx is that convolution's forward pass and dw its weight gradient; all gradients are overwritten
+ */
+extern void prsm_conv2d_transpose_backward(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace);
+
+/**
+ * @brief  Returns the number of elements the workspace of a fused upsampling and convolution needs
+ * @param  params convolution parameters
+ * @param  mode upsampling mode
+ * @param  scale upsampling factor
+ * @param  in_h input height before upsampling
+ * @param  in_w input width before upsampling
+ * @returns size_t
+ */
+extern size_t prsm_conv2d_upsample_workspace_size(const prsm_conv2d_params_t *const params, const enum PrismaConvUpsample mode, const size_t scale, const size_t in_h, const size_t in_w);
+
+/**
+ * @brief  Fused upsampling and convolution: out = activation(conv(upsample(in, scale), w) + b)
+ * @param  out output tensor of shape (N, out_channels, OH, OW) with OH = conv2d_out_dim(H * scale)
+ * @param  in input tensor of shape (N, in_channels, H, W)
+ * @param  w weights of shape (out_channels, in_channels/groups, KH, KW)
+ * @param  b bias of shape (out_channels) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters; stride and dilation must be 1
+ * @param  mode upsampling mode
+ * @param  scale upsampling factor
+ * @param  workspace scratch tensor; resized if too small
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note the upsampled tensor is never materialized; bilinear upsampling does not align corners and clamps
+ * source coordinates to the image, padding of the convolution is zero
+ * @note bilinear upsampling needs one upsampled channel per thread (`prsm_parallel_get_num_threads()`) of workspace
+ */
+extern prsm_tensor_t *prsm_conv2d_upsample_conv(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const enum PrismaConvUpsample mode, const size_t scale, prsm_tensor_t *const workspace);
+
+#endif // PRISMA_CORE_CONV_H
+
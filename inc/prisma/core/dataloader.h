@@ -0,0 +1,138 @@
+#ifndef PRISMA_CORE_DATALOADER_H
+#define PRISMA_CORE_DATALOADER_H
+
+/** DATALOADER MODULE
+ * This module implements a minibatch iterator that assembles batches on a background thread.
+ *
+ * Batches are written into a ring of preallocated buffers (double/triple buffering), so the next batches
+ * are prepared while the current one is being used. Samples are visited in a (optionally shuffled) order
+ * that is regenerated every epoch.
+
+ * Functions:
+    - prsm_dataloader_create
+    - prsm_dataloader_create_ex
+    - prsm_dataloader_destroy
+    - prsm_dataloader_len
+    - prsm_dataloader_next
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+
+/**
+ * @brief  Fills a batch with samples
+ * @param  ctx user context
+ * @param  x batch features of shape (count, x_cols)
+ * @param  y batch labels of shape (count, y_cols) or `NULL` if there are no labels
+ * @param  indices sample indices to copy
+ * @param  count number of samples
+ * @returns None
+ *
+ * @note called from the background thread
+ */
+typedef void (*prsm_dataloader_fn)(void *const ctx, prsm_tensor_t *const x, prsm_tensor_t *const y, const size_t indices[], const size_t count);
+
+// prefetched batch
+struct PrismaDataloaderBatch {
+    prsm_tensor_t *x;       // storage: (batch_size, x_cols)
+    prsm_tensor_t *y;       // storage: (batch_size, y_cols) or NULL
+    prsm_tensor_t x_view;   // filled rows of x
+    prsm_tensor_t y_view;   // filled rows of y
+    size_t x_shape[2];      // x_view shape
+    size_t y_shape[2];      // y_view shape
+};
+
+typedef struct PrismaDataloader {
+    size_t len;                 // number of samples
+    size_t batch_size;          // samples per batch
+    bool shuffle;               // shuffle samples every epoch
+    size_t *indices;            // sample order of the epoch being prefetched
+    uint64_t rng;               // shuffle random state
+
+    // data source
+    prsm_dataloader_fn fill;
+    void *ctx;
+    const prsm_tensor_t *x;     // source features (tensor based loaders)
+    const prsm_tensor_t *y;     // source labels (tensor based loaders)
+
+    // ring of batches
+    size_t num_buffers;
+    struct PrismaDataloaderBatch *buffers;
+    size_t head;                // number of batches prefetched
+    size_t tail;                // number of batches released
+    size_t epoch_batch;         // batches returned in the current epoch
+    bool holding;               // the batch at `tail` is in use
+    bool stop;                  // stop the background thread
+
+    // synchronization
+    prsm_thread_t thread;
+    prsm_mutex_t mutex;
+    prsm_cond_t not_empty;
+    prsm_cond_t not_full;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_dataloader_t;
+
+/**
+ * @brief  Creates a dataloader over in-memory tensors and starts prefetching
+ * @param  alloctr allocator instance
+ * @param  x features matrix of shape (N, x_cols)
+ * @param  y labels matrix of shape (N, y_cols) or `NULL`
+ * @param  batch_size samples per batch
+ * @param  num_buffers number of batches prefetched ahead (2 or 3 is usually enough)
+ * @param  shuffle shuffle samples every epoch
+ * @returns valid `prsm_dataloader_t*`
+ *
+ * @note `x` and `y` must not be modified while the dataloader exists
+ */
+extern prsm_dataloader_t *prsm_dataloader_create(struct VitaBaseAllocatorType *const alloctr, const prsm_tensor_t *const x, const prsm_tensor_t *const y, const size_t batch_size, const size_t num_buffers, const bool shuffle);
+
+/**
+ * @brief  Creates a dataloader with a custom data source and starts prefetching
+ * @param  alloctr allocator instance
+ * @param  len number of samples
+ * @param  x_cols features per sample
+ * @param  y_cols labels per sample; 0 if there are no labels
+ * @param  fill callback that copies samples into a batch
+ * @param  ctx context passed to `fill`
+ * @param  batch_size samples per batch
+ * @param  num_buffers number of batches prefetched ahead (2 or 3 is usually enough)
+ * @param  shuffle shuffle samples every epoch
+ * @returns valid `prsm_dataloader_t*`
+ *
+ * @note use it to decode samples on the background thread, e.g. from `prsm_dataset_idx_t`
+ */
+extern prsm_dataloader_t *prsm_dataloader_create_ex(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t x_cols, const size_t y_cols, prsm_dataloader_fn fill, void *const ctx, const size_t batch_size, const size_t num_buffers, const bool shuffle);
+
+/**
+ * @brief  Stops prefetching and frees the dataloader
+ * @param  dl dataloader
+ * @returns None
+ */
+extern void prsm_dataloader_destroy(prsm_dataloader_t *dl);
+
+/**
+ * @brief  Returns number of batches per epoch
+ * @param  dl dataloader
+ * @returns size_t
+ *
+ * @note the last batch is smaller if N is not divisible by batch_size
+ */
+extern size_t prsm_dataloader_len(const prsm_dataloader_t *const dl);
+
+/**
+ * @brief  Returns the next batch
+ * @param  dl dataloader
+ * @param  x batch features view
+ * @param  y batch labels view (may be `NULL`)
+ * @returns true upon success, false once at the end of every epoch
+ *
+ * @note views are valid until the next call; they point into the ring buffers and can be modified
+ * @note waits if the batch has not been prefetched yet
+ */
+extern bool prsm_dataloader_next(prsm_dataloader_t *const dl, prsm_tensor_t *const x, prsm_tensor_t *const y);
+
+#endif // PRISMA_CORE_DATALOADER_H
+
@@ -0,0 +1,114 @@
+#ifndef PRISMA_CORE_DATASET_H
+#define PRISMA_CORE_DATASET_H
+
+/** DATASET MODULE
+ * This module implements dataset loaders that write samples directly into preallocated tensors.
+
+ * Functions:
+    - prsm_dataset_read_csv
+    - prsm_dataset_idx_open
+    - prsm_dataset_idx_close
+    - prsm_dataset_idx_len
+    - prsm_dataset_idx_sample_size
+    - prsm_dataset_idx_get
+    - prsm_dataset_idx_to_tensor
+    - prsm_dataset_idx_to_labels
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/mmap.h"
+
+// defines
+#define PRSM_DATASET_IDX_MAX_DIMS 8
+
+// uint8 view into a mapped IDX file (e.g. MNIST `*-ubyte` files)
+typedef struct PrismaDatasetIdx {
+    prsm_mmap_t map;                            // mapped file
+    size_t ndim;                                // number of dimensions
+    size_t shape[PRSM_DATASET_IDX_MAX_DIMS];    // shape: (samples, ...)
+    const uint8_t *data;                        // points into the mapping
+} prsm_dataset_idx_t;
+
+/**
+ * @brief  Reads the first N rows of a CSV file into preallocated tensors
+ * @param  x features matrix of shape (N, features)
+ * @param  y labels matrix of shape (N, classes) for one-hot labels, (N, 1) for raw labels or `NULL` if there are no labels
+ * @param  filename file to read
+ * @param  delim field delimiter
+ * @param  has_header skip the first line
+ * @param  label_col index of the label column; ignored if `y` is `NULL`
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success
+ *
+ * @note the file is mapped into memory, split into line-aligned chunks and parsed in parallel
+ * @note each row must contain exactly `features` (+1 if `y` is set) numeric fields; empty lines are skipped
+ * @note one-hot labels must be integers in range [0, classes)
+ * @note returns PRSM_STATUS_ERROR_IO if the file cannot be mapped, PRSM_STATUS_ERROR_INVALID_FORMAT if it
+ *  contains less than N rows or a malformed row; the tensors' content is unspecified in both cases
+ */
+extern enum PrismaStatus prsm_dataset_read_csv(prsm_tensor_t *const x, prsm_tensor_t *const y, const char *const filename, const char delim, const bool has_header, const size_t label_col);
+
+/**
+ * @brief  Maps an IDX file into memory; no data is read or copied
+ * @param  idx IDX instance
+ * @param  filename file to open
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success
+ *
+ * @note only unsigned byte (type 0x08) files are supported
+ * @note returns PRSM_STATUS_ERROR_IO if the file cannot be mapped, PRSM_STATUS_ERROR_INVALID_FORMAT if the header
+ *  is invalid, the element type is not unsigned byte or the file is truncated
+ */
+extern enum PrismaStatus prsm_dataset_idx_open(prsm_dataset_idx_t *const idx, const char *const filename);
+
+/**
+ * @brief  Unmaps an IDX file; all pointers obtained from it become invalid
+ * @param  idx IDX instance
+ * @returns None
+ */
+extern void prsm_dataset_idx_close(prsm_dataset_idx_t *const idx);
+
+/**
+ * @brief  Returns number of samples (first dimension)
+ * @param  idx IDX instance
+ * @returns size_t
+ */
+extern size_t prsm_dataset_idx_len(const prsm_dataset_idx_t *const idx);
+
+/**
+ * @brief  Returns number of elements per sample (product of the remaining dimensions)
+ * @param  idx IDX instance
+ * @returns size_t
+ */
+extern size_t prsm_dataset_idx_sample_size(const prsm_dataset_idx_t *const idx);
+
+/**
+ * @brief  Returns a sample
+ * @param  idx IDX instance
+ * @param  at sample index
+ * @returns pointer to `prsm_dataset_idx_sample_size(idx)` read-only bytes
+ */
+extern const uint8_t *prsm_dataset_idx_get(const prsm_dataset_idx_t *const idx, const size_t at);
+
+/**
+ * @brief  Converts N samples starting at `from` into a matrix: out = data * scale
+ * @param  out matrix of shape (N, sample_size)
+ * @param  idx IDX instance
+ * @param  from first sample
+ * @param  scale multiplier, e.g. 1/255 to normalize pixels into [0, 1]
+ * @returns None
+ *
+ * @note conversion is a single parallel pass
+ */
+extern void prsm_dataset_idx_to_tensor(prsm_tensor_t *const out, const prsm_dataset_idx_t *const idx, const size_t from, const prsm_float scale);
+
+/**
+ * @brief  Converts N labels starting at `from` into a matrix
+ * @param  out matrix of shape (N, classes) for one-hot labels or (N, 1) for label indices
+ * @param  idx IDX instance with one byte per sample
+ * @param  from first sample
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success, PRSM_STATUS_ERROR_INVALID_FORMAT if a label is out of range [0, classes)
+ */
+extern enum PrismaStatus prsm_dataset_idx_to_labels(prsm_tensor_t *const out, const prsm_dataset_idx_t *const idx, const size_t from);
+
+#endif // PRISMA_CORE_DATASET_H
+
@@ -1,17 +1,365 @@
 #ifndef PRISMA_CORE_LAYERS_H
 #define PRISMA_CORE_LAYERS_H
 
-/** COST MODULE
+/** LAYERS MODULE
  * This module contains neural network layers.
+ *
+ * Layers own their parameters, gradients and output buffers. Buffers are resized only when the batch size
+ * changes, so steady-state forward and backward calls do not allocate.
 
  * Functions:
-    - 
+    - prsm_layer_dense_create
+    - prsm_layer_dense_destroy
+    - prsm_layer_dense_forward
+    - prsm_layer_dense_backward
+    - prsm_layer_conv2d_create
+    - prsm_layer_conv2d_destroy
+    - prsm_layer_conv2d_forward
+    - prsm_layer_conv2d_backward
+    - prsm_layer_conv2d_weights_changed
+    - prsm_layer_separable_create
+    - prsm_layer_separable_destroy
+    - prsm_layer_separable_forward
+    - prsm_layer_separable_backward
+    - prsm_layer_batchnorm_create
+    - prsm_layer_batchnorm_destroy
+    - prsm_layer_batchnorm_forward
+    - prsm_layer_batchnorm_forward_inplace
+    - prsm_layer_batchnorm_backward
+    - prsm_layer_batchnorm_fold_dense
+    - prsm_layer_batchnorm_fold_conv2d
 */
 
 #include "prisma/core/core.h"
 #include "prisma/core/tensor.h"
+#include "prisma/core/activation.h"
+#include "prisma/core/conv.h"
 
-//
+typedef struct PrismaLayerDense {
+    size_t in_features;
+    size_t out_features;
+    enum PrismaActivation activation;
+
+    // parameters
+    prsm_tensor_t *w;           // weights: (in_features, out_features)
+    prsm_tensor_t *b;           // bias: (out_features)
+
+    // gradients
+    prsm_tensor_t *dw;          // (in_features, out_features)
+    prsm_tensor_t *db;          // (out_features)
+    prsm_tensor_t *dx;          // gradient of the input: (N, in_features)
+    prsm_tensor_t *dz;          // gradient of the pre-activation: (N, out_features)
+
+    // forward state
+    prsm_tensor_t *out;         // activations: (N, out_features)
+    const prsm_tensor_t *in;    // last input (borrowed): (N, in_features)
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_layer_dense_t;
+
+typedef struct PrismaLayerConv2d {
+    prsm_conv2d_params_t params;
+    enum PrismaActivation activation;
+
+    // parameters
+    prsm_tensor_t *w;           // weights: (out_channels, in_channels/groups, KH, KW)
+    prsm_tensor_t *b;           // bias: (out_channels)
+
+    // gradients
+    prsm_tensor_t *dw;          // (out_channels, in_channels/groups, KH, KW)
+    prsm_tensor_t *db;          // (out_channels)
+    prsm_tensor_t *dx;          // gradient of the input: (N, in_channels, H, W)
+    prsm_tensor_t *dz;          // gradient of the pre-activation: (N, out_channels, OH, OW)
+
+    // forward state
+    prsm_tensor_t *out;         // activations: (N, out_channels, OH, OW)
+    const prsm_tensor_t *in;    // last input (borrowed): (N, in_channels, H, W)
+    prsm_tensor_t *workspace;   // im2col buffer shared by forward and backward
+    bool columns;               // workspace holds the columns of every image of `in`
+    prsm_tensor_t *u;           // Winograd transformed weights: ((m + 2)^2, out_channels, in_channels); allocated on first use
+    size_t u_tile;              // output tile size `m` of `u`; 0 if `w` changed since the transform
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_layer_conv2d_t;
+
+typedef struct PrismaLayerSeparable {
+    prsm_conv2d_params_t depthwise_params;      // groups == in_channels == out_channels
+    prsm_conv2d_params_t pointwise_params;      // 1x1: in_channels => out_channels
+    enum PrismaActivation depthwise_activation;
+    enum PrismaActivation pointwise_activation;
+
+    // parameters
+    prsm_tensor_t *depthwise_w;                 // (in_channels, 1, KH, KW)
+    prsm_tensor_t *depthwise_b;                 // (in_channels)
+    prsm_tensor_t *pointwise_w;                 // (out_channels, in_channels, 1, 1)
+    prsm_tensor_t *pointwise_b;                 // (out_channels)
+
+    // gradients
+    prsm_tensor_t *depthwise_dw;                // (in_channels, 1, KH, KW)
+    prsm_tensor_t *depthwise_db;                // (in_channels)
+    prsm_tensor_t *pointwise_dw;                // (out_channels, in_channels, 1, 1)
+    prsm_tensor_t *pointwise_db;                // (out_channels)
+    prsm_tensor_t *dx;                          // gradient of the input: (N, in_channels, H, W)
+    prsm_tensor_t *dz;                          // gradient of the pointwise pre-activation: (N, out_channels, OH, OW)
+    prsm_tensor_t *dmid;                        // gradient of the depthwise output: (N, in_channels, OH, OW)
+
+    // forward state
+    prsm_tensor_t *mid;                         // depthwise activations, recomputed by the backward pass
+    prsm_tensor_t *out;                         // activations: (N, out_channels, OH, OW)
+    const prsm_tensor_t *in;                    // last input (borrowed): (N, in_channels, H, W)
+    prsm_tensor_t *workspace;                   // scratch shared by forward and backward
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_layer_separable_t;
+
+typedef struct PrismaLayerBatchnorm {
+    size_t channels;
+    prsm_float momentum;        // running = (1 - momentum) * running + momentum * batch
+    prsm_float eps;             // added to the variance
+    bool folded;                // scale and shift live in the preceding layer: inference is the identity
+
+    // parameters
+    prsm_tensor_t *gamma;       // scale: (channels)
+    prsm_tensor_t *beta;        // shift: (channels)
+    prsm_tensor_t *running_mean;// (channels)
+    prsm_tensor_t *running_var; // (channels)
+
+    // gradients
+    prsm_tensor_t *dgamma;      // (channels)
+    prsm_tensor_t *dbeta;       // (channels)
+    prsm_tensor_t *dx;          // gradient of the input: (N, channels) or (N, channels, H, W)
+
+    // forward state
+    prsm_tensor_t *mean;        // batch mean: (channels)
+    prsm_tensor_t *inv_std;     // batch 1 / sqrt(var + eps): (channels)
+    prsm_tensor_t *xhat;        // normalized input of the last training pass: (N, channels) or (N, channels, H, W)
+    prsm_tensor_t *out;         // output of `prsm_layer_batchnorm_forward`; allocated on first use
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_layer_batchnorm_t;
+
+/**
+ * @brief  Creates a fully connected layer: out = activation(in * w + b)
+ * @param  alloctr allocator instance
+ * @param  in_features input size
+ * @param  out_features output size
+ * @param  activation activation applied to the output
+ * @returns valid `prsm_layer_dense_t*`
+ *
+ * @note weights are initialized with Glorot uniform, bias with zeros
+ */
+extern prsm_layer_dense_t *prsm_layer_dense_create(struct VitaBaseAllocatorType *const alloctr, const size_t in_features, const size_t out_features, const enum PrismaActivation activation);
+
+/**
+ * @brief  Frees the layer with all its buffers
+ * @param  layer dense layer
+ * @returns None
+ */
+extern void prsm_layer_dense_destroy(prsm_layer_dense_t *layer);
+
+/**
+ * @brief  Forward pass
+ * @param  layer dense layer
+ * @param  in input matrix of shape (N, in_features)
+ * @returns activations of shape (N, out_features) owned by the layer
+ *
+ * @note a single gemm: bias and activation are applied in its epilogue
+ * @note `in` is borrowed and must stay unchanged until the backward pass
+ */
+extern const prsm_tensor_t *prsm_layer_dense_forward(prsm_layer_dense_t *const layer, const prsm_tensor_t *const in);
+
+/**
+ * @brief  Backward pass: computes dw, db and, optionally, dx
+ * @param  layer dense layer
+ * @param  dout gradient of the activations of shape (N, out_features)
+ * @param  input_grad compute gradient of the input (not needed for the first layer)
+ * @returns gradient of the input of shape (N, in_features) owned by the layer or `NULL` if `input_grad==false`
+ *
+ * @note gradients are overwritten, not accumulated
+ * @note the activation derivative is computed from stored activations; no tensor is transposed
+ */
+extern const prsm_tensor_t *prsm_layer_dense_backward(prsm_layer_dense_t *const layer, const prsm_tensor_t *const dout, const bool input_grad);
+
+/**
+ * @brief  Creates a 2D convolution layer: out = activation(conv(in, w) + b)
+ * @param  alloctr allocator instance
+ * @param  params convolution parameters (copied)
+ * @param  activation activation applied to the output
+ * @returns valid `prsm_layer_conv2d_t*`
+ *
+ * @note weights are initialized with Glorot uniform, bias with zeros
+ */
+extern prsm_layer_conv2d_t *prsm_layer_conv2d_create(struct VitaBaseAllocatorType *const alloctr, const prsm_conv2d_params_t *const params, const enum PrismaActivation activation);
+
+/**
+ * @brief  Frees the layer with all its buffers
+ * @param  layer conv2d layer
+ * @returns None
+ */
+extern void prsm_layer_conv2d_destroy(prsm_layer_conv2d_t *layer);
+
+/**
+ * @brief  Forward pass
+ * @param  layer conv2d layer
+ * @param  in input tensor of shape (N, in_channels, H, W)
+ * @returns activations of shape (N, out_channels, OH, OW) owned by the layer
+ *
+ * @note the algorithm is chosen by `prsm_conv2d_select_algorithm()`; the activation is applied in the epilogue
+ * @note im2col layers keep the columns of the whole batch, so that the backward pass does not unfold `in` again
+ * @note Winograd layers transform the weights once and reuse them until the backward pass or `prsm_layer_conv2d_weights_changed()`
+ * @note `in` is borrowed and must stay unchanged until the backward pass
+ */
+extern const prsm_tensor_t *prsm_layer_conv2d_forward(prsm_layer_conv2d_t *const layer, const prsm_tensor_t *const in);
+
+/**
+ * @brief  Backward pass: computes dw, db and, optionally, dx
+ * @param  layer conv2d layer
+ * @param  dout gradient of the activations of shape (N, out_channels, OH, OW)
+ * @param  input_grad compute gradient of the input (not needed for the first layer)
+ * @returns gradient of the input of shape (N, in_channels, H, W) owned by the layer or `NULL` if `input_grad==false`
+ *
+ * @note gradients are overwritten, not accumulated
+ * @note the weights are expected to be updated afterwards, so the next forward pass transforms them again
+ */
+extern const prsm_tensor_t *prsm_layer_conv2d_backward(prsm_layer_conv2d_t *const layer, const prsm_tensor_t *const dout, const bool input_grad);
+
+/**
+ * @brief  Marks the weights as modified, e.g. after loading them: the next forward pass transforms them again
+ * @param  layer conv2d layer
+ * @returns None
+ *
+ * @note not needed after `prsm_layer_conv2d_backward()` or `prsm_layer_batchnorm_fold_conv2d()`
+ */
+extern void prsm_layer_conv2d_weights_changed(prsm_layer_conv2d_t *const layer);
+
+/**
+ * @brief  Creates a depthwise separable block: out = pw_act(conv1x1(dw_act(depthwise(in) + dw_b)) + pw_b)
+ * @param  alloctr allocator instance
+ * @param  in_channels input channels
+ * @param  out_channels output channels
+ * @param  kernel depthwise kernel size (height, width)
+ * @param  stride depthwise stride (height, width)
+ * @param  padding depthwise zero padding (height, width)
+ * @param  depthwise_activation activation after the depthwise convolution
+ * @param  pointwise_activation activation after the pointwise convolution
+ * @returns valid `prsm_layer_separable_t*`
+ *
+ * @note weights are initialized with Glorot uniform, biases with zeros
+ */
+extern prsm_layer_separable_t *prsm_layer_separable_create(struct VitaBaseAllocatorType *const alloctr, const size_t in_channels, const size_t out_channels, const size_t kernel[2], const size_t stride[2], const size_t padding[2], const enum PrismaActivation depthwise_activation, const enum PrismaActivation pointwise_activation);
+
+/**
+ * @brief  Frees the layer with all its buffers
+ * @param  layer separable layer
+ * @returns None
+ */
+extern void prsm_layer_separable_destroy(prsm_layer_separable_t *layer);
+
+/**
+ * @brief  Forward pass
+ * @param  layer separable layer
+ * @param  in input tensor of shape (N, in_channels, H, W)
+ * @returns activations of shape (N, out_channels, OH, OW) owned by the layer
+ *
+ * @note depthwise and pointwise convolutions are fused; the intermediate tensor is not stored
+ * @note `in` is borrowed and must stay unchanged until the backward pass
+ */
+extern const prsm_tensor_t *prsm_layer_separable_forward(prsm_layer_separable_t *const layer, const prsm_tensor_t *const in);
+
+/**
+ * @brief  Backward pass: computes gradients of both convolutions and, optionally, dx
+ * @param  layer separable layer
+ * @param  dout gradient of the activations of shape (N, out_channels, OH, OW)
+ * @param  input_grad compute gradient of the input (not needed for the first layer)
+ * @returns gradient of the input of shape (N, in_channels, H, W) owned by the layer or `NULL` if `input_grad==false`
+ *
+ * @note gradients are overwritten, not accumulated
+ * @note the depthwise activations are recomputed instead of kept from the forward pass
+ */
+extern const prsm_tensor_t *prsm_layer_separable_backward(prsm_layer_separable_t *const layer, const prsm_tensor_t *const dout, const bool input_grad);
+
+/**
+ * @brief  Creates a batch normalization layer: out = gamma * (in - mean) / sqrt(var + eps) + beta per channel
+ * @param  alloctr allocator instance
+ * @param  channels number of channels: features of a dense output or channels of a conv output
+ * @param  momentum weight of the batch statistics in the running statistics
+ * @param  eps added to the variance
+ * @returns valid `prsm_layer_batchnorm_t*`
+ *
+ * @note gamma is initialized with ones, beta and the running mean with zeros, the running variance with ones
+ */
+extern prsm_layer_batchnorm_t *prsm_layer_batchnorm_create(struct VitaBaseAllocatorType *const alloctr, const size_t channels, const prsm_float momentum, const prsm_float eps);
+
+/**
+ * @brief  Frees the layer with all its buffers
+ * @param  layer batchnorm layer
+ * @returns None
+ */
+extern void prsm_layer_batchnorm_destroy(prsm_layer_batchnorm_t *layer);
+
+/**
+ * @brief  Forward pass
+ * @param  layer batchnorm layer
+ * @param  in input tensor of shape (N, channels) or (N, channels, H, W)
+ * @param  training normalize with the batch statistics and update the running ones, otherwise use the running ones
+ * @returns output owned by the layer
+ *
+ * @note training computes the mean and variance of every channel in a single pass, then normalizes it while
+ * it is still in cache; channels are processed in parallel
+ * @note training keeps the normalized input for the backward pass in a buffer owned by the layer
+ * @note after folding, inference returns `in` untouched
+ */
+extern const prsm_tensor_t *prsm_layer_batchnorm_forward(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const in, const bool training);
+
+/**
+ * @brief  Same as `prsm_layer_batchnorm_forward`, but normalizes the input in place
+ * @param  layer batchnorm layer
+ * @param  in input tensor of shape (N, channels) or (N, channels, H, W); overwritten with the output
+ * @param  training normalize with the batch statistics and update the running ones, otherwise use the running ones
+ * @returns `in`
+ *
+ * @note `in` is usually the output buffer of the preceding layer (e.g. `conv->out`), which must not need it for
+ * its own backward pass: use a linear activation there and apply the nonlinearity after the batchnorm
+ */
+extern prsm_tensor_t *prsm_layer_batchnorm_forward_inplace(prsm_layer_batchnorm_t *const layer, prsm_tensor_t *const in, const bool training);
+
+/**
+ * @brief  Backward pass: computes dgamma, dbeta and, optionally, dx
+ * @param  layer batchnorm layer
+ * @param  dout gradient of the output
+ * @param  input_grad compute gradient of the input
+ * @returns gradient of the input owned by the layer or `NULL` if `input_grad==false`
+ *
+ * @note gradients are overwritten, not accumulated
+ * @note uses the normalized input of the last training forward pass
+ */
+extern const prsm_tensor_t *prsm_layer_batchnorm_backward(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const dout, const bool input_grad);
+
+/**
+ * @brief  Folds the running statistics, scale and shift into the preceding dense layer for inference
+ * @param  layer batchnorm layer
+ * @param  dense dense layer that feeds it; must have a linear activation
+ * @returns None
+ *
+ * @note w[:, j] *= s[j], b[j] = (b[j] - mean[j]) * s[j] + beta[j] with s = gamma / sqrt(var + eps)
+ * @note the batchnorm layer becomes the identity and cannot be trained anymore
+ */
+extern void prsm_layer_batchnorm_fold_dense(prsm_layer_batchnorm_t *const layer, prsm_layer_dense_t *const dense);
+
+/**
+ * @brief  Folds the running statistics, scale and shift into the preceding conv2d layer for inference
+ * @param  layer batchnorm layer
+ * @param  conv conv2d layer that feeds it; must have a linear activation
+ * @returns None
+ *
+ * @note w[oc] *= s[oc], b[oc] = (b[oc] - mean[oc]) * s[oc] + beta[oc] with s = gamma / sqrt(var + eps)
+ * @note the batchnorm layer becomes the identity and cannot be trained anymore
+ */
+extern void prsm_layer_batchnorm_fold_conv2d(prsm_layer_batchnorm_t *const layer, prsm_layer_conv2d_t *const conv);
 
 #endif // PRISMA_CORE_LAYERS_H
 
@@ -0,0 +1,53 @@
+#ifndef PRISMA_CORE_MMAP_H
+#define PRISMA_CORE_MMAP_H
+
+/** MMAP MODULE
+ * This module maps files into memory (read-only) for zero-copy data loading.
+
+ * Functions:
+    - prsm_mmap_open
+    - prsm_mmap_close
+    - prsm_mmap_is_null
+*/
+
+#include "prisma/core/core.h"
+
+typedef struct PrismaMmap {
+    const uint8_t *data;    // mapped file contents (read-only)
+    size_t size;            // file size in bytes
+
+    // platform specific handles
+#if defined(_WIN32) || defined(_WIN64)
+    void *hfile;
+    void *hmap;
+#else
+    int fd;
+#endif
+} prsm_mmap_t;
+
+/**
+ * @brief  Maps a file into memory as read-only
+ * @param  m mmap instance
+ * @param  filename file to map
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success, PRSM_STATUS_ERROR_IO otherwise
+ *
+ * @note pages are shared between processes mapping the same file
+ */
+extern enum PrismaStatus prsm_mmap_open(prsm_mmap_t *const m, const char *const filename);
+
+/**
+ * @brief  Unmaps a file
+ * @param  m mmap instance
+ * @returns None
+ */
+extern void prsm_mmap_close(prsm_mmap_t *const m);
+
+/**
+ * @brief  Checks if file is mapped
+ * @param  m mmap instance
+ * @returns ditto
+ */
+extern bool prsm_mmap_is_null(const prsm_mmap_t *const m);
+
+#endif // PRISMA_CORE_MMAP_H
+
@@ -0,0 +1,108 @@
+#ifndef PRISMA_CORE_OPTIM_H
+#define PRISMA_CORE_OPTIM_H
+
+/** OPTIM MODULE
+ * This module implements fused optimizer updates: SGD with momentum, Adam and AdamW.
+ *
+ * A step reads every parameter and its gradient once: gradient clipping, weight decay, momentum or Adam
+ * moments and the parameter update are applied to each element in a single pass, and the gradients are
+ * left untouched. All parameter tensors of a model are updated by one multi-tensor call: their elements
+ * form one range that is split into equal chunks across threads, so many small bias vectors do not
+ * each pay for a parallel dispatch and one large weight matrix still uses every thread.
+ *
+ * Optimizer state (momentum buffer, Adam moments) is allocated on the first step, one buffer per parameter
+ * tensor, and matched to the tensors by their position in the arrays passed to `prsm_optim_step()`.
+
+ * Functions:
+    - prsm_optim_create
+    - prsm_optim_destroy
+    - prsm_optim_reset
+    - prsm_optim_step
+    - prsm_optim_find
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+
+// optimizer algorithms
+enum PrismaOptimType {
+    PRSM_OPTIM_SGD,         // SGD with optional momentum; weight decay is added to the gradient
+    PRSM_OPTIM_ADAM,        // Adam; weight decay is added to the gradient
+    PRSM_OPTIM_ADAMW,       // Adam with decoupled weight decay
+    PRSM_OPTIM_COUNT
+};
+
+// optimizer hyperparameters
+typedef struct PrismaOptimParams {
+    enum PrismaOptimType type;
+    prsm_float lr;              // learning rate
+    prsm_float momentum;        // SGD: momentum factor, 0 for plain SGD
+    prsm_float beta1;           // Adam: decay of the first moment
+    prsm_float beta2;           // Adam: decay of the second moment
+    prsm_float eps;             // Adam: added to the denominator
+    prsm_float weight_decay;    // 0 to disable
+    prsm_float clip;            // gradients are clipped to [-clip, clip]; 0 to disable
+} prsm_optim_params_t;
+
+typedef struct PrismaOptim {
+    prsm_optim_params_t params;
+    size_t step;                // number of steps taken
+
+    // state: one buffer per parameter tensor, allocated on the first step
+    size_t count;               // number of parameter tensors
+    prsm_tensor_t **m;          // SGD: momentum buffer, Adam: first moment; `NULL` for plain SGD
+    prsm_tensor_t **v;          // Adam: second moment; `NULL` for SGD
+    size_t *offsets;            // (count + 1) prefix sums of the parameter sizes
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_optim_t;
+
+/**
+ * @brief  Creates an optimizer
+ * @param  alloctr allocator instance
+ * @param  params hyperparameters
+ * @returns valid `prsm_optim_t*`
+ */
+extern prsm_optim_t *prsm_optim_create(struct VitaBaseAllocatorType *const alloctr, const prsm_optim_params_t *const params);
+
+/**
+ * @brief  Frees the optimizer with its state
+ * @param  optim optimizer
+ * @returns None
+ */
+extern void prsm_optim_destroy(prsm_optim_t *optim);
+
+/**
+ * @brief  Frees the state and resets the step counter, so that the next step may use different tensors
+ * @param  optim optimizer
+ * @returns None
+ */
+extern void prsm_optim_reset(prsm_optim_t *const optim);
+
+/**
+ * @brief  Updates all parameters in one multi-tensor pass
+ * @param  optim optimizer
+ * @param  params parameter tensors, updated in place
+ * @param  grads gradients of the parameters, same shapes
+ * @param  count number of tensors
+ * @returns None
+ *
+ * @note every step must pass the same number of tensors with the same sizes in the same order
+ * @note the learning rate and other hyperparameters can be changed in `optim->params` between steps
+ */
+extern void prsm_optim_step(prsm_optim_t *const optim, prsm_tensor_t *const params[], const prsm_tensor_t *const grads[], const size_t count);
+
+/**
+ * @brief  Finds the tensor that holds an element of the concatenated parameters
+ * @param  offsets (count + 1) prefix sums of the tensor sizes
+ * @param  count number of tensors
+ * @param  at element index
+ * @returns size_t
+ *
+ * @note used by multi-tensor kernels (optimizer, gradient all-reduce) to map a flat chunk back to tensors
+ */
+extern size_t prsm_optim_find(const size_t *const offsets, const size_t count, const size_t at);
+
+#endif // PRISMA_CORE_OPTIM_H
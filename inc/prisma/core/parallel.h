@@ -0,0 +1,221 @@
+#ifndef PRISMA_CORE_PARALLEL_H
+#define PRISMA_CORE_PARALLEL_H
+
+/** PARALLEL MODULE
+ * This module implements a minimal fork-join parallel loop over a pool of persistent workers, and thin wrappers
+ * over native threads (pthreads or Win32).
+
+ * Functions:
+    - prsm_parallel_get_num_threads
+    - prsm_parallel_set_num_threads
+    - prsm_parallel_for
+    - prsm_parallel_get_num_blocks
+    - prsm_thread_create
+    - prsm_thread_join
+    - prsm_thread_pin
+    - prsm_thread_yield
+    - prsm_mutex_init
+    - prsm_mutex_destroy
+    - prsm_mutex_lock
+    - prsm_mutex_unlock
+    - prsm_cond_init
+    - prsm_cond_destroy
+    - prsm_cond_wait
+    - prsm_cond_signal
+    - prsm_cond_broadcast
+    - prsm_atomic_load
+    - prsm_atomic_store
+    - prsm_atomic_fetch_add
+*/
+
+#include "prisma/core/core.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+    typedef HANDLE prsm_thread_handle_t;
+    typedef CRITICAL_SECTION prsm_mutex_t;
+    typedef CONDITION_VARIABLE prsm_cond_t;
+#else
+    #include <pthread.h>
+    typedef pthread_t prsm_thread_handle_t;
+    typedef pthread_mutex_t prsm_mutex_t;
+    typedef pthread_cond_t prsm_cond_t;
+#endif
+
+typedef struct PrismaThread {
+    prsm_thread_handle_t handle;    // native handle
+    void (*fn)(void *const arg);    // thread body
+    void *arg;                      // thread body argument
+} prsm_thread_t;
+
+/**
+ * @brief  Loop body executed by a worker
+ * @param  ctx user context
+ * @param  from first index (inclusive)
+ * @param  to last index (exclusive)
+ * @param  tid worker id in range [0, number of workers)
+ * @returns None
+ */
+typedef void (*prsm_parallel_fn)(void *const ctx, const size_t from, const size_t to, const size_t tid);
+
+/**
+ * @brief  Returns the number of threads used by parallel kernels
+ * @returns size_t
+ *
+ * @note defaults to the number of online processors
+ */
+extern size_t prsm_parallel_get_num_threads(void);
+
+/**
+ * @brief  Sets the number of threads used by parallel kernels
+ * @param  num_threads number of threads; 0 restores the default
+ * @returns None
+ */
+extern void prsm_parallel_set_num_threads(const size_t num_threads);
+
+/**
+ * @brief  Splits range [0, size) into contiguous blocks and runs them in parallel
+ * @param  size range size
+ * @param  grain minimum block size; small ranges run on the calling thread
+ * @param  fn loop body
+ * @param  ctx user context passed to `fn`
+ * @returns None
+ *
+ * @note the calling thread executes the last block; the call returns once all blocks are done
+ * @note the other blocks run on persistent workers started on first use; while another thread's loop occupies them,
+ *       the blocks run on short-lived threads instead
+ * @note at most `prsm_parallel_get_num_threads()` workers are used, so `tid` can index per-thread buffers
+ * @note a call made from inside a loop body runs on the calling thread as a single block with `tid` 0
+ */
+extern void prsm_parallel_for(const size_t size, const size_t grain, prsm_parallel_fn fn, void *const ctx);
+
+/**
+ * @brief  Returns the number of blocks the last `prsm_parallel_for` of the calling thread was split into
+ * @returns size_t
+ *
+ * @note nested calls are not counted; 1 means the loop ran serially
+ */
+extern size_t prsm_parallel_get_num_blocks(void);
+
+/**
+ * @brief  Starts a thread
+ * @param  thread thread instance; must stay valid until `prsm_thread_join`
+ * @param  fn thread body
+ * @param  arg argument passed to `fn`
+ * @returns true upon success
+ */
+extern bool prsm_thread_create(prsm_thread_t *const thread, void (*fn)(void *const arg), void *const arg);
+
+/**
+ * @brief  Waits for a thread to finish and releases its resources
+ * @param  thread thread instance
+ * @returns None
+ */
+extern void prsm_thread_join(prsm_thread_t *const thread);
+
+/**
+ * @brief  Pins the calling thread to a processor
+ * @param  cpu processor index
+ * @returns true upon success, false if the processor does not exist or pinning is not supported
+ */
+extern bool prsm_thread_pin(const size_t cpu);
+
+/**
+ * @brief  Gives the processor of the calling thread to another thread
+ * @returns None
+ */
+extern void prsm_thread_yield(void);
+
+/**
+ * @brief  Initializes a mutex
+ * @param  mutex mutex instance
+ * @returns None
+ */
+extern void prsm_mutex_init(prsm_mutex_t *const mutex);
+
+/**
+ * @brief  Destroys a mutex
+ * @param  mutex mutex instance
+ * @returns None
+ */
+extern void prsm_mutex_destroy(prsm_mutex_t *const mutex);
+
+/**
+ * @brief  Locks a mutex
+ * @param  mutex mutex instance
+ * @returns None
+ */
+extern void prsm_mutex_lock(prsm_mutex_t *const mutex);
+
+/**
+ * @brief  Unlocks a mutex
+ * @param  mutex mutex instance
+ * @returns None
+ */
+extern void prsm_mutex_unlock(prsm_mutex_t *const mutex);
+
+/**
+ * @brief  Initializes a condition variable
+ * @param  cond condition variable instance
+ * @returns None
+ */
+extern void prsm_cond_init(prsm_cond_t *const cond);
+
+/**
+ * @brief  Destroys a condition variable
+ * @param  cond condition variable instance
+ * @returns None
+ */
+extern void prsm_cond_destroy(prsm_cond_t *const cond);
+
+/**
+ * @brief  Atomically unlocks the mutex and waits for a signal; the mutex is locked again upon return
+ * @param  cond condition variable instance
+ * @param  mutex locked mutex
+ * @returns None
+ *
+ * @note spurious wakeups are possible, so always wait in a loop checking the condition
+ */
+extern void prsm_cond_wait(prsm_cond_t *const cond, prsm_mutex_t *const mutex);
+
+/**
+ * @brief  Wakes up one waiting thread
+ * @param  cond condition variable instance
+ * @returns None
+ */
+extern void prsm_cond_signal(prsm_cond_t *const cond);
+
+/**
+ * @brief  Wakes up all waiting threads
+ * @param  cond condition variable instance
+ * @returns None
+ */
+extern void prsm_cond_broadcast(prsm_cond_t *const cond);
+
+/**
+ * @brief  Atomically loads a counter; reads that follow see all writes made before the matching store
+ * @param  ptr counter
+ * @returns size_t
+ *
+ * @note works on memory shared between processes
+ */
+extern size_t prsm_atomic_load(size_t *const ptr);
+
+/**
+ * @brief  Atomically stores a counter after all preceding writes
+ * @param  ptr counter
+ * @param  value new value
+ * @returns None
+ */
+extern void prsm_atomic_store(size_t *const ptr, const size_t value);
+
+/**
+ * @brief  Atomically adds to a counter with acquire-release ordering
+ * @param  ptr counter
+ * @param  value increment
+ * @returns the previous value
+ */
+extern size_t prsm_atomic_fetch_add(size_t *const ptr, const size_t value);
+
+#endif // PRISMA_CORE_PARALLEL_H
+
@@ -0,0 +1,119 @@
+#ifndef PRISMA_CORE_PIPELINE_H
+#define PRISMA_CORE_PIPELINE_H
+
+/** PIPELINE MODULE
+ * This module implements a pipeline-parallel executor: a model is split into stages (groups of layers),
+ * and every stage runs on its own thread, optionally pinned to a processor.
+ *
+ * A batch is cut by rows into micro-batches that stream through the stages: while stage 1 works on
+ * micro-batch k, stage 0 already works on micro-batch k + 1. Stages hand results over through bounded
+ * single-producer/single-consumer queues of tensors; queue slots keep their buffers between micro-batches,
+ * and the only synchronization is a pair of atomic counters per queue. Since a stage always runs on the
+ * same core and calls its kernels on that thread (nested parallel regions are serial), its weights stay
+ * in that core's caches instead of all weights of the model competing for the same cache.
+
+ * Functions:
+    - prsm_pipeline_create
+    - prsm_pipeline_destroy
+    - prsm_pipeline_run
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+
+// maximum number of dimensions of the batch tensors
+#define PRSM_PIPELINE_MAX_DIMS 8
+
+// cache line size in bytes: queue counters do not share lines
+#define PRSM_PIPELINE_CACHE_LINE 64
+
+/**
+ * @brief  Computes a stage (a group of layers) for one micro-batch
+ * @param  ctx stage context, e.g. the layers of the stage
+ * @param  in micro-batch input
+ * @returns stage output, owned by the stage; it is copied into the next queue before the next call
+ *
+ * @note a stage is always called from the same thread
+ */
+typedef const prsm_tensor_t *(*prsm_pipeline_stage_fn)(void *const ctx, const prsm_tensor_t *const in);
+
+typedef struct PrismaPipelineStage {
+    prsm_pipeline_stage_fn fn;
+    void *ctx;
+} prsm_pipeline_stage_t;
+
+// queue slot
+struct PrismaPipelineSlot {
+    prsm_tensor_t *tensor;                      // stage output buffer, kept between micro-batches
+    prsm_tensor_t view;                         // first queue: micro-batch view into the batch
+    size_t view_shape[PRSM_PIPELINE_MAX_DIMS];
+    size_t index;                               // micro-batch index; `SIZE_MAX` stops the stage
+};
+
+// bounded single-producer/single-consumer queue
+struct PrismaPipelineQueue {
+    size_t head;                                // number of slots consumed; written by the consumer
+    uint8_t head_pad[PRSM_PIPELINE_CACHE_LINE - sizeof(size_t)];
+    size_t tail;                                // number of slots produced; written by the producer
+    uint8_t tail_pad[PRSM_PIPELINE_CACHE_LINE - sizeof(size_t)];
+    struct PrismaPipelineSlot *slots;
+};
+
+// stage thread argument
+struct PrismaPipelineWorker {
+    struct PrismaPipeline *pipeline;
+    size_t stage;
+    bool pin;                                   // pin the thread to processor `stage`
+};
+
+typedef struct PrismaPipeline {
+    size_t num_stages;
+    size_t depth;                               // slots per queue
+    prsm_pipeline_stage_t *stages;
+    struct PrismaPipelineQueue *queues;         // queue i feeds stage i; the last one feeds the caller
+    struct PrismaPipelineWorker *workers;
+    prsm_thread_t *threads;
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_pipeline_t;
+
+/**
+ * @brief  Creates a pipeline and starts one thread per stage
+ * @param  alloctr allocator instance
+ * @param  stages stages in model order
+ * @param  num_stages number of stages
+ * @param  depth slots per queue: micro-batches that can wait between two stages
+ * @param  pin pin stage `i` to processor `i`
+ * @returns valid `prsm_pipeline_t*`
+ *
+ * @note stage threads allocate queue buffers, so `alloctr` must be thread-safe or `NULL`
+ * @note threads wait for work by spinning and yielding
+ */
+extern prsm_pipeline_t *prsm_pipeline_create(
+    struct VitaBaseAllocatorType *const alloctr, const prsm_pipeline_stage_t stages[], const size_t num_stages,
+    const size_t depth, const bool pin
+);
+
+/**
+ * @brief  Stops the stage threads and frees the pipeline
+ * @param  pipeline pipeline
+ * @returns None
+ */
+extern void prsm_pipeline_destroy(prsm_pipeline_t *pipeline);
+
+/**
+ * @brief  Streams a batch through the stages in micro-batches
+ * @param  out output tensor (N, ...)
+ * @param  pipeline pipeline
+ * @param  in input tensor (N, ...)
+ * @param  micro_batch rows per micro-batch
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note the last stage must produce one output row per input row
+ */
+extern prsm_tensor_t *prsm_pipeline_run(prsm_tensor_t *out, prsm_pipeline_t *const pipeline, const prsm_tensor_t *const in, const size_t micro_batch);
+
+#endif // PRISMA_CORE_PIPELINE_H
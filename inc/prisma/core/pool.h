@@ -0,0 +1,145 @@
+#ifndef PRISMA_CORE_POOL_H
+#define PRISMA_CORE_POOL_H
+
+/** POOL MODULE
+ * This module implements 2D max, average and global average pooling.
+ *
+ * Kernels accept NCHW tensors (N, C, H, W) and channel-blocked NCHWc tensors (N, CB, H, W, block) produced by
+ * `prsm_conv2d_to_nchwc()`, and read the input in place: padding is skipped by bounds checks, no padded copy
+ * or unfolded buffer is made, so views into a larger tensor work as well. On NCHWc, every window tap is one
+ * vector max/add across a channel block; NCHW is handled as blocks of one channel.
+ *
+ * Max pooling can record the position of the maximum for the backward pass. Instead of a mask of the input
+ * size, it stores one window offset (kh * KW + kw) per output element: 1 byte for windows of up to 256
+ * elements, 2 bytes up to 65536.
+
+ * Functions:
+    - prsm_pool_indices_create
+    - prsm_pool_indices_destroy
+    - prsm_pool_indices_get
+    - prsm_pool2d_max
+    - prsm_pool2d_max_backward
+    - prsm_pool2d_avg
+    - prsm_pool2d_avg_backward
+    - prsm_pool2d_global_avg
+    - prsm_pool2d_global_avg_backward
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+#include "prisma/core/conv.h"
+
+// pooling geometry; index 0 is height, index 1 is width
+typedef struct PrismaPool2dParams {
+    size_t kernel[2];
+    size_t stride[2];
+    size_t padding[2];      // implicit padding on each side; at most half the kernel
+} prsm_pool2d_params_t;
+
+// max pooling argmax: one window offset per output element
+typedef struct PrismaPoolIndices {
+    size_t size;            // number of offsets
+    size_t width;           // bytes per offset: 1 or 2
+    size_t capacity;        // number of bytes `data` can hold
+    uint8_t *data;          // offsets: uint8_t if `width==1`, uint16_t if `width==2`
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_pool_indices_t;
+
+/**
+ * @brief  Creates argmax storage for `size` output elements of a window with `window` elements
+ * @param  alloctr allocator instance
+ * @param  size number of output elements
+ * @param  window number of elements per window: KH * KW
+ * @returns valid `prsm_pool_indices_t*` or asserts on failure
+ *
+ * @note offsets are 1 byte wide for windows of up to 256 elements and 2 bytes wide up to 65536
+ */
+extern prsm_pool_indices_t *prsm_pool_indices_create(struct VitaBaseAllocatorType *const alloctr, const size_t size, const size_t window);
+
+/**
+ * @brief  Destroys argmax storage
+ * @param  idx argmax storage
+ * @returns None
+ */
+extern void prsm_pool_indices_destroy(prsm_pool_indices_t *idx);
+
+/**
+ * @brief  Returns the window offset (kh * KW + kw) of the maximum of an output element
+ * @param  idx argmax storage
+ * @param  at output element
+ * @returns size_t
+ */
+extern size_t prsm_pool_indices_get(const prsm_pool_indices_t *const idx, const size_t at);
+
+/**
+ * @brief  Max pooling: (N, C, H, W) => (N, C, OH, OW) or (N, CB, H, W, block) => (N, CB, OH, OW, block)
+ * @param  out output tensor
+ * @param  idx argmax storage for the backward pass or `NULL`
+ * @param  in input tensor
+ * @param  params pooling parameters
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated; `idx` is resized to the output size if needed
+ * @note padded positions are skipped, never selected
+ */
+extern prsm_tensor_t *prsm_pool2d_max(prsm_tensor_t *out, prsm_pool_indices_t *const idx, const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params);
+
+/**
+ * @brief  Max pooling backward pass: routes every output gradient to the maximum of its window
+ * @param  dx gradient of the input; must have the shape of the input
+ * @param  dout gradient of the output
+ * @param  idx argmax storage filled by `prsm_pool2d_max()`
+ * @param  params pooling parameters
+ * @returns None
+ *
+ * @note dx is overwritten; overlapping windows accumulate
+ */
+extern void prsm_pool2d_max_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout, const prsm_pool_indices_t *const idx, const prsm_pool2d_params_t *const params);
+
+/**
+ * @brief  Average pooling: (N, C, H, W) => (N, C, OH, OW) or (N, CB, H, W, block) => (N, CB, OH, OW, block)
+ * @param  out output tensor
+ * @param  in input tensor
+ * @param  params pooling parameters
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note windows are averaged over their elements inside the input; padded positions are not counted
+ */
+extern prsm_tensor_t *prsm_pool2d_avg(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params);
+
+/**
+ * @brief  Average pooling backward pass: spreads every output gradient evenly over its window
+ * @param  dx gradient of the input; must have the shape of the input
+ * @param  dout gradient of the output
+ * @param  params pooling parameters
+ * @returns None
+ *
+ * @note dx is overwritten; overlapping windows accumulate
+ */
+extern void prsm_pool2d_avg_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout, const prsm_pool2d_params_t *const params);
+
+/**
+ * @brief  Global average pooling: (N, C, H, W) => (N, C, 1, 1) or (N, CB, H, W, block) => (N, CB, 1, 1, block)
+ * @param  out output tensor
+ * @param  in input tensor
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_pool2d_global_avg(prsm_tensor_t *out, const prsm_tensor_t *const in);
+
+/**
+ * @brief  Global average pooling backward pass
+ * @param  dx gradient of the input; must have the shape of the input
+ * @param  dout gradient of the output of shape (N, C, 1, 1) or (N, CB, 1, 1, block)
+ * @returns None
+ *
+ * @note dx is overwritten
+ */
+extern void prsm_pool2d_global_avg_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout);
+
+#endif // PRISMA_CORE_POOL_H
@@ -0,0 +1,161 @@
+#ifndef PRISMA_CORE_SPARSE_H
+#define PRISMA_CORE_SPARSE_H
+
+/** SPARSE MODULE
+ * This module is a collection of compressed sparse matrix formats (CSR/CSC) and sparse-dense kernels.
+
+ * Functions:
+    - prsm_sparse_create
+    - prsm_sparse_destroy
+    - prsm_sparse_is_null
+    - prsm_sparse_nnz
+    - prsm_sparse_density
+    - prsm_sparse_from_dense
+    - prsm_sparse_to_dense
+    - prsm_sparse_spmv
+    - prsm_sparse_spmm
+    - prsm_sparse_display
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+
+// sparse matrix storage format
+enum PrismaSparseFormat {
+    PRSM_SPARSE_FORMAT_CSR,     // compressed sparse row: row pointers, column indices
+    PRSM_SPARSE_FORMAT_CSC,     // compressed sparse column: column pointers, row indices
+    PRSM_SPARSE_FORMAT_COUNT    // number of elements
+};
+
+typedef struct PrismaSparse {
+    enum PrismaSparseFormat format; // storage format
+
+    size_t rows;        // number of rows of the dense matrix
+    size_t cols;        // number of cols of the dense matrix
+    size_t nnz;         // number of stored (non-zero) elements
+    size_t capacity;    // number of elements `idx` and `data` can hold
+
+    size_t *ptr;        // compressed pointers: rows+1 (CSR) or cols+1 (CSC)
+    size_t *idx;        // column (CSR) or row (CSC) index of each stored element
+    prsm_float *data;   // stored values
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_sparse_t;
+
+/*
+    Sparse creation/destruction
+*/
+
+/**
+ * @brief  Creates an empty sparse matrix
+ * @param  alloctr allocator instance
+ * @param  format storage format
+ * @param  rows number of rows
+ * @param  cols number of cols
+ * @param  capacity number of non-zero elements to preallocate
+ * @returns valid `prsm_sparse_t*` or asserts on failure
+ */
+extern prsm_sparse_t *prsm_sparse_create(struct VitaBaseAllocatorType *const alloctr, const enum PrismaSparseFormat format, const size_t rows, const size_t cols, const size_t capacity);
+
+/**
+ * @brief  Destroys a sparse matrix
+ * @param  sp sparse matrix
+ * @returns None
+ */
+extern void prsm_sparse_destroy(prsm_sparse_t *sp);
+
+/*
+    Sparse properties
+*/
+
+/**
+ * @brief  Checks if sparse matrix is valid
+ * @param  sp sparse matrix
+ * @returns ditto
+ */
+extern bool prsm_sparse_is_null(const prsm_sparse_t *const sp);
+
+/**
+ * @brief  Returns number of stored elements
+ * @param  sp sparse matrix
+ * @returns nnz
+ */
+extern size_t prsm_sparse_nnz(const prsm_sparse_t *const sp);
+
+/**
+ * @brief  Returns ratio of stored elements to the dense size
+ * @param  sp sparse matrix
+ * @returns density in range [0; 1]
+ */
+extern prsm_float prsm_sparse_density(const prsm_sparse_t *const sp);
+
+/*
+    Sparse conversion
+*/
+
+/**
+ * @brief  Compresses a dense 2d tensor dropping values whose magnitude is `<= threshold`
+ * @param  out output sparse matrix
+ * @param  in dense matrix tensor
+ * @param  format storage format
+ * @param  threshold values with `abs(x) <= threshold` are treated as zeros
+ * @returns prsm_sparse_t*
+ *
+ * @note if `out==NULL`, sparse matrix is allocated
+ * @note `out` buffers are reused if their capacity suffices
+ */
+extern prsm_sparse_t *prsm_sparse_from_dense(prsm_sparse_t *out, const prsm_tensor_t *const in, const enum PrismaSparseFormat format, const prsm_float threshold);
+
+/**
+ * @brief  Decompresses sparse matrix into a dense 2d tensor
+ * @param  out output tensor
+ * @param  sp sparse matrix
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ */
+extern prsm_tensor_t *prsm_sparse_to_dense(prsm_tensor_t *out, const prsm_sparse_t *const sp);
+
+/*
+    Sparse-dense operations
+*/
+
+/**
+ * @brief  Sparse matrix by dense vector multiplication (SpMV)
+ * @param  out output vector tensor (rows)
+ * @param  lhs sparse matrix (rows, cols)
+ * @param  rhs dense vector tensor (cols)
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note `out` is zero initialized
+ */
+extern prsm_tensor_t *prsm_sparse_spmv(prsm_tensor_t *out, const prsm_sparse_t *const lhs, const prsm_tensor_t *const rhs);
+
+/**
+ * @brief  Sparse matrix by dense matrix multiplication (SpMM)
+ * @param  out output matrix tensor (rows, rhs.cols)
+ * @param  lhs sparse matrix (rows, cols)
+ * @param  rhs dense matrix tensor (cols, rhs.cols)
+ * @returns prsm_tensor_t*
+ *
+ * @note if `out==NULL`, tensor is allocated
+ * @note `out` is zero initialized
+ * @note the cost is O(nnz * rhs.cols) instead of O(rows * cols * rhs.cols)
+ */
+extern prsm_tensor_t *prsm_sparse_spmm(prsm_tensor_t *out, const prsm_sparse_t *const lhs, const prsm_tensor_t *const rhs);
+
+/*
+    Pretty printing
+*/
+
+/**
+ * @brief  Pretty printing
+ * @param  sp sparse matrix
+ * @returns None
+ */
+extern void prsm_sparse_display(const prsm_sparse_t *const sp);
+
+#endif // PRISMA_CORE_SPARSE_H
+
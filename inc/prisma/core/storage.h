@@ -0,0 +1,130 @@
+#ifndef PRISMA_CORE_STORAGE_H
+#define PRISMA_CORE_STORAGE_H
+
+/** STORAGE MODULE
+ * This module implements a versioned binary container for named tensors with zero-copy loading.
+ *
+ * File layout (native byte order, checked on load):
+ *   [header: 64 bytes][entry table: count * 160 bytes][padding][tensor data, each aligned to PRSM_STORAGE_ALIGNMENT]
+
+ * Functions:
+    - prsm_storage_save
+    - prsm_storage_open
+    - prsm_storage_close
+    - prsm_storage_len
+    - prsm_storage_name
+    - prsm_storage_dtype
+    - prsm_storage_get
+    - prsm_storage_get_at
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/mmap.h"
+
+// defines
+#define PRSM_STORAGE_VERSION 1
+#define PRSM_STORAGE_ALIGNMENT 64
+#define PRSM_STORAGE_MAX_DIMS 8
+#define PRSM_STORAGE_MAX_NAME_LEN 64
+
+// element data types
+enum PrismaStorageDtype {
+    PRSM_STORAGE_DTYPE_FLOAT32,     // float
+    PRSM_STORAGE_DTYPE_FLOAT64,     // double
+    PRSM_STORAGE_DTYPE_FLOAT80,     // long double
+    PRSM_STORAGE_DTYPE_COUNT        // number of elements
+};
+
+// a tensor stored in the container
+struct PrismaStorageItem {
+    const char *name;                       // points into the mapping
+    enum PrismaStorageDtype dtype;          // element type
+    size_t ndim;                            // number of dimensions
+    size_t shape[PRSM_STORAGE_MAX_DIMS];    // tensor shape
+    const void *data;                       // points into the mapping
+};
+
+typedef struct PrismaStorage {
+    prsm_mmap_t map;                    // mapped file
+    size_t len;                         // number of tensors
+    struct PrismaStorageItem *items;    // parsed entry table
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_storage_t;
+
+/**
+ * @brief  Saves tensors into a binary container
+ * @param  filename file to write
+ * @param  count number of tensors
+ * @param  names tensor names (unique, shorter than PRSM_STORAGE_MAX_NAME_LEN)
+ * @param  tensors tensors to save
+ * @returns PRSM_STATUS_OPERATION_SUCCESS upon success, PRSM_STATUS_ERROR_IO otherwise
+ */
+extern enum PrismaStatus prsm_storage_save(const char *const filename, const size_t count, const char *const names[], const prsm_tensor_t *const tensors[]);
+
+/**
+ * @brief  Maps a binary container into memory; no tensor data is read or copied
+ * @param  alloctr allocator instance
+ * @param  filename file to open
+ * @returns valid `prsm_storage_t*` upon success, `NULL` if file cannot be mapped or is invalid
+ */
+extern prsm_storage_t *prsm_storage_open(struct VitaBaseAllocatorType *const alloctr, const char *const filename);
+
+/**
+ * @brief  Unmaps the container; all views become invalid
+ * @param  st storage
+ * @returns None
+ */
+extern void prsm_storage_close(prsm_storage_t *st);
+
+/**
+ * @brief  Returns number of stored tensors
+ * @param  st storage
+ * @returns size_t
+ */
+extern size_t prsm_storage_len(const prsm_storage_t *const st);
+
+/**
+ * @brief  Returns tensor name
+ * @param  st storage
+ * @param  at tensor index
+ * @returns C string
+ */
+extern const char *prsm_storage_name(const prsm_storage_t *const st, const size_t at);
+
+/**
+ * @brief  Returns tensor element type
+ * @param  st storage
+ * @param  at tensor index
+ * @returns enum PrismaStorageDtype
+ */
+extern enum PrismaStorageDtype prsm_storage_dtype(const prsm_storage_t *const st, const size_t at);
+
+/**
+ * @brief  Makes a read-only view into the mapping by tensor name
+ * @param  st storage
+ * @param  name tensor name
+ * @returns prsm_tensor_t
+ *
+ * @note it's a value type, no need to free it
+ * @note the view is null (see `prsm_tensor_is_null`) if not found or the dtype differs from `prsm_float`
+ * @note writing to the view crashes, since the pages are mapped read-only
+ */
+extern prsm_tensor_t prsm_storage_get(const prsm_storage_t *const st, const char *const name);
+
+/**
+ * @brief  Makes a read-only view into the mapping by tensor index
+ * @param  st storage
+ * @param  at tensor index
+ * @returns prsm_tensor_t
+ *
+ * @note it's a value type, no need to free it
+ * @note the view is null (see `prsm_tensor_is_null`) if the dtype differs from `prsm_float`
+ * @note writing to the view crashes, since the pages are mapped read-only
+ */
+extern prsm_tensor_t prsm_storage_get_at(const prsm_storage_t *const st, const size_t at);
+
+#endif // PRISMA_CORE_STORAGE_H
+
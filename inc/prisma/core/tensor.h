@@ -45,10 +45,16 @@
     - prsm_tensor_set_from_array
     - prsm_tensor_sum
     - prsm_tensor_dot
+    - prsm_tensor_gemm
+    - prsm_tensor_gemm_ex
     - prsm_tensor_vdot
     - prsm_tensor_add
     - prsm_tensor_sub
     - prsm_tensor_mul
+    - prsm_tensor_gather
+    - prsm_tensor_gather_add
+    - prsm_tensor_scatter
+    - prsm_tensor_scatter_add
     - prsm_tensor_apply_scale_add
     - prsm_tensor_apply_ceil
     - prsm_tensor_apply_floor
@@ -71,6 +77,7 @@
     - prsm_tensor_rand
     - prsm_tensor_rand_uniform
     - prsm_tensor_rand_normal
+    - prsm_tensor_rand_permutation
     - prsm_tensor_display
 */
 
@@ -91,6 +98,14 @@ typedef struct PrismaTensor {
     struct VitaBaseAllocatorType *alloctr;
 } prsm_tensor_t;
 
+// gemm epilogue: out = func(scale * (alpha * op(lhs) * op(rhs) + beta * out) + bias + residual)
+struct PrismaTensorEpilogue {
+    const prsm_tensor_t *scale;     // per-column multiplier (n elements); `NULL` to skip
+    const prsm_tensor_t *bias;      // added to every row (n elements); `NULL` to skip
+    const prsm_tensor_t *residual;  // added element-wise (m x n elements), e.g. a skip connection; `NULL` to skip
+    prsm_float (*func)(prsm_float); // applied to every element, e.g. `prsm_activate_get_func()`; `NULL` to skip
+};
+
 /* 
     Tensor creation/destruction
 */
@@ -466,6 +481,41 @@ extern prsm_tensor_t *prsm_tensor_sub(prsm_tensor_t *out, const prsm_tensor_t *c
  */
 extern prsm_tensor_t *prsm_tensor_dot(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
 
+/**
+ * @brief  General matrix multiplication: out = alpha * op(lhs) * op(rhs) + beta * out
+ * @param  out output matrix
+ * @param  lhs matrix
+ * @param  rhs matrix
+ * @param  trans_lhs use lhs transposed
+ * @param  trans_rhs use rhs transposed
+ * @param  alpha product scale
+ * @param  beta output scale; if 0, `out` is overwritten (its values are not read)
+ * @returns prsm_tensor_t*
+ * 
+ * @note if `out==NULL`, tensor is allocated
+ * @note transposition is done by indexing, no data is moved
+ * @note rows of `out` are computed in parallel
+ */
+extern prsm_tensor_t *prsm_tensor_gemm(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const bool trans_lhs, const bool trans_rhs, const prsm_float alpha, const prsm_float beta);
+
+/**
+ * @brief  General matrix multiplication with a fused epilogue: out = func(scale * (alpha * op(lhs) * op(rhs) + beta * out) + bias + residual)
+ * @param  out output matrix
+ * @param  lhs matrix
+ * @param  rhs matrix
+ * @param  trans_lhs use lhs transposed
+ * @param  trans_rhs use rhs transposed
+ * @param  alpha product scale
+ * @param  beta output scale; if 0, `out` is overwritten (its values are not read)
+ * @param  ep epilogue; if `NULL`, same as `prsm_tensor_gemm`
+ * @returns prsm_tensor_t*
+ * 
+ * @note if `out==NULL`, tensor is allocated
+ * @note the epilogue runs on register tiles before they are stored, so every output element is written once
+ * @note `residual` may be `out` itself
+ */
+extern prsm_tensor_t *prsm_tensor_gemm_ex(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const bool trans_lhs, const bool trans_rhs, const prsm_float alpha, const prsm_float beta, const struct PrismaTensorEpilogue *const ep);
+
 /**
  * @brief  Vector dot product
  * @param  lhs tensor
@@ -485,6 +535,62 @@ extern prsm_float prsm_tensor_vdot(const prsm_tensor_t *const lhs, const prsm_te
  */
 extern prsm_tensor_t *prsm_tensor_mul(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
 
+/* 
+    Tensor indexing operations
+*/
+
+/**
+ * @brief  Selects slices along an axis: out[..., k, ...] = in[..., idx[k], ...]
+ * @param  out output tensor of the same shape as `in`, except `out->shape[axis] == idx_size`
+ * @param  in tensor
+ * @param  idx indices into `in->shape[axis]`
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @returns prsm_tensor_t*
+ * 
+ * @note if `out==NULL`, tensor is allocated
+ * @note e.g. assembling a minibatch: gather rows (axis 0) of a dataset by sample index
+ */
+extern prsm_tensor_t *prsm_tensor_gather(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis);
+
+/**
+ * @brief  Same as `prsm_tensor_gather`, but accumulates: out[..., k, ...] += in[..., idx[k], ...]
+ * @param  out output tensor of the same shape as `in`, except `out->shape[axis] == idx_size`
+ * @param  in tensor
+ * @param  idx indices into `in->shape[axis]`
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @returns prsm_tensor_t*
+ */
+extern prsm_tensor_t *prsm_tensor_gather_add(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis);
+
+/**
+ * @brief  Writes slices along an axis: out[..., idx[k], ...] = in[..., k, ...]
+ * @param  out output tensor of the same shape as `in`, except along `axis`
+ * @param  in tensor with `in->shape[axis] == idx_size`
+ * @param  idx indices into `out->shape[axis]`
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @returns prsm_tensor_t*
+ * 
+ * @note slices of `out` that are not indexed are left unchanged
+ * @note if an index repeats, the last slice wins
+ */
+extern prsm_tensor_t *prsm_tensor_scatter(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis);
+
+/**
+ * @brief  Same as `prsm_tensor_scatter`, but accumulates: out[..., idx[k], ...] += in[..., k, ...]
+ * @param  out output tensor of the same shape as `in`, except along `axis`
+ * @param  in tensor with `in->shape[axis] == idx_size`
+ * @param  idx indices into `out->shape[axis]`
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @returns prsm_tensor_t*
+ * 
+ * @note repeated indices accumulate in order, so the result is deterministic (e.g. gradient of `prsm_tensor_gather`)
+ */
+extern prsm_tensor_t *prsm_tensor_scatter_add(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis);
+
 /* 
     Tensor element-wise operations
 */
@@ -664,6 +770,17 @@ extern void prsm_tensor_rand_uniform(prsm_tensor_t *const t, const prsm_float lb
  */
 extern void prsm_tensor_rand_normal(prsm_tensor_t *const t, const prsm_float mu, const prsm_float std);
 
+/**
+ * @brief  Shuffles indices in place (Fisher-Yates)
+ * @param  idx indices, e.g. 0, 1, ..., size-1
+ * @param  size number of indices
+ * @param  state xorshift random state; if `NULL`, the global generator is used
+ * @returns None
+ * 
+ * @note pass a non-zero `state` owned by the caller to get reproducible or thread-safe shuffling
+ */
+extern void prsm_tensor_rand_permutation(size_t idx[], const size_t size, uint64_t *const state);
+
 /* 
     Pretty printing
 */
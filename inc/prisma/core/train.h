@@ -0,0 +1,221 @@
+#ifndef PRISMA_CORE_TRAIN_H
+#define PRISMA_CORE_TRAIN_H
+
+/** TRAIN MODULE
+ * This module implements data-parallel training steps on an autograd model.
+ *
+ * A minibatch is split by rows into a fixed number of shards. Every shard owns an autograd tape, so its
+ * activations and gradients are private, while all shards read the same parameter tensors. Shards are
+ * processed in parallel, one or more per thread; kernels called by the model inside a shard run on that
+ * thread (nested parallel regions are serial), so threads never compete for cores.
+ *
+ * Per-shard gradients are then combined by an all-reduce: the concatenated gradients are split into
+ * cache-sized tiles and every thread reduces its own tiles across all shards with a binary tree, reading
+ * each shard buffer once while the partial sums stay in cache. The tree and the shard boundaries depend
+ * only on the batch size and the number of shards, never on the number of threads, so a step gives
+ * bit-identical results whether it runs on one thread or on many.
+ *
+ * For sparse or convex models, `prsm_train_hogwild()` trains without synchronization instead: every shard
+ * is a worker that walks its own part of the data, computes gradients reading the shared parameters in place
+ * (nothing is copied per minibatch) and writes plain SGD updates straight into them with relaxed atomic
+ * loads and stores, so a float is never torn.
+ * Updates from different workers may overwrite each other; zero gradients are not written, so workers
+ * touching disjoint coordinates do not interfere. Only the writes are sparse: gradients are computed densely
+ * and every update scans all parameters, so its cost grows with the number of parameters, not with the
+ * non-zeros of its rows. Staleness, the number of updates made by other workers between reading the
+ * parameters and writing an update, is reported per epoch.
+ *
+ * `prsm_train_step_accumulate()` bounds activation memory: a minibatch is processed in micro-batches of a
+ * fixed number of rows, one after another, and the all-reduced gradient of every micro-batch, weighted by
+ * its share of the rows, is added in place to a persistent gradient buffer. Shard tapes replay with buffers
+ * sized to the micro-batch, so peak memory depends on the micro-batch size instead of the minibatch size,
+ * while the accumulated gradients are those of the minibatch loss.
+ *
+ * Models may checkpoint layer segments on their shard tapes (see the autograd module);
+ * `prsm_train_checkpoint_stats()` reports the activation memory saved against the extra compute.
+ *
+ * `prsm_train_step_distributed()` extends a step across processes: every process runs a trainer on its
+ * own rows, and the gradients are all-reduced through a communicator before the optimizer step, so all
+ * processes keep bit-identical parameters.
+
+ * Functions:
+    - prsm_train_create
+    - prsm_train_destroy
+    - prsm_train_step
+    - prsm_train_step_accumulate
+    - prsm_train_grad
+    - prsm_train_checkpoint_stats
+    - prsm_train_hogwild
+    - prsm_train_step_distributed
+*/
+
+#include "prisma/core/core.h"
+#include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+#include "prisma/core/autograd.h"
+#include "prisma/core/optim.h"
+#include "prisma/core/comm.h"
+
+// maximum number of dimensions of the minibatch tensors
+#define PRSM_TRAIN_MAX_DIMS 8
+
+/**
+ * @brief  Records the model on a shard tape
+ * @param  tape shard tape; parameters are already recorded as leaves 0..count-1
+ * @param  x shard inputs
+ * @param  y shard targets or `NULL`
+ * @param  ctx user context
+ * @returns id of the loss node
+ *
+ * @note the loss must be a mean over the rows of the shard, e.g. `prsm_autograd_softmax_cce()`
+ * @note the function is called from several threads at once and must not modify shared state
+ */
+typedef size_t (*prsm_train_model_fn)(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const y, void *const ctx);
+
+// minibatch shard
+struct PrismaTrainShard {
+    prsm_autograd_t *tape;              // activations and gradients of the shard
+    prsm_tensor_t x;                    // view into the minibatch inputs
+    prsm_tensor_t y;                    // view into the minibatch targets
+    size_t x_shape[PRSM_TRAIN_MAX_DIMS];
+    size_t y_shape[PRSM_TRAIN_MAX_DIMS];
+    prsm_float weight;                  // rows of the shard / rows of the minibatch
+    size_t loss;                        // loss node of the last step
+};
+
+typedef struct PrismaTrain {
+    size_t count;                       // number of parameter tensors
+    prsm_tensor_t **params;             // parameters: borrowed
+    prsm_tensor_t **grads;              // all-reduced gradients: borrowed from the first shard tape
+    size_t *offsets;                    // (count + 1) prefix sums of the parameter sizes
+    size_t num_shards;                  // number of shards
+    size_t active;                      // number of shards used by the last step: min(rows, num_shards)
+    struct PrismaTrainShard *shards;
+    prsm_train_model_fn model;
+    void *ctx;                          // user context passed to `model`
+    size_t version;                     // hogwild: number of updates applied to the parameters
+    prsm_tensor_t **accum;              // micro-batching: accumulated gradients; allocated on first use
+
+    // allocator: if `NULL`, then calloc/realloc/free is used
+    struct VitaBaseAllocatorType *alloctr;
+} prsm_train_t;
+
+// hogwild epoch statistics
+typedef struct PrismaTrainHogwildStats {
+    size_t updates;                     // number of updates applied to the shared parameters
+    size_t max_staleness;               // largest number of updates by other workers during one update
+    prsm_float mean_staleness;          // average number of updates by other workers during one update
+    prsm_float loss;                    // mean minibatch loss weighted by rows
+} prsm_train_hogwild_stats_t;
+
+/**
+ * @brief  Creates a data-parallel trainer
+ * @param  alloctr allocator instance
+ * @param  params parameter tensors; borrowed, must outlive the trainer
+ * @param  count number of parameter tensors
+ * @param  num_shards number of minibatch shards; 0 uses `prsm_parallel_get_num_threads()`
+ * @param  model records the model on a shard tape
+ * @param  ctx user context passed to `model`
+ * @returns valid `prsm_train_t*`
+ *
+ * @note results depend on `num_shards`, but not on the number of threads
+ * @note shard tapes allocate from worker threads, so `alloctr` must be thread-safe or `NULL`
+ */
+extern prsm_train_t *prsm_train_create(
+    struct VitaBaseAllocatorType *const alloctr, prsm_tensor_t *const params[], const size_t count,
+    const size_t num_shards, prsm_train_model_fn model, void *const ctx
+);
+
+/**
+ * @brief  Frees the trainer with its shard tapes
+ * @param  train trainer
+ * @returns None
+ */
+extern void prsm_train_destroy(prsm_train_t *train);
+
+/**
+ * @brief  Runs forward and backward on all shards, all-reduces the gradients and updates the parameters
+ * @param  train trainer
+ * @param  x minibatch inputs (N, ...)
+ * @param  y minibatch targets (N, ...) or `NULL`
+ * @param  optim optimizer or `NULL` to only compute the gradients
+ * @returns minibatch loss: the mean of the shard losses weighted by their number of rows
+ *
+ * @note gradients are those of the minibatch loss, i.e., shard gradients weighted by their number of rows
+ * @note if N is smaller than the number of shards, only N shards are used
+ */
+extern prsm_float prsm_train_step(prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y, prsm_optim_t *const optim);
+
+/**
+ * @brief  Runs a step on a minibatch in micro-batches, accumulating their gradients in place, and updates the parameters
+ * @param  train trainer
+ * @param  x minibatch inputs (N, ...)
+ * @param  y minibatch targets (N, ...) or `NULL`
+ * @param  micro_batch rows per micro-batch; the last one may be smaller
+ * @param  optim optimizer or `NULL` to only compute the gradients
+ * @returns minibatch loss: the mean of the micro-batch losses weighted by their number of rows
+ *
+ * @note gradients equal those of `prsm_train_step()` on the whole minibatch up to rounding
+ * @note activation memory is that of a `prsm_train_step()` on `micro_batch` rows
+ */
+extern prsm_float prsm_train_step_accumulate(
+    prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y,
+    const size_t micro_batch, prsm_optim_t *const optim
+);
+
+/**
+ * @brief  Returns the all-reduced gradient of a parameter computed by the last step
+ * @param  train trainer
+ * @param  i parameter index
+ * @returns prsm_tensor_t*
+ *
+ * @note the tensor is owned by the first shard tape and is overwritten by the next step
+ */
+extern prsm_tensor_t *prsm_train_grad(const prsm_train_t *const train, const size_t i);
+
+/**
+ * @brief  Reports activation checkpointing statistics of the last step summed over the shards
+ * @param  train trainer
+ * @returns prsm_autograd_checkpoint_stats_t
+ *
+ * @note after `prsm_train_step_accumulate()`, statistics are those of the last micro-batch
+ */
+extern prsm_autograd_checkpoint_stats_t prsm_train_checkpoint_stats(const prsm_train_t *const train);
+
+/**
+ * @brief  Runs one lock-free asynchronous SGD epoch: every shard is a worker updating the shared parameters
+ * @param  train trainer
+ * @param  x inputs (N, ...); split by rows across the workers
+ * @param  y targets (N, ...) or `NULL`
+ * @param  batch_size rows per update
+ * @param  params SGD hyperparameters: `lr`, `weight_decay` and `clip`; momentum is not supported
+ * @returns prsm_train_hogwild_stats_t
+ *
+ * @note results depend on thread scheduling and are not reproducible
+ * @note the model reads the shared parameters with plain loads while other workers update them, which race
+ * detectors report as races; this is the hogwild trade-off, not a bug
+ * @note the model must not read the parameters through anything but the leaves 0..count-1
+ */
+extern prsm_train_hogwild_stats_t prsm_train_hogwild(
+    prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y,
+    const size_t batch_size, const prsm_optim_params_t *const params
+);
+
+/**
+ * @brief  Runs a data-parallel step across processes: local step, gradient all-reduce and update
+ * @param  train trainer of this process
+ * @param  comm communicator connecting all processes
+ * @param  x local inputs (N_local, ...); at least one row
+ * @param  y local targets (N_local, ...) or `NULL`
+ * @param  optim optimizer or `NULL` to only compute the gradients
+ * @returns loss of the global minibatch: the mean of the local losses weighted by their number of rows
+ *
+ * @note all processes must call it together with the same model, parameters and optimizer settings
+ * @note gradients are those of the global minibatch loss and are bit-identical in all processes
+ */
+extern prsm_float prsm_train_step_distributed(
+    prsm_train_t *const train, prsm_comm_t *const comm, const prsm_tensor_t *const x,
+    const prsm_tensor_t *const y, prsm_optim_t *const optim
+);
+
+#endif // PRISMA_CORE_TRAIN_H
@@ -5,9 +5,22 @@
 #include "prisma/core/version.h"
 #include "prisma/core/math.h"
 #include "prisma/core/tensor.h"
+#include "prisma/core/sparse.h"
+#include "prisma/core/parallel.h"
+#include "prisma/core/comm.h"
+#include "prisma/core/mmap.h"
+#include "prisma/core/storage.h"
+#include "prisma/core/dataset.h"
+#include "prisma/core/dataloader.h"
 #include "prisma/core/activation.h"
 #include "prisma/core/loss.h"
+#include "prisma/core/conv.h"
+#include "prisma/core/pool.h"
 #include "prisma/core/layers.h"
+#include "prisma/core/autograd.h"
+#include "prisma/core/optim.h"
+#include "prisma/core/train.h"
+#include "prisma/core/pipeline.h"
 
 #endif // PRISMA_H
 
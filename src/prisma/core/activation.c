@@ -1,5 +1,10 @@
 #include "prisma/core/activation.h"
 
+static prsm_float prsm_activate_sigmoid_dy(prsm_float y);
+static prsm_float prsm_activate_tanh_dy(prsm_float y);
+static prsm_float prsm_activate_relu_dy(prsm_float y);
+static prsm_float prsm_activate_lrelu_dy(prsm_float y);
+
 prsm_tensor_t *prsm_activate_sigmoid(prsm_tensor_t *out, const prsm_tensor_t *const in) {
     // check for invalid input
     VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
@@ -618,3 +623,46 @@ prsm_tensor_t *prsm_activate_lsoftmax_d(prsm_tensor_t *out, const prsm_tensor_t
     return ret;
 }
 
+prsm_activate_fn prsm_activate_get_func(const enum PrismaActivation act) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(act < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    switch (act) {
+        case PRSM_ACTIVATION_SIGMOID: return prsm_math_sigmoid;
+        case PRSM_ACTIVATION_TANH: return prsm_math_tanh;
+        case PRSM_ACTIVATION_RELU: return prsm_math_relu;
+        case PRSM_ACTIVATION_LRELU: return prsm_math_lrelu;
+        default: return prsm_math_linear;
+    }
+}
+
+prsm_activate_fn prsm_activate_get_func_d(const enum PrismaActivation act) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(act < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    switch (act) {
+        case PRSM_ACTIVATION_SIGMOID: return prsm_activate_sigmoid_dy;
+        case PRSM_ACTIVATION_TANH: return prsm_activate_tanh_dy;
+        case PRSM_ACTIVATION_RELU: return prsm_activate_relu_dy;
+        case PRSM_ACTIVATION_LRELU: return prsm_activate_lrelu_dy;
+        default: return prsm_math_linear_d;
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+static prsm_float prsm_activate_sigmoid_dy(prsm_float y) {
+    return y * (1 - y);
+}
+
+static prsm_float prsm_activate_tanh_dy(prsm_float y) {
+    return 1 - y * y;
+}
+
+static prsm_float prsm_activate_relu_dy(prsm_float y) {
+    return y > 0 ? 1 : 0;
+}
+
+static prsm_float prsm_activate_lrelu_dy(prsm_float y) {
+    return y >= 0 ? 1 : 0.01;
+}
@@ -0,0 +1,1156 @@
+#include "prisma/core/autograd.h"
+
+static size_t prsm_autograd_record(prsm_autograd_t *const tape, const enum PrismaAutogradOp op, const size_t lhs, const size_t rhs);
+static size_t prsm_autograd_record_ex(prsm_autograd_t *const tape, const enum PrismaAutogradOp op, const size_t lhs, const size_t rhs, const size_t bias, const enum PrismaActivation activation);
+static void prsm_autograd_truncate(prsm_autograd_t *const tape, const size_t len);
+static prsm_tensor_t *prsm_autograd_scalar(prsm_autograd_t *const tape, prsm_tensor_t *const out);
+static prsm_tensor_t *prsm_autograd_grad_buffer(prsm_autograd_t *const tape, struct PrismaAutogradNode *const node);
+static void prsm_autograd_softmax_rows(prsm_tensor_t *const out, const prsm_tensor_t *const in);
+static void prsm_autograd_forward(prsm_autograd_t *const tape, const size_t id);
+static void prsm_autograd_forward_node(prsm_autograd_t *const tape, const size_t id);
+static size_t prsm_autograd_flops(const prsm_autograd_t *const tape, const size_t id);
+static void prsm_autograd_release(prsm_autograd_t *const tape, const size_t from, const size_t to);
+static void prsm_autograd_recompute(prsm_autograd_t *const tape, const struct PrismaAutogradSegment *const segment);
+static const size_t *prsm_autograd_shape(const struct PrismaAutogradNode *const node, size_t *const ndim);
+static void prsm_autograd_stash_node(prsm_autograd_t *const tape, const size_t id);
+static void prsm_autograd_stash_decode(const struct PrismaAutogradStash *const stash, const size_t from, const size_t len, prsm_float *const out);
+static const prsm_float *prsm_autograd_stash_tile(const struct PrismaAutogradNode *const node, const size_t from, const size_t len, prsm_float *const tile);
+static const prsm_tensor_t *prsm_autograd_operand(prsm_autograd_t *const tape, const struct PrismaAutogradNode *const node, const size_t slot);
+static uint16_t prsm_autograd_half_from_float(const float value);
+static float prsm_autograd_half_to_float(const uint16_t half);
+static void prsm_autograd_backward_node(prsm_autograd_t *const tape, const size_t id);
+
+prsm_autograd_t *prsm_autograd_create(struct VitaBaseAllocatorType *const alloctr) {
+    prsm_autograd_t *tape = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_autograd_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_autograd_t));
+    tape->alloctr = alloctr;
+
+    return tape;
+}
+
+void prsm_autograd_destroy(prsm_autograd_t *tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free node buffers
+    prsm_autograd_truncate(tape, 0);
+
+    // free tape
+    struct VitaBaseAllocatorType *const alloctr = tape->alloctr;
+    if (tape->nodes != NULL) {
+        (alloctr) ? VT_ALLOCATOR_FREE(alloctr, tape->nodes) : VT_FREE(tape->nodes);
+    }
+    if (tape->segments != NULL) {
+        (alloctr) ? VT_ALLOCATOR_FREE(alloctr, tape->segments) : VT_FREE(tape->segments);
+    }
+    VT_FOREACH(i, 0, 3) {
+        if (tape->scratch[i] != NULL) prsm_tensor_destroy(tape->scratch[i]);
+    }
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, tape) : VT_FREE(tape);
+    tape = NULL;
+}
+
+void prsm_autograd_reset(prsm_autograd_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // readers recorded by the pass that ends here decide when the next pass stashes values
+    VT_FOREACH(i, 0, tape->len) {
+        tape->nodes[i].last_use = (i < tape->cursor) ? tape->nodes[i].last_use_next : 0;
+    }
+    tape->cursor = 0;
+    tape->diverged = false;
+
+    // segments and statistics belong to a pass
+    tape->num_segments = 0;
+    tape->checkpointing = false;
+    tape->stats = (prsm_autograd_checkpoint_stats_t) {0};
+}
+
+size_t prsm_autograd_leaf(prsm_autograd_t *const tape, prsm_tensor_t *const t, const bool requires_grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(t), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // leaves are not owned, so only the reference is updated upon replay
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_LEAF, 0, 0);
+    tape->nodes[id].value = t;
+    tape->nodes[id].requires_grad = requires_grad;
+
+    return id;
+}
+
+size_t prsm_autograd_matmul(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_MATMUL, lhs, rhs);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_add(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_ADD, lhs, rhs);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_sub(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_SUB, lhs, rhs);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_mul(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_MUL, lhs, rhs);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_add_rows(prsm_autograd_t *const tape, const size_t lhs, const size_t rhs) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_ADD_ROWS, lhs, rhs);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_dense(prsm_autograd_t *const tape, const size_t in, const size_t w, const size_t b, const enum PrismaActivation activation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(activation < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const size_t id = prsm_autograd_record_ex(tape, PRSM_AUTOGRAD_OP_DENSE, in, w, b, activation);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_sigmoid(prsm_autograd_t *const tape, const size_t in) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_SIGMOID, in, in);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_tanh(prsm_autograd_t *const tape, const size_t in) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_TANH, in, in);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_relu(prsm_autograd_t *const tape, const size_t in) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_RELU, in, in);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_softmax(prsm_autograd_t *const tape, const size_t in) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_SOFTMAX, in, in);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_mse(prsm_autograd_t *const tape, const size_t input, const size_t target) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_MSE, input, target);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+size_t prsm_autograd_softmax_cce(prsm_autograd_t *const tape, const size_t logits, const size_t target) {
+    const size_t id = prsm_autograd_record(tape, PRSM_AUTOGRAD_OP_SOFTMAX_CCE, logits, target);
+    prsm_autograd_forward(tape, id);
+
+    return id;
+}
+
+void prsm_autograd_checkpoint_begin(prsm_autograd_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(!tape->checkpointing, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    tape->checkpointing = true;
+    tape->checkpoint_from = tape->cursor;
+}
+
+void prsm_autograd_checkpoint_end(prsm_autograd_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(tape->checkpointing, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    tape->checkpointing = false;
+
+    // the segment needs an output and at least one node to discard
+    if (tape->cursor < tape->checkpoint_from + 2) {
+        return;
+    }
+
+    // grow
+    if (tape->num_segments == tape->segments_capacity) {
+        const size_t capacity = (tape->segments_capacity == 0) ? 8 : 2 * tape->segments_capacity;
+        tape->segments = (tape->alloctr == NULL)
+            ? VT_REALLOC(tape->segments, capacity * sizeof(*tape->segments))
+            : VT_ALLOCATOR_REALLOC(tape->alloctr, tape->segments, capacity * sizeof(*tape->segments));
+        tape->segments_capacity = capacity;
+    }
+
+    // record: the last node is the output, it is kept
+    const struct PrismaAutogradSegment segment = {
+        .first = tape->checkpoint_from,
+        .last = tape->cursor - 1
+    };
+    tape->segments[tape->num_segments++] = segment;
+
+    // discard activations inside the segment
+    VT_FOREACH(i, segment.first, segment.last) {
+        struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (node->op == PRSM_AUTOGRAD_OP_LEAF) continue;
+        node->checkpointed = true;
+        tape->stats.saved_bytes += prsm_tensor_size(node->value) * sizeof(prsm_float);
+        if (node->aux != NULL) tape->stats.saved_bytes += prsm_tensor_size(node->aux) * sizeof(prsm_float);
+    }
+    prsm_autograd_release(tape, segment.first, segment.last);
+}
+
+prsm_autograd_checkpoint_stats_t prsm_autograd_checkpoint_stats(const prsm_autograd_t *const tape) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // activations currently held by the tape
+    prsm_autograd_checkpoint_stats_t stats = tape->stats;
+    VT_FOREACH(i, 0, tape->cursor) {
+        const struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (node->op == PRSM_AUTOGRAD_OP_LEAF) continue;
+        if (node->value != NULL) stats.stored_bytes += prsm_tensor_size(node->value) * sizeof(prsm_float);
+        if (node->aux != NULL) stats.stored_bytes += prsm_tensor_size(node->aux) * sizeof(prsm_float);
+        if (node->stashed) stats.stored_bytes += node->stash.bytes;
+    }
+
+    return stats;
+}
+
+void prsm_autograd_set_stash(prsm_autograd_t *const tape, const enum PrismaAutogradStashFormat format) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        format == PRSM_AUTOGRAD_STASH_FLOAT || format == PRSM_AUTOGRAD_STASH_FP16 || format == PRSM_AUTOGRAD_STASH_INT8,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+
+    tape->stash = format;
+}
+
+prsm_tensor_t *prsm_autograd_value(const prsm_autograd_t *const tape, const size_t node) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(node < tape->cursor, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return tape->nodes[node].value;
+}
+
+prsm_tensor_t *prsm_autograd_grad(const prsm_autograd_t *const tape, const size_t node) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(node < tape->cursor, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return tape->nodes[node].requires_grad ? tape->nodes[node].grad : NULL;
+}
+
+void prsm_autograd_backward(prsm_autograd_t *const tape, const size_t root) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(root < tape->cursor, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // nothing depends on a parameter
+    if (!tape->nodes[root].requires_grad) {
+        return;
+    }
+
+    VT_ENFORCE(!tape->nodes[root].checkpointed, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // reset gradients; buffers are allocated only once, except inside checkpointed segments
+    VT_FOREACH(i, 0, root + 1) {
+        struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (node->requires_grad && !node->checkpointed) {
+            prsm_tensor_set_zeros(prsm_autograd_grad_buffer(tape, node));
+        }
+    }
+    prsm_tensor_set_ones(tape->nodes[root].grad);
+
+    // segments that end after the root are not visited
+    size_t segment = tape->num_segments;
+    while (segment > 0 && tape->segments[segment - 1].last > root) {
+        segment--;
+    }
+
+    // propagate in reverse order of recording
+    for (size_t i = root + 1; i-- > 0;) {
+        // reaching the output of a segment: recompute its activations
+        const struct PrismaAutogradSegment *const seg = (segment > 0) ? &tape->segments[segment - 1] : NULL;
+        if (seg != NULL && i == seg->last && tape->nodes[i].requires_grad) {
+            prsm_autograd_recompute(tape, seg);
+        }
+
+        if (tape->nodes[i].requires_grad && tape->nodes[i].op != PRSM_AUTOGRAD_OP_LEAF) {
+            prsm_autograd_backward_node(tape, i);
+        }
+
+        // leaving the segment: discard its activations and gradients again
+        if (seg != NULL && i == seg->first) {
+            prsm_autograd_release(tape, seg->first, seg->last);
+            segment--;
+        }
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Appends a node at the cursor or reuses the recorded one if it matches
+ * @param  tape tape instance
+ * @param  op operation
+ * @param  lhs first input node
+ * @param  rhs second input node
+ * @returns node id
+ */
+static size_t prsm_autograd_record(prsm_autograd_t *const tape, const enum PrismaAutogradOp op, const size_t lhs, const size_t rhs) {
+    return prsm_autograd_record_ex(tape, op, lhs, rhs, lhs, PRSM_ACTIVATION_LINEAR);
+}
+
+/**
+ * @brief  Appends a node with a third input and an activation at the cursor or reuses the recorded one if it matches
+ * @param  tape tape instance
+ * @param  op operation
+ * @param  lhs first input node
+ * @param  rhs second input node
+ * @param  bias third input node
+ * @param  activation fused activation
+ * @returns node id
+ */
+static size_t prsm_autograd_record_ex(prsm_autograd_t *const tape, const enum PrismaAutogradOp op, const size_t lhs, const size_t rhs, const size_t bias, const enum PrismaActivation activation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(tape != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(op < PRSM_AUTOGRAD_OP_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (op != PRSM_AUTOGRAD_OP_LEAF) {
+        VT_ENFORCE(lhs < tape->cursor && rhs < tape->cursor && bias < tape->cursor, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+        // activations inside a closed checkpointed segment are not available
+        VT_ENFORCE(
+            !tape->nodes[lhs].checkpointed && !tape->nodes[rhs].checkpointed && !tape->nodes[bias].checkpointed,
+            "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+        );
+    }
+
+    const size_t id = tape->cursor;
+    if (id < tape->len) {
+        // replay: keep buffers of the recorded node
+        const struct PrismaAutogradNode *const node = &tape->nodes[id];
+        if (node->op != op || node->lhs != lhs || node->rhs != rhs || node->bias != bias || node->activation != activation) {
+            prsm_autograd_truncate(tape, id);
+        }
+    }
+
+    if (id == tape->len) {
+        // grow
+        if (tape->len == tape->capacity) {
+            const size_t capacity = (tape->capacity == 0) ? 16 : 2 * tape->capacity;
+            tape->nodes = (tape->alloctr == NULL)
+                ? VT_REALLOC(tape->nodes, capacity * sizeof(*tape->nodes))
+                : VT_ALLOCATOR_REALLOC(tape->alloctr, tape->nodes, capacity * sizeof(*tape->nodes));
+            tape->capacity = capacity;
+        }
+
+        // record: readers of earlier values in this pass are unknown to the previous pass
+        tape->diverged = true;
+        tape->nodes[id] = (struct PrismaAutogradNode) {
+            .op = op,
+            .lhs = lhs,
+            .rhs = rhs,
+            .bias = bias,
+            .activation = activation,
+        };
+        tape->len++;
+    }
+
+    // what backward reads from the node itself
+    struct PrismaAutogradNode *const node = &tape->nodes[id];
+    node->checkpointed = false;
+    node->stashed = false;
+    node->last_use_next = 0;
+    node->needs_value = (op == PRSM_AUTOGRAD_OP_SIGMOID || op == PRSM_AUTOGRAD_OP_TANH || op == PRSM_AUTOGRAD_OP_SOFTMAX)
+        || (op == PRSM_AUTOGRAD_OP_DENSE && activation != PRSM_ACTIVATION_LINEAR && activation != PRSM_ACTIVATION_RELU);
+    node->needs_mask = (op == PRSM_AUTOGRAD_OP_RELU) || (op == PRSM_AUTOGRAD_OP_DENSE && activation == PRSM_ACTIVATION_RELU);
+
+    if (op != PRSM_AUTOGRAD_OP_LEAF) {
+        struct PrismaAutogradNode *const a = &tape->nodes[lhs];
+        struct PrismaAutogradNode *const b = &tape->nodes[rhs];
+        struct PrismaAutogradNode *const c = &tape->nodes[bias];
+
+        // a value reduced to a mask or dropped cannot be read again
+        VT_ENFORCE(
+            !(a->stashed && a->stash.format >= PRSM_AUTOGRAD_STASH_MASK) && !(b->stashed && b->stash.format >= PRSM_AUTOGRAD_STASH_MASK),
+            "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+        );
+
+        // what backward reads from the inputs; checkpointed segments recompute from their inputs
+        if (op == PRSM_AUTOGRAD_OP_MATMUL || op == PRSM_AUTOGRAD_OP_DENSE || op == PRSM_AUTOGRAD_OP_MUL || op == PRSM_AUTOGRAD_OP_MSE) {
+            a->needs_value = b->needs_value = true;
+        } else if (op == PRSM_AUTOGRAD_OP_SOFTMAX_CCE) {
+            b->needs_value = true;
+        }
+        if (tape->checkpointing) {
+            a->needs_value = b->needs_value = c->needs_value = true;
+        }
+        a->last_use_next = b->last_use_next = c->last_use_next = id;
+
+        // gradient flows through the node if any of its inputs needs it
+        node->requires_grad = a->requires_grad || b->requires_grad || c->requires_grad;
+    }
+    tape->cursor++;
+
+    return id;
+}
+
+/**
+ * @brief  Frees nodes starting from `len`
+ * @param  tape tape instance
+ * @param  len number of nodes to keep
+ * @returns None
+ */
+static void prsm_autograd_truncate(prsm_autograd_t *const tape, const size_t len) {
+    VT_FOREACH(i, len, tape->len) {
+        struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (node->op != PRSM_AUTOGRAD_OP_LEAF && node->value != NULL) prsm_tensor_destroy(node->value);
+        if (node->grad != NULL) prsm_tensor_destroy(node->grad);
+        if (node->aux != NULL) prsm_tensor_destroy(node->aux);
+        if (node->stash.data != NULL) {
+            (tape->alloctr) ? VT_ALLOCATOR_FREE(tape->alloctr, node->stash.data) : VT_FREE(node->stash.data);
+        }
+    }
+    tape->len = len;
+}
+
+/**
+ * @brief  Returns a one-element tensor
+ * @param  tape tape instance
+ * @param  out output tensor or `NULL`
+ * @returns prsm_tensor_t*
+ */
+static prsm_tensor_t *prsm_autograd_scalar(prsm_autograd_t *const tape, prsm_tensor_t *const out) {
+    return (out == NULL)
+        ? prsm_tensor_create_ex(tape->alloctr, 1, (size_t[]){1})
+        : out;
+}
+
+/**
+ * @brief  Returns the gradient buffer of a node shaped as its value
+ * @param  tape tape instance
+ * @param  node node
+ * @returns prsm_tensor_t*
+ */
+static prsm_tensor_t *prsm_autograd_grad_buffer(prsm_autograd_t *const tape, struct PrismaAutogradNode *const node) {
+    size_t ndim = 0;
+    const size_t *const shape = prsm_autograd_shape(node, &ndim);
+    if (node->grad == NULL) {
+        node->grad = prsm_tensor_create_ex(tape->alloctr, ndim, shape);
+    } else if (!prsm_tensor_shapes_match_ex(node->grad, ndim, shape)) {
+        prsm_tensor_resize_ex(node->grad, ndim, shape);
+    }
+
+    return node->grad;
+}
+
+/**
+ * @brief  Computes a recorded node during the forward pass
+ * @param  tape tape instance
+ * @param  id node id
+ * @returns None
+ */
+static void prsm_autograd_forward(prsm_autograd_t *const tape, const size_t id) {
+    prsm_autograd_forward_node(tape, id);
+    tape->stats.forward_flops += prsm_autograd_flops(tape, id);
+
+    // stash inputs this node was the last to read in the previous pass
+    if (tape->stash == PRSM_AUTOGRAD_STASH_FLOAT || tape->diverged || tape->checkpointing) {
+        return;
+    }
+    const struct PrismaAutogradNode *const node = &tape->nodes[id];
+    const size_t inputs[] = { node->lhs, node->rhs, node->bias };
+    VT_FOREACH(i, 0, 3) {
+        const struct PrismaAutogradNode *const in = &tape->nodes[inputs[i]];
+        if (in->op != PRSM_AUTOGRAD_OP_LEAF && in->last_use == id && !in->stashed && in->value != NULL) {
+            prsm_autograd_stash_node(tape, inputs[i]);
+        }
+    }
+}
+
+/**
+ * @brief  Computes the value of a node from the values of its inputs
+ * @param  tape tape instance
+ * @param  id node id
+ * @returns None
+ */
+static void prsm_autograd_forward_node(prsm_autograd_t *const tape, const size_t id) {
+    struct PrismaAutogradNode *const node = &tape->nodes[id];
+    const prsm_tensor_t *const x = prsm_autograd_operand(tape, &tape->nodes[node->lhs], 0);
+    const prsm_tensor_t *const t = prsm_autograd_operand(tape, &tape->nodes[node->rhs], 1);
+
+    switch (node->op) {
+        case PRSM_AUTOGRAD_OP_MATMUL:
+            node->value = prsm_tensor_gemm(node->value, x, t, false, false, 1, 0);
+            break;
+        case PRSM_AUTOGRAD_OP_ADD:
+            node->value = prsm_tensor_add(node->value, x, t);
+            break;
+        case PRSM_AUTOGRAD_OP_SUB:
+            node->value = prsm_tensor_sub(node->value, x, t);
+            break;
+        case PRSM_AUTOGRAD_OP_MUL:
+            node->value = prsm_tensor_mul(node->value, x, t);
+            break;
+        case PRSM_AUTOGRAD_OP_ADD_ROWS:
+            {
+                // check shapes
+                VT_ENFORCE(x->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+                VT_ENFORCE(prsm_tensor_size(t) == x->shape[1], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+                // create tensor
+                if (node->value == NULL) {
+                    node->value = prsm_tensor_create_ex(tape->alloctr, x->ndim, x->shape);
+                } else if (!prsm_tensor_shapes_match(node->value, x)) {
+                    prsm_tensor_resize_ex(node->value, x->ndim, x->shape);
+                }
+
+                // add bias to every row
+                const size_t rows = x->shape[0], cols = x->shape[1];
+                VT_FOREACH(i, 0, rows) {
+                    const prsm_float *const x_row = x->data + i * cols;
+                    prsm_float *const out_row = node->value->data + i * cols;
+                    VT_FOREACH(j, 0, cols) {
+                        out_row[j] = x_row[j] + t->data[j];
+                    }
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_DENSE:
+            {
+                const struct PrismaTensorEpilogue ep = {
+                    .bias = prsm_autograd_operand(tape, &tape->nodes[node->bias], 2),
+                    .func = (node->activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(node->activation)
+                };
+                node->value = prsm_tensor_gemm_ex(node->value, x, t, false, false, 1, 0, &ep);
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SIGMOID:
+            node->value = prsm_activate_sigmoid(node->value, x);
+            break;
+        case PRSM_AUTOGRAD_OP_TANH:
+            node->value = prsm_activate_tanh(node->value, x);
+            break;
+        case PRSM_AUTOGRAD_OP_RELU:
+            node->value = prsm_activate_relu(node->value, x);
+            break;
+        case PRSM_AUTOGRAD_OP_SOFTMAX:
+            // create tensor
+            if (node->value == NULL) {
+                node->value = prsm_tensor_create_ex(tape->alloctr, x->ndim, x->shape);
+            }
+            prsm_autograd_softmax_rows(node->value, x);
+            break;
+        case PRSM_AUTOGRAD_OP_MSE:
+            {
+                // check shapes
+                VT_ENFORCE(prsm_tensor_shapes_match(x, t), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+                // calculate mse
+                prsm_float sum = 0;
+                const size_t size = prsm_tensor_size(x);
+                VT_FOREACH(i, 0, size) {
+                    const prsm_float diff = x->data[i] - t->data[i];
+                    sum += diff * diff;
+                }
+                node->value = prsm_autograd_scalar(tape, node->value);
+                node->value->data[0] = sum / (prsm_float)size;
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SOFTMAX_CCE:
+            {
+                // check shapes
+                VT_ENFORCE(prsm_tensor_shapes_match(x, t), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+                // probabilities are kept for the backward pass
+                if (node->aux == NULL) {
+                    node->aux = prsm_tensor_create_ex(tape->alloctr, x->ndim, x->shape);
+                }
+                prsm_autograd_softmax_rows(node->aux, x);
+
+                // calculate cce averaged over rows
+                prsm_float sum = 0;
+                const size_t size = prsm_tensor_size(x);
+                const size_t rows = size / x->shape[x->ndim - 1];
+                VT_FOREACH(i, 0, size) {
+                    if (t->data[i] != 0) {
+                        sum += t->data[i] * PRSM_LOG(PRSM_CLAMP(node->aux->data[i], PRSM_CONST_EPSILON, 1 - PRSM_CONST_EPSILON));
+                    }
+                }
+                node->value = prsm_autograd_scalar(tape, node->value);
+                node->value->data[0] = -sum / (prsm_float)rows;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief  Estimates floating point operations of a node
+ * @param  tape tape instance
+ * @param  id node id
+ * @returns 2*N*K*M for matrix products plus one operation per element
+ */
+static size_t prsm_autograd_flops(const prsm_autograd_t *const tape, const size_t id) {
+    const struct PrismaAutogradNode *const node = &tape->nodes[id];
+    size_t ndim = 0;
+    const size_t *const shape = prsm_autograd_shape(&tape->nodes[node->lhs], &ndim);
+    size_t size = 1;
+    VT_FOREACH(d, 0, ndim) {
+        size *= shape[d];
+    }
+
+    switch (node->op) {
+        case PRSM_AUTOGRAD_OP_LEAF:
+            return 0;
+        case PRSM_AUTOGRAD_OP_MATMUL:
+        case PRSM_AUTOGRAD_OP_DENSE:
+            return 2 * prsm_tensor_size(node->value) * shape[1] + prsm_tensor_size(node->value);
+        default:
+            return size;
+    }
+}
+
+/**
+ * @brief  Frees the activations and gradients of checkpointed nodes [from, to)
+ * @param  tape tape instance
+ * @param  from first node
+ * @param  to one past the last node
+ * @returns None
+ */
+static void prsm_autograd_release(prsm_autograd_t *const tape, const size_t from, const size_t to) {
+    VT_FOREACH(i, from, to) {
+        struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (!node->checkpointed) continue;
+        if (node->value != NULL) prsm_tensor_destroy(node->value);
+        if (node->grad != NULL) prsm_tensor_destroy(node->grad);
+        if (node->aux != NULL) prsm_tensor_destroy(node->aux);
+        node->value = node->grad = node->aux = NULL;
+    }
+}
+
+/**
+ * @brief  Recomputes the activations of a segment and prepares their gradient buffers
+ * @param  tape tape instance
+ * @param  segment segment
+ * @returns None
+ */
+static void prsm_autograd_recompute(prsm_autograd_t *const tape, const struct PrismaAutogradSegment *const segment) {
+    // forward again from the kept inputs of the segment
+    VT_FOREACH(i, segment->first, segment->last) {
+        if (!tape->nodes[i].checkpointed) continue;
+        prsm_autograd_forward_node(tape, i);
+        tape->stats.recompute_flops += prsm_autograd_flops(tape, i);
+    }
+
+    // gradients live only while the segment is propagated
+    VT_FOREACH(i, segment->first, segment->last) {
+        struct PrismaAutogradNode *const node = &tape->nodes[i];
+        if (node->checkpointed && node->requires_grad) {
+            prsm_tensor_set_zeros(prsm_autograd_grad_buffer(tape, node));
+        }
+    }
+}
+
+/**
+ * @brief  Returns the shape of a node value, also when it is stashed
+ * @param  node node
+ * @param  ndim number of dimensions
+ * @returns shape
+ */
+static const size_t *prsm_autograd_shape(const struct PrismaAutogradNode *const node, size_t *const ndim) {
+    *ndim = node->stashed ? node->stash.ndim : node->value->ndim;
+    return node->stashed ? node->stash.shape : node->value->shape;
+}
+
+/**
+ * @brief  Compresses the value of a node into its stash and frees the value
+ * @param  tape tape instance
+ * @param  id node id
+ * @returns None
+ */
+static void prsm_autograd_stash_node(prsm_autograd_t *const tape, const size_t id) {
+    struct PrismaAutogradNode *const node = &tape->nodes[id];
+    struct PrismaAutogradStash *const stash = &node->stash;
+    const prsm_tensor_t *const value = node->value;
+    const size_t size = prsm_tensor_size(value);
+    const size_t blocks = (size + PRSM_AUTOGRAD_STASH_BLOCK - 1) / PRSM_AUTOGRAD_STASH_BLOCK;
+    VT_ENFORCE(value->ndim <= PRSM_AUTOGRAD_MAX_DIMS, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // keep only what backward reads
+    stash->format = node->needs_value ? tape->stash : node->needs_mask ? PRSM_AUTOGRAD_STASH_MASK : PRSM_AUTOGRAD_STASH_DROP;
+    switch (stash->format) {
+        case PRSM_AUTOGRAD_STASH_FP16:
+            stash->bytes = size * sizeof(uint16_t);
+            break;
+        case PRSM_AUTOGRAD_STASH_INT8:
+            stash->bytes = blocks * sizeof(float) + size;
+            break;
+        case PRSM_AUTOGRAD_STASH_MASK:
+            stash->bytes = (size + 7) / 8;
+            break;
+        default:
+            stash->bytes = 0;
+            break;
+    }
+    stash->ndim = value->ndim;
+    VT_FOREACH(d, 0, value->ndim) {
+        stash->shape[d] = value->shape[d];
+    }
+
+    // grow
+    if (stash->bytes > stash->capacity) {
+        stash->data = (tape->alloctr == NULL)
+            ? VT_REALLOC(stash->data, stash->bytes)
+            : VT_ALLOCATOR_REALLOC(tape->alloctr, stash->data, stash->bytes);
+        stash->capacity = stash->bytes;
+    }
+
+    // encode
+    const prsm_float *const x = value->data;
+    switch (stash->format) {
+        case PRSM_AUTOGRAD_STASH_FP16:
+            {
+                uint16_t *const half = (uint16_t*)stash->data;
+                VT_FOREACH(i, 0, size) {
+                    half[i] = prsm_autograd_half_from_float((float)x[i]);
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_STASH_INT8:
+            {
+                // symmetric quantization: q = round(x / scale), scale = max(|x|) / 127 of the block
+                float *const scales = (float*)stash->data;
+                int8_t *const q = (int8_t*)(stash->data + blocks * sizeof(float));
+                VT_FOREACH(b, 0, blocks) {
+                    const size_t from = b * PRSM_AUTOGRAD_STASH_BLOCK;
+                    const size_t to = (size - from < PRSM_AUTOGRAD_STASH_BLOCK) ? size : from + PRSM_AUTOGRAD_STASH_BLOCK;
+                    prsm_float max = 0;
+                    VT_FOREACH(i, from, to) {
+                        const prsm_float v = PRSM_ABS(x[i]);
+                        max = (v > max) ? v : max;
+                    }
+                    scales[b] = (float)(max / 127);
+                    const prsm_float inv = (max == 0) ? 0 : 127 / max;
+                    VT_FOREACH(i, from, to) {
+                        const prsm_float v = x[i] * inv;
+                        q[i] = (int8_t)((v >= 0) ? v + (prsm_float)0.5 : v - (prsm_float)0.5);
+                    }
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_STASH_MASK:
+            memset(stash->data, 0, stash->bytes);
+            VT_FOREACH(i, 0, size) {
+                if (x[i] > 0) stash->data[i / 8] |= (uint8_t)(1u << (i % 8));
+            }
+            break;
+        default:
+            break;
+    }
+
+    // free the value
+    tape->stats.stashed_bytes += stash->bytes;
+    tape->stats.saved_bytes += size * sizeof(prsm_float) - stash->bytes;
+    prsm_tensor_destroy(node->value);
+    node->value = NULL;
+    node->stashed = true;
+}
+
+/**
+ * @brief  Decodes elements [from, from + len) of a stash
+ * @param  stash stash
+ * @param  from first element
+ * @param  len number of elements
+ * @param  out output of `len` elements
+ * @returns None
+ */
+static void prsm_autograd_stash_decode(const struct PrismaAutogradStash *const stash, const size_t from, const size_t len, prsm_float *const out) {
+    switch (stash->format) {
+        case PRSM_AUTOGRAD_STASH_FP16:
+            {
+                const uint16_t *const half = (const uint16_t*)stash->data + from;
+                VT_FOREACH(i, 0, len) {
+                    out[i] = (prsm_float)prsm_autograd_half_to_float(half[i]);
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_STASH_INT8:
+            {
+                size_t size = 1;
+                VT_FOREACH(d, 0, stash->ndim) {
+                    size *= stash->shape[d];
+                }
+                const size_t blocks = (size + PRSM_AUTOGRAD_STASH_BLOCK - 1) / PRSM_AUTOGRAD_STASH_BLOCK;
+                const float *const scales = (const float*)stash->data;
+                const int8_t *const q = (const int8_t*)(stash->data + blocks * sizeof(float));
+                VT_FOREACH(i, 0, len) {
+                    out[i] = (prsm_float)scales[(from + i) / PRSM_AUTOGRAD_STASH_BLOCK] * (prsm_float)q[from + i];
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_STASH_MASK:
+            VT_FOREACH(i, 0, len) {
+                out[i] = (stash->data[(from + i) / 8] >> ((from + i) % 8)) & 1;
+            }
+            break;
+        default:
+            VT_ENFORCE(false, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+            break;
+    }
+}
+
+/**
+ * @brief  Returns elements [from, from + len) of a node value, decoded into `tile` if the value is stashed
+ * @param  node node
+ * @param  from first element
+ * @param  len number of elements; at most `PRSM_AUTOGRAD_STASH_BLOCK`
+ * @param  tile decoding buffer of `PRSM_AUTOGRAD_STASH_BLOCK` elements
+ * @returns prsm_float*
+ */
+static const prsm_float *prsm_autograd_stash_tile(const struct PrismaAutogradNode *const node, const size_t from, const size_t len, prsm_float *const tile) {
+    if (!node->stashed) {
+        return node->value->data + from;
+    }
+    prsm_autograd_stash_decode(&node->stash, from, len, tile);
+
+    return tile;
+}
+
+/**
+ * @brief  Returns the value of a node, decoded into a scratch tensor of the tape if the value is stashed
+ * @param  tape tape instance
+ * @param  node node
+ * @param  slot scratch tensor: 0, 1 or 2, one per operand of a node
+ * @returns prsm_tensor_t*
+ *
+ * @note the decoded value is valid until the slot is used again
+ */
+static const prsm_tensor_t *prsm_autograd_operand(prsm_autograd_t *const tape, const struct PrismaAutogradNode *const node, const size_t slot) {
+    if (!node->stashed) {
+        return node->value;
+    }
+
+    // create tensor
+    prsm_tensor_t *ret = (tape->scratch[slot] == NULL)
+        ? prsm_tensor_create_ex(tape->alloctr, node->stash.ndim, node->stash.shape)
+        : tape->scratch[slot];
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, node->stash.ndim, node->stash.shape)) {
+        prsm_tensor_resize_ex(ret, node->stash.ndim, node->stash.shape);
+    }
+    tape->scratch[slot] = ret;
+
+    prsm_autograd_stash_decode(&node->stash, 0, prsm_tensor_size(ret), ret->data);
+    return ret;
+}
+
+/**
+ * @brief  Converts a float to IEEE half precision, rounding to nearest even
+ * @param  value float
+ * @returns half precision bits
+ */
+static uint16_t prsm_autograd_half_from_float(const float value) {
+    uint32_t x = 0;
+    memcpy(&x, &value, sizeof(x));
+    const uint32_t sign = (x >> 16) & 0x8000;
+    const uint32_t exp = (x >> 23) & 0xFF;
+    uint32_t mant = x & 0x7FFFFF;
+
+    // inf and nan
+    if (exp == 0xFF) {
+        return (uint16_t)(sign | 0x7C00 | (mant ? 0x200 : 0));
+    }
+
+    // overflow to inf
+    const int e = (int)exp - 127 + 15;
+    if (e >= 31) {
+        return (uint16_t)(sign | 0x7C00);
+    }
+
+    // subnormal or zero
+    if (e <= 0) {
+        if (e < -10) {
+            return (uint16_t)sign;
+        }
+        mant |= 0x800000;
+        const uint32_t shift = (uint32_t)(14 - e);
+        const uint32_t rem = mant & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        uint32_t h = mant >> shift;
+        if (rem > halfway || (rem == halfway && (h & 1))) h++;
+        return (uint16_t)(sign | h);
+    }
+
+    // normal; a carry out of the mantissa correctly bumps the exponent
+    uint32_t h = ((uint32_t)e << 10) | (mant >> 13);
+    const uint32_t rem = mant & 0x1FFF;
+    if (rem > 0x1000 || (rem == 0x1000 && (h & 1))) h++;
+    return (uint16_t)(sign | h);
+}
+
+/**
+ * @brief  Converts IEEE half precision to float
+ * @param  half half precision bits
+ * @returns float
+ */
+static float prsm_autograd_half_to_float(const uint16_t half) {
+    const uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    const uint32_t exp = (half >> 10) & 0x1F;
+    uint32_t mant = half & 0x3FF;
+
+    uint32_t x = 0;
+    if (exp == 0x1F) {
+        x = sign | 0x7F800000 | (mant << 13);
+    } else if (exp != 0) {
+        x = sign | ((exp + 112) << 23) | (mant << 13);
+    } else if (mant != 0) {
+        // subnormal: normalize
+        uint32_t e = 113;
+        while (!(mant & 0x400)) {
+            mant <<= 1;
+            e--;
+        }
+        x = sign | (e << 23) | ((mant & 0x3FF) << 13);
+    } else {
+        x = sign;
+    }
+
+    float value = 0;
+    memcpy(&value, &x, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief  Numerically stable softmax applied to every row (last dimension)
+ * @param  out output tensor
+ * @param  in input tensor
+ * @returns None
+ */
+static void prsm_autograd_softmax_rows(prsm_tensor_t *const out, const prsm_tensor_t *const in) {
+    // check size
+    if (!prsm_tensor_shapes_match(out, in)) {
+        prsm_tensor_resize_ex(out, in->ndim, in->shape);
+    }
+
+    const size_t cols = in->shape[in->ndim - 1];
+    const size_t rows = prsm_tensor_size(in) / cols;
+    VT_FOREACH(i, 0, rows) {
+        const prsm_float *const x = in->data + i * cols;
+        prsm_float *const y = out->data + i * cols;
+
+        // find max
+        prsm_float max = x[0];
+        VT_FOREACH(j, 1, cols) {
+            max = (x[j] > max) ? x[j] : max;
+        }
+
+        // exponentiate and normalize
+        prsm_float sum = 0;
+        VT_FOREACH(j, 0, cols) {
+            y[j] = PRSM_EXP(x[j] - max);
+            sum += y[j];
+        }
+        VT_FOREACH(j, 0, cols) {
+            y[j] /= sum;
+        }
+    }
+}
+
+/**
+ * @brief  Accumulates the gradient of a node into the gradients of its inputs
+ * @param  tape tape instance
+ * @param  id node id
+ * @returns None
+ */
+static void prsm_autograd_backward_node(prsm_autograd_t *const tape, const size_t id) {
+    const struct PrismaAutogradNode *const node = &tape->nodes[id];
+    struct PrismaAutogradNode *const a = &tape->nodes[node->lhs];
+    struct PrismaAutogradNode *const b = &tape->nodes[node->rhs];
+    const prsm_tensor_t *const g = node->grad;
+    const size_t size = prsm_tensor_size(g);
+    prsm_float tile[PRSM_AUTOGRAD_STASH_BLOCK];
+
+    switch (node->op) {
+        case PRSM_AUTOGRAD_OP_MATMUL:
+            // dA += dC * B_T, dB += A_T * dC
+            if (a->requires_grad) prsm_tensor_gemm(a->grad, g, prsm_autograd_operand(tape, b, 1), false, true, 1, 1);
+            if (b->requires_grad) prsm_tensor_gemm(b->grad, prsm_autograd_operand(tape, a, 0), g, true, false, 1, 1);
+            break;
+        case PRSM_AUTOGRAD_OP_ADD:
+            VT_FOREACH(i, 0, size) {
+                if (a->requires_grad) a->grad->data[i] += g->data[i];
+                if (b->requires_grad) b->grad->data[i] += g->data[i];
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SUB:
+            VT_FOREACH(i, 0, size) {
+                if (a->requires_grad) a->grad->data[i] += g->data[i];
+                if (b->requires_grad) b->grad->data[i] -= g->data[i];
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_MUL:
+            {
+                const prsm_tensor_t *const av = prsm_autograd_operand(tape, a, 0);
+                const prsm_tensor_t *const bv = prsm_autograd_operand(tape, b, 1);
+                VT_FOREACH(i, 0, size) {
+                    if (a->requires_grad) a->grad->data[i] += g->data[i] * bv->data[i];
+                    if (b->requires_grad) b->grad->data[i] += g->data[i] * av->data[i];
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_ADD_ROWS:
+            {
+                // the bias gradient is the column-wise sum
+                const size_t cols = g->shape[1];
+                VT_FOREACH(i, 0, size) {
+                    if (a->requires_grad) a->grad->data[i] += g->data[i];
+                    if (b->requires_grad) b->grad->data[i % cols] += g->data[i];
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_DENSE:
+            {
+                // dz = dy * activation'(y); linear layers pass dy through
+                const prsm_tensor_t *dz = g;
+                if (node->activation != PRSM_ACTIVATION_LINEAR) {
+                    prsm_tensor_t *const aux = (node->aux == NULL)
+                        ? prsm_tensor_create_ex(tape->alloctr, g->ndim, g->shape)
+                        : node->aux;
+                    if (!prsm_tensor_shapes_match(aux, g)) {
+                        prsm_tensor_resize_ex(aux, g->ndim, g->shape);
+                    }
+
+                    // the stash is decoded tile by tile; a relu mask decodes to 0/1, which relu_d maps to itself
+                    const prsm_activate_fn func_d = prsm_activate_get_func_d(node->activation);
+                    for (size_t from = 0; from < size; from += PRSM_AUTOGRAD_STASH_BLOCK) {
+                        const size_t len = (size - from < PRSM_AUTOGRAD_STASH_BLOCK) ? size - from : PRSM_AUTOGRAD_STASH_BLOCK;
+                        const prsm_float *const y = prsm_autograd_stash_tile(node, from, len, tile);
+                        VT_FOREACH(i, 0, len) {
+                            aux->data[from + i] = g->data[from + i] * func_d(y[i]);
+                        }
+                    }
+                    tape->nodes[id].aux = aux;
+                    dz = aux;
+                }
+
+                // dX += dZ * W_T, dW += X_T * dZ, db += sum(dZ, 0)
+                struct PrismaAutogradNode *const bias = &tape->nodes[node->bias];
+                if (a->requires_grad) prsm_tensor_gemm(a->grad, dz, prsm_autograd_operand(tape, b, 1), false, true, 1, 1);
+                if (b->requires_grad) prsm_tensor_gemm(b->grad, prsm_autograd_operand(tape, a, 0), dz, true, false, 1, 1);
+                if (bias->requires_grad) {
+                    const size_t cols = dz->shape[1];
+                    VT_FOREACH(i, 0, size) {
+                        bias->grad->data[i % cols] += dz->data[i];
+                    }
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SIGMOID:
+        case PRSM_AUTOGRAD_OP_TANH:
+        case PRSM_AUTOGRAD_OP_RELU:
+            // the stash is decoded tile by tile inside the loop
+            for (size_t from = 0; from < size; from += PRSM_AUTOGRAD_STASH_BLOCK) {
+                const size_t len = (size - from < PRSM_AUTOGRAD_STASH_BLOCK) ? size - from : PRSM_AUTOGRAD_STASH_BLOCK;
+                const prsm_float *const y = prsm_autograd_stash_tile(node, from, len, tile);
+                const prsm_float *const g_tile = g->data + from;
+                prsm_float *const dx_tile = a->grad->data + from;
+                if (node->op == PRSM_AUTOGRAD_OP_SIGMOID) {
+                    VT_FOREACH(i, 0, len) {
+                        dx_tile[i] += g_tile[i] * y[i] * (1 - y[i]);
+                    }
+                } else if (node->op == PRSM_AUTOGRAD_OP_TANH) {
+                    VT_FOREACH(i, 0, len) {
+                        dx_tile[i] += g_tile[i] * (1 - y[i] * y[i]);
+                    }
+                } else {
+                    VT_FOREACH(i, 0, len) {
+                        dx_tile[i] += (y[i] > 0) ? g_tile[i] : 0;
+                    }
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SOFTMAX:
+            {
+                const prsm_tensor_t *const y = prsm_autograd_operand(tape, node, 2);
+                // dx = y * (dy - sum(dy * y)) for every row
+                const size_t cols = y->shape[y->ndim - 1];
+                const size_t rows = size / cols;
+                VT_FOREACH(i, 0, rows) {
+                    const prsm_float *const g_row = g->data + i * cols;
+                    const prsm_float *const y_row = y->data + i * cols;
+                    prsm_float *const dx_row = a->grad->data + i * cols;
+
+                    prsm_float dot = 0;
+                    VT_FOREACH(j, 0, cols) {
+                        dot += g_row[j] * y_row[j];
+                    }
+                    VT_FOREACH(j, 0, cols) {
+                        dx_row[j] += y_row[j] * (g_row[j] - dot);
+                    }
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_MSE:
+            {
+                const prsm_tensor_t *const av = prsm_autograd_operand(tape, a, 0);
+                const prsm_tensor_t *const bv = prsm_autograd_operand(tape, b, 1);
+                const size_t n = prsm_tensor_size(av);
+                const prsm_float scale = 2 * g->data[0] / (prsm_float)n;
+                VT_FOREACH(i, 0, n) {
+                    const prsm_float diff = scale * (av->data[i] - bv->data[i]);
+                    if (a->requires_grad) a->grad->data[i] += diff;
+                    if (b->requires_grad) b->grad->data[i] -= diff;
+                }
+            }
+            break;
+        case PRSM_AUTOGRAD_OP_SOFTMAX_CCE:
+            {
+                // dx = (p * sum(t) - t)/N for every row; sum(t) = 1 for one-hot targets
+                const prsm_tensor_t *const p = node->aux;
+                const prsm_tensor_t *const t = prsm_autograd_operand(tape, b, 1);
+                const size_t cols = p->shape[p->ndim - 1];
+                const size_t rows = prsm_tensor_size(p) / cols;
+                const prsm_float scale = g->data[0] / (prsm_float)rows;
+                if (!a->requires_grad) break;
+                VT_FOREACH(i, 0, rows) {
+                    const prsm_float *const p_row = p->data + i * cols;
+                    const prsm_float *const t_row = t->data + i * cols;
+                    prsm_float *const dx_row = a->grad->data + i * cols;
+
+                    prsm_float t_sum = 0;
+                    VT_FOREACH(j, 0, cols) {
+                        t_sum += t_row[j];
+                    }
+                    VT_FOREACH(j, 0, cols) {
+                        dx_row[j] += scale * (p_row[j] * t_sum - t_row[j]);
+                    }
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
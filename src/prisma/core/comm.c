@@ -0,0 +1,250 @@
+#include "prisma/core/comm.h"
+#include "prisma/core/parallel.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+// cache line size in bytes: barrier counters and slots do not share lines
+#define PRSM_COMM_CACHE_LINE 64
+
+// barrier polls before yielding the processor
+#define PRSM_COMM_SPIN 1024
+
+static void prsm_comm_copy(prsm_tensor_t *const tensors[], const size_t count, const size_t from, const size_t len, prsm_float *const buffer, const bool to_buffer);
+
+enum PrismaStatus prsm_comm_open(prsm_comm_t *const comm, const char *const name, const size_t rank, const size_t size, const size_t capacity) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(comm != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(name != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(size > 0 && rank < size && capacity > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // zero-init
+    *comm = (prsm_comm_t) {0};
+
+    // layout: barrier counters on their own cache lines, then `size` rank slots and the result slot
+    const size_t line = PRSM_COMM_CACHE_LINE / sizeof(prsm_float);
+    const size_t stride = (capacity + line - 1) / line * line;
+    const size_t bytes = 2 * PRSM_COMM_CACHE_LINE + (size + 1) * stride * sizeof(prsm_float);
+
+#if defined(_WIN32) || defined(_WIN64)
+    // named mapping backed by the paging file; opened if another rank created it
+    HANDLE hmap = CreateFileMappingA(
+        INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)bytes >> 32), (DWORD)(bytes & 0xFFFFFFFF), name
+    );
+    if (hmap == NULL) {
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    void *base = MapViewOfFile(hmap, FILE_MAP_ALL_ACCESS, 0, 0, bytes);
+    if (base == NULL) {
+        CloseHandle(hmap);
+        return PRSM_STATUS_ERROR_IO;
+    }
+    comm->hmap = hmap;
+#else
+    // create or open the object; new pages are zero, which is the initial barrier state
+    const int fd = shm_open(name, O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        return PRSM_STATUS_ERROR_IO;
+    }
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        close(fd);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    void *base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return PRSM_STATUS_ERROR_IO;
+    }
+    comm->fd = fd;
+#endif
+
+    comm->rank = rank;
+    comm->size = size;
+    comm->capacity = capacity;
+    comm->stride = stride;
+    comm->slot_shape[0] = capacity;
+    comm->base = base;
+    comm->bytes = bytes;
+    comm->arrived = (size_t*)base;
+    comm->generation = (size_t*)((uint8_t*)base + PRSM_COMM_CACHE_LINE);
+    comm->slots = (prsm_float*)((uint8_t*)base + 2 * PRSM_COMM_CACHE_LINE);
+
+    return PRSM_STATUS_OPERATION_SUCCESS;
+}
+
+void prsm_comm_close(prsm_comm_t *const comm) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(comm != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // if not connected, skip
+    if (prsm_comm_is_null(comm)) {
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(comm->base);
+    CloseHandle(comm->hmap);
+#else
+    munmap(comm->base, comm->bytes);
+    close(comm->fd);
+#endif
+
+    *comm = (prsm_comm_t) {0};
+}
+
+void prsm_comm_unlink(const char *const name) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(name != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+#if defined(_WIN32) || defined(_WIN64)
+    (void)name; // removed with the last handle
+#else
+    shm_unlink(name);
+#endif
+}
+
+bool prsm_comm_is_null(const prsm_comm_t *const comm) {
+    return (comm == NULL || comm->base == NULL);
+}
+
+prsm_tensor_t prsm_comm_buffer(prsm_comm_t *const comm, const size_t rank) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_comm_is_null(comm), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(rank < comm->size, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return (prsm_tensor_t) {
+        .ndim = 1,
+        .shape = comm->slot_shape,
+        .data = comm->slots + rank * comm->stride,
+        .is_view = true
+    };
+}
+
+void prsm_comm_barrier(prsm_comm_t *const comm) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_comm_is_null(comm), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+
+    // the last rank to arrive resets the counter and opens the barrier by advancing the generation
+    const size_t generation = prsm_atomic_load(comm->generation);
+    if (prsm_atomic_fetch_add(comm->arrived, 1) == comm->size - 1) {
+        prsm_atomic_store(comm->arrived, 0);
+        prsm_atomic_store(comm->generation, generation + 1);
+        return;
+    }
+
+    // others spin, then yield, until the generation changes
+    for (size_t spin = 0; prsm_atomic_load(comm->generation) == generation; spin++) {
+        if (spin >= PRSM_COMM_SPIN) prsm_thread_yield();
+    }
+}
+
+void prsm_comm_allreduce(prsm_comm_t *const comm, prsm_tensor_t *const tensors[], const size_t count) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_comm_is_null(comm), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_DEBUG_ASSERT(tensors != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    size_t total = 0;
+    VT_FOREACH(i, 0, count) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(tensors[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        total += prsm_tensor_size(tensors[i]);
+    }
+
+    // one process: nothing to exchange
+    if (comm->size == 1) {
+        return;
+    }
+
+    // slot-sized rounds
+    prsm_float *const own = comm->slots + comm->rank * comm->stride;
+    prsm_float *const result = comm->slots + comm->size * comm->stride;
+    for (size_t from = 0; from < total; from += comm->capacity) {
+        const size_t len = (total - from < comm->capacity) ? total - from : comm->capacity;
+
+        // publish local values
+        prsm_comm_copy(tensors, count, from, len, own, true);
+        prsm_comm_barrier(comm);
+
+        // reduce-scatter: this rank sums its part of the elements over all slots in rank order
+        const size_t part_from = len * comm->rank / comm->size;
+        const size_t part_to = len * (comm->rank + 1) / comm->size;
+        VT_FOREACH(i, part_from, part_to) {
+            result[i] = comm->slots[i];
+        }
+        VT_FOREACH(r, 1, comm->size) {
+            const prsm_float *const slot = comm->slots + r * comm->stride;
+            VT_FOREACH(i, part_from, part_to) {
+                result[i] += slot[i];
+            }
+        }
+        prsm_comm_barrier(comm);
+
+        // all-gather: every rank reads the full result
+        prsm_comm_copy(tensors, count, from, len, result, false);
+    }
+}
+
+void prsm_comm_broadcast(prsm_comm_t *const comm, prsm_tensor_t *const tensors[], const size_t count, const size_t root) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_comm_is_null(comm), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_DEBUG_ASSERT(tensors != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(root < comm->size, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    size_t total = 0;
+    VT_FOREACH(i, 0, count) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(tensors[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        total += prsm_tensor_size(tensors[i]);
+    }
+
+    // one process: nothing to exchange
+    if (comm->size == 1) {
+        return;
+    }
+
+    // slot-sized rounds through the result slot; the root writes it once all ranks are done reading it
+    prsm_float *const result = comm->slots + comm->size * comm->stride;
+    for (size_t from = 0; from < total; from += comm->capacity) {
+        const size_t len = (total - from < comm->capacity) ? total - from : comm->capacity;
+        prsm_comm_barrier(comm);
+        if (comm->rank == root) {
+            prsm_comm_copy(tensors, count, from, len, result, true);
+        }
+        prsm_comm_barrier(comm);
+        if (comm->rank != root) {
+            prsm_comm_copy(tensors, count, from, len, result, false);
+        }
+    }
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Copies elements [from, from + len) of the concatenated tensors to or from a buffer
+ * @param  tensors tensors
+ * @param  count number of tensors
+ * @param  from first element of the concatenation
+ * @param  len number of elements
+ * @param  buffer buffer of `len` elements
+ * @param  to_buffer copy direction
+ * @returns None
+ */
+static void prsm_comm_copy(prsm_tensor_t *const tensors[], const size_t count, const size_t from, const size_t len, prsm_float *const buffer, const bool to_buffer) {
+    size_t offset = 0, done = 0;
+    for (size_t t = 0; t < count && done < len; t++) {
+        const size_t size = prsm_tensor_size(tensors[t]);
+        if (offset + size > from + done) {
+            // part of this tensor inside the range
+            const size_t at = from + done - offset;
+            const size_t n = (size - at < len - done) ? size - at : len - done;
+            if (to_buffer) memcpy(buffer + done, tensors[t]->data + at, n * sizeof(prsm_float));
+            else memcpy(tensors[t]->data + at, buffer + done, n * sizeof(prsm_float));
+            done += n;
+        }
+        offset += size;
+    }
+}
@@ -0,0 +1,2563 @@
+#include "prisma/core/conv.h"
+
+// im2col/col2im: minimum elements per task
+#define PRSM_CONV_GRAIN (32 * 1024)
+
+// direct convolution register tile: output pixels by output channels (channel blocks are multiples of NR)
+#define PRSM_CONV_DIRECT_TILE 4
+#define PRSM_CONV_DIRECT_NR 8
+
+// direct convolution heuristic: input channels below which im2col inflation dominates, im2col buffer limit in bytes
+#define PRSM_CONV_DIRECT_MAX_CHANNELS 16
+#define PRSM_CONV_DIRECT_MAX_COL_BYTES (8 * 1024 * 1024)
+
+// Winograd: smallest channel count and number of tiles per image that amortize the transforms (narrower gemms
+// fall off the register tile); rounding error growth relative to a direct dot product, measured with margin
+#define PRSM_CONV_WINOGRAD_MIN_CHANNELS 32
+#define PRSM_CONV_WINOGRAD_MIN_TILES 16
+#define PRSM_CONV_WINOGRAD_GROWTH_2 1
+#define PRSM_CONV_WINOGRAD_GROWTH_4 8
+
+// depthwise-pointwise fusion: bytes of the intermediate band each thread keeps in cache
+#define PRSM_CONV_BAND_BYTES (32 * 1024)
+
+// weight gradient: register tile (output channels x weight rows), output channels per task, minimum multiply-adds per task
+#define PRSM_CONV_GRAD_MR 4
+#define PRSM_CONV_GRAD_NR 4
+#define PRSM_CONV_GRAD_LANES 8
+#define PRSM_CONV_GRAD_ROWS 16
+#define PRSM_CONV_GRAD_GRAIN (64 * 1024)
+
+// Winograd relative error tolerance
+static prsm_float gi_winograd_rtol = 1e-3;
+
+// Winograd F(2x2,3x3) transforms: B_T (4x4), G (4x3), A_T (2x4)
+static const prsm_float gi_winograd_bt2[] = {
+    1,  0, -1,  0,
+    0,  1,  1,  0,
+    0, -1,  1,  0,
+    0,  1,  0, -1
+};
+static const prsm_float gi_winograd_g2[] = {
+    1,    0,   0,
+    0.5,  0.5, 0.5,
+    0.5, -0.5, 0.5,
+    0,    0,   1
+};
+static const prsm_float gi_winograd_at2[] = {
+    1, 1,  1,  0,
+    0, 1, -1, -1
+};
+
+// Winograd F(4x4,3x3) transforms: B_T (6x6), G (6x3), A_T (4x6)
+static const prsm_float gi_winograd_bt4[] = {
+    4,  0, -5,  0, 1, 0,
+    0, -4, -4,  1, 1, 0,
+    0,  4, -4, -1, 1, 0,
+    0, -2, -1,  2, 1, 0,
+    0,  2, -1, -2, 1, 0,
+    0,  4,  0, -5, 0, 1
+};
+static const prsm_float gi_winograd_g4[] = {
+     1.0 / 4,  0,         0,
+    -1.0 / 6, -1.0 / 6,  -1.0 / 6,
+    -1.0 / 6,  1.0 / 6,  -1.0 / 6,
+     1.0 / 24, 1.0 / 12,  1.0 / 6,
+     1.0 / 24, -1.0 / 12, 1.0 / 6,
+     0,        0,         1
+};
+static const prsm_float gi_winograd_at4[] = {
+    1, 1,  1, 1,  1, 0,
+    0, 1, -1, 2, -2, 0,
+    0, 1,  1, 4,  4, 0,
+    0, 1, -1, 8, -8, 1
+};
+
+// shared state of a parallel im2col/col2im
+struct PrismaConvColContext {
+    prsm_float *col;                        // (C * KH * KW, OH * OW)
+    prsm_float *img;                        // (C, H, W)
+    size_t h, w;                            // image size
+    size_t oh, ow;                          // output size
+    const prsm_conv2d_params_t *params;
+};
+
+// convolution shapes
+struct PrismaConvShape {
+    size_t n, c, h, w;                      // input
+    size_t oc, oh, ow;                      // output
+    size_t cg, ocg;                         // channels per group
+    size_t kk;                              // kernel size: KH * KW
+};
+
+// shared state of a parallel direct convolution
+struct PrismaConvDirectContext {
+    prsm_float *out;                        // (N, OCB, OH, OW, block)
+    const prsm_float *in;                   // (N, CB, H, W, block)
+    const prsm_float *w;                    // (OCB, CB, KH, KW, block, block)
+    const prsm_float *bias;                 // (OC) or NULL
+    prsm_activate_fn func;                  // NULL for linear
+    size_t c, oc;                           // input and output channels
+    size_t cb, ocb;                         // channel blocks
+    size_t h, w_, oh, ow;                   // image and output size
+    size_t block;
+    const prsm_conv2d_params_t *params;
+};
+
+// Winograd F(m x m, 3x3) transforms
+struct PrismaConvWinograd {
+    size_t m;                               // output tile size
+    size_t alpha;                           // input tile size: m + 2
+    const prsm_float *bt;                   // (alpha, alpha)
+    const prsm_float *g;                    // (alpha, 3)
+    const prsm_float *at;                   // (m, alpha)
+};
+
+// shared state of parallel Winograd transforms of one image
+struct PrismaConvWinogradContext {
+    const struct PrismaConvWinograd *wg;
+    const prsm_float *img;                  // (C, H, W)
+    prsm_float *v;                          // transformed input: (alpha^2, C, P)
+    const prsm_float *mm;                   // transformed output: (alpha^2, OC, P)
+    prsm_float *out;                        // (OC, OH, OW)
+    const prsm_float *bias;                 // (OC) or NULL
+    prsm_activate_fn func;                  // NULL for linear
+    size_t c, oc;                           // channels
+    size_t h, w, oh, ow;                    // image and output size
+    size_t th, tw;                          // tiles along height and width; P = th * tw
+    size_t pad_h, pad_w;
+};
+
+// shared state of a parallel depthwise (and fused pointwise) convolution on NCHWc
+struct PrismaConvDepthwiseContext {
+    prsm_float *out;                        // (N, CB, OH, OW, block) or (N, OCB, OH, OW, block) if fused
+    const prsm_float *in;                   // (N, CB, H, W, block)
+    const prsm_float *w;                    // (CB, KH, KW, block)
+    const prsm_float *bias;                 // (C) or NULL
+    prsm_activate_fn func;                  // NULL for linear
+    size_t c, cb;                           // channels and channel blocks
+    size_t h, w_, oh, ow;                   // image and output size
+    size_t block;
+    const prsm_conv2d_params_t *params;
+
+    // fused pointwise convolution
+    const prsm_float *pw;                   // (OCB, CB, 1, 1, block, block)
+    const prsm_float *pw_bias;              // (OC) or NULL
+    prsm_activate_fn pw_func;               // NULL for linear
+    size_t oc, ocb;                         // output channels and blocks
+    size_t band;                            // output rows per band
+    prsm_float *tmp;                        // per-thread bands: (CB, band, OW, block)
+};
+
+// shared state of a parallel weight gradient
+struct PrismaConvGradContext {
+    prsm_float *acc;                        // per-thread copies of dw: (slices, OC, C/groups * KH * KW)
+    prsm_float *dw;                         // (OC, C/groups * KH * KW)
+    prsm_float *db;                         // (OC) or NULL
+    const prsm_float *col;                  // columns of the images of this pass: (images, C * KH * KW, OH * OW)
+    const prsm_float *dout;                 // output gradient of the same images: (images, OC, OH, OW)
+    const prsm_float *dout_all;             // output gradient of the batch: (N, OC, OH, OW)
+    size_t n, oc;                           // batch size and output channels
+    size_t groups, ocg;                     // groups and output channels per group
+    size_t rows;                            // weights per output channel: C/groups * KH * KW
+    size_t ohw;                             // output pixels
+    size_t blocks;                          // output channel blocks per group
+    size_t slices;                          // per-thread copies in use
+};
+
+// one axis of an output phase: outputs r, r + stride, ...; output j of the phase reads input j + q + t * step at tap t
+struct PrismaConvPhaseAxis {
+    size_t r;                               // first output
+    size_t stride;                          // distance between outputs of the phase
+    size_t out;                             // outputs of the phase
+    size_t taps;                            // kernel taps that reach them
+    int64_t q;                              // input offset of the first tap; negative reads padding
+    size_t step;                            // input distance between taps
+};
+
+// shared state of a parallel phase: gather im2col and strided store of the gemm result
+struct PrismaConvPhaseContext {
+    prsm_float *col;                        // (C * TY * TX, Y * X)
+    const prsm_float *img;                  // (C, H, W)
+    const prsm_float *mm;                   // gemm result: (OC, Y * X) or NULL without taps
+    prsm_float *out;                        // (OC, OH, OW)
+    const prsm_float *bias;                 // (OC) or NULL
+    prsm_activate_fn func;                  // NULL for linear
+    struct PrismaConvPhaseAxis y, x;
+    size_t h, w, oh, ow;                    // image and output size
+    size_t scale;                           // bilinear: offsets address the image upsampled by scale; 0 otherwise
+    prsm_float *planes;                     // bilinear: per-thread upsampled channel: (threads, H * scale, W * scale)
+};
+
+static void prsm_conv2d_check(const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, struct PrismaConvShape *const shape);
+static bool prsm_conv2d_is_pointwise(const prsm_conv2d_params_t *const params);
+static void prsm_conv2d_reserve(prsm_tensor_t *const workspace, const size_t size);
+static prsm_tensor_t prsm_conv2d_view(prsm_float *const data, size_t shape[2], const size_t rows, const size_t cols);
+static void prsm_conv2d_im2col_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_conv2d_col2im_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static size_t prsm_conv2d_block(const prsm_conv2d_params_t *const params);
+static size_t prsm_conv2d_direct_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w);
+static void prsm_conv2d_forward_direct(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const struct PrismaConvShape *const s);
+static void prsm_conv2d_direct_row(const struct PrismaConvDirectContext *const c, const size_t n, const size_t ocb, const size_t oh);
+static void prsm_conv2d_direct_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static struct PrismaConvWinograd prsm_conv2d_winograd_get(const size_t m);
+static bool prsm_conv2d_winograd_fits(const prsm_conv2d_params_t *const params, const size_t m);
+static size_t prsm_conv2d_winograd_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w, const size_t m);
+static void prsm_conv2d_winograd_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_float *const u, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t m, prsm_float *const ws);
+static void prsm_conv2d_winograd_input_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_conv2d_winograd_output_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static size_t prsm_conv2d_depthwise_band(const size_t cb, const size_t ow, const size_t block);
+static size_t prsm_conv2d_depthwise_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w);
+static size_t prsm_conv2d_separable_workspace_size(const prsm_conv2d_params_t *const params, const size_t out_channels, const size_t in_h, const size_t in_w);
+static void prsm_conv2d_forward_depthwise(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const struct PrismaConvShape *const s);
+static void prsm_conv2d_depthwise_pointwise_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, const size_t out_channels, prsm_float *const tmp);
+static void prsm_conv2d_depthwise_row(const struct PrismaConvDepthwiseContext *const c, const size_t n, const size_t cb, const size_t oh, prsm_float *const dst);
+static void prsm_conv2d_depthwise_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_conv2d_depthwise_pointwise_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static size_t prsm_conv2d_grad_grain(const struct PrismaConvGradContext *const c);
+static void prsm_conv2d_grad_run(struct PrismaConvGradContext *const c, const prsm_float *const col, const prsm_float *const dout, const size_t images);
+static void prsm_conv2d_grad_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_conv2d_grad_tile(prsm_float *const acc, const size_t ld, const prsm_float *const dout, const prsm_float *const col, const size_t ohw, const size_t mr, const size_t nr);
+static void prsm_conv2d_grad_reduce_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static size_t prsm_conv2d_gcd(size_t a, size_t b);
+static int64_t prsm_conv2d_floor_div(const int64_t a, const size_t b);
+static void prsm_conv2d_transpose_axis(struct PrismaConvPhaseAxis *const a, size_t *const k_last, size_t *const k_step, const size_t r, const size_t out, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation);
+static void prsm_conv2d_upsample_axis(struct PrismaConvPhaseAxis *const a, const size_t r, const size_t out, const size_t kernel, const size_t scale, const size_t padding);
+static size_t prsm_conv2d_phase_workspace_size(const size_t c, const size_t oc, const size_t taps, const size_t pixels);
+static void prsm_conv2d_phase_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const struct PrismaConvPhaseAxis *const y, const struct PrismaConvPhaseAxis *const x, prsm_float *const wp, const prsm_tensor_t *const b, const prsm_activate_fn func, const size_t groups, const size_t scale, prsm_float *const ws);
+static void prsm_conv2d_bilinear_src(const size_t dst, const size_t scale, const size_t size, size_t *const i0, size_t *const i1, prsm_float *const l);
+static void prsm_conv2d_phase_gather_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_conv2d_phase_store_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+
+size_t prsm_conv2d_out_dim(const size_t in, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(kernel > 0 && stride > 0 && dilation > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const size_t extent = dilation * (kernel - 1) + 1;
+    const size_t padded = in + 2 * padding;
+    return (padded < extent) ? 0 : (padded - extent) / stride + 1;
+}
+
+size_t prsm_conv2d_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // backward accumulates the weight gradient in one copy per thread
+    const size_t kk = params->kernel[0] * params->kernel[1];
+    const size_t grad_size = prsm_parallel_get_num_threads() * params->out_channels * (params->in_channels / params->groups) * kk;
+
+    // 1x1 stride 1 convolutions read the input directly
+    const bool depthwise = params->groups == params->in_channels && params->groups == params->out_channels;
+    if (prsm_conv2d_is_pointwise(params)) {
+        const size_t forward_size = depthwise ? prsm_conv2d_depthwise_workspace_size(params, in_h, in_w) : 0;
+        return (grad_size > forward_size) ? grad_size : forward_size;
+    }
+
+    // backward unfolds one image at a time
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    const size_t col_size = params->in_channels * kk * oh * ow;
+    size_t forward_size = 0;
+    switch (prsm_conv2d_select_algorithm(params, in_h, in_w)) {
+        case PRSM_CONV_ALGORITHM_DIRECT:
+            forward_size = prsm_conv2d_direct_workspace_size(params, in_h, in_w);
+            break;
+        case PRSM_CONV_ALGORITHM_WINOGRAD_2:
+            forward_size = prsm_conv2d_winograd_workspace_size(params, in_h, in_w, 2) + 16 * params->out_channels * params->in_channels;
+            break;
+        case PRSM_CONV_ALGORITHM_WINOGRAD_4:
+            forward_size = prsm_conv2d_winograd_workspace_size(params, in_h, in_w, 4) + 36 * params->out_channels * params->in_channels;
+            break;
+        case PRSM_CONV_ALGORITHM_DEPTHWISE:
+            forward_size = prsm_conv2d_depthwise_workspace_size(params, in_h, in_w);
+            break;
+        default:
+            break;
+    }
+
+    const size_t backward_size = col_size + grad_size;
+    return (backward_size > forward_size) ? backward_size : forward_size;
+}
+
+size_t prsm_conv2d_workspace_size_ex(const prsm_conv2d_params_t *const params, const size_t in_n, const size_t in_h, const size_t in_w, const bool keep_columns) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // 1x1 stride 1 convolutions have no columns to keep
+    const size_t size = prsm_conv2d_workspace_size(params, in_h, in_w);
+    if (!keep_columns || prsm_conv2d_is_pointwise(params)) {
+        return size;
+    }
+
+    // [columns of every image | gradient of the columns of one image | per-thread dw]
+    const size_t kk = params->kernel[0] * params->kernel[1];
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    const size_t col_size = params->in_channels * kk * oh * ow;
+    const size_t grad_size = prsm_parallel_get_num_threads() * params->out_channels * (params->in_channels / params->groups) * kk;
+    const size_t keep_size = (in_n + 1) * col_size + grad_size;
+    return (keep_size > size) ? keep_size : size;
+}
+
+prsm_tensor_t *prsm_conv2d_im2col(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_conv2d_params_t *const params) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 3, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // calculate output size
+    const size_t c = in->shape[0], h = in->shape[1], w = in->shape[2];
+    const size_t oh = prsm_conv2d_out_dim(h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    const size_t rows = c * params->kernel[0] * params->kernel[1], cols = oh * ow;
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 2, rows, cols)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 2, (size_t[]){rows, cols})) {
+        prsm_tensor_resize(ret, 2, rows, cols);
+    }
+
+    // unfold every channel in parallel
+    struct PrismaConvColContext ctx = {
+        .col = ret->data,
+        .img = in->data,
+        .h = h,
+        .w = w,
+        .oh = oh,
+        .ow = ow,
+        .params = params
+    };
+    const size_t channel_work = (rows / c) * cols;
+    prsm_parallel_for(c, (channel_work == 0 || channel_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / channel_work, prsm_conv2d_im2col_kernel, &ctx);
+
+    return ret;
+}
+
+void prsm_conv2d_col2im(prsm_tensor_t *const out, const prsm_tensor_t *const col, const prsm_conv2d_params_t *const params) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(col), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(out->ndim == 3, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // check shapes
+    const size_t c = out->shape[0], h = out->shape[1], w = out->shape[2];
+    const size_t oh = prsm_conv2d_out_dim(h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    const size_t rows = c * params->kernel[0] * params->kernel[1], cols = oh * ow;
+    VT_ENFORCE(prsm_tensor_shapes_match_ex(col, 2, (size_t[]){rows, cols}), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // fold every channel in parallel: channels do not overlap
+    struct PrismaConvColContext ctx = {
+        .col = col->data,
+        .img = out->data,
+        .h = h,
+        .w = w,
+        .oh = oh,
+        .ow = ow,
+        .params = params
+    };
+    const size_t channel_work = (rows / c) * cols;
+    prsm_parallel_for(c, (channel_work == 0 || channel_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / channel_work, prsm_conv2d_col2im_kernel, &ctx);
+}
+
+prsm_tensor_t *prsm_conv2d_forward(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace) {
+    return prsm_conv2d_forward_ex(out, in, w, b, activation, params, workspace, false);
+}
+
+prsm_tensor_t *prsm_conv2d_forward_ex(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const bool keep_columns) {
+    // check for invalid input
+    struct PrismaConvShape s;
+    prsm_conv2d_check(in, w, params, &s);
+    if (b != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(b), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(b) == s.oc, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 4, s.n, s.oc, s.oh, s.ow)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, (size_t[]){s.n, s.oc, s.oh, s.ow})) {
+        prsm_tensor_resize(ret, 4, s.n, s.oc, s.oh, s.ow);
+    }
+
+    // pick the algorithm for this shape; kept columns need im2col
+    const bool pointwise = prsm_conv2d_is_pointwise(params);
+    const bool keep = keep_columns && !pointwise;
+    const enum PrismaConvAlgorithm algorithm = keep ? PRSM_CONV_ALGORITHM_IM2COL : prsm_conv2d_select_algorithm(params, s.h, s.w);
+    if (algorithm == PRSM_CONV_ALGORITHM_DEPTHWISE) {
+        // one filter per channel: vectorize across channels
+        prsm_conv2d_forward_depthwise(ret, in, w, b, activation, params, workspace, &s);
+        return ret;
+    } else if (algorithm == PRSM_CONV_ALGORITHM_DIRECT) {
+        // few channels: convolve directly without unfolding
+        prsm_conv2d_forward_direct(ret, in, w, b, activation, params, workspace, &s);
+        return ret;
+    } else if (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_2 || algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_4) {
+        // workspace: [transformed weights | transformed tiles of one image]
+        const size_t m = (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_2) ? 2 : 4;
+        const size_t u_size = (m + 2) * (m + 2) * s.oc * s.c;
+        prsm_conv2d_reserve(workspace, u_size + prsm_conv2d_winograd_workspace_size(params, s.h, s.w, m));
+
+        size_t u_shape[] = {(m + 2) * (m + 2), s.oc, s.c};
+        prsm_tensor_t u = { .ndim = 3, .shape = u_shape, .data = workspace->data, .is_view = true };
+        prsm_conv2d_winograd_weights(&u, w, m);
+        prsm_conv2d_winograd_run(ret, in, u.data, b, activation, params, m, workspace->data + u_size);
+        return ret;
+    }
+
+    // reserve columns buffer: one image, or every image if the columns are kept
+    prsm_conv2d_reserve(workspace, prsm_conv2d_workspace_size_ex(params, s.n, s.h, s.w, keep));
+
+    // bias is written first and accumulated by the gemm (beta = 1); activation runs in the epilogue
+    const size_t ohw = s.oh * s.ow;
+    const size_t col_size = s.c * s.kk * ohw;
+    const struct PrismaTensorEpilogue ep = {
+        .func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation)
+    };
+    size_t col_shape[2], w_shape[2], out_shape[2];
+    VT_FOREACH(n, 0, s.n) {
+        // unfold image
+        prsm_float *const img = in->data + n * s.c * s.h * s.w;
+        prsm_float *col = img;
+        if (!pointwise) {
+            col = workspace->data + (keep ? n * col_size : 0);
+            prsm_tensor_t img_view = { .ndim = 3, .shape = in->shape + 1, .data = img, .is_view = true };
+            prsm_tensor_t col_view = prsm_conv2d_view(col, col_shape, s.c * s.kk, ohw);
+            prsm_conv2d_im2col(&col_view, &img_view, params);
+        }
+
+        // out_g = w_g * col_g
+        VT_FOREACH(g, 0, params->groups) {
+            prsm_tensor_t col_g = prsm_conv2d_view(col + g * s.cg * s.kk * ohw, col_shape, s.cg * s.kk, ohw);
+            prsm_tensor_t w_g = prsm_conv2d_view(w->data + g * s.ocg * s.cg * s.kk, w_shape, s.ocg, s.cg * s.kk);
+            prsm_tensor_t out_g = prsm_conv2d_view(ret->data + (n * s.oc + g * s.ocg) * ohw, out_shape, s.ocg, ohw);
+            if (b != NULL) {
+                VT_FOREACH(r, 0, s.ocg) {
+                    const prsm_float bias = b->data[g * s.ocg + r];
+                    prsm_float *const out_row = out_g.data + r * ohw;
+                    VT_FOREACH(j, 0, ohw) {
+                        out_row[j] = bias;
+                    }
+                }
+            }
+            prsm_tensor_gemm_ex(&out_g, &w_g, &col_g, false, false, 1, (b == NULL) ? 0 : 1, &ep);
+        }
+    }
+
+    return ret;
+}
+
+void prsm_conv2d_backward(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace) {
+    prsm_conv2d_backward_ex(dx, dw, db, dout, in, w, params, workspace, false);
+}
+
+void prsm_conv2d_backward_ex(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const bool reuse_columns) {
+    // check for invalid input
+    struct PrismaConvShape s;
+    prsm_conv2d_check(in, w, params, &s);
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dw), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(prsm_tensor_shapes_match_ex(dout, 4, (size_t[]){s.n, s.oc, s.oh, s.ow}), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(prsm_tensor_shapes_match(dw, w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    if (db != NULL) {
+        VT_ENFORCE(prsm_tensor_size(db) == s.oc, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    if (dx != NULL) {
+        VT_ENFORCE(prsm_tensor_shapes_match(dx, in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        prsm_tensor_set_zeros(dx);
+    }
+
+    // workspace: [columns of one image (or of every image if reused) | gradient of the columns | per-thread dw];
+    // without reuse, the columns buffer holds the columns for dw, then their gradient for dx
+    const bool pointwise = prsm_conv2d_is_pointwise(params);
+    const bool reuse = reuse_columns && !pointwise;
+    prsm_conv2d_reserve(workspace, prsm_conv2d_workspace_size_ex(params, s.n, s.h, s.w, reuse));
+
+    const size_t ohw = s.oh * s.ow;
+    const size_t col_size = pointwise ? 0 : s.c * s.kk * ohw;
+    prsm_float *const dcol_buf = workspace->data + (reuse ? s.n * col_size : 0);
+    struct PrismaConvGradContext ctx = {
+        .acc = workspace->data + (reuse ? s.n + 1 : 1) * col_size,
+        .dw = dw->data,
+        .db = (db == NULL) ? NULL : db->data,
+        .dout_all = dout->data,
+        .n = s.n,
+        .oc = s.oc,
+        .groups = params->groups,
+        .ocg = s.ocg,
+        .rows = s.cg * s.kk,
+        .ohw = ohw,
+        .blocks = (s.ocg + PRSM_CONV_GRAD_ROWS - 1) / PRSM_CONV_GRAD_ROWS
+    };
+
+    // one copy of dw per worker of a pass; the split into workers is the same for every pass
+    const size_t images = (reuse || pointwise) ? s.n : 1;
+    const size_t tasks = images * ctx.groups * ctx.blocks, grad_grain = prsm_conv2d_grad_grain(&ctx);
+    const size_t workers = (tasks + grad_grain - 1) / grad_grain, num_threads = prsm_parallel_get_num_threads();
+    ctx.slices = (workers < num_threads) ? workers : num_threads;
+    memset(ctx.acc, 0, ctx.slices * s.oc * ctx.rows * sizeof(prsm_float));
+
+    // the columns of every image are at hand: one pass over the whole batch; pointwise columns are the input
+    if (reuse || pointwise) {
+        prsm_conv2d_grad_run(&ctx, pointwise ? in->data : workspace->data, dout->data, s.n);
+    }
+
+    size_t col_shape[2], w_shape[2], dout_shape[2];
+    VT_FOREACH(n, 0, s.n) {
+        const prsm_float *const dout_n = dout->data + n * s.oc * ohw;
+
+        // unfold image and accumulate its share of dw
+        if (!reuse && !pointwise) {
+            prsm_tensor_t img_view = { .ndim = 3, .shape = in->shape + 1, .data = in->data + n * s.c * s.h * s.w, .is_view = true };
+            prsm_tensor_t col_view = prsm_conv2d_view(workspace->data, col_shape, s.c * s.kk, ohw);
+            prsm_conv2d_im2col(&col_view, &img_view, params);
+            prsm_conv2d_grad_run(&ctx, workspace->data, dout_n, 1);
+        }
+        if (dx == NULL) {
+            continue;
+        }
+
+        // dcol_g = w_g_T * dout_g; pointwise convolutions accumulate into dx directly
+        prsm_float *const dimg = dx->data + n * s.c * s.h * s.w;
+        prsm_float *const dcol = pointwise ? dimg : dcol_buf;
+        VT_FOREACH(g, 0, params->groups) {
+            prsm_tensor_t dcol_g = prsm_conv2d_view(dcol + g * s.cg * s.kk * ohw, col_shape, s.cg * s.kk, ohw);
+            prsm_tensor_t w_g = prsm_conv2d_view(w->data + g * s.ocg * s.cg * s.kk, w_shape, s.ocg, s.cg * s.kk);
+            prsm_tensor_t dout_g = prsm_conv2d_view((prsm_float*)dout_n + g * s.ocg * ohw, dout_shape, s.ocg, ohw);
+            prsm_tensor_gemm(&dcol_g, &w_g, &dout_g, true, false, 1, pointwise ? 1 : 0);
+        }
+
+        // fold columns back into the image
+        if (!pointwise) {
+            prsm_tensor_t dimg_view = { .ndim = 3, .shape = dx->shape + 1, .data = dimg, .is_view = true };
+            prsm_tensor_t dcol_view = prsm_conv2d_view(dcol, col_shape, s.c * s.kk, ohw);
+            prsm_conv2d_col2im(&dimg_view, &dcol_view, params);
+        }
+    }
+
+    // dw = sum of the per-thread copies, db = sum(dout) over images and pixels; every task owns its output channels
+    const size_t reduce_work = ctx.slices * ctx.rows + s.n * ohw;
+    const size_t grain = (reduce_work == 0 || reduce_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / reduce_work;
+    prsm_parallel_for(s.oc, grain, prsm_conv2d_grad_reduce_kernel, &ctx);
+}
+
+enum PrismaConvAlgorithm prsm_conv2d_select_algorithm(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // one filter per channel
+    if (params->groups == params->in_channels && params->groups == params->out_channels) {
+        return PRSM_CONV_ALGORITHM_DEPTHWISE;
+    }
+
+    // grouped layers have few channels per group already; 1x1 layers are a plain gemm
+    if (params->groups != 1 || prsm_conv2d_is_pointwise(params)) {
+        return PRSM_CONV_ALGORITHM_IM2COL;
+    }
+
+    // 3x3 stride 1: Winograd if the transforms are amortized and rounding errors stay within tolerance
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    if (
+        params->in_channels >= PRSM_CONV_WINOGRAD_MIN_CHANNELS && params->out_channels >= PRSM_CONV_WINOGRAD_MIN_CHANNELS &&
+        params->kernel[0] == 3 && params->kernel[1] == 3 && params->stride[0] == 1 && params->stride[1] == 1 &&
+        params->dilation[0] == 1 && params->dilation[1] == 1
+    ) {
+        // prefer the larger tile while there are enough tiles to fill the transform-domain gemms
+        if (((oh + 3) / 4) * ((ow + 3) / 4) >= PRSM_CONV_WINOGRAD_MIN_TILES && prsm_conv2d_winograd_fits(params, 4)) {
+            return PRSM_CONV_ALGORITHM_WINOGRAD_4;
+        } else if (((oh + 1) / 2) * ((ow + 1) / 2) >= PRSM_CONV_WINOGRAD_MIN_TILES && prsm_conv2d_winograd_fits(params, 2)) {
+            return PRSM_CONV_ALGORITHM_WINOGRAD_2;
+        }
+    }
+
+    // im2col pays KH * KW copies of every input pixel; it is won back by gemm only with enough channels
+    const size_t col_bytes = params->in_channels * params->kernel[0] * params->kernel[1] * oh * ow * sizeof(prsm_float);
+    return (params->in_channels <= PRSM_CONV_DIRECT_MAX_CHANNELS || col_bytes > PRSM_CONV_DIRECT_MAX_COL_BYTES)
+        ? PRSM_CONV_ALGORITHM_DIRECT
+        : PRSM_CONV_ALGORITHM_IM2COL;
+}
+
+prsm_tensor_t *prsm_conv2d_to_nchwc(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t block) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // calculate output size
+    const size_t n = in->shape[0], c = in->shape[1], hw = in->shape[2] * in->shape[3];
+    const size_t cb = (c + block - 1) / block;
+    const size_t shape[] = {n, cb, in->shape[2], in->shape[3], block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, 5, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 5, shape)) {
+        prsm_tensor_resize_ex(ret, 5, shape);
+    }
+
+    // interleave channels of every block
+    VT_FOREACH(i, 0, n) {
+        VT_FOREACH(j, 0, cb) {
+            prsm_float *const dst = ret->data + (i * cb + j) * hw * block;
+            VT_FOREACH(k, 0, block) {
+                const size_t ch = j * block + k;
+                const prsm_float *const src = in->data + (i * c + ch) * hw;
+                VT_FOREACH(px, 0, hw) {
+                    dst[px * block + k] = (ch < c) ? src[px] : 0;
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_from_nchwc(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t channels) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(channels > 0 && channels <= in->shape[1] * in->shape[4], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // calculate output size
+    const size_t n = in->shape[0], cb = in->shape[1], block = in->shape[4], hw = in->shape[2] * in->shape[3];
+    const size_t shape[] = {n, channels, in->shape[2], in->shape[3]};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, 4, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, shape)) {
+        prsm_tensor_resize_ex(ret, 4, shape);
+    }
+
+    // deinterleave channels; padding channels are dropped
+    VT_FOREACH(i, 0, n) {
+        VT_FOREACH(ch, 0, channels) {
+            const prsm_float *const src = in->data + (i * cb + ch / block) * hw * block + ch % block;
+            prsm_float *const dst = ret->data + (i * channels + ch) * hw;
+            VT_FOREACH(px, 0, hw) {
+                dst[px] = src[px * block];
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_pack_weights(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t block) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(w->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // calculate output size
+    const size_t oc = w->shape[0], c = w->shape[1], kk = w->shape[2] * w->shape[3];
+    const size_t ocb = (oc + block - 1) / block, cb = (c + block - 1) / block;
+    const size_t shape[] = {ocb, cb, w->shape[2], w->shape[3], block, block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(w->alloctr, 6, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 6, shape)) {
+        prsm_tensor_resize_ex(ret, 6, shape);
+    }
+
+    // (ocb, cb, k, ic, oc) <= (ocb * block + oc, cb * block + ic, k); missing channels are zeros
+    VT_FOREACH(i, 0, ocb) {
+        VT_FOREACH(j, 0, cb) {
+            VT_FOREACH(k, 0, kk) {
+                prsm_float *const dst = ret->data + ((i * cb + j) * kk + k) * block * block;
+                VT_FOREACH(ic, 0, block) {
+                    VT_FOREACH(o, 0, block) {
+                        const size_t och = i * block + o, ich = j * block + ic;
+                        dst[ic * block + o] = (och < oc && ich < c) ? w->data[(och * c + ich) * kk + k] : 0;
+                    }
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_direct(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(params->groups == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // check shapes
+    const size_t block = in->shape[4];
+    const size_t cb = (params->in_channels + block - 1) / block, ocb = (params->out_channels + block - 1) / block;
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->shape[1] == cb, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(w, 6, (size_t[]){ocb, cb, params->kernel[0], params->kernel[1], block, block}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    if (b != NULL) {
+        VT_ENFORCE(prsm_tensor_size(b) == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // calculate output size
+    const size_t n = in->shape[0], h = in->shape[2], w_ = in->shape[3];
+    const size_t oh = prsm_conv2d_out_dim(h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(w_, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    VT_ENFORCE(oh > 0 && ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    const size_t shape[] = {n, ocb, oh, ow, block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, 5, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 5, shape)) {
+        prsm_tensor_resize_ex(ret, 5, shape);
+    }
+
+    // every task computes whole output rows of one channel block
+    struct PrismaConvDirectContext ctx = {
+        .out = ret->data,
+        .in = in->data,
+        .w = w->data,
+        .bias = (b == NULL) ? NULL : b->data,
+        .func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation),
+        .c = params->in_channels,
+        .oc = params->out_channels,
+        .cb = cb,
+        .ocb = ocb,
+        .h = h,
+        .w_ = w_,
+        .oh = oh,
+        .ow = ow,
+        .block = block,
+        .params = params
+    };
+    const size_t row_work = ow * cb * params->kernel[0] * params->kernel[1] * block * block;
+    prsm_parallel_for(n * ocb * oh, (row_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / row_work, prsm_conv2d_direct_kernel, &ctx);
+
+    return ret;
+}
+
+void prsm_conv2d_set_winograd_tolerance(const prsm_float rtol) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(rtol >= 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    gi_winograd_rtol = rtol;
+}
+
+prsm_float prsm_conv2d_get_winograd_tolerance(void) {
+    return gi_winograd_rtol;
+}
+
+prsm_tensor_t *prsm_conv2d_winograd_weights(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t m) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(m == 2 || m == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(w->ndim == 4 && w->shape[2] == 3 && w->shape[3] == 3, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // calculate output size
+    const struct PrismaConvWinograd wg = prsm_conv2d_winograd_get(m);
+    const size_t oc = w->shape[0], c = w->shape[1], a = wg.alpha;
+    const size_t shape[] = {a * a, oc, c};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(w->alloctr, 3, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 3, shape)) {
+        prsm_tensor_resize_ex(ret, 3, shape);
+    }
+
+    // U = G * g * G_T for every (oc, c) pair
+    prsm_float tmp[6 * 3];
+    VT_FOREACH(i, 0, oc * c) {
+        const prsm_float *const g = w->data + i * 9;
+        VT_FOREACH(r, 0, a) {
+            VT_FOREACH(k, 0, 3) {
+                tmp[r * 3 + k] = wg.g[r * 3] * g[k] + wg.g[r * 3 + 1] * g[3 + k] + wg.g[r * 3 + 2] * g[6 + k];
+            }
+        }
+        VT_FOREACH(r, 0, a) {
+            VT_FOREACH(q, 0, a) {
+                ret->data[(r * a + q) * oc * c + i] = tmp[r * 3] * wg.g[q * 3] + tmp[r * 3 + 1] * wg.g[q * 3 + 1] + tmp[r * 3 + 2] * wg.g[q * 3 + 2];
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_winograd(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const u, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t m, prsm_tensor_t *const workspace) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(u), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(m == 2 || m == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->groups == 1 && params->kernel[0] == 3 && params->kernel[1] == 3 && params->stride[0] == 1 && params->stride[1] == 1 &&
+        params->dilation[0] == 1 && params->dilation[1] == 1,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(in->ndim == 4 && in->shape[1] == params->in_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(u, 3, (size_t[]){(m + 2) * (m + 2), params->out_channels, params->in_channels}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    if (b != NULL) {
+        VT_ENFORCE(prsm_tensor_size(b) == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // calculate output size
+    const size_t n = in->shape[0], h = in->shape[2], w = in->shape[3];
+    const size_t oh = prsm_conv2d_out_dim(h, 3, 1, params->padding[0], 1);
+    const size_t ow = prsm_conv2d_out_dim(w, 3, 1, params->padding[1], 1);
+    VT_ENFORCE(oh > 0 && ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 4, n, params->out_channels, oh, ow)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, (size_t[]){n, params->out_channels, oh, ow})) {
+        prsm_tensor_resize(ret, 4, n, params->out_channels, oh, ow);
+    }
+
+    // transform, multiply and transform back one image at a time
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(workspace), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    prsm_conv2d_reserve(workspace, prsm_conv2d_winograd_workspace_size(params, h, w, m));
+    prsm_conv2d_winograd_run(ret, in, u->data, b, activation, params, m, workspace->data);
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_pack_depthwise(prsm_tensor_t *out, const prsm_tensor_t *const w, const size_t block) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(w->ndim == 4 && w->shape[1] == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // calculate output size
+    const size_t c = w->shape[0], kk = w->shape[2] * w->shape[3];
+    const size_t cb = (c + block - 1) / block;
+    const size_t shape[] = {cb, w->shape[2], w->shape[3], block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(w->alloctr, 4, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, shape)) {
+        prsm_tensor_resize_ex(ret, 4, shape);
+    }
+
+    // (cb, k, o) <= (cb * block + o, k); missing channels are zeros
+    VT_FOREACH(i, 0, cb) {
+        VT_FOREACH(k, 0, kk) {
+            prsm_float *const dst = ret->data + (i * kk + k) * block;
+            VT_FOREACH(o, 0, block) {
+                const size_t ch = i * block + o;
+                dst[o] = (ch < c) ? w->data[ch * kk + k] : 0;
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_depthwise(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->groups == params->in_channels && params->groups == params->out_channels,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // check shapes
+    const size_t block = in->shape[4], cb = (params->in_channels + block - 1) / block;
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->shape[1] == cb, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(w, 4, (size_t[]){cb, params->kernel[0], params->kernel[1], block}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    if (b != NULL) {
+        VT_ENFORCE(prsm_tensor_size(b) == params->in_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // calculate output size
+    const size_t n = in->shape[0], h = in->shape[2], w_ = in->shape[3];
+    const size_t oh = prsm_conv2d_out_dim(h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(w_, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    VT_ENFORCE(oh > 0 && ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    const size_t shape[] = {n, cb, oh, ow, block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, 5, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 5, shape)) {
+        prsm_tensor_resize_ex(ret, 5, shape);
+    }
+
+    // every task computes whole output rows of one channel block
+    struct PrismaConvDepthwiseContext ctx = {
+        .out = ret->data,
+        .in = in->data,
+        .w = w->data,
+        .bias = (b == NULL) ? NULL : b->data,
+        .func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation),
+        .c = params->in_channels,
+        .cb = cb,
+        .h = h,
+        .w_ = w_,
+        .oh = oh,
+        .ow = ow,
+        .block = block,
+        .params = params
+    };
+    const size_t row_work = ow * params->kernel[0] * params->kernel[1] * block;
+    prsm_parallel_for(n * cb * oh, (row_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / row_work, prsm_conv2d_depthwise_kernel, &ctx);
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_depthwise_pointwise(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, const size_t out_channels, prsm_tensor_t *const workspace) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dw_w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(pw_w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(workspace), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->groups == params->in_channels && params->groups == params->out_channels && out_channels > 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // check shapes
+    const size_t block = in->shape[4];
+    const size_t cb = (params->in_channels + block - 1) / block, ocb = (out_channels + block - 1) / block;
+    VT_ENFORCE(block == 8 || block == 16, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->shape[1] == cb, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(dw_w, 4, (size_t[]){cb, params->kernel[0], params->kernel[1], block}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(pw_w, 6, (size_t[]){ocb, cb, 1, 1, block, block}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    if (dw_b != NULL) {
+        VT_ENFORCE(prsm_tensor_size(dw_b) == params->in_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    if (pw_b != NULL) {
+        VT_ENFORCE(prsm_tensor_size(pw_b) == out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // calculate output size
+    const size_t n = in->shape[0];
+    const size_t oh = prsm_conv2d_out_dim(in->shape[2], params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in->shape[3], params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    VT_ENFORCE(oh > 0 && ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    const size_t shape[] = {n, ocb, oh, ow, block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, 5, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 5, shape)) {
+        prsm_tensor_resize_ex(ret, 5, shape);
+    }
+
+    // one band per thread
+    const size_t band = prsm_conv2d_depthwise_band(cb, ow, block);
+    prsm_conv2d_reserve(workspace, prsm_parallel_get_num_threads() * cb * band * ow * block);
+    prsm_conv2d_depthwise_pointwise_run(ret, in, dw_w, dw_b, dw_activation, pw_w, pw_b, pw_activation, params, out_channels, workspace->data);
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_conv2d_separable_forward(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace) {
+    // check for invalid input
+    struct PrismaConvShape s;
+    prsm_conv2d_check(in, dw_w, params, &s);
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(pw_w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(workspace), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->groups == params->in_channels && params->groups == params->out_channels,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(pw_w->ndim == 4 && pw_w->shape[1] == s.c && pw_w->shape[2] == 1 && pw_w->shape[3] == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create tensor
+    const size_t oc = pw_w->shape[0];
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 4, s.n, oc, s.oh, s.ow)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, (size_t[]){s.n, oc, s.oh, s.ow})) {
+        prsm_tensor_resize(ret, 4, s.n, oc, s.oh, s.ow);
+    }
+
+    // workspace: [depthwise weights | pointwise weights | packed image | packed output | bands]
+    const size_t block = PRSM_CONV_DIRECT_NR;
+    const size_t cb = (s.c + block - 1) / block, ocb = (oc + block - 1) / block;
+    prsm_conv2d_reserve(workspace, prsm_conv2d_separable_workspace_size(params, oc, s.h, s.w));
+
+    size_t dw_shape[] = {cb, params->kernel[0], params->kernel[1], block};
+    size_t pw_shape[] = {ocb, cb, 1, 1, block, block};
+    size_t in_shape[] = {1, cb, s.h, s.w, block};
+    size_t out_shape[] = {1, ocb, s.oh, s.ow, block};
+    size_t img_shape[] = {1, s.c, s.h, s.w};
+    size_t res_shape[] = {1, oc, s.oh, s.ow};
+    prsm_tensor_t dw_view = { .ndim = 4, .shape = dw_shape, .data = workspace->data, .is_view = true };
+    prsm_tensor_t pw_view = { .ndim = 6, .shape = pw_shape, .data = dw_view.data + cb * s.kk * block, .is_view = true };
+    prsm_tensor_t in_view = { .ndim = 5, .shape = in_shape, .data = pw_view.data + ocb * cb * block * block, .is_view = true };
+    prsm_tensor_t out_view = { .ndim = 5, .shape = out_shape, .data = in_view.data + cb * s.h * s.w * block, .is_view = true };
+    prsm_float *const tmp = out_view.data + ocb * s.oh * s.ow * block;
+    prsm_conv2d_pack_depthwise(&dw_view, dw_w, block);
+    prsm_conv2d_pack_weights(&pw_view, pw_w, block);
+
+    VT_FOREACH(n, 0, s.n) {
+        prsm_tensor_t img = { .ndim = 4, .shape = img_shape, .data = in->data + n * s.c * s.h * s.w, .is_view = true };
+        prsm_tensor_t res = { .ndim = 4, .shape = res_shape, .data = ret->data + n * oc * s.oh * s.ow, .is_view = true };
+        prsm_conv2d_to_nchwc(&in_view, &img, block);
+        prsm_conv2d_depthwise_pointwise_run(&out_view, &in_view, &dw_view, dw_b, dw_activation, &pw_view, pw_b, pw_activation, params, oc, tmp);
+        prsm_conv2d_from_nchwc(&res, &out_view, oc);
+    }
+
+    return ret;
+}
+
+size_t prsm_conv2d_transpose_out_dim(const size_t in, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation, const size_t output_padding) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(in > 0 && kernel > 0 && stride > 0 && dilation > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const size_t full = (in - 1) * stride + dilation * (kernel - 1) + 1 + output_padding;
+    return (full <= 2 * padding) ? 0 : full - 2 * padding;
+}
+
+size_t prsm_conv2d_transpose_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w, const size_t output_padding[2]) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // largest phase along every axis; phases are processed one at a time
+    size_t taps[2] = {0, 0}, outs[2] = {0, 0};
+    const size_t in_size[2] = {in_h, in_w};
+    VT_FOREACH(d, 0, 2) {
+        const size_t out = prsm_conv2d_transpose_out_dim(
+            in_size[d], params->kernel[d], params->stride[d], params->padding[d], params->dilation[d],
+            (output_padding == NULL) ? 0 : output_padding[d]
+        );
+        VT_FOREACH(r, 0, params->stride[d]) {
+            struct PrismaConvPhaseAxis a;
+            size_t k_last, k_step;
+            prsm_conv2d_transpose_axis(&a, &k_last, &k_step, r, out, params->kernel[d], params->stride[d], params->padding[d], params->dilation[d]);
+            taps[d] = (a.taps > taps[d]) ? a.taps : taps[d];
+            outs[d] = (a.out > outs[d]) ? a.out : outs[d];
+        }
+    }
+
+    // [sub-kernel of one phase | phase workspace]
+    const size_t wp_size = params->out_channels * (params->in_channels / params->groups) * taps[0] * taps[1];
+    return wp_size + prsm_conv2d_phase_workspace_size(params->in_channels, params->out_channels, taps[0] * taps[1], outs[0] * outs[1]);
+}
+
+prsm_tensor_t *prsm_conv2d_transpose(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t output_padding[2], prsm_tensor_t *const workspace) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4 && w->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(
+        params->groups > 0 && params->in_channels % params->groups == 0 && params->out_channels % params->groups == 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(in->shape[1] == params->in_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(w, 4, (size_t[]){params->in_channels, params->out_channels / params->groups, params->kernel[0], params->kernel[1]}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+    if (b != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(b), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(b) == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    const size_t op[2] = {(output_padding == NULL) ? 0 : output_padding[0], (output_padding == NULL) ? 0 : output_padding[1]};
+    VT_ENFORCE(op[0] < params->stride[0] && op[1] < params->stride[1], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // output size
+    const size_t n = in->shape[0], oc = params->out_channels;
+    const size_t cg = params->in_channels / params->groups, ocg = oc / params->groups;
+    const size_t oh = prsm_conv2d_transpose_out_dim(in->shape[2], params->kernel[0], params->stride[0], params->padding[0], params->dilation[0], op[0]);
+    const size_t ow = prsm_conv2d_transpose_out_dim(in->shape[3], params->kernel[1], params->stride[1], params->padding[1], params->dilation[1], op[1]);
+    VT_ENFORCE(oh > 0 && ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 4, n, oc, oh, ow)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, (size_t[]){n, oc, oh, ow})) {
+        prsm_tensor_resize(ret, 4, n, oc, oh, ow);
+    }
+
+    // workspace: [sub-kernel of one phase | columns | gemm result]
+    const size_t ws_size = prsm_conv2d_transpose_workspace_size(params, in->shape[2], in->shape[3], op);
+    prsm_conv2d_reserve(workspace, ws_size);
+    const prsm_activate_fn func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation);
+    const size_t kh_size = params->kernel[0], kw_size = params->kernel[1];
+    VT_FOREACH(ry, 0, params->stride[0]) {
+        VT_FOREACH(rx, 0, params->stride[1]) {
+            struct PrismaConvPhaseAxis y, x;
+            size_t ky, ky_step, kx, kx_step;
+            prsm_conv2d_transpose_axis(&y, &ky, &ky_step, ry, oh, kh_size, params->stride[0], params->padding[0], params->dilation[0]);
+            prsm_conv2d_transpose_axis(&x, &kx, &kx_step, rx, ow, kw_size, params->stride[1], params->padding[1], params->dilation[1]);
+            if (y.out == 0 || x.out == 0) {
+                continue;
+            }
+
+            // sub-kernel (OC, C/groups * TY * TX): taps of the phase in descending kernel order
+            prsm_float *dst = workspace->data;
+            VT_FOREACH(g, 0, params->groups) {
+                VT_FOREACH(o, 0, ocg) {
+                    VT_FOREACH(c, 0, cg) {
+                        const prsm_float *const w_oc = w->data + ((g * cg + c) * ocg + o) * kh_size * kw_size;
+                        VT_FOREACH(ty, 0, y.taps) {
+                            VT_FOREACH(tx, 0, x.taps) {
+                                *dst++ = w_oc[(ky - ty * ky_step) * kw_size + kx - tx * kx_step];
+                            }
+                        }
+                    }
+                }
+            }
+            prsm_conv2d_phase_run(ret, in, &y, &x, workspace->data, b, func, params->groups, 0, dst);
+        }
+    }
+
+    return ret;
+}
+
+void prsm_conv2d_transpose_backward(prsm_tensor_t *const dx, prsm_tensor_t *const dw, prsm_tensor_t *const db, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4 && dout->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(dout->shape[0] == in->shape[0] && dout->shape[1] == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    if (dx != NULL) {
+        VT_ENFORCE(prsm_tensor_shapes_match(dx, in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // the mirrored convolution maps the output back onto the input with the same weights
+    prsm_conv2d_params_t mirror = *params;
+    mirror.in_channels = params->out_channels;
+    mirror.out_channels = params->in_channels;
+
+    // dx = conv(dout, w), dw = gradient of that convolution's weights with `in` as its output gradient
+    if (dx != NULL) {
+        prsm_conv2d_forward(dx, dout, w, NULL, PRSM_ACTIVATION_LINEAR, &mirror, workspace);
+    }
+    prsm_conv2d_backward(NULL, dw, NULL, in, dout, w, &mirror, workspace);
+
+    // db = sum(dout) per output channel
+    if (db != NULL) {
+        VT_ENFORCE(prsm_tensor_size(db) == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        const size_t ohw = dout->shape[2] * dout->shape[3];
+        VT_FOREACH(oc, 0, params->out_channels) {
+            prsm_float sum = 0;
+            VT_FOREACH(n, 0, dout->shape[0]) {
+                const prsm_float *const plane = dout->data + (n * params->out_channels + oc) * ohw;
+                VT_FOREACH(i, 0, ohw) {
+                    sum += plane[i];
+                }
+            }
+            db->data[oc] = sum;
+        }
+    }
+}
+
+size_t prsm_conv2d_upsample_workspace_size(const prsm_conv2d_params_t *const params, const enum PrismaConvUpsample mode, const size_t scale, const size_t in_h, const size_t in_w) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mode < PRSM_CONV_UPSAMPLE_COUNT && scale > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const size_t oh = prsm_conv2d_out_dim(in_h * scale, params->kernel[0], 1, params->padding[0], 1);
+    const size_t ow = prsm_conv2d_out_dim(in_w * scale, params->kernel[1], 1, params->padding[1], 1);
+    if (mode == PRSM_CONV_UPSAMPLE_BILINEAR) {
+        // one phase over the upsampled image with the weights as they are, one upsampled channel per thread
+        const size_t planes = prsm_parallel_get_num_threads() * in_h * scale * in_w * scale;
+        return prsm_conv2d_phase_workspace_size(params->in_channels, params->out_channels, params->kernel[0] * params->kernel[1], oh * ow) + planes;
+    }
+
+    // largest phase along every axis
+    size_t taps[2] = {0, 0}, outs[2] = {0, 0};
+    const size_t out_size[2] = {oh, ow};
+    VT_FOREACH(d, 0, 2) {
+        VT_FOREACH(r, 0, scale) {
+            struct PrismaConvPhaseAxis a;
+            prsm_conv2d_upsample_axis(&a, r, out_size[d], params->kernel[d], scale, params->padding[d]);
+            taps[d] = (a.taps > taps[d]) ? a.taps : taps[d];
+            outs[d] = (a.out > outs[d]) ? a.out : outs[d];
+        }
+    }
+
+    // [folded kernel of one phase | phase workspace]
+    const size_t wp_size = params->out_channels * (params->in_channels / params->groups) * taps[0] * taps[1];
+    return wp_size + prsm_conv2d_phase_workspace_size(params->in_channels, params->out_channels, taps[0] * taps[1], outs[0] * outs[1]);
+}
+
+prsm_tensor_t *prsm_conv2d_upsample_conv(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const enum PrismaConvUpsample mode, const size_t scale, prsm_tensor_t *const workspace) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(mode < PRSM_CONV_UPSAMPLE_COUNT && scale > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(
+        params->stride[0] == 1 && params->stride[1] == 1 && params->dilation[0] == 1 && params->dilation[1] == 1,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    if (b != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(b), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(b) == params->out_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // shapes of a convolution over the upsampled image, which only exists as a shape
+    size_t up_shape[] = {in->shape[0], in->shape[1], in->shape[2] * scale, in->shape[3] * scale};
+    const prsm_tensor_t up = { .ndim = 4, .shape = up_shape, .data = in->data, .is_view = true };
+    struct PrismaConvShape s;
+    prsm_conv2d_check(&up, w, params, &s);
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(in->alloctr, 4, s.n, s.oc, s.oh, s.ow)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 4, (size_t[]){s.n, s.oc, s.oh, s.ow})) {
+        prsm_tensor_resize(ret, 4, s.n, s.oc, s.oh, s.ow);
+    }
+
+    prsm_conv2d_reserve(workspace, prsm_conv2d_upsample_workspace_size(params, mode, scale, s.h / scale, s.w / scale));
+    const prsm_activate_fn func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation);
+    const size_t kh_size = params->kernel[0], kw_size = params->kernel[1];
+    if (mode == PRSM_CONV_UPSAMPLE_BILINEAR) {
+        // every thread interpolates one channel at a time and gathers its columns from there
+        const struct PrismaConvPhaseAxis y = { .stride = 1, .out = s.oh, .taps = kh_size, .q = -(int64_t)params->padding[0], .step = 1 };
+        const struct PrismaConvPhaseAxis x = { .stride = 1, .out = s.ow, .taps = kw_size, .q = -(int64_t)params->padding[1], .step = 1 };
+        prsm_conv2d_phase_run(ret, in, &y, &x, w->data, b, func, params->groups, scale, workspace->data);
+        return ret;
+    }
+
+    // nearest: taps of a phase that read the same input pixel share one folded weight
+    VT_FOREACH(ry, 0, scale) {
+        VT_FOREACH(rx, 0, scale) {
+            struct PrismaConvPhaseAxis y, x;
+            prsm_conv2d_upsample_axis(&y, ry, s.oh, kh_size, scale, params->padding[0]);
+            prsm_conv2d_upsample_axis(&x, rx, s.ow, kw_size, scale, params->padding[1]);
+            if (y.out == 0 || x.out == 0) {
+                continue;
+            }
+
+            // folded kernel (OC, C/groups * TY * TX)
+            const size_t taps = y.taps * x.taps;
+            prsm_float *const wp = workspace->data;
+            memset(wp, 0, s.oc * s.cg * taps * sizeof(prsm_float));
+            VT_FOREACH(oc, 0, s.oc * s.cg) {
+                const prsm_float *const w_oc = w->data + oc * s.kk;
+                prsm_float *const wp_oc = wp + oc * taps;
+                VT_FOREACH(kh, 0, kh_size) {
+                    const size_t ty = (size_t)(prsm_conv2d_floor_div((int64_t)(ry + kh) - (int64_t)params->padding[0], scale) - y.q);
+                    VT_FOREACH(kw, 0, kw_size) {
+                        const size_t tx = (size_t)(prsm_conv2d_floor_div((int64_t)(rx + kw) - (int64_t)params->padding[1], scale) - x.q);
+                        wp_oc[ty * x.taps + tx] += w_oc[kh * kw_size + kw];
+                    }
+                }
+            }
+            prsm_conv2d_phase_run(ret, in, &y, &x, wp, b, func, params->groups, 0, wp + s.oc * s.cg * taps);
+        }
+    }
+
+    return ret;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Checks convolution arguments and calculates shapes
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C/groups, KH, KW)
+ * @param  params convolution parameters
+ * @param  shape calculated shapes
+ * @returns None
+ */
+static void prsm_conv2d_check(const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, struct PrismaConvShape *const shape) {
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(w), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4 && w->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(
+        params->groups > 0 && params->in_channels % params->groups == 0 && params->out_channels % params->groups == 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+    VT_ENFORCE(in->shape[1] == params->in_channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(
+        prsm_tensor_shapes_match_ex(w, 4, (size_t[]){params->out_channels, params->in_channels / params->groups, params->kernel[0], params->kernel[1]}),
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES)
+    );
+
+    *shape = (struct PrismaConvShape) {
+        .n = in->shape[0],
+        .c = in->shape[1],
+        .h = in->shape[2],
+        .w = in->shape[3],
+        .oc = params->out_channels,
+        .oh = prsm_conv2d_out_dim(in->shape[2], params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]),
+        .ow = prsm_conv2d_out_dim(in->shape[3], params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]),
+        .cg = params->in_channels / params->groups,
+        .ocg = params->out_channels / params->groups,
+        .kk = params->kernel[0] * params->kernel[1]
+    };
+    VT_ENFORCE(shape->oh > 0 && shape->ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+}
+
+/**
+ * @brief  Checks if the convolution is 1x1 with stride 1 and no padding, i.e., im2col is the identity
+ * @param  params convolution parameters
+ * @returns bool
+ */
+static bool prsm_conv2d_is_pointwise(const prsm_conv2d_params_t *const params) {
+    return params->kernel[0] == 1 && params->kernel[1] == 1
+        && params->stride[0] == 1 && params->stride[1] == 1
+        && params->padding[0] == 0 && params->padding[1] == 0;
+}
+
+/**
+ * @brief  Grows workspace to hold at least `size` elements
+ * @param  workspace workspace tensor
+ * @param  size number of elements
+ * @returns None
+ */
+static void prsm_conv2d_reserve(prsm_tensor_t *const workspace, const size_t size) {
+    if (size == 0) {
+        return;
+    }
+
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(workspace), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (prsm_tensor_size(workspace) < size) {
+        prsm_tensor_resize(workspace, 1, size);
+    }
+}
+
+/**
+ * @brief  Makes a matrix view over raw data
+ * @param  data data pointer
+ * @param  shape shape storage that must outlive the view
+ * @param  rows number of rows
+ * @param  cols number of columns
+ * @returns prsm_tensor_t
+ */
+static prsm_tensor_t prsm_conv2d_view(prsm_float *const data, size_t shape[2], const size_t rows, const size_t cols) {
+    shape[0] = rows;
+    shape[1] = cols;
+
+    prsm_tensor_t tview = {
+        .ndim = 2,
+        .shape = shape,
+        .data = data,
+        .is_view = true
+    };
+
+    return tview;
+}
+
+/**
+ * @brief  Unfolds channels [from, to) of an image
+ * @param  ctx struct PrismaConvColContext*
+ * @param  from first channel
+ * @param  to last channel (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_im2col_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvColContext *const c = ctx;
+    const prsm_conv2d_params_t *const p = c->params;
+    const size_t ohw = c->oh * c->ow;
+
+    VT_FOREACH(ch, from, to) {
+        const prsm_float *const img = c->img + ch * c->h * c->w;
+        VT_FOREACH(kh, 0, p->kernel[0]) {
+            VT_FOREACH(kw, 0, p->kernel[1]) {
+                prsm_float *col = c->col + ((ch * p->kernel[0] + kh) * p->kernel[1] + kw) * ohw;
+                VT_FOREACH(oh, 0, c->oh) {
+                    // input row; unsigned wrap-around marks padding above the image
+                    const size_t ih = oh * p->stride[0] + kh * p->dilation[0] - p->padding[0];
+                    if (oh * p->stride[0] + kh * p->dilation[0] < p->padding[0] || ih >= c->h) {
+                        memset(col, 0, c->ow * sizeof(prsm_float));
+                        col += c->ow;
+                        continue;
+                    }
+
+                    const prsm_float *const img_row = img + ih * c->w;
+                    VT_FOREACH(ow, 0, c->ow) {
+                        const size_t iw_pad = ow * p->stride[1] + kw * p->dilation[1];
+                        const size_t iw = iw_pad - p->padding[1];
+                        col[ow] = (iw_pad < p->padding[1] || iw >= c->w) ? 0 : img_row[iw];
+                    }
+                    col += c->ow;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Folds channels [from, to) of columns back into an image
+ * @param  ctx struct PrismaConvColContext*
+ * @param  from first channel
+ * @param  to last channel (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_col2im_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvColContext *const c = ctx;
+    const prsm_conv2d_params_t *const p = c->params;
+    const size_t ohw = c->oh * c->ow;
+
+    VT_FOREACH(ch, from, to) {
+        prsm_float *const img = c->img + ch * c->h * c->w;
+        VT_FOREACH(kh, 0, p->kernel[0]) {
+            VT_FOREACH(kw, 0, p->kernel[1]) {
+                const prsm_float *col = c->col + ((ch * p->kernel[0] + kh) * p->kernel[1] + kw) * ohw;
+                VT_FOREACH(oh, 0, c->oh) {
+                    const size_t ih_pad = oh * p->stride[0] + kh * p->dilation[0];
+                    const size_t ih = ih_pad - p->padding[0];
+                    if (ih_pad < p->padding[0] || ih >= c->h) {
+                        col += c->ow;
+                        continue;
+                    }
+
+                    prsm_float *const img_row = img + ih * c->w;
+                    VT_FOREACH(ow, 0, c->ow) {
+                        const size_t iw_pad = ow * p->stride[1] + kw * p->dilation[1];
+                        const size_t iw = iw_pad - p->padding[1];
+                        if (iw_pad >= p->padding[1] && iw < c->w) {
+                            img_row[iw] += col[ow];
+                        }
+                    }
+                    col += c->ow;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Returns the channel block of direct convolution: wide blocks only pay off with enough output channels
+ * @param  params convolution parameters
+ * @returns size_t
+ */
+static size_t prsm_conv2d_block(const prsm_conv2d_params_t *const params) {
+    return (params->out_channels >= 16) ? 16 : 8;
+}
+
+/**
+ * @brief  Returns the workspace size of the direct forward pass: packed weights, one packed image and its packed output
+ * @param  params convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @returns size_t
+ */
+static size_t prsm_conv2d_direct_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w) {
+    const size_t block = prsm_conv2d_block(params);
+    const size_t cb = (params->in_channels + block - 1) / block, ocb = (params->out_channels + block - 1) / block;
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    return (ocb * cb * params->kernel[0] * params->kernel[1] * block + cb * in_h * in_w + ocb * oh * ow) * block;
+}
+
+/**
+ * @brief  Forward pass on NCHW tensors through direct convolution, repacking one image at a time
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (OC, C, KH, KW)
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor
+ * @param  s convolution shapes
+ * @returns None
+ */
+static void prsm_conv2d_forward_direct(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const struct PrismaConvShape *const s) {
+    const size_t block = prsm_conv2d_block(params);
+    const size_t cb = (s->c + block - 1) / block, ocb = (s->oc + block - 1) / block;
+    prsm_conv2d_reserve(workspace, prsm_conv2d_direct_workspace_size(params, s->h, s->w));
+
+    // workspace: [packed weights | packed image | packed output]
+    size_t w_shape[] = {ocb, cb, params->kernel[0], params->kernel[1], block, block};
+    size_t in_shape[] = {1, cb, s->h, s->w, block};
+    size_t out_shape[] = {1, ocb, s->oh, s->ow, block};
+    size_t img_shape[] = {1, s->c, s->h, s->w};
+    size_t res_shape[] = {1, s->oc, s->oh, s->ow};
+    prsm_tensor_t w_view = { .ndim = 6, .shape = w_shape, .data = workspace->data, .is_view = true };
+    prsm_tensor_t in_view = { .ndim = 5, .shape = in_shape, .data = w_view.data + ocb * cb * s->kk * block * block, .is_view = true };
+    prsm_tensor_t out_view = { .ndim = 5, .shape = out_shape, .data = in_view.data + cb * s->h * s->w * block, .is_view = true };
+    prsm_conv2d_pack_weights(&w_view, w, block);
+
+    VT_FOREACH(n, 0, s->n) {
+        prsm_tensor_t img = { .ndim = 4, .shape = img_shape, .data = in->data + n * s->c * s->h * s->w, .is_view = true };
+        prsm_tensor_t res = { .ndim = 4, .shape = res_shape, .data = out->data + n * s->oc * s->oh * s->ow, .is_view = true };
+        prsm_conv2d_to_nchwc(&in_view, &img, block);
+        prsm_conv2d_direct(&out_view, &in_view, &w_view, b, activation, params);
+        prsm_conv2d_from_nchwc(&res, &out_view, s->oc);
+    }
+}
+
+/**
+ * @brief  Computes one output row of one channel block in register tiles of TILE pixels by NR output channels
+ * @param  c direct convolution context
+ * @param  n image
+ * @param  ocb output channel block
+ * @param  oh output row
+ * @returns None
+ */
+static void prsm_conv2d_direct_row(const struct PrismaConvDirectContext *const c, const size_t n, const size_t ocb, const size_t oh) {
+    const prsm_conv2d_params_t *const p = c->params;
+    const size_t block = c->block, kh_size = p->kernel[0], kw_size = p->kernel[1];
+    const prsm_float *const in_n = c->in + n * c->cb * c->h * c->w_ * block;
+    const prsm_float *const w_ocb = c->w + ocb * c->cb * kh_size * kw_size * block * block;
+    prsm_float *const out_row = c->out + ((n * c->ocb + ocb) * c->oh + oh) * c->ow * block;
+    const size_t xs = p->stride[1] * block;
+
+    VT_FOREACH_STEP(ow0, 0, c->ow, PRSM_CONV_DIRECT_TILE) {
+        const size_t tile = (c->ow - ow0 < PRSM_CONV_DIRECT_TILE) ? c->ow - ow0 : PRSM_CONV_DIRECT_TILE;
+        VT_FOREACH_STEP(o0, 0, block, PRSM_CONV_DIRECT_NR) {
+            prsm_float acc[PRSM_CONV_DIRECT_TILE][PRSM_CONV_DIRECT_NR] = {{0}};
+
+            VT_FOREACH(icb, 0, c->cb) {
+                // padding channels of the last block are skipped
+                const size_t ic_size = (c->c - icb * block < block) ? c->c - icb * block : block;
+                VT_FOREACH(kh, 0, kh_size) {
+                    const size_t ih_pad = oh * p->stride[0] + kh * p->dilation[0];
+                    const size_t ih = ih_pad - p->padding[0];
+                    if (ih_pad < p->padding[0] || ih >= c->h) {
+                        continue;
+                    }
+
+                    const prsm_float *const in_row = in_n + (icb * c->h + ih) * c->w_ * block;
+                    VT_FOREACH(kw, 0, kw_size) {
+                        const prsm_float *const wk = w_ocb + ((icb * kh_size + kh) * kw_size + kw) * block * block + o0;
+                        const size_t iw_pad = ow0 * p->stride[1] + kw * p->dilation[1];
+
+                        // acc[t] += x[t][ic] * w[ic]: one input channel against a vector of output channels
+                        if (tile == PRSM_CONV_DIRECT_TILE && iw_pad >= p->padding[1] && iw_pad - p->padding[1] + (PRSM_CONV_DIRECT_TILE - 1) * p->stride[1] < c->w_) {
+                            const prsm_float *const x = in_row + (iw_pad - p->padding[1]) * block;
+                            VT_FOREACH(ic, 0, ic_size) {
+                                const prsm_float *const wv = wk + ic * block;
+                                VT_FOREACH(t, 0, PRSM_CONV_DIRECT_TILE) {
+                                    const prsm_float xv = x[t * xs + ic];
+                                    VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                                        acc[t][o] += xv * wv[o];
+                                    }
+                                }
+                            }
+                        } else {
+                            // edge tile: skip pixels that fall into padding
+                            VT_FOREACH(t, 0, tile) {
+                                const size_t iw_t = iw_pad + t * p->stride[1] - p->padding[1];
+                                if (iw_pad + t * p->stride[1] < p->padding[1] || iw_t >= c->w_) {
+                                    continue;
+                                }
+
+                                const prsm_float *const x = in_row + iw_t * block;
+                                VT_FOREACH(ic, 0, ic_size) {
+                                    const prsm_float *const wv = wk + ic * block;
+                                    VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                                        acc[t][o] += x[ic] * wv[o];
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            // epilogue: bias and activation
+            VT_FOREACH(t, 0, tile) {
+                prsm_float *const dst = out_row + (ow0 + t) * block + o0;
+                VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                    const size_t och = ocb * block + o0 + o;
+                    const prsm_float v = acc[t][o] + ((c->bias != NULL && och < c->oc) ? c->bias[och] : 0);
+                    dst[o] = (c->func == NULL) ? v : c->func(v);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Computes output rows [from, to) of a direct convolution
+ * @param  ctx struct PrismaConvDirectContext*
+ * @param  from first row: (n * OCB + ocb) * OH + oh
+ * @param  to last row (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_direct_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvDirectContext *const c = ctx;
+    VT_FOREACH(r, from, to) {
+        const size_t oh = r % c->oh, ocb = (r / c->oh) % c->ocb, n = r / (c->oh * c->ocb);
+        prsm_conv2d_direct_row(c, n, ocb, oh);
+    }
+}
+
+/**
+ * @brief  Returns Winograd F(m x m, 3x3) transforms
+ * @param  m output tile size: 2 or 4
+ * @returns struct PrismaConvWinograd
+ */
+static struct PrismaConvWinograd prsm_conv2d_winograd_get(const size_t m) {
+    return (m == 2)
+        ? (struct PrismaConvWinograd) { .m = 2, .alpha = 4, .bt = gi_winograd_bt2, .g = gi_winograd_g2, .at = gi_winograd_at2 }
+        : (struct PrismaConvWinograd) { .m = 4, .alpha = 6, .bt = gi_winograd_bt4, .g = gi_winograd_g4, .at = gi_winograd_at4 };
+}
+
+/**
+ * @brief  Checks if the rounding error estimate of Winograd F(m x m, 3x3) is within tolerance
+ * @param  params convolution parameters
+ * @param  m output tile size: 2 or 4
+ * @returns bool
+ *
+ * @note the error of a dot product of length C * 9 grows as sqrt(C * 9) * eps; transforms multiply it by a constant
+ */
+static bool prsm_conv2d_winograd_fits(const prsm_conv2d_params_t *const params, const size_t m) {
+    const prsm_float growth = (m == 2) ? PRSM_CONV_WINOGRAD_GROWTH_2 : PRSM_CONV_WINOGRAD_GROWTH_4;
+    return growth * PRSM_SQRT((prsm_float)(params->in_channels * 9)) * PRSM_CONST_EPSILON <= gi_winograd_rtol;
+}
+
+/**
+ * @brief  Returns the workspace size of Winograd transforms of one image: alpha^2 * (C + OC) * tiles
+ * @param  params convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @param  m output tile size: 2 or 4
+ * @returns size_t
+ */
+static size_t prsm_conv2d_winograd_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w, const size_t m) {
+    const size_t oh = prsm_conv2d_out_dim(in_h, 3, 1, params->padding[0], 1);
+    const size_t ow = prsm_conv2d_out_dim(in_w, 3, 1, params->padding[1], 1);
+    const size_t tiles = ((oh + m - 1) / m) * ((ow + m - 1) / m);
+    return (m + 2) * (m + 2) * (params->in_channels + params->out_channels) * tiles;
+}
+
+/**
+ * @brief  Runs Winograd convolution image by image
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  u transformed weights: (alpha^2, OC, C)
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters
+ * @param  m output tile size: 2 or 4
+ * @param  ws scratch buffer of `prsm_conv2d_winograd_workspace_size()` elements
+ * @returns None
+ */
+static void prsm_conv2d_winograd_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_float *const u, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, const size_t m, prsm_float *const ws) {
+    const struct PrismaConvWinograd wg = prsm_conv2d_winograd_get(m);
+    const size_t c = params->in_channels, oc = params->out_channels, aa = wg.alpha * wg.alpha;
+    const size_t h = in->shape[2], w = in->shape[3], oh = out->shape[2], ow = out->shape[3];
+    const size_t th = (oh + m - 1) / m, tw = (ow + m - 1) / m, tiles = th * tw;
+
+    // workspace: [V: (alpha^2, C, P) | M: (alpha^2, OC, P)]
+    struct PrismaConvWinogradContext ctx = {
+        .wg = &wg,
+        .v = ws,
+        .mm = ws + aa * c * tiles,
+        .bias = (b == NULL) ? NULL : b->data,
+        .func = (activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(activation),
+        .c = c,
+        .oc = oc,
+        .h = h,
+        .w = w,
+        .oh = oh,
+        .ow = ow,
+        .th = th,
+        .tw = tw,
+        .pad_h = params->padding[0],
+        .pad_w = params->padding[1]
+    };
+    const size_t channel_work = tiles * aa * wg.alpha * 2;
+    const size_t grain = (channel_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / channel_work;
+
+    size_t u_shape[2], v_shape[2], m_shape[2];
+    VT_FOREACH(n, 0, in->shape[0]) {
+        ctx.img = in->data + n * c * h * w;
+        ctx.out = out->data + n * oc * oh * ow;
+
+        // V = B_T * d * B for every channel and tile
+        prsm_parallel_for(c, grain, prsm_conv2d_winograd_input_kernel, &ctx);
+
+        // M_xi = U_xi * V_xi: alpha^2 independent gemms
+        VT_FOREACH(xi, 0, aa) {
+            prsm_tensor_t u_xi = prsm_conv2d_view((prsm_float*)u + xi * oc * c, u_shape, oc, c);
+            prsm_tensor_t v_xi = prsm_conv2d_view(ctx.v + xi * c * tiles, v_shape, c, tiles);
+            prsm_tensor_t m_xi = prsm_conv2d_view((prsm_float*)ctx.mm + xi * oc * tiles, m_shape, oc, tiles);
+            prsm_tensor_gemm(&m_xi, &u_xi, &v_xi, false, false, 1, 0);
+        }
+
+        // Y = A_T * M * A for every output channel and tile
+        prsm_parallel_for(oc, grain, prsm_conv2d_winograd_output_kernel, &ctx);
+    }
+}
+
+/**
+ * @brief  Transforms input tiles of channels [from, to): V = B_T * d * B
+ * @param  ctx struct PrismaConvWinogradContext*
+ * @param  from first channel
+ * @param  to last channel (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_winograd_input_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvWinogradContext *const c = ctx;
+    const size_t a = c->wg->alpha, m = c->wg->m, tiles = c->th * c->tw;
+    const prsm_float *const bt = c->wg->bt;
+
+    prsm_float d[6 * 6], tmp[6 * 6];
+    VT_FOREACH(ch, from, to) {
+        const prsm_float *const img = c->img + ch * c->h * c->w;
+        VT_FOREACH(p, 0, tiles) {
+            // gather tile; out of image positions are padding
+            const size_t ih0 = (p / c->tw) * m, iw0 = (p % c->tw) * m;
+            VT_FOREACH(r, 0, a) {
+                const size_t ih = ih0 + r - c->pad_h;
+                const bool row_in = ih0 + r >= c->pad_h && ih < c->h;
+                VT_FOREACH(q, 0, a) {
+                    const size_t iw = iw0 + q - c->pad_w;
+                    d[r * a + q] = (row_in && iw0 + q >= c->pad_w && iw < c->w) ? img[ih * c->w + iw] : 0;
+                }
+            }
+
+            // tmp = B_T * d
+            VT_FOREACH(r, 0, a) {
+                VT_FOREACH(q, 0, a) {
+                    prsm_float sum = 0;
+                    VT_FOREACH(k, 0, a) {
+                        sum += bt[r * a + k] * d[k * a + q];
+                    }
+                    tmp[r * a + q] = sum;
+                }
+            }
+
+            // V = tmp * B
+            VT_FOREACH(r, 0, a) {
+                VT_FOREACH(q, 0, a) {
+                    prsm_float sum = 0;
+                    VT_FOREACH(k, 0, a) {
+                        sum += tmp[r * a + k] * bt[q * a + k];
+                    }
+                    c->v[((r * a + q) * c->c + ch) * tiles + p] = sum;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Transforms output tiles of channels [from, to) back: Y = A_T * M * A, then applies bias and activation
+ * @param  ctx struct PrismaConvWinogradContext*
+ * @param  from first output channel
+ * @param  to last output channel (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_winograd_output_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvWinogradContext *const c = ctx;
+    const size_t a = c->wg->alpha, m = c->wg->m, tiles = c->th * c->tw;
+    const prsm_float *const at = c->wg->at;
+
+    prsm_float mt[6 * 6], tmp[4 * 6];
+    VT_FOREACH(och, from, to) {
+        prsm_float *const out = c->out + och * c->oh * c->ow;
+        const prsm_float bias = (c->bias == NULL) ? 0 : c->bias[och];
+        VT_FOREACH(p, 0, tiles) {
+            // gather transformed tile
+            VT_FOREACH(xi, 0, a * a) {
+                mt[xi] = c->mm[(xi * c->oc + och) * tiles + p];
+            }
+
+            // tmp = A_T * M
+            VT_FOREACH(r, 0, m) {
+                VT_FOREACH(q, 0, a) {
+                    prsm_float sum = 0;
+                    VT_FOREACH(k, 0, a) {
+                        sum += at[r * a + k] * mt[k * a + q];
+                    }
+                    tmp[r * a + q] = sum;
+                }
+            }
+
+            // Y = tmp * A, clipped at the bottom and right edges
+            const size_t oh0 = (p / c->tw) * m, ow0 = (p % c->tw) * m;
+            VT_FOREACH(r, 0, m) {
+                if (oh0 + r >= c->oh) {
+                    break;
+                }
+                VT_FOREACH(q, 0, m) {
+                    if (ow0 + q >= c->ow) {
+                        break;
+                    }
+                    prsm_float sum = bias;
+                    VT_FOREACH(k, 0, a) {
+                        sum += tmp[r * a + k] * at[q * a + k];
+                    }
+                    out[(oh0 + r) * c->ow + ow0 + q] = (c->func == NULL) ? sum : c->func(sum);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Returns output rows per band of the fused depthwise-pointwise kernel so that a band fits in L1
+ * @param  cb number of channel blocks
+ * @param  ow output width
+ * @param  block channel block size
+ * @returns size_t
+ */
+static size_t prsm_conv2d_depthwise_band(const size_t cb, const size_t ow, const size_t block) {
+    const size_t row_bytes = cb * ow * block * sizeof(prsm_float);
+    return (row_bytes >= PRSM_CONV_BAND_BYTES) ? 1 : PRSM_CONV_BAND_BYTES / row_bytes;
+}
+
+/**
+ * @brief  Returns the workspace size of the depthwise forward pass on NCHW: packed weights, one packed image and its output
+ * @param  params convolution parameters
+ * @param  in_h input height
+ * @param  in_w input width
+ * @returns size_t
+ */
+static size_t prsm_conv2d_depthwise_workspace_size(const prsm_conv2d_params_t *const params, const size_t in_h, const size_t in_w) {
+    const size_t block = PRSM_CONV_DIRECT_NR;
+    const size_t cb = (params->in_channels + block - 1) / block;
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    return cb * (params->kernel[0] * params->kernel[1] + in_h * in_w + oh * ow) * block;
+}
+
+/**
+ * @brief  Returns the workspace size of `prsm_conv2d_separable_forward()`
+ * @param  params depthwise convolution parameters
+ * @param  out_channels pointwise output channels
+ * @param  in_h input height
+ * @param  in_w input width
+ * @returns size_t
+ */
+static size_t prsm_conv2d_separable_workspace_size(const prsm_conv2d_params_t *const params, const size_t out_channels, const size_t in_h, const size_t in_w) {
+    const size_t block = PRSM_CONV_DIRECT_NR;
+    const size_t cb = (params->in_channels + block - 1) / block, ocb = (out_channels + block - 1) / block;
+    const size_t oh = prsm_conv2d_out_dim(in_h, params->kernel[0], params->stride[0], params->padding[0], params->dilation[0]);
+    const size_t ow = prsm_conv2d_out_dim(in_w, params->kernel[1], params->stride[1], params->padding[1], params->dilation[1]);
+    const size_t bands = prsm_parallel_get_num_threads() * cb * prsm_conv2d_depthwise_band(cb, ow, block) * ow;
+    return (cb * params->kernel[0] * params->kernel[1] + ocb * cb * block + cb * in_h * in_w + ocb * oh * ow + bands) * block;
+}
+
+/**
+ * @brief  Forward pass on NCHW tensors through the depthwise kernel, repacking one image at a time
+ * @param  out output tensor of shape (N, C, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  w weights of shape (C, 1, KH, KW)
+ * @param  b bias of shape (C) or `NULL`
+ * @param  activation activation applied to the output
+ * @param  params convolution parameters
+ * @param  workspace scratch tensor
+ * @param  s convolution shapes
+ * @returns None
+ */
+static void prsm_conv2d_forward_depthwise(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_tensor_t *const b, const enum PrismaActivation activation, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace, const struct PrismaConvShape *const s) {
+    const size_t block = PRSM_CONV_DIRECT_NR, cb = (s->c + block - 1) / block;
+    prsm_conv2d_reserve(workspace, prsm_conv2d_depthwise_workspace_size(params, s->h, s->w));
+
+    // workspace: [packed weights | packed image | packed output]
+    size_t w_shape[] = {cb, params->kernel[0], params->kernel[1], block};
+    size_t in_shape[] = {1, cb, s->h, s->w, block};
+    size_t out_shape[] = {1, cb, s->oh, s->ow, block};
+    size_t img_shape[] = {1, s->c, s->h, s->w};
+    size_t res_shape[] = {1, s->c, s->oh, s->ow};
+    prsm_tensor_t w_view = { .ndim = 4, .shape = w_shape, .data = workspace->data, .is_view = true };
+    prsm_tensor_t in_view = { .ndim = 5, .shape = in_shape, .data = w_view.data + cb * s->kk * block, .is_view = true };
+    prsm_tensor_t out_view = { .ndim = 5, .shape = out_shape, .data = in_view.data + cb * s->h * s->w * block, .is_view = true };
+    prsm_conv2d_pack_depthwise(&w_view, w, block);
+
+    VT_FOREACH(n, 0, s->n) {
+        prsm_tensor_t img = { .ndim = 4, .shape = img_shape, .data = in->data + n * s->c * s->h * s->w, .is_view = true };
+        prsm_tensor_t res = { .ndim = 4, .shape = res_shape, .data = out->data + n * s->c * s->oh * s->ow, .is_view = true };
+        prsm_conv2d_to_nchwc(&in_view, &img, block);
+        prsm_conv2d_depthwise(&out_view, &in_view, &w_view, b, activation, params);
+        prsm_conv2d_from_nchwc(&res, &out_view, s->c);
+    }
+}
+
+/**
+ * @brief  Runs the fused depthwise-pointwise kernel over bands of output rows
+ * @param  out output tensor of shape (N, OCB, OH, OW, block)
+ * @param  in input tensor of shape (N, CB, H, W, block)
+ * @param  dw_w packed depthwise weights
+ * @param  dw_b depthwise bias or `NULL`
+ * @param  dw_activation depthwise activation
+ * @param  pw_w packed pointwise weights
+ * @param  pw_b pointwise bias or `NULL`
+ * @param  pw_activation pointwise activation
+ * @param  params depthwise convolution parameters
+ * @param  out_channels pointwise output channels
+ * @param  tmp per-thread bands: num_threads * (CB, band, OW, block)
+ * @returns None
+ */
+static void prsm_conv2d_depthwise_pointwise_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const prsm_tensor_t *const dw_w, const prsm_tensor_t *const dw_b, const enum PrismaActivation dw_activation, const prsm_tensor_t *const pw_w, const prsm_tensor_t *const pw_b, const enum PrismaActivation pw_activation, const prsm_conv2d_params_t *const params, const size_t out_channels, prsm_float *const tmp) {
+    const size_t block = in->shape[4], cb = in->shape[1], oh = out->shape[2], ow = out->shape[3];
+    struct PrismaConvDepthwiseContext ctx = {
+        .out = out->data,
+        .in = in->data,
+        .w = dw_w->data,
+        .bias = (dw_b == NULL) ? NULL : dw_b->data,
+        .func = (dw_activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(dw_activation),
+        .c = params->in_channels,
+        .cb = cb,
+        .h = in->shape[2],
+        .w_ = in->shape[3],
+        .oh = oh,
+        .ow = ow,
+        .block = block,
+        .params = params,
+        .pw = pw_w->data,
+        .pw_bias = (pw_b == NULL) ? NULL : pw_b->data,
+        .pw_func = (pw_activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(pw_activation),
+        .oc = out_channels,
+        .ocb = out->shape[1],
+        .band = prsm_conv2d_depthwise_band(cb, ow, block),
+        .tmp = tmp
+    };
+
+    // every task computes one band of one image
+    const size_t bands = (oh + ctx.band - 1) / ctx.band;
+    prsm_parallel_for(in->shape[0] * bands, 1, prsm_conv2d_depthwise_pointwise_kernel, &ctx);
+}
+
+/**
+ * @brief  Computes one output row of one channel block of a depthwise convolution
+ * @param  c depthwise convolution context
+ * @param  n image
+ * @param  cb channel block
+ * @param  oh output row
+ * @param  dst output row: (OW, block)
+ * @returns None
+ */
+static void prsm_conv2d_depthwise_row(const struct PrismaConvDepthwiseContext *const c, const size_t n, const size_t cb, const size_t oh, prsm_float *const dst) {
+    const prsm_conv2d_params_t *const p = c->params;
+    const size_t block = c->block, kh_size = p->kernel[0], kw_size = p->kernel[1];
+    const prsm_float *const in_cb = c->in + (n * c->cb + cb) * c->h * c->w_ * block;
+    const prsm_float *const w_cb = c->w + cb * kh_size * kw_size * block;
+
+    VT_FOREACH(ow, 0, c->ow) {
+        VT_FOREACH_STEP(o0, 0, block, PRSM_CONV_DIRECT_NR) {
+            // acc += x * w: every kernel tap is one multiply-add across channels
+            prsm_float acc[PRSM_CONV_DIRECT_NR] = {0};
+            VT_FOREACH(kh, 0, kh_size) {
+                const size_t ih_pad = oh * p->stride[0] + kh * p->dilation[0];
+                const size_t ih = ih_pad - p->padding[0];
+                if (ih_pad < p->padding[0] || ih >= c->h) {
+                    continue;
+                }
+
+                const prsm_float *const in_row = in_cb + ih * c->w_ * block + o0;
+                VT_FOREACH(kw, 0, kw_size) {
+                    const size_t iw_pad = ow * p->stride[1] + kw * p->dilation[1];
+                    const size_t iw = iw_pad - p->padding[1];
+                    if (iw_pad < p->padding[1] || iw >= c->w_) {
+                        continue;
+                    }
+
+                    const prsm_float *const x = in_row + iw * block;
+                    const prsm_float *const wv = w_cb + (kh * kw_size + kw) * block + o0;
+                    VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                        acc[o] += x[o] * wv[o];
+                    }
+                }
+            }
+
+            // epilogue: bias and activation
+            prsm_float *const out = dst + ow * block + o0;
+            VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                const size_t ch = cb * block + o0 + o;
+                const prsm_float v = acc[o] + ((c->bias != NULL && ch < c->c) ? c->bias[ch] : 0);
+                out[o] = (c->func == NULL) ? v : c->func(v);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Computes output rows [from, to) of a depthwise convolution
+ * @param  ctx struct PrismaConvDepthwiseContext*
+ * @param  from first row: (n * CB + cb) * OH + oh
+ * @param  to last row (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_depthwise_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvDepthwiseContext *const c = ctx;
+    VT_FOREACH(r, from, to) {
+        const size_t oh = r % c->oh, cb = (r / c->oh) % c->cb, n = r / (c->oh * c->cb);
+        prsm_conv2d_depthwise_row(c, n, cb, oh, c->out + r * c->ow * c->block);
+    }
+}
+
+/**
+ * @brief  Computes bands [from, to) of the fused depthwise-pointwise convolution
+ * @param  ctx struct PrismaConvDepthwiseContext*
+ * @param  from first band: n * bands + band
+ * @param  to last band (exclusive)
+ * @param  tid worker id; selects the band buffer
+ * @returns None
+ */
+static void prsm_conv2d_depthwise_pointwise_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    const struct PrismaConvDepthwiseContext *const c = ctx;
+    const size_t block = c->block, bands = (c->oh + c->band - 1) / c->band;
+    prsm_float *const tmp = c->tmp + tid * c->cb * c->band * c->ow * block;
+
+    VT_FOREACH(i, from, to) {
+        const size_t n = i / bands, r0 = (i % bands) * c->band;
+        const size_t rows = (c->oh - r0 < c->band) ? c->oh - r0 : c->band;
+        const size_t pixels = rows * c->ow;
+
+        // depthwise band: (CB, rows, OW, block)
+        VT_FOREACH(cb, 0, c->cb) {
+            VT_FOREACH(r, 0, rows) {
+                prsm_conv2d_depthwise_row(c, n, cb, r0 + r, tmp + (cb * c->band + r) * c->ow * block);
+            }
+        }
+
+        // pointwise on the band while it is in cache: acc[t] += tmp[t][ic] * pw[ic]
+        VT_FOREACH(ocb, 0, c->ocb) {
+            prsm_float *const out = c->out + ((n * c->ocb + ocb) * c->oh + r0) * c->ow * block;
+            const prsm_float *const pw_ocb = c->pw + ocb * c->cb * block * block;
+            VT_FOREACH_STEP(p0, 0, pixels, PRSM_CONV_DIRECT_TILE) {
+                const size_t tile = (pixels - p0 < PRSM_CONV_DIRECT_TILE) ? pixels - p0 : PRSM_CONV_DIRECT_TILE;
+                VT_FOREACH_STEP(o0, 0, block, PRSM_CONV_DIRECT_NR) {
+                    prsm_float acc[PRSM_CONV_DIRECT_TILE][PRSM_CONV_DIRECT_NR] = {{0}};
+                    VT_FOREACH(cb, 0, c->cb) {
+                        const size_t ic_size = (c->c - cb * block < block) ? c->c - cb * block : block;
+                        const prsm_float *const x = tmp + (cb * c->band * c->ow + p0) * block;
+                        const prsm_float *const w_cb = pw_ocb + cb * block * block + o0;
+                        if (tile == PRSM_CONV_DIRECT_TILE) {
+                            VT_FOREACH(ic, 0, ic_size) {
+                                const prsm_float *const wv = w_cb + ic * block;
+                                VT_FOREACH(t, 0, PRSM_CONV_DIRECT_TILE) {
+                                    const prsm_float xv = x[t * block + ic];
+                                    VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                                        acc[t][o] += xv * wv[o];
+                                    }
+                                }
+                            }
+                        } else {
+                            VT_FOREACH(ic, 0, ic_size) {
+                                const prsm_float *const wv = w_cb + ic * block;
+                                VT_FOREACH(t, 0, tile) {
+                                    const prsm_float xv = x[t * block + ic];
+                                    VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                                        acc[t][o] += xv * wv[o];
+                                    }
+                                }
+                            }
+                        }
+                    }
+
+                    // epilogue: bias and activation
+                    VT_FOREACH(t, 0, tile) {
+                        prsm_float *const dst = out + (p0 + t) * block + o0;
+                        VT_FOREACH(o, 0, PRSM_CONV_DIRECT_NR) {
+                            const size_t och = ocb * block + o0 + o;
+                            const prsm_float v = acc[t][o] + ((c->pw_bias != NULL && och < c->oc) ? c->pw_bias[och] : 0);
+                            dst[o] = (c->pw_func == NULL) ? v : c->pw_func(v);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Returns the number of (image, output channel block) tasks per weight gradient worker
+ * @param  c weight gradient context
+ * @returns size_t
+ */
+static size_t prsm_conv2d_grad_grain(const struct PrismaConvGradContext *const c) {
+    const size_t task_work = PRSM_CONV_GRAD_ROWS * c->rows * c->ohw;
+    return (task_work == 0 || task_work >= PRSM_CONV_GRAD_GRAIN) ? 1 : PRSM_CONV_GRAD_GRAIN / task_work;
+}
+
+/**
+ * @brief  Accumulates dout * col_T of a run of images into the per-thread copies of dw
+ * @param  c weight gradient context
+ * @param  col columns of the images: (images, C * KH * KW, OH * OW)
+ * @param  dout output gradient of the images: (images, OC, OH, OW)
+ * @param  images number of images
+ * @returns None
+ */
+static void prsm_conv2d_grad_run(struct PrismaConvGradContext *const c, const prsm_float *const col, const prsm_float *const dout, const size_t images) {
+    c->col = col;
+    c->dout = dout;
+    prsm_parallel_for(images * c->groups * c->blocks, prsm_conv2d_grad_grain(c), prsm_conv2d_grad_kernel, c);
+}
+
+/**
+ * @brief  Weight gradient worker: tasks are (image, group, output channel block) triples
+ * @param  ctx struct PrismaConvGradContext
+ * @param  from first task
+ * @param  to last task (exclusive)
+ * @param  tid worker index: selects the copy of dw
+ * @returns None
+ */
+static void prsm_conv2d_grad_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    const struct PrismaConvGradContext *const c = ctx;
+    prsm_float *const acc = c->acc + tid * c->oc * c->rows;
+    const size_t per_image = c->groups * c->blocks;
+    VT_FOREACH(t, from, to) {
+        const size_t n = t / per_image, g = (t % per_image) / c->blocks, ob = t % c->blocks;
+        const size_t r0 = ob * PRSM_CONV_GRAD_ROWS;
+        const size_t r1 = (r0 + PRSM_CONV_GRAD_ROWS < c->ocg) ? r0 + PRSM_CONV_GRAD_ROWS : c->ocg;
+
+        // acc_g[r, k] += dot(dout_g[r], col_g[k]): both operands are contiguous rows
+        const prsm_float *const col_g = c->col + (n * c->groups + g) * c->rows * c->ohw;
+        const prsm_float *const dout_g = c->dout + (n * c->oc + g * c->ocg) * c->ohw;
+        prsm_float *const acc_g = acc + g * c->ocg * c->rows;
+        VT_FOREACH_STEP(r, r0, r1, PRSM_CONV_GRAD_MR) {
+            const size_t mr = (r + PRSM_CONV_GRAD_MR < r1) ? PRSM_CONV_GRAD_MR : r1 - r;
+            VT_FOREACH_STEP(k, 0, c->rows, PRSM_CONV_GRAD_NR) {
+                const size_t nr = (k + PRSM_CONV_GRAD_NR < c->rows) ? PRSM_CONV_GRAD_NR : c->rows - k;
+                prsm_conv2d_grad_tile(acc_g + r * c->rows + k, c->rows, dout_g + r * c->ohw, col_g + k * c->ohw, c->ohw, mr, nr);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Accumulates a register tile of dot products: acc[i, j] += dot(dout[i], col[j])
+ * @param  acc accumulator tile with a leading dimension of `ld`
+ * @param  ld leading dimension of acc
+ * @param  dout mr rows of the output gradient
+ * @param  col nr rows of the columns
+ * @param  ohw row length
+ * @param  mr number of rows of the tile
+ * @param  nr number of columns of the tile
+ * @returns None
+ */
+static void prsm_conv2d_grad_tile(prsm_float *const acc, const size_t ld, const prsm_float *const dout, const prsm_float *const col, const size_t ohw, const size_t mr, const size_t nr) {
+    prsm_float sum[PRSM_CONV_GRAD_MR][PRSM_CONV_GRAD_NR] = {{0}};
+    size_t p0 = 0;
+    if (mr == PRSM_CONV_GRAD_MR && nr == PRSM_CONV_GRAD_NR) {
+        // full tile: partial sums are kept per lane of a run of pixels, every loaded run is used MR or NR times
+        prsm_float lanes[PRSM_CONV_GRAD_MR][PRSM_CONV_GRAD_NR][PRSM_CONV_GRAD_LANES] = {{{0}}};
+        for (; p0 + PRSM_CONV_GRAD_LANES <= ohw; p0 += PRSM_CONV_GRAD_LANES) {
+            VT_FOREACH(i, 0, PRSM_CONV_GRAD_MR) {
+                VT_FOREACH(j, 0, PRSM_CONV_GRAD_NR) {
+                    VT_FOREACH(l, 0, PRSM_CONV_GRAD_LANES) {
+                        lanes[i][j][l] += dout[i * ohw + p0 + l] * col[j * ohw + p0 + l];
+                    }
+                }
+            }
+        }
+        VT_FOREACH(i, 0, PRSM_CONV_GRAD_MR) {
+            VT_FOREACH(j, 0, PRSM_CONV_GRAD_NR) {
+                VT_FOREACH(l, 0, PRSM_CONV_GRAD_LANES) {
+                    sum[i][j] += lanes[i][j][l];
+                }
+            }
+        }
+    }
+
+    // partial tiles and the remaining pixels
+    VT_FOREACH(i, 0, mr) {
+        VT_FOREACH(j, 0, nr) {
+            VT_FOREACH(p, p0, ohw) {
+                sum[i][j] += dout[i * ohw + p] * col[j * ohw + p];
+            }
+        }
+    }
+
+    VT_FOREACH(i, 0, mr) {
+        VT_FOREACH(j, 0, nr) {
+            acc[i * ld + j] += sum[i][j];
+        }
+    }
+}
+
+/**
+ * @brief  Sums the per-thread copies of dw and the output gradient into db for a range of output channels
+ * @param  ctx struct PrismaConvGradContext
+ * @param  from first output channel
+ * @param  to last output channel (exclusive)
+ * @param  tid unused
+ * @returns None
+ */
+static void prsm_conv2d_grad_reduce_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvGradContext *const c = ctx;
+    const size_t wsize = c->oc * c->rows;
+    VT_FOREACH(oc, from, to) {
+        // copies are summed in worker order, so the result only depends on the number of threads
+        prsm_float *const dw_row = c->dw + oc * c->rows;
+        VT_FOREACH(k, 0, c->rows) {
+            dw_row[k] = 0;
+        }
+        VT_FOREACH(t, 0, c->slices) {
+            const prsm_float *const acc_row = c->acc + t * wsize + oc * c->rows;
+            VT_FOREACH(k, 0, c->rows) {
+                dw_row[k] += acc_row[k];
+            }
+        }
+        if (c->db == NULL) {
+            continue;
+        }
+
+        prsm_float sum = 0;
+        VT_FOREACH(n, 0, c->n) {
+            const prsm_float *const dout_row = c->dout_all + (n * c->oc + oc) * c->ohw;
+            VT_FOREACH(j, 0, c->ohw) {
+                sum += dout_row[j];
+            }
+        }
+        c->db[oc] = sum;
+    }
+}
+
+/**
+ * @brief  Greatest common divisor
+ * @param  a first number
+ * @param  b second number
+ * @returns size_t
+ */
+static size_t prsm_conv2d_gcd(size_t a, size_t b) {
+    while (b != 0) {
+        const size_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+/**
+ * @brief  Signed division rounding towards negative infinity
+ * @param  a dividend
+ * @param  b divisor
+ * @returns int64_t
+ */
+static int64_t prsm_conv2d_floor_div(const int64_t a, const size_t b) {
+    const int64_t d = (int64_t)b;
+    return (a >= 0) ? a / d : -((-a + d - 1) / d);
+}
+
+/**
+ * @brief  Plans one axis of a transposed convolution phase
+ * @param  a planned axis
+ * @param  k_last kernel index of the first tap; tap t uses index k_last - t * k_step
+ * @param  k_step kernel index distance between taps
+ * @param  r phase: first output index
+ * @param  out output size
+ * @param  kernel kernel size
+ * @param  stride stride
+ * @param  padding padding
+ * @param  dilation dilation
+ * @returns None
+ *
+ * @note output o = i * stride - padding + k * dilation receives input i through tap k, so output r + j * stride
+ * only sees the kernel indices with (r + padding - k * dilation) divisible by the stride
+ */
+static void prsm_conv2d_transpose_axis(struct PrismaConvPhaseAxis *const a, size_t *const k_last, size_t *const k_step, const size_t r, const size_t out, const size_t kernel, const size_t stride, const size_t padding, const size_t dilation) {
+    const size_t g = prsm_conv2d_gcd(stride, dilation);
+    *a = (struct PrismaConvPhaseAxis) {
+        .r = r,
+        .stride = stride,
+        .out = (out > r) ? (out - r + stride - 1) / stride : 0,
+        .step = dilation / g
+    };
+    *k_step = stride / g;
+    *k_last = 0;
+
+    // first kernel index that reaches the phase; the following ones are k_step apart
+    size_t k0 = 0;
+    while (k0 < kernel && ((int64_t)(r + padding) - (int64_t)(k0 * dilation)) % (int64_t)stride != 0) {
+        k0++;
+    }
+    if (k0 >= kernel) {
+        return;
+    }
+
+    // taps run from the last index down, so that input offsets grow by step
+    a->taps = (kernel - 1 - k0) / *k_step + 1;
+    *k_last = k0 + (a->taps - 1) * *k_step;
+    a->q = ((int64_t)(r + padding) - (int64_t)(*k_last * dilation)) / (int64_t)stride;
+}
+
+/**
+ * @brief  Plans one axis of a nearest upsampling and convolution phase
+ * @param  a planned axis
+ * @param  r phase: first output index
+ * @param  out output size
+ * @param  kernel kernel size
+ * @param  scale upsampling factor
+ * @param  padding padding of the convolution
+ * @returns None
+ *
+ * @note output r + j * scale reads upsampled pixel r + j * scale - padding + k, which is input pixel
+ * j + floor((r - padding + k) / scale): kernel indices map onto consecutive input offsets
+ */
+static void prsm_conv2d_upsample_axis(struct PrismaConvPhaseAxis *const a, const size_t r, const size_t out, const size_t kernel, const size_t scale, const size_t padding) {
+    const int64_t first = prsm_conv2d_floor_div((int64_t)r - (int64_t)padding, scale);
+    const int64_t last = prsm_conv2d_floor_div((int64_t)(r + kernel - 1) - (int64_t)padding, scale);
+    *a = (struct PrismaConvPhaseAxis) {
+        .r = r,
+        .stride = scale,
+        .out = (out > r) ? (out - r + scale - 1) / scale : 0,
+        .taps = (size_t)(last - first + 1),
+        .q = first,
+        .step = 1
+    };
+}
+
+/**
+ * @brief  Returns the number of elements a phase needs: columns and gemm result of one image
+ * @param  c input channels
+ * @param  oc output channels
+ * @param  taps taps of the phase: TY * TX
+ * @param  pixels outputs of the phase
+ * @returns size_t
+ */
+static size_t prsm_conv2d_phase_workspace_size(const size_t c, const size_t oc, const size_t taps, const size_t pixels) {
+    return (c * taps + oc) * pixels;
+}
+
+/**
+ * @brief  Computes one output phase of every image: gather im2col, gemm, strided store with bias and activation
+ * @param  out output tensor of shape (N, OC, OH, OW)
+ * @param  in input tensor of shape (N, C, H, W)
+ * @param  y phase rows
+ * @param  x phase columns
+ * @param  wp phase kernel of shape (OC, C/groups * TY * TX)
+ * @param  b bias of shape (OC) or `NULL`
+ * @param  func activation or `NULL` for linear
+ * @param  groups number of groups
+ * @param  scale bilinear upsampling factor or 0 to read the input directly
+ * @param  ws workspace of `prsm_conv2d_phase_workspace_size()` elements, followed by the bilinear planes
+ * @returns None
+ */
+static void prsm_conv2d_phase_run(prsm_tensor_t *const out, const prsm_tensor_t *const in, const struct PrismaConvPhaseAxis *const y, const struct PrismaConvPhaseAxis *const x, prsm_float *const wp, const prsm_tensor_t *const b, const prsm_activate_fn func, const size_t groups, const size_t scale, prsm_float *const ws) {
+    const size_t n = in->shape[0], c = in->shape[1], h = in->shape[2], w = in->shape[3];
+    const size_t oc = out->shape[1], oh = out->shape[2], ow = out->shape[3];
+    const size_t cg = c / groups, ocg = oc / groups;
+    const size_t taps = y->taps * x->taps, pixels = y->out * x->out;
+    struct PrismaConvPhaseContext ctx = {
+        .col = ws,
+        .mm = (taps == 0) ? NULL : ws + c * taps * pixels,
+        .bias = (b == NULL) ? NULL : b->data,
+        .func = func,
+        .y = *y,
+        .x = *x,
+        .h = h,
+        .w = w,
+        .oh = oh,
+        .ow = ow,
+        .scale = scale,
+        .planes = ws + (c * taps + oc) * pixels
+    };
+
+    // tasks: input channels for the gather, output channels for the store
+    const size_t channel_work = taps * pixels + ((scale == 0) ? 0 : 4 * h * w * scale * scale);
+    const size_t gather_grain = (channel_work == 0 || channel_work >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / channel_work;
+    const size_t store_grain = (pixels >= PRSM_CONV_GRAIN) ? 1 : PRSM_CONV_GRAIN / pixels;
+    size_t col_shape[2], w_shape[2], mm_shape[2];
+    VT_FOREACH(i, 0, n) {
+        ctx.img = in->data + i * c * h * w;
+        ctx.out = out->data + i * oc * oh * ow;
+        if (taps > 0) {
+            // mm_g = wp_g * col_g
+            prsm_parallel_for(c, gather_grain, prsm_conv2d_phase_gather_kernel, &ctx);
+            VT_FOREACH(g, 0, groups) {
+                prsm_tensor_t col_g = prsm_conv2d_view(ctx.col + g * cg * taps * pixels, col_shape, cg * taps, pixels);
+                prsm_tensor_t w_g = prsm_conv2d_view(wp + g * ocg * cg * taps, w_shape, ocg, cg * taps);
+                prsm_tensor_t mm_g = prsm_conv2d_view(ws + (c * taps + g * ocg) * pixels, mm_shape, ocg, pixels);
+                prsm_tensor_gemm(&mm_g, &w_g, &col_g, false, false, 1, 0);
+            }
+        }
+        prsm_parallel_for(oc, store_grain, prsm_conv2d_phase_store_kernel, &ctx);
+    }
+}
+
+/**
+ * @brief  Source pixels of a bilinearly upsampled pixel along one axis (corners not aligned)
+ * @param  dst upsampled pixel
+ * @param  scale upsampling factor
+ * @param  size input size
+ * @param  i0 first source pixel
+ * @param  i1 second source pixel
+ * @param  l weight of the second source pixel
+ * @returns None
+ */
+static void prsm_conv2d_bilinear_src(const size_t dst, const size_t scale, const size_t size, size_t *const i0, size_t *const i1, prsm_float *const l) {
+    // pixel centers: src = (dst + 0.5) / scale - 0.5, clamped to the first pixel
+    const prsm_float src = PRSM_MAX(((prsm_float)dst + 0.5) / (prsm_float)scale - 0.5, 0);
+    *i0 = (size_t)src;
+    *i1 = *i0 + (*i0 + 1 < size);
+    *l = src - (prsm_float)*i0;
+}
+
+/**
+ * @brief  Gathers the phase columns of input channels [from, to)
+ * @param  ctx `struct PrismaConvPhaseContext`
+ * @param  from first channel
+ * @param  to one past the last channel
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_phase_gather_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    const struct PrismaConvPhaseContext *const c = ctx;
+    const struct PrismaConvPhaseAxis *const y = &c->y, *const x = &c->x;
+    const size_t pixels = y->out * x->out;
+
+    // offsets address the upsampled image for bilinear columns
+    const size_t src_h = (c->scale == 0) ? c->h : c->h * c->scale;
+    const size_t src_w = (c->scale == 0) ? c->w : c->w * c->scale;
+    prsm_float *const plane = (c->scale == 0) ? NULL : c->planes + tid * src_h * src_w;
+    VT_FOREACH(ch, from, to) {
+        const prsm_float *img = c->img + ch * c->h * c->w;
+        if (c->scale != 0) {
+            // interpolate between two rows and two columns of the input
+            VT_FOREACH(uy, 0, src_h) {
+                size_t y0, y1, x0, x1;
+                prsm_float ly, lx;
+                prsm_conv2d_bilinear_src(uy, c->scale, c->h, &y0, &y1, &ly);
+                const prsm_float *const row0 = img + y0 * c->w, *const row1 = img + y1 * c->w;
+                prsm_float *const dst = plane + uy * src_w;
+                VT_FOREACH(ux, 0, src_w) {
+                    prsm_conv2d_bilinear_src(ux, c->scale, c->w, &x0, &x1, &lx);
+                    const prsm_float top = row0[x0] + lx * (row0[x1] - row0[x0]);
+                    const prsm_float bottom = row1[x0] + lx * (row1[x1] - row1[x0]);
+                    dst[ux] = top + ly * (bottom - top);
+                }
+            }
+            img = plane;
+        }
+
+        prsm_float *col = c->col + ch * y->taps * x->taps * pixels;
+        VT_FOREACH(ty, 0, y->taps) {
+            VT_FOREACH(tx, 0, x->taps) {
+                // phase columns [i0, i1) read inside the image, the rest is padding
+                const int64_t qx = x->q + (int64_t)(tx * x->step);
+                const int64_t out_x = (int64_t)x->out;
+                const int64_t lo = (qx >= 0) ? 0 : ((-qx < out_x) ? -qx : out_x);
+                const int64_t hi = ((int64_t)src_w - qx < out_x) ? (int64_t)src_w - qx : out_x;
+                const size_t i0 = (size_t)lo, i1 = (size_t)((hi > lo) ? hi : lo);
+                VT_FOREACH(j, 0, y->out) {
+                    const int64_t iy = (int64_t)j + y->q + (int64_t)(ty * y->step);
+                    if (iy < 0 || iy >= (int64_t)src_h) {
+                        memset(col, 0, x->out * sizeof(prsm_float));
+                        col += x->out;
+                        continue;
+                    }
+
+                    VT_FOREACH(i, 0, i0) {
+                        col[i] = 0;
+                    }
+                    if (i1 > i0) {
+                        const prsm_float *const src = img + (size_t)iy * src_w + (size_t)((int64_t)i0 + qx);
+                        VT_FOREACH(i, i0, i1) {
+                            col[i] = src[i - i0];
+                        }
+                    }
+                    VT_FOREACH(i, i1, x->out) {
+                        col[i] = 0;
+                    }
+                    col += x->out;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Stores the phase outputs of output channels [from, to) with bias and activation
+ * @param  ctx `struct PrismaConvPhaseContext`
+ * @param  from first output channel
+ * @param  to one past the last output channel
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_conv2d_phase_store_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaConvPhaseContext *const c = ctx;
+    const struct PrismaConvPhaseAxis *const y = &c->y, *const x = &c->x;
+    VT_FOREACH(oc, from, to) {
+        const prsm_float bias = (c->bias == NULL) ? 0 : c->bias[oc];
+        VT_FOREACH(j, 0, y->out) {
+            prsm_float *const out_row = c->out + (oc * c->oh + y->r + j * y->stride) * c->ow + x->r;
+            if (c->mm == NULL) {
+                // no tap reaches this phase
+                const prsm_float v = (c->func == NULL) ? bias : c->func(bias);
+                VT_FOREACH(i, 0, x->out) {
+                    out_row[i * x->stride] = v;
+                }
+                continue;
+            }
+
+            const prsm_float *const mm_row = c->mm + (oc * y->out + j) * x->out;
+            if (c->func == NULL) {
+                VT_FOREACH(i, 0, x->out) {
+                    out_row[i * x->stride] = mm_row[i] + bias;
+                }
+            } else {
+                VT_FOREACH(i, 0, x->out) {
+                    out_row[i * x->stride] = c->func(mm_row[i] + bias);
+                }
+            }
+        }
+    }
+}
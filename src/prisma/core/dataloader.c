@@ -0,0 +1,286 @@
+#include "prisma/core/dataloader.h"
+
+static prsm_dataloader_t *prsm_dataloader_init(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t x_cols, const size_t y_cols, const size_t batch_size, const size_t num_buffers, const bool shuffle);
+static void prsm_dataloader_start(prsm_dataloader_t *const dl);
+static void prsm_dataloader_producer(void *const arg);
+static void prsm_dataloader_fill_from_tensors(void *const ctx, prsm_tensor_t *const x, prsm_tensor_t *const y, const size_t indices[], const size_t count);
+
+prsm_dataloader_t *prsm_dataloader_create(struct VitaBaseAllocatorType *const alloctr, const prsm_tensor_t *const x, const prsm_tensor_t *const y, const size_t batch_size, const size_t num_buffers, const bool shuffle) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(x), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(x->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    if (y != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(y), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(y->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(y->shape[0] == x->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // create dataloader reading from tensors
+    prsm_dataloader_t *dl = prsm_dataloader_init(alloctr, x->shape[0], x->shape[1], (y == NULL) ? 0 : y->shape[1], batch_size, num_buffers, shuffle);
+    dl->fill = prsm_dataloader_fill_from_tensors;
+    dl->ctx = dl;
+    dl->x = x;
+    dl->y = y;
+
+    // start prefetching
+    prsm_dataloader_start(dl);
+
+    return dl;
+}
+
+prsm_dataloader_t *prsm_dataloader_create_ex(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t x_cols, const size_t y_cols, prsm_dataloader_fn fill, void *const ctx, const size_t batch_size, const size_t num_buffers, const bool shuffle) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(fill != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // create dataloader with a custom source
+    prsm_dataloader_t *dl = prsm_dataloader_init(alloctr, len, x_cols, y_cols, batch_size, num_buffers, shuffle);
+    dl->fill = fill;
+    dl->ctx = ctx;
+
+    // start prefetching
+    prsm_dataloader_start(dl);
+
+    return dl;
+}
+
+void prsm_dataloader_destroy(prsm_dataloader_t *dl) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dl != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // stop background thread
+    prsm_mutex_lock(&dl->mutex);
+    {
+        dl->stop = true;
+        prsm_cond_broadcast(&dl->not_full);
+    }
+    prsm_mutex_unlock(&dl->mutex);
+    prsm_thread_join(&dl->thread);
+
+    // release synchronization primitives
+    prsm_cond_destroy(&dl->not_full);
+    prsm_cond_destroy(&dl->not_empty);
+    prsm_mutex_destroy(&dl->mutex);
+
+    // free buffers
+    VT_FOREACH(i, 0, dl->num_buffers) {
+        prsm_tensor_destroy(dl->buffers[i].x);
+        if (dl->buffers[i].y != NULL) {
+            prsm_tensor_destroy(dl->buffers[i].y);
+        }
+    }
+
+    // free dataloader
+    struct VitaBaseAllocatorType *const alloctr = dl->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, dl->buffers) : VT_FREE(dl->buffers);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, dl->indices) : VT_FREE(dl->indices);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, dl) : VT_FREE(dl);
+}
+
+size_t prsm_dataloader_len(const prsm_dataloader_t *const dl) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dl != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    return (dl->len + dl->batch_size - 1) / dl->batch_size;
+}
+
+bool prsm_dataloader_next(prsm_dataloader_t *const dl, prsm_tensor_t *const x, prsm_tensor_t *const y) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(dl != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(x != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const struct PrismaDataloaderBatch *batch = NULL;
+    prsm_mutex_lock(&dl->mutex);
+    {
+        // release the previous batch
+        if (dl->holding) {
+            dl->holding = false;
+            dl->tail++;
+            prsm_cond_signal(&dl->not_full);
+        }
+
+        // end of epoch: the producer is already prefetching the next one
+        if (dl->epoch_batch == prsm_dataloader_len(dl)) {
+            dl->epoch_batch = 0;
+            prsm_mutex_unlock(&dl->mutex);
+            return false;
+        }
+
+        // wait for a batch
+        while (dl->head == dl->tail) {
+            prsm_cond_wait(&dl->not_empty, &dl->mutex);
+        }
+        batch = &dl->buffers[dl->tail % dl->num_buffers];
+        dl->holding = true;
+        dl->epoch_batch++;
+    }
+    prsm_mutex_unlock(&dl->mutex);
+
+    *x = batch->x_view;
+    if (y != NULL) {
+        *y = batch->y_view;
+    }
+
+    return true;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Allocates a dataloader and its buffers; the background thread is not started
+ * @param  alloctr allocator instance
+ * @param  len number of samples
+ * @param  x_cols features per sample
+ * @param  y_cols labels per sample
+ * @param  batch_size samples per batch
+ * @param  num_buffers number of batches prefetched ahead
+ * @param  shuffle shuffle samples every epoch
+ * @returns prsm_dataloader_t*
+ */
+static prsm_dataloader_t *prsm_dataloader_init(struct VitaBaseAllocatorType *const alloctr, const size_t len, const size_t x_cols, const size_t y_cols, const size_t batch_size, const size_t num_buffers, const bool shuffle) {
+    // check for invalid input
+    VT_ENFORCE(len > 0 && x_cols > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(batch_size > 0 && num_buffers > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate for dataloader
+    prsm_dataloader_t *dl = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_dataloader_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_dataloader_t));
+
+    // allocate for sample order
+    size_t *indices = (alloctr == NULL)
+        ? VT_CALLOC(len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, len * sizeof(size_t));
+    VT_FOREACH(i, 0, len) {
+        indices[i] = i;
+    }
+
+    // allocate for buffers
+    struct PrismaDataloaderBatch *buffers = (alloctr == NULL)
+        ? VT_CALLOC(num_buffers * sizeof(struct PrismaDataloaderBatch))
+        : VT_ALLOCATOR_ALLOC(alloctr, num_buffers * sizeof(struct PrismaDataloaderBatch));
+    VT_FOREACH(i, 0, num_buffers) {
+        buffers[i] = (struct PrismaDataloaderBatch) {
+            .x = prsm_tensor_create_mat(alloctr, batch_size, x_cols),
+            .y = (y_cols == 0) ? NULL : prsm_tensor_create_mat(alloctr, batch_size, y_cols)
+        };
+    }
+
+    // seed shuffling from the global generator; xorshift state must be non-zero
+    const uint64_t seed = vt_math_random_u64();
+
+    *dl = (prsm_dataloader_t) {
+        .len = len,
+        .batch_size = batch_size,
+        .shuffle = shuffle,
+        .indices = indices,
+        .rng = (seed == 0) ? 0x9E3779B97F4A7C15ull : seed,
+        .num_buffers = num_buffers,
+        .buffers = buffers,
+        .alloctr = alloctr
+    };
+
+    return dl;
+}
+
+/**
+ * @brief  Starts the background thread
+ * @param  dl dataloader
+ * @returns None
+ */
+static void prsm_dataloader_start(prsm_dataloader_t *const dl) {
+    prsm_mutex_init(&dl->mutex);
+    prsm_cond_init(&dl->not_empty);
+    prsm_cond_init(&dl->not_full);
+
+    VT_ENFORCE(
+        prsm_thread_create(&dl->thread, prsm_dataloader_producer, dl),
+        "%s: Failed to start the dataloader thread.\n",
+        prsm_status_to_str(PRSM_STATUS_OPERATION_FAILURE)
+    );
+}
+
+/**
+ * @brief  Background thread: fills batches in order, epoch after epoch, until stopped
+ * @param  arg prsm_dataloader_t*
+ * @returns None
+ */
+static void prsm_dataloader_producer(void *const arg) {
+    prsm_dataloader_t *const dl = arg;
+    const size_t num_batches = prsm_dataloader_len(dl);
+
+    size_t batch_index = 0;
+    for (;;) {
+        // new epoch
+        if (batch_index == 0 && dl->shuffle) {
+            prsm_tensor_rand_permutation(dl->indices, dl->len, &dl->rng);
+        }
+
+        // wait for a free buffer
+        size_t slot = 0;
+        prsm_mutex_lock(&dl->mutex);
+        {
+            while (!dl->stop && dl->head - dl->tail >= dl->num_buffers) {
+                prsm_cond_wait(&dl->not_full, &dl->mutex);
+            }
+            if (dl->stop) {
+                prsm_mutex_unlock(&dl->mutex);
+                break;
+            }
+            slot = dl->head % dl->num_buffers;
+        }
+        prsm_mutex_unlock(&dl->mutex);
+
+        // fill buffer: the consumer does not touch it until `head` is advanced
+        struct PrismaDataloaderBatch *const batch = &dl->buffers[slot];
+        const size_t from = batch_index * dl->batch_size;
+        const size_t count = (dl->len - from < dl->batch_size) ? dl->len - from : dl->batch_size;
+
+        batch->x_shape[0] = count;
+        batch->x_shape[1] = batch->x->shape[1];
+        batch->x_view = (prsm_tensor_t) {
+            .ndim = 2,
+            .shape = batch->x_shape,
+            .data = batch->x->data,
+            .is_view = true
+        };
+        if (batch->y != NULL) {
+            batch->y_shape[0] = count;
+            batch->y_shape[1] = batch->y->shape[1];
+            batch->y_view = (prsm_tensor_t) {
+                .ndim = 2,
+                .shape = batch->y_shape,
+                .data = batch->y->data,
+                .is_view = true
+            };
+        }
+        dl->fill(dl->ctx, &batch->x_view, (batch->y == NULL) ? NULL : &batch->y_view, dl->indices + from, count);
+
+        // publish
+        prsm_mutex_lock(&dl->mutex);
+        {
+            dl->head++;
+            prsm_cond_signal(&dl->not_empty);
+        }
+        prsm_mutex_unlock(&dl->mutex);
+
+        batch_index = (batch_index + 1) % num_batches;
+    }
+}
+
+/**
+ * @brief  Gathers rows of the source tensors into a batch
+ * @param  ctx prsm_dataloader_t*
+ * @param  x batch features
+ * @param  y batch labels or `NULL`
+ * @param  indices rows to copy
+ * @param  count number of rows
+ * @returns None
+ */
+static void prsm_dataloader_fill_from_tensors(void *const ctx, prsm_tensor_t *const x, prsm_tensor_t *const y, const size_t indices[], const size_t count) {
+    const prsm_dataloader_t *const dl = ctx;
+
+    prsm_tensor_gather(x, dl->x, indices, count, 0);
+    if (y != NULL) {
+        prsm_tensor_gather(y, dl->y, indices, count, 0);
+    }
+}
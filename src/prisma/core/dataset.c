@@ -0,0 +1,577 @@
+#include "prisma/core/dataset.h"
+#include "prisma/core/parallel.h"
+
+// CSV files are split into chunks of at least this size (in bytes)
+#define PRSM_DATASET_CSV_MIN_CHUNK (64 * 1024)
+#define PRSM_DATASET_CSV_MAX_CHUNKS 256
+
+// significant digits that fit into uint64_t without overflow
+#define PRSM_DATASET_MAX_DIGITS 19
+
+// IDX header: 0x00 0x00 <type> <ndim> followed by ndim big-endian uint32 dimensions
+#define PRSM_DATASET_IDX_TYPE_UBYTE 0x08
+
+// elements converted per task
+#define PRSM_DATASET_IDX_GRAIN (64 * 1024)
+
+// SWAR digit parsing loads 8 characters into an integer and assumes little-endian byte order
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_WIN32) || defined(_WIN64)
+    #define PRSM_DATASET_USE_SWAR
+#endif
+
+// shared state of a parallel CSV read
+struct PrismaDatasetCsvContext {
+    prsm_tensor_t *x;
+    prsm_tensor_t *y;
+    char delim;
+    size_t label_col;
+    size_t rows;                                                // rows to read
+    size_t num_chunks;
+    const char *chunks[PRSM_DATASET_CSV_MAX_CHUNKS + 1];        // line-aligned chunk boundaries
+    size_t chunk_rows[PRSM_DATASET_CSV_MAX_CHUNKS];             // rows per chunk, then index of the first chunk row
+    enum PrismaStatus chunk_status[PRSM_DATASET_CSV_MAX_CHUNKS];
+};
+
+static void prsm_dataset_csv_count_rows(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_dataset_csv_parse_rows(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static bool prsm_dataset_csv_parse_line(struct PrismaDatasetCsvContext *const csv, const char *p, const char *const eol, const size_t row);
+static bool prsm_dataset_csv_line_is_empty(const char *const p, const char *const eol);
+static bool prsm_dataset_parse_float(const char **const ptr, const char *const end, prsm_float *const out);
+static void prsm_dataset_idx_convert(void *const ctx, const size_t from, const size_t to, const size_t tid);
+
+// shared state of a parallel IDX conversion
+struct PrismaDatasetIdxContext {
+    prsm_float *out;
+    const uint8_t *in;
+    prsm_float scale;
+};
+
+enum PrismaStatus prsm_dataset_read_csv(prsm_tensor_t *const x, prsm_tensor_t *const y, const char *const filename, const char delim, const bool has_header, const size_t label_col) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(x), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_DEBUG_ASSERT(filename != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(x->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    if (y != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(y), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(y->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(y->shape[0] == x->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        VT_ENFORCE(label_col <= x->shape[1], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    }
+
+    // map file
+    prsm_mmap_t map;
+    const enum PrismaStatus status = prsm_mmap_open(&map, filename);
+    if (status != PRSM_STATUS_OPERATION_SUCCESS) {
+        return status;
+    }
+
+    // skip BOM and header
+    const char *begin = (const char*)map.data;
+    const char *const end = begin + map.size;
+    if (map.size >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0) {
+        begin += 3;
+    }
+    if (has_header) {
+        const char *eol = memchr(begin, '\n', (size_t)(end - begin));
+        begin = (eol == NULL) ? end : eol + 1;
+    }
+
+    // split into line-aligned chunks
+    struct PrismaDatasetCsvContext csv = {
+        .x = x,
+        .y = y,
+        .delim = delim,
+        .label_col = label_col,
+        .rows = x->shape[0],
+    };
+    const size_t size = (size_t)(end - begin);
+    const size_t max_chunks = size / PRSM_DATASET_CSV_MIN_CHUNK + 1;
+    const size_t num_threads = prsm_parallel_get_num_threads();
+    csv.num_chunks = (max_chunks < num_threads) ? max_chunks : num_threads;
+    if (csv.num_chunks > PRSM_DATASET_CSV_MAX_CHUNKS) {
+        csv.num_chunks = PRSM_DATASET_CSV_MAX_CHUNKS;
+    }
+    csv.chunks[0] = begin;
+    csv.chunks[csv.num_chunks] = end;
+    VT_FOREACH(i, 1, csv.num_chunks) {
+        const char *p = begin + size / csv.num_chunks * i;
+        if (p < csv.chunks[i - 1]) {
+            p = csv.chunks[i - 1];
+        }
+        const char *eol = memchr(p, '\n', (size_t)(end - p));
+        csv.chunks[i] = (eol == NULL) ? end : eol + 1;
+    }
+
+    // count rows per chunk and find where each chunk starts
+    prsm_parallel_for(csv.num_chunks, 1, prsm_dataset_csv_count_rows, &csv);
+    size_t total_rows = 0;
+    VT_FOREACH(i, 0, csv.num_chunks) {
+        const size_t chunk_rows = csv.chunk_rows[i];
+        csv.chunk_rows[i] = total_rows;
+        total_rows += chunk_rows;
+    }
+
+    // parse rows directly into tensors
+    enum PrismaStatus result = PRSM_STATUS_ERROR_INVALID_FORMAT;
+    if (total_rows >= csv.rows) {
+        prsm_parallel_for(csv.num_chunks, 1, prsm_dataset_csv_parse_rows, &csv);
+
+        result = PRSM_STATUS_OPERATION_SUCCESS;
+        VT_FOREACH(i, 0, csv.num_chunks) {
+            if (csv.chunk_status[i] != PRSM_STATUS_OPERATION_SUCCESS) {
+                result = csv.chunk_status[i];
+                break;
+            }
+        }
+    }
+
+    // unmap
+    prsm_mmap_close(&map);
+
+    return result;
+}
+
+enum PrismaStatus prsm_dataset_idx_open(prsm_dataset_idx_t *const idx, const char *const filename) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(filename != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // zero-init
+    *idx = (prsm_dataset_idx_t) {0};
+
+    // map file
+    prsm_mmap_t map;
+    const enum PrismaStatus status = prsm_mmap_open(&map, filename);
+    if (status != PRSM_STATUS_OPERATION_SUCCESS) {
+        return status;
+    }
+
+    // validate magic
+    const uint8_t *const header = map.data;
+    const size_t ndim = (map.size >= 4) ? header[3] : 0;
+    if (
+        map.size < 4 || header[0] != 0 || header[1] != 0 ||
+        header[2] != PRSM_DATASET_IDX_TYPE_UBYTE ||
+        ndim == 0 || ndim > PRSM_DATASET_IDX_MAX_DIMS ||
+        map.size < 4 + 4 * ndim
+    ) {
+        prsm_mmap_close(&map);
+        return PRSM_STATUS_ERROR_INVALID_FORMAT;
+    }
+
+    // read big-endian dimensions
+    size_t size = 1;
+    VT_FOREACH(i, 0, ndim) {
+        const uint8_t *const d = header + 4 + 4 * i;
+        idx->shape[i] = ((size_t)d[0] << 24) | ((size_t)d[1] << 16) | ((size_t)d[2] << 8) | (size_t)d[3];
+        size *= idx->shape[i];
+    }
+
+    // check that data is not truncated
+    const size_t offset = 4 + 4 * ndim;
+    if (map.size - offset < size) {
+        prsm_mmap_close(&map);
+        *idx = (prsm_dataset_idx_t) {0};
+        return PRSM_STATUS_ERROR_INVALID_FORMAT;
+    }
+
+    idx->map = map;
+    idx->ndim = ndim;
+    idx->data = map.data + offset;
+
+    return PRSM_STATUS_OPERATION_SUCCESS;
+}
+
+void prsm_dataset_idx_close(prsm_dataset_idx_t *const idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    prsm_mmap_close(&idx->map);
+    *idx = (prsm_dataset_idx_t) {0};
+}
+
+size_t prsm_dataset_idx_len(const prsm_dataset_idx_t *const idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+
+    return idx->shape[0];
+}
+
+size_t prsm_dataset_idx_sample_size(const prsm_dataset_idx_t *const idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+
+    size_t size = 1;
+    VT_FOREACH(i, 1, idx->ndim) {
+        size *= idx->shape[i];
+    }
+
+    return size;
+}
+
+const uint8_t *prsm_dataset_idx_get(const prsm_dataset_idx_t *const idx, const size_t at) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(at < idx->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return idx->data + at * prsm_dataset_idx_sample_size(idx);
+}
+
+void prsm_dataset_idx_to_tensor(prsm_tensor_t *const out, const prsm_dataset_idx_t *const idx, const size_t from, const prsm_float scale) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(out->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(out->shape[1] == prsm_dataset_idx_sample_size(idx), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(from + out->shape[0] <= idx->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // convert: samples are contiguous, so this is a flat loop over all elements
+    struct PrismaDatasetIdxContext ctx = {
+        .out = out->data,
+        .in = idx->data + from * out->shape[1],
+        .scale = scale
+    };
+    prsm_parallel_for(prsm_tensor_size(out), PRSM_DATASET_IDX_GRAIN, prsm_dataset_idx_convert, &ctx);
+}
+
+enum PrismaStatus prsm_dataset_idx_to_labels(prsm_tensor_t *const out, const prsm_dataset_idx_t *const idx, const size_t from) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(out->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(prsm_dataset_idx_sample_size(idx) == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(from + out->shape[0] <= idx->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    const size_t rows = out->shape[0];
+    const size_t classes = out->shape[1];
+    const uint8_t *const labels = idx->data + from;
+
+    // label indices
+    if (classes == 1) {
+        VT_FOREACH(i, 0, rows) {
+            out->data[i] = labels[i];
+        }
+        return PRSM_STATUS_OPERATION_SUCCESS;
+    }
+
+    // one-hot
+    memset(out->data, 0, rows * classes * sizeof(prsm_float));
+    VT_FOREACH(i, 0, rows) {
+        if (labels[i] >= classes) {
+            return PRSM_STATUS_ERROR_INVALID_FORMAT;
+        }
+        out->data[i * classes + labels[i]] = 1;
+    }
+
+    return PRSM_STATUS_OPERATION_SUCCESS;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Converts bytes [from, to) to prsm_float
+ * @param  ctx struct PrismaDatasetIdxContext*
+ * @param  from first element
+ * @param  to last element (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_dataset_idx_convert(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaDatasetIdxContext *const idx = ctx;
+    prsm_float *const out = idx->out;
+    const uint8_t *const in = idx->in;
+    const prsm_float scale = idx->scale;
+
+    // plain loop: vectorized by the compiler
+    VT_FOREACH(i, from, to) {
+        out[i] = (prsm_float)in[i] * scale;
+    }
+}
+
+/**
+ * @brief  Counts non-empty lines in chunks [from, to)
+ * @param  ctx struct PrismaDatasetCsvContext*
+ * @param  from first chunk
+ * @param  to last chunk (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_dataset_csv_count_rows(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    struct PrismaDatasetCsvContext *const csv = ctx;
+    VT_FOREACH(i, from, to) {
+        size_t rows = 0;
+        const char *p = csv->chunks[i];
+        const char *const end = csv->chunks[i + 1];
+        while (p < end) {
+            const char *eol = memchr(p, '\n', (size_t)(end - p));
+            if (eol == NULL) {
+                eol = end;
+            }
+            rows += !prsm_dataset_csv_line_is_empty(p, eol);
+            p = eol + 1;
+        }
+        csv->chunk_rows[i] = rows;
+    }
+}
+
+/**
+ * @brief  Parses rows of chunks [from, to) into x and y
+ * @param  ctx struct PrismaDatasetCsvContext*
+ * @param  from first chunk
+ * @param  to last chunk (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_dataset_csv_parse_rows(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    struct PrismaDatasetCsvContext *const csv = ctx;
+    VT_FOREACH(i, from, to) {
+        csv->chunk_status[i] = PRSM_STATUS_OPERATION_SUCCESS;
+
+        size_t row = csv->chunk_rows[i];
+        const char *p = csv->chunks[i];
+        const char *const end = csv->chunks[i + 1];
+        while (p < end && row < csv->rows) {
+            const char *eol = memchr(p, '\n', (size_t)(end - p));
+            if (eol == NULL) {
+                eol = end;
+            }
+            if (!prsm_dataset_csv_line_is_empty(p, eol)) {
+                if (!prsm_dataset_csv_parse_line(csv, p, eol, row)) {
+                    csv->chunk_status[i] = PRSM_STATUS_ERROR_INVALID_FORMAT;
+                    break;
+                }
+                row++;
+            }
+            p = eol + 1;
+        }
+    }
+}
+
+/**
+ * @brief  Parses a single CSV line into row `row` of x and y
+ * @param  csv CSV context
+ * @param  p line start
+ * @param  eol line end
+ * @param  row row index
+ * @returns true upon success, false if the line is malformed
+ */
+static bool prsm_dataset_csv_parse_line(struct PrismaDatasetCsvContext *const csv, const char *p, const char *const eol, const size_t row) {
+    const size_t x_cols = csv->x->shape[1];
+    const size_t num_fields = x_cols + (csv->y != NULL);
+    prsm_float *const x_row = csv->x->data + row * x_cols;
+
+    size_t x_col = 0;
+    VT_FOREACH(i, 0, num_fields) {
+        // parse value
+        prsm_float value = 0;
+        if (!prsm_dataset_parse_float(&p, eol, &value)) {
+            return false;
+        }
+
+        // skip trailing whitespace, then expect a delimiter or the end of line
+        while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) {
+            p++;
+        }
+        if (i + 1 < num_fields) {
+            if (p == eol || *p != csv->delim) {
+                return false;
+            }
+            p++;
+        } else if (p != eol) {
+            return false;
+        }
+
+        // store value
+        if (csv->y != NULL && i == csv->label_col) {
+            const size_t y_cols = csv->y->shape[1];
+            prsm_float *const y_row = csv->y->data + row * y_cols;
+            if (y_cols == 1) {
+                y_row[0] = value;
+                continue;
+            }
+
+            // one-hot
+            if (value < 0 || value >= (prsm_float)y_cols || value != PRSM_FLOOR(value)) {
+                return false;
+            }
+            memset(y_row, 0, y_cols * sizeof(prsm_float));
+            y_row[(size_t)value] = 1;
+        } else {
+            x_row[x_col++] = value;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief  Checks if a line contains no data
+ * @param  p line start
+ * @param  eol line end
+ * @returns ditto
+ */
+static bool prsm_dataset_csv_line_is_empty(const char *const p, const char *const eol) {
+    return (p == eol) || (eol - p == 1 && *p == '\r');
+}
+
+#if defined(PRSM_DATASET_USE_SWAR)
+/**
+ * @brief  Checks if 8 characters packed into an integer are all digits
+ * @param  v packed characters
+ * @returns ditto
+ */
+static bool prsm_dataset_swar_is_eight_digits(const uint64_t v) {
+    return (((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull);
+}
+
+/**
+ * @brief  Converts 8 digits packed into an integer using 3 multiplications
+ * @param  v packed digits
+ * @returns value in range [0, 99999999]
+ */
+static uint64_t prsm_dataset_swar_parse_eight_digits(uint64_t v) {
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 0x000F424000000064ull; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ull; // 1 + (10000 << 32)
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return v;
+}
+#endif
+
+/**
+ * @brief  Accumulates a run of digits into a mantissa
+ * @param  ptr current position (updated)
+ * @param  end end of input
+ * @param  mantissa accumulated significant digits
+ * @param  num_digits number of significant digits
+ * @param  dropped number of digits that did not fit into the mantissa
+ * @returns number of digits consumed
+ */
+static size_t prsm_dataset_parse_digits(const char **const ptr, const char *const end, uint64_t *const mantissa, size_t *const num_digits, size_t *const dropped) {
+    const char *p = *ptr;
+
+#if defined(PRSM_DATASET_USE_SWAR)
+    // 8 digits at a time
+    while (end - p >= 8 && *num_digits + 8 <= PRSM_DATASET_MAX_DIGITS) {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        if (!prsm_dataset_swar_is_eight_digits(v)) {
+            break;
+        }
+        const uint64_t chunk = prsm_dataset_swar_parse_eight_digits(v);
+        if (*mantissa != 0) {
+            *num_digits += 8;
+        } else {
+            // leading zeros are not significant: count digits from the first non-zero one
+            for (uint64_t d = chunk; d != 0; d /= 10) {
+                (*num_digits)++;
+            }
+        }
+        *mantissa = *mantissa * 100000000ull + chunk;
+        p += 8;
+    }
+#endif
+
+    // remaining digits
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (*num_digits < PRSM_DATASET_MAX_DIGITS) {
+            *mantissa = *mantissa * 10 + (uint64_t)(*p - '0');
+            *num_digits += (*mantissa != 0);
+        } else {
+            (*dropped)++;
+        }
+        p++;
+    }
+
+    const size_t consumed = (size_t)(p - *ptr);
+    *ptr = p;
+    return consumed;
+}
+
+/**
+ * @brief  Parses a decimal floating point number: [ws][+-]digits[.digits][(e|E)[+-]digits]
+ * @param  ptr current position (updated)
+ * @param  end end of input
+ * @param  out parsed value
+ * @returns true upon success
+ *
+ * @note the result is exact for up to 19 significant digits and a decimal exponent within [-22, 22],
+ *  otherwise it may differ from strtod in the last bit
+ */
+static bool prsm_dataset_parse_float(const char **const ptr, const char *const end, prsm_float *const out) {
+    static const double pow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const char *p = *ptr;
+
+    // skip leading whitespace
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+
+    // sign
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    // integer and fractional parts
+    uint64_t mantissa = 0;
+    size_t num_digits = 0, dropped = 0;
+    size_t consumed = prsm_dataset_parse_digits(&p, end, &mantissa, &num_digits, &dropped);
+    long exp10 = (long)dropped;
+    if (p < end && *p == '.') {
+        p++;
+        const size_t dropped_before = dropped;
+        const size_t frac = prsm_dataset_parse_digits(&p, end, &mantissa, &num_digits, &dropped);
+        exp10 -= (long)(frac - (dropped - dropped_before));
+        consumed += frac;
+    }
+    if (consumed == 0) {
+        return false;
+    }
+
+    // exponent
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9') {
+            return false;
+        }
+        long e = 0;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+            p++;
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+
+    // scale
+    double value = (double)mantissa;
+    if (mantissa != 0 && exp10 != 0) {
+        if (exp10 >= -22 && exp10 <= 22) {
+            value = (exp10 < 0) ? value / pow10[-exp10] : value * pow10[exp10];
+        } else {
+            value *= pow(10.0, (double)exp10);
+        }
+    }
+
+    *out = (prsm_float)(negative ? -value : value);
+    *ptr = p;
+    return true;
+}
+
@@ -1,4 +1,791 @@
 #include "prisma/core/layers.h"
 
-//
+// minimum elements per batchnorm task
+#define PRSM_LAYER_BATCHNORM_GRAIN (32 * 1024)
 
+// shared state of a parallel batchnorm pass: tensors are viewed as (N, C, HW)
+struct PrismaLayerBatchnormContext {
+    prsm_layer_batchnorm_t *layer;
+    const prsm_float *x;                    // input
+    prsm_float *y;                          // output; may be `x`
+    prsm_float *xhat;                       // normalized input of the training forward pass
+    const prsm_float *dout;
+    prsm_float *dx;                         // gradient of the input or NULL
+    size_t n, c, hw;
+};
+
+static size_t prsm_layer_batchnorm_grain(const size_t n, const size_t hw);
+static void prsm_layer_batchnorm_train_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_layer_batchnorm_infer_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_layer_batchnorm_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_layer_batchnorm_run(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const in, prsm_tensor_t *const out, const bool training);
+static void prsm_layer_batchnorm_fold(prsm_layer_batchnorm_t *const layer, prsm_tensor_t *const w, prsm_tensor_t *const b, const size_t rows, const size_t cols, const bool channel_rows);
+
+prsm_layer_dense_t *prsm_layer_dense_create(struct VitaBaseAllocatorType *const alloctr, const size_t in_features, const size_t out_features, const enum PrismaActivation activation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(in_features > 0 && out_features > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(activation < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate layer
+    prsm_layer_dense_t *layer = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_layer_dense_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_layer_dense_t));
+    layer->in_features = in_features;
+    layer->out_features = out_features;
+    layer->activation = activation;
+    layer->alloctr = alloctr;
+
+    // parameters
+    layer->w = prsm_tensor_create_mat(alloctr, in_features, out_features);
+    layer->b = prsm_tensor_create_vec(alloctr, out_features);
+    layer->dw = prsm_tensor_create_mat(alloctr, in_features, out_features);
+    layer->db = prsm_tensor_create_vec(alloctr, out_features);
+
+    // glorot uniform
+    const prsm_float limit = PRSM_SQRT(6.0 / (prsm_float)(in_features + out_features));
+    prsm_tensor_rand_uniform(layer->w, -limit, limit);
+    prsm_tensor_set_zeros(layer->b);
+
+    return layer;
+}
+
+void prsm_layer_dense_destroy(prsm_layer_dense_t *layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers
+    prsm_tensor_destroy(layer->w);
+    prsm_tensor_destroy(layer->b);
+    prsm_tensor_destroy(layer->dw);
+    prsm_tensor_destroy(layer->db);
+    if (layer->dx != NULL) prsm_tensor_destroy(layer->dx);
+    if (layer->dz != NULL) prsm_tensor_destroy(layer->dz);
+    if (layer->out != NULL) prsm_tensor_destroy(layer->out);
+
+    // free layer
+    struct VitaBaseAllocatorType *const alloctr = layer->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, layer) : VT_FREE(layer);
+    layer = NULL;
+}
+
+const prsm_tensor_t *prsm_layer_dense_forward(prsm_layer_dense_t *const layer, const prsm_tensor_t *const in) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(in->shape[1] == layer->in_features, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // out = activation(in * w + b): bias and activation are applied while the output row is in cache
+    const struct PrismaTensorEpilogue ep = {
+        .bias = layer->b,
+        .func = (layer->activation == PRSM_ACTIVATION_LINEAR) ? NULL : prsm_activate_get_func(layer->activation)
+    };
+    layer->out = prsm_tensor_gemm_ex(layer->out, in, layer->w, false, false, 1, 0, &ep);
+    layer->in = in;
+
+    return layer->out;
+}
+
+const prsm_tensor_t *prsm_layer_dense_backward(prsm_layer_dense_t *const layer, const prsm_tensor_t *const dout, const bool input_grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(layer->in != NULL && layer->out != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+    VT_ENFORCE(prsm_tensor_shapes_match(dout, layer->out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // linear layers pass the gradient through
+    const prsm_tensor_t *dz = dout;
+    const size_t rows = dout->shape[0], cols = dout->shape[1];
+    prsm_tensor_set_zeros(layer->db);
+    if (layer->activation == PRSM_ACTIVATION_LINEAR) {
+        // db = sum(dout, 0)
+        VT_FOREACH(i, 0, rows) {
+            const prsm_float *const dout_row = dout->data + i * cols;
+            VT_FOREACH(j, 0, cols) {
+                layer->db->data[j] += dout_row[j];
+            }
+        }
+    } else {
+        // resize buffer
+        if (layer->dz == NULL) {
+            layer->dz = prsm_tensor_create_mat(layer->alloctr, rows, cols);
+        } else if (!prsm_tensor_shapes_match(layer->dz, dout)) {
+            prsm_tensor_resize(layer->dz, 2, rows, cols);
+        }
+
+        // dz = dout * activation'(out), db = sum(dz, 0) in one pass
+        const prsm_activate_fn func_d = prsm_activate_get_func_d(layer->activation);
+        VT_FOREACH(i, 0, rows) {
+            const prsm_float *const dout_row = dout->data + i * cols;
+            const prsm_float *const out_row = layer->out->data + i * cols;
+            prsm_float *const dz_row = layer->dz->data + i * cols;
+            VT_FOREACH(j, 0, cols) {
+                dz_row[j] = dout_row[j] * func_d(out_row[j]);
+                layer->db->data[j] += dz_row[j];
+            }
+        }
+        dz = layer->dz;
+    }
+
+    // dw = in_T * dz
+    prsm_tensor_gemm(layer->dw, layer->in, dz, true, false, 1, 0);
+
+    // dx = dz * w_T
+    if (!input_grad) {
+        return NULL;
+    }
+    layer->dx = prsm_tensor_gemm(layer->dx, dz, layer->w, false, true, 1, 0);
+
+    return layer->dx;
+}
+
+prsm_layer_conv2d_t *prsm_layer_conv2d_create(struct VitaBaseAllocatorType *const alloctr, const prsm_conv2d_params_t *const params, const enum PrismaActivation activation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(activation < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->groups > 0 && params->in_channels % params->groups == 0 && params->out_channels % params->groups == 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+
+    // allocate layer
+    prsm_layer_conv2d_t *layer = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_layer_conv2d_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_layer_conv2d_t));
+    layer->params = *params;
+    layer->activation = activation;
+    layer->alloctr = alloctr;
+
+    // parameters
+    const size_t in_group = params->in_channels / params->groups;
+    layer->w = prsm_tensor_create(alloctr, 4, params->out_channels, in_group, params->kernel[0], params->kernel[1]);
+    layer->b = prsm_tensor_create_vec(alloctr, params->out_channels);
+    layer->dw = prsm_tensor_create(alloctr, 4, params->out_channels, in_group, params->kernel[0], params->kernel[1]);
+    layer->db = prsm_tensor_create_vec(alloctr, params->out_channels);
+    layer->workspace = prsm_tensor_create_vec(alloctr, 1);
+
+    // glorot uniform: fan_in = in_group * KH * KW, fan_out = out_channels/groups * KH * KW
+    const size_t kk = params->kernel[0] * params->kernel[1];
+    const prsm_float limit = PRSM_SQRT(6.0 / (prsm_float)((in_group + params->out_channels / params->groups) * kk));
+    prsm_tensor_rand_uniform(layer->w, -limit, limit);
+    prsm_tensor_set_zeros(layer->b);
+
+    return layer;
+}
+
+void prsm_layer_conv2d_destroy(prsm_layer_conv2d_t *layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers
+    prsm_tensor_destroy(layer->w);
+    prsm_tensor_destroy(layer->b);
+    prsm_tensor_destroy(layer->dw);
+    prsm_tensor_destroy(layer->db);
+    prsm_tensor_destroy(layer->workspace);
+    if (layer->dx != NULL) prsm_tensor_destroy(layer->dx);
+    if (layer->dz != NULL) prsm_tensor_destroy(layer->dz);
+    if (layer->out != NULL) prsm_tensor_destroy(layer->out);
+    if (layer->u != NULL) prsm_tensor_destroy(layer->u);
+
+    // free layer
+    struct VitaBaseAllocatorType *const alloctr = layer->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, layer) : VT_FREE(layer);
+    layer = NULL;
+}
+
+const prsm_tensor_t *prsm_layer_conv2d_forward(prsm_layer_conv2d_t *const layer, const prsm_tensor_t *const in) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // out = activation(conv(in, w) + b); im2col columns are kept for the backward pass
+    const enum PrismaConvAlgorithm algorithm = prsm_conv2d_select_algorithm(&layer->params, in->shape[2], in->shape[3]);
+    layer->columns = algorithm == PRSM_CONV_ALGORITHM_IM2COL;
+    if (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_2 || algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_4) {
+        // weights are transformed only after they change, not on every call
+        const size_t m = (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_2) ? 2 : 4;
+        if (layer->u_tile != m) {
+            layer->u = prsm_conv2d_winograd_weights(layer->u, layer->w, m);
+            layer->u_tile = m;
+        }
+        layer->out = prsm_conv2d_winograd(layer->out, in, layer->u, layer->b, layer->activation, &layer->params, m, layer->workspace);
+    } else {
+        layer->out = prsm_conv2d_forward_ex(layer->out, in, layer->w, layer->b, layer->activation, &layer->params, layer->workspace, layer->columns);
+    }
+    layer->in = in;
+
+    return layer->out;
+}
+
+const prsm_tensor_t *prsm_layer_conv2d_backward(prsm_layer_conv2d_t *const layer, const prsm_tensor_t *const dout, const bool input_grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(layer->in != NULL && layer->out != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+    VT_ENFORCE(prsm_tensor_shapes_match(dout, layer->out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // linear layers pass the gradient through
+    const prsm_tensor_t *dz = dout;
+    if (layer->activation != PRSM_ACTIVATION_LINEAR) {
+        // resize buffer
+        if (layer->dz == NULL) {
+            layer->dz = prsm_tensor_create_ex(layer->alloctr, dout->ndim, dout->shape);
+        } else if (!prsm_tensor_shapes_match(layer->dz, dout)) {
+            prsm_tensor_resize_ex(layer->dz, dout->ndim, dout->shape);
+        }
+
+        // dz = dout * activation'(out)
+        const prsm_activate_fn func_d = prsm_activate_get_func_d(layer->activation);
+        const size_t size = prsm_tensor_size(dout);
+        VT_FOREACH(i, 0, size) {
+            layer->dz->data[i] = dout->data[i] * func_d(layer->out->data[i]);
+        }
+        dz = layer->dz;
+    }
+
+    // resize input gradient
+    if (input_grad) {
+        if (layer->dx == NULL) {
+            layer->dx = prsm_tensor_create_ex(layer->alloctr, layer->in->ndim, layer->in->shape);
+        } else if (!prsm_tensor_shapes_match(layer->dx, layer->in)) {
+            prsm_tensor_resize_ex(layer->dx, layer->in->ndim, layer->in->shape);
+        }
+    }
+
+    // dw, db and dx share the forward workspace and the columns kept in it
+    prsm_conv2d_backward_ex(input_grad ? layer->dx : NULL, layer->dw, layer->db, dz, layer->in, layer->w, &layer->params, layer->workspace, layer->columns);
+
+    // the optimizer updates the weights next
+    layer->u_tile = 0;
+
+    return input_grad ? layer->dx : NULL;
+}
+
+void prsm_layer_conv2d_weights_changed(prsm_layer_conv2d_t *const layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    layer->u_tile = 0;
+}
+
+prsm_layer_separable_t *prsm_layer_separable_create(struct VitaBaseAllocatorType *const alloctr, const size_t in_channels, const size_t out_channels, const size_t kernel[2], const size_t stride[2], const size_t padding[2], const enum PrismaActivation depthwise_activation, const enum PrismaActivation pointwise_activation) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(in_channels > 0 && out_channels > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(kernel != NULL && stride != NULL && padding != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(depthwise_activation < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(pointwise_activation < PRSM_ACTIVATION_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate layer
+    prsm_layer_separable_t *layer = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_layer_separable_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_layer_separable_t));
+    layer->depthwise_params = (prsm_conv2d_params_t) {
+        .in_channels = in_channels,
+        .out_channels = in_channels,
+        .groups = in_channels,
+        .kernel = {kernel[0], kernel[1]},
+        .stride = {stride[0], stride[1]},
+        .padding = {padding[0], padding[1]},
+        .dilation = {1, 1}
+    };
+    layer->pointwise_params = (prsm_conv2d_params_t) {
+        .in_channels = in_channels,
+        .out_channels = out_channels,
+        .groups = 1,
+        .kernel = {1, 1},
+        .stride = {1, 1},
+        .padding = {0, 0},
+        .dilation = {1, 1}
+    };
+    layer->depthwise_activation = depthwise_activation;
+    layer->pointwise_activation = pointwise_activation;
+    layer->alloctr = alloctr;
+
+    // parameters
+    layer->depthwise_w = prsm_tensor_create(alloctr, 4, in_channels, 1, kernel[0], kernel[1]);
+    layer->depthwise_b = prsm_tensor_create_vec(alloctr, in_channels);
+    layer->pointwise_w = prsm_tensor_create(alloctr, 4, out_channels, in_channels, 1, 1);
+    layer->pointwise_b = prsm_tensor_create_vec(alloctr, out_channels);
+    layer->depthwise_dw = prsm_tensor_create(alloctr, 4, in_channels, 1, kernel[0], kernel[1]);
+    layer->depthwise_db = prsm_tensor_create_vec(alloctr, in_channels);
+    layer->pointwise_dw = prsm_tensor_create(alloctr, 4, out_channels, in_channels, 1, 1);
+    layer->pointwise_db = prsm_tensor_create_vec(alloctr, out_channels);
+    layer->workspace = prsm_tensor_create_vec(alloctr, 1);
+
+    // glorot uniform: a depthwise filter sees KH * KW inputs and feeds KH * KW outputs
+    const prsm_float depthwise_limit = PRSM_SQRT(6.0 / (prsm_float)(2 * kernel[0] * kernel[1]));
+    const prsm_float pointwise_limit = PRSM_SQRT(6.0 / (prsm_float)(in_channels + out_channels));
+    prsm_tensor_rand_uniform(layer->depthwise_w, -depthwise_limit, depthwise_limit);
+    prsm_tensor_rand_uniform(layer->pointwise_w, -pointwise_limit, pointwise_limit);
+    prsm_tensor_set_zeros(layer->depthwise_b);
+    prsm_tensor_set_zeros(layer->pointwise_b);
+
+    return layer;
+}
+
+void prsm_layer_separable_destroy(prsm_layer_separable_t *layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers
+    prsm_tensor_destroy(layer->depthwise_w);
+    prsm_tensor_destroy(layer->depthwise_b);
+    prsm_tensor_destroy(layer->pointwise_w);
+    prsm_tensor_destroy(layer->pointwise_b);
+    prsm_tensor_destroy(layer->depthwise_dw);
+    prsm_tensor_destroy(layer->depthwise_db);
+    prsm_tensor_destroy(layer->pointwise_dw);
+    prsm_tensor_destroy(layer->pointwise_db);
+    prsm_tensor_destroy(layer->workspace);
+    if (layer->dx != NULL) prsm_tensor_destroy(layer->dx);
+    if (layer->dz != NULL) prsm_tensor_destroy(layer->dz);
+    if (layer->dmid != NULL) prsm_tensor_destroy(layer->dmid);
+    if (layer->mid != NULL) prsm_tensor_destroy(layer->mid);
+    if (layer->out != NULL) prsm_tensor_destroy(layer->out);
+
+    // free layer
+    struct VitaBaseAllocatorType *const alloctr = layer->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, layer) : VT_FREE(layer);
+    layer = NULL;
+}
+
+const prsm_tensor_t *prsm_layer_separable_forward(prsm_layer_separable_t *const layer, const prsm_tensor_t *const in) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // out = pw_act(conv1x1(dw_act(depthwise(in) + dw_b)) + pw_b) in one pass
+    layer->out = prsm_conv2d_separable_forward(
+        layer->out, in,
+        layer->depthwise_w, layer->depthwise_b, layer->depthwise_activation,
+        layer->pointwise_w, layer->pointwise_b, layer->pointwise_activation,
+        &layer->depthwise_params, layer->workspace
+    );
+    layer->in = in;
+
+    return layer->out;
+}
+
+const prsm_tensor_t *prsm_layer_separable_backward(prsm_layer_separable_t *const layer, const prsm_tensor_t *const dout, const bool input_grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(layer->in != NULL && layer->out != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+    VT_ENFORCE(prsm_tensor_shapes_match(dout, layer->out), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // the fused forward pass does not keep the depthwise activations
+    layer->mid = prsm_conv2d_forward(layer->mid, layer->in, layer->depthwise_w, layer->depthwise_b, layer->depthwise_activation, &layer->depthwise_params, layer->workspace);
+
+    // dz = dout * pw_act'(out)
+    const prsm_tensor_t *dz = dout;
+    if (layer->pointwise_activation != PRSM_ACTIVATION_LINEAR) {
+        // resize buffer
+        if (layer->dz == NULL) {
+            layer->dz = prsm_tensor_create_ex(layer->alloctr, dout->ndim, dout->shape);
+        } else if (!prsm_tensor_shapes_match(layer->dz, dout)) {
+            prsm_tensor_resize_ex(layer->dz, dout->ndim, dout->shape);
+        }
+
+        const prsm_activate_fn func_d = prsm_activate_get_func_d(layer->pointwise_activation);
+        const size_t size = prsm_tensor_size(dout);
+        VT_FOREACH(i, 0, size) {
+            layer->dz->data[i] = dout->data[i] * func_d(layer->out->data[i]);
+        }
+        dz = layer->dz;
+    }
+
+    // pointwise gradients; dmid = pw_w_T * dz
+    if (layer->dmid == NULL) {
+        layer->dmid = prsm_tensor_create_ex(layer->alloctr, layer->mid->ndim, layer->mid->shape);
+    } else if (!prsm_tensor_shapes_match(layer->dmid, layer->mid)) {
+        prsm_tensor_resize_ex(layer->dmid, layer->mid->ndim, layer->mid->shape);
+    }
+    prsm_conv2d_backward(layer->dmid, layer->pointwise_dw, layer->pointwise_db, dz, layer->mid, layer->pointwise_w, &layer->pointwise_params, layer->workspace);
+
+    // dmid *= dw_act'(mid) in place
+    if (layer->depthwise_activation != PRSM_ACTIVATION_LINEAR) {
+        const prsm_activate_fn func_d = prsm_activate_get_func_d(layer->depthwise_activation);
+        const size_t size = prsm_tensor_size(layer->dmid);
+        VT_FOREACH(i, 0, size) {
+            layer->dmid->data[i] *= func_d(layer->mid->data[i]);
+        }
+    }
+
+    // resize input gradient
+    if (input_grad) {
+        if (layer->dx == NULL) {
+            layer->dx = prsm_tensor_create_ex(layer->alloctr, layer->in->ndim, layer->in->shape);
+        } else if (!prsm_tensor_shapes_match(layer->dx, layer->in)) {
+            prsm_tensor_resize_ex(layer->dx, layer->in->ndim, layer->in->shape);
+        }
+    }
+
+    // depthwise gradients
+    prsm_conv2d_backward(input_grad ? layer->dx : NULL, layer->depthwise_dw, layer->depthwise_db, layer->dmid, layer->in, layer->depthwise_w, &layer->depthwise_params, layer->workspace);
+
+    return input_grad ? layer->dx : NULL;
+}
+
+prsm_layer_batchnorm_t *prsm_layer_batchnorm_create(struct VitaBaseAllocatorType *const alloctr, const size_t channels, const prsm_float momentum, const prsm_float eps) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(channels > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(momentum >= 0 && momentum <= 1 && eps > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate layer
+    prsm_layer_batchnorm_t *layer = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_layer_batchnorm_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_layer_batchnorm_t));
+    layer->channels = channels;
+    layer->momentum = momentum;
+    layer->eps = eps;
+    layer->alloctr = alloctr;
+
+    // parameters
+    layer->gamma = prsm_tensor_create_vec(alloctr, channels);
+    layer->beta = prsm_tensor_create_vec(alloctr, channels);
+    layer->running_mean = prsm_tensor_create_vec(alloctr, channels);
+    layer->running_var = prsm_tensor_create_vec(alloctr, channels);
+    layer->dgamma = prsm_tensor_create_vec(alloctr, channels);
+    layer->dbeta = prsm_tensor_create_vec(alloctr, channels);
+    layer->mean = prsm_tensor_create_vec(alloctr, channels);
+    layer->inv_std = prsm_tensor_create_vec(alloctr, channels);
+
+    // identity transform
+    prsm_tensor_set_ones(layer->gamma);
+    prsm_tensor_set_zeros(layer->beta);
+    prsm_tensor_set_zeros(layer->running_mean);
+    prsm_tensor_set_ones(layer->running_var);
+
+    return layer;
+}
+
+void prsm_layer_batchnorm_destroy(prsm_layer_batchnorm_t *layer) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers
+    prsm_tensor_destroy(layer->gamma);
+    prsm_tensor_destroy(layer->beta);
+    prsm_tensor_destroy(layer->running_mean);
+    prsm_tensor_destroy(layer->running_var);
+    prsm_tensor_destroy(layer->dgamma);
+    prsm_tensor_destroy(layer->dbeta);
+    prsm_tensor_destroy(layer->mean);
+    prsm_tensor_destroy(layer->inv_std);
+    if (layer->dx != NULL) prsm_tensor_destroy(layer->dx);
+    if (layer->xhat != NULL) prsm_tensor_destroy(layer->xhat);
+    if (layer->out != NULL) prsm_tensor_destroy(layer->out);
+
+    // free layer
+    struct VitaBaseAllocatorType *const alloctr = layer->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, layer) : VT_FREE(layer);
+    layer = NULL;
+}
+
+const prsm_tensor_t *prsm_layer_batchnorm_forward(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const in, const bool training) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // scale and shift were moved into the preceding layer
+    if (!training && layer->folded) {
+        return in;
+    }
+
+    // resize output
+    if (layer->out == NULL) {
+        layer->out = prsm_tensor_create_ex(layer->alloctr, in->ndim, in->shape);
+    } else if (!prsm_tensor_shapes_match(layer->out, in)) {
+        prsm_tensor_resize_ex(layer->out, in->ndim, in->shape);
+    }
+    prsm_layer_batchnorm_run(layer, in, layer->out, training);
+
+    return layer->out;
+}
+
+prsm_tensor_t *prsm_layer_batchnorm_forward_inplace(prsm_layer_batchnorm_t *const layer, prsm_tensor_t *const in, const bool training) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // scale and shift were moved into the preceding layer
+    if (!training && layer->folded) {
+        return in;
+    }
+    prsm_layer_batchnorm_run(layer, in, in, training);
+
+    return in;
+}
+
+const prsm_tensor_t *prsm_layer_batchnorm_backward(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const dout, const bool input_grad) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(layer->xhat != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+    VT_ENFORCE(prsm_tensor_shapes_match(dout, layer->xhat), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // resize input gradient
+    if (input_grad) {
+        if (layer->dx == NULL) {
+            layer->dx = prsm_tensor_create_ex(layer->alloctr, dout->ndim, dout->shape);
+        } else if (!prsm_tensor_shapes_match(layer->dx, dout)) {
+            prsm_tensor_resize_ex(layer->dx, dout->ndim, dout->shape);
+        }
+    }
+
+    // every task reduces and differentiates whole channels
+    const size_t hw = (dout->ndim == 4) ? dout->shape[2] * dout->shape[3] : 1;
+    struct PrismaLayerBatchnormContext ctx = {
+        .layer = layer,
+        .xhat = layer->xhat->data,
+        .dout = dout->data,
+        .dx = input_grad ? layer->dx->data : NULL,
+        .n = dout->shape[0],
+        .c = layer->channels,
+        .hw = hw
+    };
+    prsm_parallel_for(ctx.c, prsm_layer_batchnorm_grain(ctx.n, hw), prsm_layer_batchnorm_backward_kernel, &ctx);
+
+    return input_grad ? layer->dx : NULL;
+}
+
+void prsm_layer_batchnorm_fold_dense(prsm_layer_batchnorm_t *const layer, prsm_layer_dense_t *const dense) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(dense != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(dense->out_features == layer->channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(dense->activation == PRSM_ACTIVATION_LINEAR, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // w: (in_features, out_features), channels are columns
+    prsm_layer_batchnorm_fold(layer, dense->w, dense->b, dense->in_features, dense->out_features, false);
+}
+
+void prsm_layer_batchnorm_fold_conv2d(prsm_layer_batchnorm_t *const layer, prsm_layer_conv2d_t *const conv) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(layer != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(conv != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(conv->params.out_channels == layer->channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(conv->activation == PRSM_ACTIVATION_LINEAR, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // w: (out_channels, in_channels/groups * KH * KW), channels are rows
+    const size_t out_channels = conv->params.out_channels;
+    prsm_layer_batchnorm_fold(layer, conv->w, conv->b, out_channels, prsm_tensor_size(conv->w) / out_channels, true);
+    prsm_layer_conv2d_weights_changed(conv);
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Normalizes `in` into `out` with the batch or the running statistics
+ * @param  layer batchnorm layer
+ * @param  in input tensor of shape (N, channels) or (N, channels, H, W)
+ * @param  out output tensor of the same shape; may be `in`
+ * @param  training use and update the batch statistics
+ * @returns None
+ */
+static void prsm_layer_batchnorm_run(prsm_layer_batchnorm_t *const layer, const prsm_tensor_t *const in, prsm_tensor_t *const out, const bool training) {
+    // check for invalid input
+    VT_ENFORCE(in->ndim == 2 || in->ndim == 4, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(in->shape[1] == layer->channels, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(!(training && layer->folded), "%s\n", prsm_status_to_str(PRSM_STATUS_OPERATION_FAILURE));
+
+    // resize normalized input
+    if (training) {
+        if (layer->xhat == NULL) {
+            layer->xhat = prsm_tensor_create_ex(layer->alloctr, in->ndim, in->shape);
+        } else if (!prsm_tensor_shapes_match(layer->xhat, in)) {
+            prsm_tensor_resize_ex(layer->xhat, in->ndim, in->shape);
+        }
+    }
+
+    // every task normalizes whole channels
+    const size_t hw = (in->ndim == 4) ? in->shape[2] * in->shape[3] : 1;
+    struct PrismaLayerBatchnormContext ctx = {
+        .layer = layer,
+        .x = in->data,
+        .y = out->data,
+        .xhat = training ? layer->xhat->data : NULL,
+        .n = in->shape[0],
+        .c = layer->channels,
+        .hw = hw
+    };
+    const size_t grain = prsm_layer_batchnorm_grain(ctx.n, hw);
+    if (training) {
+        prsm_parallel_for(ctx.c, grain, prsm_layer_batchnorm_train_kernel, &ctx);
+    } else {
+        prsm_parallel_for(ctx.c, grain, prsm_layer_batchnorm_infer_kernel, &ctx);
+    }
+}
+
+/**
+ * @brief  Calculates the number of channels per batchnorm task
+ * @param  n batch size
+ * @param  hw elements per channel and sample
+ * @returns size_t
+ */
+static size_t prsm_layer_batchnorm_grain(const size_t n, const size_t hw) {
+    const size_t channel_work = n * hw;
+    return (channel_work >= PRSM_LAYER_BATCHNORM_GRAIN) ? 1 : PRSM_LAYER_BATCHNORM_GRAIN / channel_work;
+}
+
+/**
+ * @brief  Training forward pass over channels [from, to): batch statistics, running statistics and normalization
+ * @param  ctx `struct PrismaLayerBatchnormContext`
+ * @param  from first channel
+ * @param  to one past the last channel
+ * @param  tid worker id
+ * @returns None
+ *
+ * @note sums are taken relative to the first element of the channel, so the one-pass variance does not
+ * cancel catastrophically when the mean is large compared to the spread
+ */
+static void prsm_layer_batchnorm_train_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaLayerBatchnormContext *const c = ctx;
+    prsm_layer_batchnorm_t *const layer = c->layer;
+    const size_t m = c->n * c->hw;
+    VT_FOREACH(ch, from, to) {
+        // sum and sum of squares in one pass
+        const prsm_float shift = c->x[ch * c->hw];
+        prsm_float sum = 0, sum_sq = 0;
+        VT_FOREACH(n, 0, c->n) {
+            const prsm_float *const x = c->x + (n * c->c + ch) * c->hw;
+            VT_FOREACH(k, 0, c->hw) {
+                const prsm_float d = x[k] - shift;
+                sum += d;
+                sum_sq += d * d;
+            }
+        }
+        const prsm_float mean_shifted = sum / (prsm_float)m;
+        const prsm_float var = PRSM_MAX(sum_sq / (prsm_float)m - mean_shifted * mean_shifted, 0);
+        const prsm_float mean = shift + mean_shifted;
+        const prsm_float inv_std = 1 / PRSM_SQRT(var + layer->eps);
+        layer->mean->data[ch] = mean;
+        layer->inv_std->data[ch] = inv_std;
+
+        // running statistics track the unbiased variance
+        const prsm_float unbiased = (m > 1) ? var * (prsm_float)m / (prsm_float)(m - 1) : var;
+        layer->running_mean->data[ch] += layer->momentum * (mean - layer->running_mean->data[ch]);
+        layer->running_var->data[ch] += layer->momentum * (unbiased - layer->running_var->data[ch]);
+
+        // xhat = (x - mean) * inv_std is kept for backward, out = gamma * xhat + beta
+        const prsm_float gamma = layer->gamma->data[ch], beta = layer->beta->data[ch];
+        VT_FOREACH(n, 0, c->n) {
+            const size_t at = (n * c->c + ch) * c->hw;
+            const prsm_float *const x = c->x + at;
+            prsm_float *const y = c->y + at;
+            prsm_float *const xhat = c->xhat + at;
+            VT_FOREACH(k, 0, c->hw) {
+                xhat[k] = (x[k] - mean) * inv_std;
+                y[k] = xhat[k] * gamma + beta;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Inference forward pass over channels [from, to) with the running statistics
+ * @param  ctx `struct PrismaLayerBatchnormContext`
+ * @param  from first channel
+ * @param  to one past the last channel
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_layer_batchnorm_infer_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaLayerBatchnormContext *const c = ctx;
+    const prsm_layer_batchnorm_t *const layer = c->layer;
+    VT_FOREACH(ch, from, to) {
+        const prsm_float scale = layer->gamma->data[ch] / PRSM_SQRT(layer->running_var->data[ch] + layer->eps);
+        const prsm_float offset = layer->beta->data[ch] - layer->running_mean->data[ch] * scale;
+        VT_FOREACH(n, 0, c->n) {
+            const size_t at = (n * c->c + ch) * c->hw;
+            const prsm_float *const x = c->x + at;
+            prsm_float *const y = c->y + at;
+            VT_FOREACH(k, 0, c->hw) {
+                y[k] = x[k] * scale + offset;
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Backward pass over channels [from, to)
+ * @param  ctx `struct PrismaLayerBatchnormContext`
+ * @param  from first channel
+ * @param  to one past the last channel
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_layer_batchnorm_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaLayerBatchnormContext *const c = ctx;
+    prsm_layer_batchnorm_t *const layer = c->layer;
+    const size_t m = c->n * c->hw;
+    VT_FOREACH(ch, from, to) {
+        const prsm_float gamma = layer->gamma->data[ch];
+
+        // dbeta = sum(dout), dgamma = sum(dout * xhat)
+        prsm_float dbeta = 0, dgamma = 0;
+        VT_FOREACH(n, 0, c->n) {
+            const size_t at = (n * c->c + ch) * c->hw;
+            VT_FOREACH(k, 0, c->hw) {
+                dbeta += c->dout[at + k];
+                dgamma += c->dout[at + k] * c->xhat[at + k];
+            }
+        }
+        layer->dbeta->data[ch] = dbeta;
+        layer->dgamma->data[ch] = dgamma;
+        if (c->dx == NULL) {
+            continue;
+        }
+
+        // dx = gamma * inv_std / m * (m * dout - dbeta - xhat * dgamma)
+        const prsm_float k_scale = gamma * layer->inv_std->data[ch] / (prsm_float)m;
+        VT_FOREACH(n, 0, c->n) {
+            const size_t at = (n * c->c + ch) * c->hw;
+            VT_FOREACH(k, 0, c->hw) {
+                c->dx[at + k] = k_scale * ((prsm_float)m * c->dout[at + k] - dbeta - c->xhat[at + k] * dgamma);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Folds the batchnorm transform into the weights and bias of the preceding layer
+ * @param  layer batchnorm layer
+ * @param  w weights viewed as a matrix (rows, cols)
+ * @param  b bias: (channels)
+ * @param  rows weight rows
+ * @param  cols weight columns
+ * @param  channel_rows channels are rows of `w`, otherwise columns
+ * @returns None
+ */
+static void prsm_layer_batchnorm_fold(prsm_layer_batchnorm_t *const layer, prsm_tensor_t *const w, prsm_tensor_t *const b, const size_t rows, const size_t cols, const bool channel_rows) {
+    VT_ENFORCE(!layer->folded, "%s\n", prsm_status_to_str(PRSM_STATUS_OPERATION_FAILURE));
+
+    // s = gamma / sqrt(var + eps), b = (b - mean) * s + beta
+    prsm_tensor_t *const scale = prsm_tensor_create_vec(layer->alloctr, layer->channels);
+    prsm_float *const s = scale->data;
+    VT_FOREACH(ch, 0, layer->channels) {
+        s[ch] = layer->gamma->data[ch] / PRSM_SQRT(layer->running_var->data[ch] + layer->eps);
+        b->data[ch] = (b->data[ch] - layer->running_mean->data[ch]) * s[ch] + layer->beta->data[ch];
+    }
+
+    // w *= s along the output channels
+    VT_FOREACH(i, 0, rows) {
+        prsm_float *const w_row = w->data + i * cols;
+        if (channel_rows) {
+            VT_FOREACH(j, 0, cols) {
+                w_row[j] *= s[i];
+            }
+        } else {
+            VT_FOREACH(j, 0, cols) {
+                w_row[j] *= s[j];
+            }
+        }
+    }
+    prsm_tensor_destroy(scale);
+    layer->folded = true;
+}
@@ -0,0 +1,109 @@
+#include "prisma/core/mmap.h"
+
+#if defined(_WIN32) || defined(_WIN64)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+enum PrismaStatus prsm_mmap_open(prsm_mmap_t *const m, const char *const filename) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(m != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(filename != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // zero-init
+    *m = (prsm_mmap_t) {0};
+
+#if defined(_WIN32) || defined(_WIN64)
+    // open file
+    HANDLE hfile = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hfile == INVALID_HANDLE_VALUE) {
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    // query size: empty files cannot be mapped
+    LARGE_INTEGER size = {0};
+    if (!GetFileSizeEx(hfile, &size) || size.QuadPart == 0) {
+        CloseHandle(hfile);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    // map file
+    HANDLE hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hmap == NULL) {
+        CloseHandle(hfile);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    const void *data = MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(hmap);
+        CloseHandle(hfile);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    *m = (prsm_mmap_t) {
+        .data = data,
+        .size = (size_t)size.QuadPart,
+        .hfile = hfile,
+        .hmap = hmap
+    };
+#else
+    // open file
+    const int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    // query size: empty files cannot be mapped
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    // map file
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        close(fd);
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    *m = (prsm_mmap_t) {
+        .data = data,
+        .size = (size_t)st.st_size,
+        .fd = fd
+    };
+#endif
+
+    return PRSM_STATUS_OPERATION_SUCCESS;
+}
+
+void prsm_mmap_close(prsm_mmap_t *const m) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(m != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // if not mapped, skip
+    if (prsm_mmap_is_null(m)) {
+        return;
+    }
+
+#if defined(_WIN32) || defined(_WIN64)
+    UnmapViewOfFile(m->data);
+    CloseHandle(m->hmap);
+    CloseHandle(m->hfile);
+#else
+    munmap((void*)m->data, m->size);
+    close(m->fd);
+#endif
+
+    *m = (prsm_mmap_t) {0};
+}
+
+bool prsm_mmap_is_null(const prsm_mmap_t *const m) {
+    return (m == NULL || m->data == NULL);
+}
+
@@ -0,0 +1,230 @@
+#include "prisma/core/optim.h"
+
+// minimum elements per task
+#define PRSM_OPTIM_GRAIN (16 * 1024)
+
+// shared state of a parallel multi-tensor step
+struct PrismaOptimContext {
+    const prsm_optim_t *optim;
+    prsm_tensor_t *const *params;
+    const prsm_tensor_t *const *grads;
+    prsm_float clip;                        // clipping bound; infinity if disabled
+    prsm_float step_size;                   // Adam: lr / (1 - beta1^t)
+    prsm_float inv_sqrt_bc2;                // Adam: 1 / sqrt(1 - beta2^t)
+};
+
+static void prsm_optim_init_state(prsm_optim_t *const optim, prsm_tensor_t *const params[], const size_t count);
+static void prsm_optim_update(const struct PrismaOptimContext *const c, const size_t t, const size_t from, const size_t to);
+static void prsm_optim_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+
+prsm_optim_t *prsm_optim_create(struct VitaBaseAllocatorType *const alloctr, const prsm_optim_params_t *const params) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params->type < PRSM_OPTIM_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(params->lr > 0 && params->momentum >= 0 && params->weight_decay >= 0 && params->clip >= 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (params->type != PRSM_OPTIM_SGD) {
+        VT_ENFORCE(
+            params->beta1 >= 0 && params->beta1 < 1 && params->beta2 >= 0 && params->beta2 < 1 && params->eps > 0,
+            "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+        );
+    }
+
+    // allocate optimizer
+    prsm_optim_t *optim = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_optim_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_optim_t));
+    optim->params = *params;
+    optim->alloctr = alloctr;
+
+    return optim;
+}
+
+void prsm_optim_destroy(prsm_optim_t *optim) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(optim != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free state
+    prsm_optim_reset(optim);
+
+    // free optimizer
+    struct VitaBaseAllocatorType *const alloctr = optim->alloctr;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, optim) : VT_FREE(optim);
+    optim = NULL;
+}
+
+void prsm_optim_reset(prsm_optim_t *const optim) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(optim != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free buffers
+    struct VitaBaseAllocatorType *const alloctr = optim->alloctr;
+    VT_FOREACH(i, 0, optim->count) {
+        if (optim->m != NULL) prsm_tensor_destroy(optim->m[i]);
+        if (optim->v != NULL) prsm_tensor_destroy(optim->v[i]);
+    }
+    if (optim->m != NULL) (alloctr) ? VT_ALLOCATOR_FREE(alloctr, optim->m) : VT_FREE(optim->m);
+    if (optim->v != NULL) (alloctr) ? VT_ALLOCATOR_FREE(alloctr, optim->v) : VT_FREE(optim->v);
+    if (optim->offsets != NULL) (alloctr) ? VT_ALLOCATOR_FREE(alloctr, optim->offsets) : VT_FREE(optim->offsets);
+
+    optim->m = NULL;
+    optim->v = NULL;
+    optim->offsets = NULL;
+    optim->count = 0;
+    optim->step = 0;
+}
+
+void prsm_optim_step(prsm_optim_t *const optim, prsm_tensor_t *const params[], const prsm_tensor_t *const grads[], const size_t count) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(optim != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL && grads != NULL && count > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, count) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(params[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(grads[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(prsm_tensor_size(params[i]) == prsm_tensor_size(grads[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // allocate state on the first step, then check that the same tensors are passed
+    if (optim->offsets == NULL) {
+        prsm_optim_init_state(optim, params, count);
+    }
+    VT_ENFORCE(optim->count == count, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_FOREACH(i, 0, count) {
+        VT_ENFORCE(prsm_tensor_size(params[i]) == optim->offsets[i + 1] - optim->offsets[i], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    const prsm_optim_params_t *const p = &optim->params;
+    VT_ENFORCE(p->type != PRSM_OPTIM_SGD || p->momentum == 0 || optim->m != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+
+    // bias corrections of the Adam moments
+    optim->step++;
+    struct PrismaOptimContext ctx = {
+        .optim = optim,
+        .params = params,
+        .grads = grads,
+        .clip = (p->clip > 0) ? p->clip : (prsm_float)INFINITY,
+        .step_size = p->lr,
+        .inv_sqrt_bc2 = 1
+    };
+    if (p->type != PRSM_OPTIM_SGD) {
+        ctx.step_size = p->lr / (1 - PRSM_POW(p->beta1, (prsm_float)optim->step));
+        ctx.inv_sqrt_bc2 = 1 / PRSM_SQRT(1 - PRSM_POW(p->beta2, (prsm_float)optim->step));
+    }
+
+    // every task updates a chunk of the concatenated parameters
+    prsm_parallel_for(optim->offsets[count], PRSM_OPTIM_GRAIN, prsm_optim_kernel, &ctx);
+}
+
+size_t prsm_optim_find(const size_t *const offsets, const size_t count, const size_t at) {
+    // last tensor starting at or before `at`
+    size_t lo = 0, hi = count;
+    while (hi - lo > 1) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (offsets[mid] <= at) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Allocates the optimizer state for the given parameters
+ * @param  optim optimizer
+ * @param  params parameter tensors
+ * @param  count number of tensors
+ * @returns None
+ */
+static void prsm_optim_init_state(prsm_optim_t *const optim, prsm_tensor_t *const params[], const size_t count) {
+    struct VitaBaseAllocatorType *const alloctr = optim->alloctr;
+    optim->count = count;
+    optim->offsets = (alloctr == NULL)
+        ? VT_CALLOC((count + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (count + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, count) {
+        optim->offsets[i + 1] = optim->offsets[i] + prsm_tensor_size(params[i]);
+    }
+
+    // plain SGD keeps no state, SGD with momentum one buffer, Adam two
+    const bool adam = optim->params.type != PRSM_OPTIM_SGD;
+    const size_t buffers = adam ? 2 : (optim->params.momentum > 0) ? 1 : 0;
+    VT_FOREACH(b, 0, buffers) {
+        prsm_tensor_t **const state = (alloctr == NULL)
+            ? VT_CALLOC(count * sizeof(prsm_tensor_t*))
+            : VT_ALLOCATOR_ALLOC(alloctr, count * sizeof(prsm_tensor_t*));
+        VT_FOREACH(i, 0, count) {
+            state[i] = prsm_tensor_create_ex(alloctr, params[i]->ndim, params[i]->shape);
+            prsm_tensor_set_zeros(state[i]);
+        }
+        if (b == 0) optim->m = state;
+        else optim->v = state;
+    }
+}
+
+/**
+ * @brief  Updates elements [from, to) of one parameter tensor
+ * @param  c `struct PrismaOptimContext`
+ * @param  t tensor index
+ * @param  from first element
+ * @param  to one past the last element
+ * @returns None
+ */
+static void prsm_optim_update(const struct PrismaOptimContext *const c, const size_t t, const size_t from, const size_t to) {
+    const prsm_optim_params_t *const p = &c->optim->params;
+    prsm_float *const w = c->params[t]->data;
+    const prsm_float *const g = c->grads[t]->data;
+    prsm_float *const m = (c->optim->m == NULL) ? NULL : c->optim->m[t]->data;
+    prsm_float *const v = (c->optim->v == NULL) ? NULL : c->optim->v[t]->data;
+    const prsm_float clip = c->clip, lr = p->lr;
+
+    if (p->type == PRSM_OPTIM_SGD) {
+        const prsm_float wd = p->weight_decay, mu = p->momentum;
+        if (m == NULL) {
+            // w -= lr * (clip(g) + wd * w)
+            VT_FOREACH(i, from, to) {
+                const prsm_float gc = (g[i] > clip) ? clip : (g[i] < -clip) ? -clip : g[i];
+                w[i] -= lr * (gc + wd * w[i]);
+            }
+        } else {
+            // m = mu * m + clip(g) + wd * w, w -= lr * m
+            VT_FOREACH(i, from, to) {
+                const prsm_float gc = (g[i] > clip) ? clip : (g[i] < -clip) ? -clip : g[i];
+                m[i] = mu * m[i] + gc + wd * w[i];
+                w[i] -= lr * m[i];
+            }
+        }
+        return;
+    }
+
+    // Adam adds weight decay to the gradient, AdamW shrinks the weights directly
+    const prsm_float b1 = p->beta1, b2 = p->beta2, eps = p->eps;
+    const prsm_float wd = (p->type == PRSM_OPTIM_ADAM) ? p->weight_decay : 0;
+    const prsm_float decay = (p->type == PRSM_OPTIM_ADAMW) ? 1 - lr * p->weight_decay : 1;
+    const prsm_float step_size = c->step_size, inv_sqrt_bc2 = c->inv_sqrt_bc2;
+    VT_FOREACH(i, from, to) {
+        const prsm_float gc = ((g[i] > clip) ? clip : (g[i] < -clip) ? -clip : g[i]) + wd * w[i];
+        m[i] = b1 * m[i] + (1 - b1) * gc;
+        v[i] = b2 * v[i] + (1 - b2) * gc * gc;
+        w[i] = w[i] * decay - step_size * m[i] / (PRSM_SQRT(v[i]) * inv_sqrt_bc2 + eps);
+    }
+}
+
+/**
+ * @brief  Updates elements [from, to) of the concatenated parameters
+ * @param  ctx `struct PrismaOptimContext`
+ * @param  from first element
+ * @param  to one past the last element
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_optim_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaOptimContext *const c = ctx;
+    const size_t *const offsets = c->optim->offsets;
+
+    // walk the tensors the chunk spans
+    size_t at = from;
+    for (size_t t = prsm_optim_find(offsets, c->optim->count, from); at < to; t++) {
+        const size_t end = (offsets[t + 1] < to) ? offsets[t + 1] : to;
+        prsm_optim_update(c, t, at - offsets[t], end - offsets[t]);
+        at = end;
+    }
+}
@@ -0,0 +1,481 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE // pthread_setaffinity_np
+#endif
+
+#include "prisma/core/parallel.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    #include <unistd.h>
+    #include <sched.h>
+#endif
+
+// maximum number of workers per parallel region
+#define PRSM_PARALLEL_MAX_THREADS 256
+
+// thread-local storage qualifier
+#if defined(_MSC_VER)
+    #define PRSM_PARALLEL_THREAD_LOCAL __declspec(thread)
+#else
+    #define PRSM_PARALLEL_THREAD_LOCAL _Thread_local
+#endif
+
+// pool polls before yielding the processor, and yields before going to sleep
+#define PRSM_PARALLEL_SPIN 256
+#define PRSM_PARALLEL_YIELD 64
+
+// worker arguments
+struct PrismaParallelTask {
+    prsm_parallel_fn fn;
+    void *ctx;
+    size_t from;
+    size_t to;
+    size_t tid;
+};
+
+// pool worker arguments
+struct PrismaParallelWorker {
+    size_t id;              // runs block `id` of every loop that has more than `id + 1` blocks
+    size_t generation;      // last loop seen
+};
+
+// persistent workers of `prsm_parallel_for`; started on first use, never stopped
+static struct PrismaParallelPool {
+    prsm_mutex_t mutex;
+    prsm_cond_t wake;                                                   // a new loop was published
+    prsm_cond_t done;                                                   // all worker blocks finished
+    prsm_thread_t threads[PRSM_PARALLEL_MAX_THREADS - 1];
+    struct PrismaParallelWorker workers[PRSM_PARALLEL_MAX_THREADS - 1];
+    struct PrismaParallelTask tasks[PRSM_PARALLEL_MAX_THREADS - 1];    // worker blocks of the current loop
+    size_t num_workers;                                                 // started workers
+    size_t num_tasks;                                                   // worker blocks of the current loop
+    size_t generation;                                                  // incremented for every loop
+    size_t pending;                                                     // worker blocks not finished yet
+    bool ready;                                                         // mutex and conditions initialized
+} gi_pool;
+
+// non-zero while a thread runs a loop on the pool
+static size_t gi_pool_busy = 0;
+
+// 0 means "use default"
+static size_t gi_num_threads = 0;
+
+// set while the current thread executes a parallel_for block
+static PRSM_PARALLEL_THREAD_LOCAL bool gi_in_region = false;
+
+// number of blocks of the last top-level parallel_for of the current thread
+static PRSM_PARALLEL_THREAD_LOCAL size_t gi_num_blocks = 0;
+
+static size_t prsm_parallel_num_processors(void);
+static bool prsm_parallel_pool_run(const struct PrismaParallelTask *const tasks, const size_t num_blocks);
+static void prsm_parallel_pool_worker(void *const arg);
+static void prsm_parallel_spawn_run(const struct PrismaParallelTask *const tasks, const size_t num_blocks);
+static void prsm_parallel_run_task(void *const arg);
+#if defined(_WIN32) || defined(_WIN64)
+    static DWORD WINAPI prsm_thread_main(LPVOID arg);
+#else
+    static void *prsm_thread_main(void *arg);
+#endif
+
+size_t prsm_parallel_get_num_threads(void) {
+    const size_t num_threads = (gi_num_threads == 0) ? prsm_parallel_num_processors() : gi_num_threads;
+    return (num_threads > PRSM_PARALLEL_MAX_THREADS) ? PRSM_PARALLEL_MAX_THREADS : num_threads;
+}
+
+void prsm_parallel_set_num_threads(const size_t num_threads) {
+    gi_num_threads = num_threads;
+}
+
+void prsm_parallel_for(const size_t size, const size_t grain, prsm_parallel_fn fn, void *const ctx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(fn != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // nothing to do
+    if (size == 0) {
+        gi_num_blocks = 0;
+        return;
+    }
+
+    // nested region: the enclosing region already occupies the workers, so run on the calling thread
+    if (gi_in_region) {
+        fn(ctx, 0, size, 0);
+        return;
+    }
+
+    // number of blocks: each at least `grain` elements long
+    const size_t num_threads = prsm_parallel_get_num_threads();
+    const size_t min_block = (grain == 0) ? 1 : grain;
+    const size_t max_blocks = (size + min_block - 1) / min_block;
+    const size_t num_blocks = (max_blocks < num_threads) ? max_blocks : num_threads;
+    gi_num_blocks = (num_blocks == 0) ? 1 : num_blocks;
+    if (num_blocks <= 1) {
+        gi_in_region = true;
+        fn(ctx, 0, size, 0);
+        gi_in_region = false;
+        return;
+    }
+
+    // split range evenly; the first `rem` blocks get one extra element
+    struct PrismaParallelTask tasks[PRSM_PARALLEL_MAX_THREADS];
+    const size_t block = size / num_blocks;
+    const size_t rem = size % num_blocks;
+    size_t from = 0;
+    VT_FOREACH(i, 0, num_blocks) {
+        const size_t len = block + (i < rem);
+        tasks[i] = (struct PrismaParallelTask) {
+            .fn = fn,
+            .ctx = ctx,
+            .from = from,
+            .to = from + len,
+            .tid = i
+        };
+        from += len;
+    }
+
+    // run on the worker pool; while another thread's loop occupies it, on short-lived threads
+    gi_in_region = true;
+    if (!prsm_parallel_pool_run(tasks, num_blocks)) {
+        prsm_parallel_spawn_run(tasks, num_blocks);
+    }
+    gi_in_region = false;
+}
+
+size_t prsm_parallel_get_num_blocks(void) {
+    return gi_num_blocks;
+}
+
+bool prsm_thread_create(prsm_thread_t *const thread, void (*fn)(void *const arg), void *const arg) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(thread != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(fn != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    thread->fn = fn;
+    thread->arg = arg;
+
+#if defined(_WIN32) || defined(_WIN64)
+    thread->handle = CreateThread(NULL, 0, prsm_thread_main, thread, 0, NULL);
+    return thread->handle != NULL;
+#else
+    return pthread_create(&thread->handle, NULL, prsm_thread_main, thread) == 0;
+#endif
+}
+
+void prsm_thread_join(prsm_thread_t *const thread) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(thread != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+#if defined(_WIN32) || defined(_WIN64)
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+#else
+    pthread_join(thread->handle, NULL);
+#endif
+}
+
+bool prsm_thread_pin(const size_t cpu) {
+#if defined(_WIN32) || defined(_WIN64)
+    if (cpu >= sizeof(DWORD_PTR) * 8) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu; // not supported
+    return false;
+#endif
+}
+
+void prsm_thread_yield(void) {
+#if defined(_WIN32) || defined(_WIN64)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+
+void prsm_mutex_init(prsm_mutex_t *const mutex) {
+#if defined(_WIN32) || defined(_WIN64)
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+void prsm_mutex_destroy(prsm_mutex_t *const mutex) {
+#if defined(_WIN32) || defined(_WIN64)
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+void prsm_mutex_lock(prsm_mutex_t *const mutex) {
+#if defined(_WIN32) || defined(_WIN64)
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+void prsm_mutex_unlock(prsm_mutex_t *const mutex) {
+#if defined(_WIN32) || defined(_WIN64)
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+void prsm_cond_init(prsm_cond_t *const cond) {
+#if defined(_WIN32) || defined(_WIN64)
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+void prsm_cond_destroy(prsm_cond_t *const cond) {
+#if defined(_WIN32) || defined(_WIN64)
+    (void)cond; // nothing to release
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+void prsm_cond_wait(prsm_cond_t *const cond, prsm_mutex_t *const mutex) {
+#if defined(_WIN32) || defined(_WIN64)
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+void prsm_cond_signal(prsm_cond_t *const cond) {
+#if defined(_WIN32) || defined(_WIN64)
+    WakeConditionVariable(cond);
+#else
+    pthread_cond_signal(cond);
+#endif
+}
+
+void prsm_cond_broadcast(prsm_cond_t *const cond) {
+#if defined(_WIN32) || defined(_WIN64)
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+size_t prsm_atomic_load(size_t *const ptr) {
+#if defined(_MSC_VER)
+    return (size_t)InterlockedCompareExchangePointer((PVOID volatile *)ptr, NULL, NULL);
+#else
+    return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+#endif
+}
+
+void prsm_atomic_store(size_t *const ptr, const size_t value) {
+#if defined(_MSC_VER)
+    InterlockedExchangePointer((PVOID volatile *)ptr, (PVOID)value);
+#else
+    __atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+#endif
+}
+
+size_t prsm_atomic_fetch_add(size_t *const ptr, const size_t value) {
+#if defined(_MSC_VER)
+    return (size_t)InterlockedExchangeAddSizeT(ptr, value);
+#else
+    return __atomic_fetch_add(ptr, value, __ATOMIC_ACQ_REL);
+#endif
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Returns the number of online processors
+ * @returns size_t
+ */
+static size_t prsm_parallel_num_processors(void) {
+#if defined(_WIN32) || defined(_WIN64)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwNumberOfProcessors;
+#else
+    const long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return (n > 0) ? (size_t)n : 1;
+#endif
+}
+
+/**
+ * @brief  Runs blocks on the worker pool, starting missing workers; the calling thread executes the last block
+ * @param  tasks blocks
+ * @param  num_blocks number of blocks; at least 2
+ * @returns false if another thread is running a loop on the pool, nothing is run then
+ */
+static bool prsm_parallel_pool_run(const struct PrismaParallelTask *const tasks, const size_t num_blocks) {
+    // the first caller owns the pool until the loop is done
+    if (prsm_atomic_fetch_add(&gi_pool_busy, 1) != 0) {
+        return false;
+    }
+
+    // initialize on first use
+    if (!gi_pool.ready) {
+        prsm_mutex_init(&gi_pool.mutex);
+        prsm_cond_init(&gi_pool.wake);
+        prsm_cond_init(&gi_pool.done);
+        gi_pool.ready = true;
+    }
+
+    // start missing workers; blocks without a worker run on the calling thread
+    const size_t num_tasks = num_blocks - 1;
+    prsm_mutex_lock(&gi_pool.mutex);
+    while (gi_pool.num_workers < num_tasks) {
+        struct PrismaParallelWorker *const worker = &gi_pool.workers[gi_pool.num_workers];
+        *worker = (struct PrismaParallelWorker) {
+            .id = gi_pool.num_workers,
+            .generation = gi_pool.generation
+        };
+        if (!prsm_thread_create(&gi_pool.threads[gi_pool.num_workers], prsm_parallel_pool_worker, worker)) {
+            break;
+        }
+        gi_pool.num_workers++;
+    }
+
+    // publish the loop
+    const size_t num_workers = (gi_pool.num_workers < num_tasks) ? gi_pool.num_workers : num_tasks;
+    VT_FOREACH(i, 0, num_workers) {
+        gi_pool.tasks[i] = tasks[i];
+    }
+    gi_pool.num_tasks = num_workers;
+    prsm_atomic_store(&gi_pool.pending, num_workers);
+    prsm_atomic_store(&gi_pool.generation, gi_pool.generation + 1);
+    prsm_cond_broadcast(&gi_pool.wake);
+    prsm_mutex_unlock(&gi_pool.mutex);
+
+    // run the last block and the blocks left without a worker on the calling thread
+    tasks[num_blocks - 1].fn(tasks[num_blocks - 1].ctx, tasks[num_blocks - 1].from, tasks[num_blocks - 1].to, tasks[num_blocks - 1].tid);
+    VT_FOREACH(i, num_workers, num_tasks) {
+        tasks[i].fn(tasks[i].ctx, tasks[i].from, tasks[i].to, tasks[i].tid);
+    }
+
+    // wait for the workers: poll, then sleep
+    for (size_t spin = 0; prsm_atomic_load(&gi_pool.pending) != 0 && spin < PRSM_PARALLEL_SPIN + PRSM_PARALLEL_YIELD; spin++) {
+        if (spin >= PRSM_PARALLEL_SPIN) prsm_thread_yield();
+    }
+    prsm_mutex_lock(&gi_pool.mutex);
+    while (prsm_atomic_load(&gi_pool.pending) != 0) {
+        prsm_cond_wait(&gi_pool.done, &gi_pool.mutex);
+    }
+    prsm_mutex_unlock(&gi_pool.mutex);
+
+    // release the pool
+    prsm_atomic_store(&gi_pool_busy, 0);
+    return true;
+}
+
+/**
+ * @brief  Pool worker body: waits for loops and runs its block of each
+ * @param  arg struct PrismaParallelWorker*
+ * @returns None
+ */
+static void prsm_parallel_pool_worker(void *const arg) {
+    struct PrismaParallelWorker *const worker = arg;
+
+    // loops called from a block run serially
+    gi_in_region = true;
+    for (;;) {
+        // wait for the next loop: poll, then yield, then sleep
+        for (size_t spin = 0; prsm_atomic_load(&gi_pool.generation) == worker->generation && spin < PRSM_PARALLEL_SPIN + PRSM_PARALLEL_YIELD; spin++) {
+            if (spin >= PRSM_PARALLEL_SPIN) prsm_thread_yield();
+        }
+        prsm_mutex_lock(&gi_pool.mutex);
+        while (prsm_atomic_load(&gi_pool.generation) == worker->generation) {
+            prsm_cond_wait(&gi_pool.wake, &gi_pool.mutex);
+        }
+        worker->generation = prsm_atomic_load(&gi_pool.generation);
+        const bool has_task = worker->id < gi_pool.num_tasks;
+        const struct PrismaParallelTask task = has_task ? gi_pool.tasks[worker->id] : (struct PrismaParallelTask) {0};
+        prsm_mutex_unlock(&gi_pool.mutex);
+        if (!has_task) {
+            continue;
+        }
+
+        // run the block and report
+        task.fn(task.ctx, task.from, task.to, task.tid);
+        prsm_mutex_lock(&gi_pool.mutex);
+        if (prsm_atomic_fetch_add(&gi_pool.pending, (size_t)-1) == 1) {
+            prsm_cond_signal(&gi_pool.done);
+        }
+        prsm_mutex_unlock(&gi_pool.mutex);
+    }
+}
+
+/**
+ * @brief  Runs blocks on short-lived threads; the calling thread executes the last block
+ * @param  tasks blocks
+ * @param  num_blocks number of blocks; at least 2
+ * @returns None
+ *
+ * @note if a thread cannot be created, its block runs on the calling thread
+ */
+static void prsm_parallel_spawn_run(const struct PrismaParallelTask *const tasks, const size_t num_blocks) {
+    // spawn workers
+    prsm_thread_t threads[PRSM_PARALLEL_MAX_THREADS];
+    bool spawned[PRSM_PARALLEL_MAX_THREADS];
+    VT_FOREACH(i, 0, num_blocks - 1) {
+        spawned[i] = prsm_thread_create(&threads[i], prsm_parallel_run_task, (void *)&tasks[i]);
+    }
+
+    // run the last block on the calling thread
+    tasks[num_blocks - 1].fn(tasks[num_blocks - 1].ctx, tasks[num_blocks - 1].from, tasks[num_blocks - 1].to, tasks[num_blocks - 1].tid);
+
+    // join
+    VT_FOREACH(i, 0, num_blocks - 1) {
+        if (spawned[i]) {
+            prsm_thread_join(&threads[i]);
+        } else {
+            tasks[i].fn(tasks[i].ctx, tasks[i].from, tasks[i].to, tasks[i].tid);
+        }
+    }
+}
+
+/**
+ * @brief  Runs a parallel_for block
+ * @param  arg struct PrismaParallelTask*
+ * @returns None
+ */
+static void prsm_parallel_run_task(void *const arg) {
+    const struct PrismaParallelTask *task = arg;
+    gi_in_region = true;
+    task->fn(task->ctx, task->from, task->to, task->tid);
+}
+
+#if defined(_WIN32) || defined(_WIN64)
+/**
+ * @brief  Thread entry point
+ * @param  arg prsm_thread_t*
+ * @returns 0
+ */
+static DWORD WINAPI prsm_thread_main(LPVOID arg) {
+    const prsm_thread_t *thread = arg;
+    thread->fn(thread->arg);
+    return 0;
+}
+#else
+/**
+ * @brief  Thread entry point
+ * @param  arg prsm_thread_t*
+ * @returns NULL
+ */
+static void *prsm_thread_main(void *arg) {
+    const prsm_thread_t *thread = arg;
+    thread->fn(thread->arg);
+    return NULL;
+}
+#endif
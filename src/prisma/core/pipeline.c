@@ -0,0 +1,309 @@
+#include "prisma/core/pipeline.h"
+
+// queue polls before yielding the processor
+#define PRSM_PIPELINE_SPIN 256
+
+// micro-batch index that stops a stage thread
+#define PRSM_PIPELINE_STOP SIZE_MAX
+
+static void prsm_pipeline_thread(void *const arg);
+static void prsm_pipeline_stage_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static prsm_tensor_t *prsm_pipeline_store(struct VitaBaseAllocatorType *const alloctr, prsm_tensor_t *out, const prsm_tensor_t *const in);
+static struct PrismaPipelineSlot *prsm_pipeline_queue_back(struct PrismaPipelineQueue *const q, const size_t depth, const bool wait);
+static void prsm_pipeline_queue_push(struct PrismaPipelineQueue *const q);
+static struct PrismaPipelineSlot *prsm_pipeline_queue_front(struct PrismaPipelineQueue *const q, const size_t depth, const bool wait);
+static void prsm_pipeline_queue_pop(struct PrismaPipelineQueue *const q);
+
+prsm_pipeline_t *prsm_pipeline_create(
+    struct VitaBaseAllocatorType *const alloctr, const prsm_pipeline_stage_t stages[], const size_t num_stages,
+    const size_t depth, const bool pin
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(stages != NULL && num_stages > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(depth > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, num_stages) {
+        VT_DEBUG_ASSERT(stages[i].fn != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    }
+
+    // allocate pipeline
+    prsm_pipeline_t *pipeline = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_pipeline_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_pipeline_t));
+    pipeline->num_stages = num_stages;
+    pipeline->depth = depth;
+    pipeline->alloctr = alloctr;
+
+    // stages
+    pipeline->stages = (alloctr == NULL)
+        ? VT_CALLOC(num_stages * sizeof(prsm_pipeline_stage_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, num_stages * sizeof(prsm_pipeline_stage_t));
+    VT_FOREACH(i, 0, num_stages) {
+        pipeline->stages[i] = stages[i];
+    }
+
+    // queues: one in front of every stage and one behind the last stage
+    pipeline->queues = (alloctr == NULL)
+        ? VT_CALLOC((num_stages + 1) * sizeof(struct PrismaPipelineQueue))
+        : VT_ALLOCATOR_ALLOC(alloctr, (num_stages + 1) * sizeof(struct PrismaPipelineQueue));
+    VT_FOREACH(i, 0, num_stages + 1) {
+        pipeline->queues[i].slots = (alloctr == NULL)
+            ? VT_CALLOC(depth * sizeof(struct PrismaPipelineSlot))
+            : VT_ALLOCATOR_ALLOC(alloctr, depth * sizeof(struct PrismaPipelineSlot));
+    }
+
+    // start stage threads
+    pipeline->workers = (alloctr == NULL)
+        ? VT_CALLOC(num_stages * sizeof(struct PrismaPipelineWorker))
+        : VT_ALLOCATOR_ALLOC(alloctr, num_stages * sizeof(struct PrismaPipelineWorker));
+    pipeline->threads = (alloctr == NULL)
+        ? VT_CALLOC(num_stages * sizeof(prsm_thread_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, num_stages * sizeof(prsm_thread_t));
+    VT_FOREACH(i, 0, num_stages) {
+        pipeline->workers[i] = (struct PrismaPipelineWorker) {
+            .pipeline = pipeline,
+            .stage = i,
+            .pin = pin
+        };
+        VT_ENFORCE(
+            prsm_thread_create(&pipeline->threads[i], prsm_pipeline_thread, &pipeline->workers[i]),
+            "%s\n", prsm_status_to_str(PRSM_STATUS_OPERATION_FAILURE)
+        );
+    }
+
+    return pipeline;
+}
+
+void prsm_pipeline_destroy(prsm_pipeline_t *pipeline) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pipeline != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // stop: the marker travels through all stages, every stage exits after forwarding it
+    struct PrismaPipelineSlot *const slot = prsm_pipeline_queue_back(&pipeline->queues[0], pipeline->depth, true);
+    slot->index = PRSM_PIPELINE_STOP;
+    prsm_pipeline_queue_push(&pipeline->queues[0]);
+    VT_FOREACH(i, 0, pipeline->num_stages) {
+        prsm_thread_join(&pipeline->threads[i]);
+    }
+
+    // free queues
+    struct VitaBaseAllocatorType *const alloctr = pipeline->alloctr;
+    VT_FOREACH(i, 0, pipeline->num_stages + 1) {
+        VT_FOREACH(j, 0, pipeline->depth) {
+            if (pipeline->queues[i].slots[j].tensor != NULL) prsm_tensor_destroy(pipeline->queues[i].slots[j].tensor);
+        }
+        (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline->queues[i].slots) : VT_FREE(pipeline->queues[i].slots);
+    }
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline->queues) : VT_FREE(pipeline->queues);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline->stages) : VT_FREE(pipeline->stages);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline->workers) : VT_FREE(pipeline->workers);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline->threads) : VT_FREE(pipeline->threads);
+
+    // free pipeline
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, pipeline) : VT_FREE(pipeline);
+    pipeline = NULL;
+}
+
+prsm_tensor_t *prsm_pipeline_run(prsm_tensor_t *out, prsm_pipeline_t *const pipeline, const prsm_tensor_t *const in, const size_t micro_batch) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(pipeline != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(in->ndim <= PRSM_PIPELINE_MAX_DIMS && in->shape[0] > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(micro_batch > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    const size_t n = in->shape[0];
+    const size_t count = (n + micro_batch - 1) / micro_batch;
+    const size_t in_row = prsm_tensor_size(in) / n;
+    struct PrismaPipelineQueue *const first = &pipeline->queues[0];
+    struct PrismaPipelineQueue *const last = &pipeline->queues[pipeline->num_stages];
+
+    // feed micro-batches and collect results until all are back; never block on one side only
+    prsm_tensor_t *ret = out;
+    size_t sent = 0, received = 0;
+    while (received < count) {
+        bool progress = false;
+
+        // feed the next micro-batch: a view into the batch, no copy
+        struct PrismaPipelineSlot *const next = (sent < count) ? prsm_pipeline_queue_back(first, pipeline->depth, false) : NULL;
+        if (next != NULL) {
+            const size_t from = sent * micro_batch;
+            VT_FOREACH(d, 0, in->ndim) {
+                next->view_shape[d] = in->shape[d];
+            }
+            next->view_shape[0] = (n - from < micro_batch) ? n - from : micro_batch;
+            next->view = (prsm_tensor_t) {
+                .ndim = in->ndim,
+                .shape = next->view_shape,
+                .data = in->data + from * in_row,
+                .is_view = true
+            };
+            next->index = sent++;
+            prsm_pipeline_queue_push(first);
+            progress = true;
+        }
+
+        // collect a finished micro-batch
+        struct PrismaPipelineSlot *const done = prsm_pipeline_queue_front(last, pipeline->depth, false);
+        if (done != NULL) {
+            const prsm_tensor_t *const result = done->tensor;
+            const size_t rows = (n - done->index * micro_batch < micro_batch) ? n - done->index * micro_batch : micro_batch;
+            VT_ENFORCE(result->ndim <= PRSM_PIPELINE_MAX_DIMS && result->shape[0] == rows, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+            // create tensor
+            if (received == 0) {
+                size_t shape[PRSM_PIPELINE_MAX_DIMS];
+                VT_FOREACH(d, 0, result->ndim) {
+                    shape[d] = result->shape[d];
+                }
+                shape[0] = n;
+                ret = (ret == NULL)
+                    ? prsm_tensor_create_ex(in->alloctr, result->ndim, shape)
+                    : ret;
+
+                // check size
+                if (!prsm_tensor_shapes_match_ex(ret, result->ndim, shape)) {
+                    prsm_tensor_resize_ex(ret, result->ndim, shape);
+                }
+            }
+
+            // micro-batches arrive in order
+            const size_t out_row = prsm_tensor_size(ret) / n;
+            VT_ENFORCE(prsm_tensor_size(result) == rows * out_row, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+            vt_memcopy(ret->data + done->index * micro_batch * out_row, result->data, rows * out_row * sizeof(prsm_float));
+            prsm_pipeline_queue_pop(last);
+            received++;
+            progress = true;
+        }
+
+        if (!progress) {
+            prsm_thread_yield();
+        }
+    }
+
+    return ret;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Stage thread entry point
+ * @param  arg struct PrismaPipelineWorker*
+ * @returns None
+ */
+static void prsm_pipeline_thread(void *const arg) {
+    struct PrismaPipelineWorker *const worker = arg;
+    if (worker->pin) {
+        prsm_thread_pin(worker->stage);
+    }
+
+    // run the stage loop as a one-block parallel region, so kernels called by the stage stay on this thread
+    prsm_parallel_for(1, 1, prsm_pipeline_stage_kernel, worker);
+}
+
+/**
+ * @brief  Stage loop: takes micro-batches from the stage queue, computes them and passes them on
+ * @param  ctx struct PrismaPipelineWorker*
+ * @param  from unused
+ * @param  to unused
+ * @param  tid unused
+ * @returns None
+ */
+static void prsm_pipeline_stage_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)from;
+    (void)to;
+    (void)tid;
+    const struct PrismaPipelineWorker *const worker = ctx;
+    prsm_pipeline_t *const pipeline = worker->pipeline;
+    const prsm_pipeline_stage_t *const stage = &pipeline->stages[worker->stage];
+    struct PrismaPipelineQueue *const in_queue = &pipeline->queues[worker->stage];
+    struct PrismaPipelineQueue *const out_queue = &pipeline->queues[worker->stage + 1];
+
+    for (;;) {
+        struct PrismaPipelineSlot *const in = prsm_pipeline_queue_front(in_queue, pipeline->depth, true);
+        struct PrismaPipelineSlot *const out = prsm_pipeline_queue_back(out_queue, pipeline->depth, true);
+        const size_t index = in->index;
+        out->index = index;
+        if (index != PRSM_PIPELINE_STOP) {
+            // the first stage reads views into the batch, others read the buffers of the previous stage
+            const prsm_tensor_t *const result = stage->fn(stage->ctx, (worker->stage == 0) ? &in->view : in->tensor);
+            out->tensor = prsm_pipeline_store(pipeline->alloctr, out->tensor, result);
+        }
+        prsm_pipeline_queue_push(out_queue);
+        prsm_pipeline_queue_pop(in_queue);
+
+        if (index == PRSM_PIPELINE_STOP) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief  Copies a stage output into a queue buffer
+ * @param  alloctr allocator instance
+ * @param  out queue buffer or `NULL`
+ * @param  in stage output
+ * @returns prsm_tensor_t*
+ */
+static prsm_tensor_t *prsm_pipeline_store(struct VitaBaseAllocatorType *const alloctr, prsm_tensor_t *out, const prsm_tensor_t *const in) {
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(alloctr, in->ndim, in->shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match(ret, in)) {
+        prsm_tensor_resize_ex(ret, in->ndim, in->shape);
+    }
+
+    prsm_tensor_dup_into(ret, in);
+    return ret;
+}
+
+/**
+ * @brief  Returns the slot to be filled by the producer
+ * @param  q queue
+ * @param  depth number of slots
+ * @param  wait wait while the queue is full
+ * @returns struct PrismaPipelineSlot* or `NULL` if the queue is full and `wait==false`
+ */
+static struct PrismaPipelineSlot *prsm_pipeline_queue_back(struct PrismaPipelineQueue *const q, const size_t depth, const bool wait) {
+    const size_t tail = prsm_atomic_load(&q->tail);
+    for (size_t spin = 0; tail - prsm_atomic_load(&q->head) == depth; spin++) {
+        if (!wait) return NULL;
+        if (spin >= PRSM_PIPELINE_SPIN) prsm_thread_yield();
+    }
+    return &q->slots[tail % depth];
+}
+
+/**
+ * @brief  Publishes the slot returned by `prsm_pipeline_queue_back()`
+ * @param  q queue
+ * @returns None
+ */
+static void prsm_pipeline_queue_push(struct PrismaPipelineQueue *const q) {
+    prsm_atomic_store(&q->tail, prsm_atomic_load(&q->tail) + 1);
+}
+
+/**
+ * @brief  Returns the oldest published slot
+ * @param  q queue
+ * @param  depth number of slots
+ * @param  wait wait while the queue is empty
+ * @returns struct PrismaPipelineSlot* or `NULL` if the queue is empty and `wait==false`
+ */
+static struct PrismaPipelineSlot *prsm_pipeline_queue_front(struct PrismaPipelineQueue *const q, const size_t depth, const bool wait) {
+    const size_t head = prsm_atomic_load(&q->head);
+    for (size_t spin = 0; prsm_atomic_load(&q->tail) == head; spin++) {
+        if (!wait) return NULL;
+        if (spin >= PRSM_PIPELINE_SPIN) prsm_thread_yield();
+    }
+    return &q->slots[head % depth];
+}
+
+/**
+ * @brief  Releases the slot returned by `prsm_pipeline_queue_front()` to the producer
+ * @param  q queue
+ * @returns None
+ */
+static void prsm_pipeline_queue_pop(struct PrismaPipelineQueue *const q) {
+    prsm_atomic_store(&q->head, prsm_atomic_load(&q->head) + 1);
+}
@@ -0,0 +1,677 @@
+#include "prisma/core/pool.h"
+
+// channels per vector operation on NCHWc (blocks are multiples of NR), minimum elements per task
+#define PRSM_POOL_NR 8
+#define PRSM_POOL_GRAIN (32 * 1024)
+
+// largest window whose offsets fit into 1 and 2 bytes
+#define PRSM_POOL_WINDOW_1 256
+#define PRSM_POOL_WINDOW_2 65536
+
+// pooling shapes: NCHW is handled as NCHWc with blocks of one channel
+struct PrismaPoolShape {
+    size_t n, cb, block;                    // planes: N * CB
+    size_t h, w;                            // input
+    size_t oh, ow;                          // output
+};
+
+// shared state of a parallel pooling
+struct PrismaPoolContext {
+    prsm_float *out;                        // (N, CB, OH, OW, block) or (N, CB, H, W, block) for dx
+    const prsm_float *in;                   // (N, CB, H, W, block) or (N, CB, OH, OW, block) for dout
+    uint8_t *idx;                           // argmax offsets or NULL
+    size_t idx_width;                       // bytes per offset
+    struct PrismaPoolShape s;
+    const prsm_pool2d_params_t *params;
+};
+
+static void prsm_pool2d_shape(const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params, struct PrismaPoolShape *const s);
+static prsm_tensor_t *prsm_pool2d_create(prsm_tensor_t *out, const prsm_tensor_t *const in, const struct PrismaPoolShape *const s, const size_t oh, const size_t ow);
+static void prsm_pool_indices_reserve(prsm_pool_indices_t *const idx, const size_t size, const size_t window);
+static size_t prsm_pool_indices_width(const size_t window);
+static void prsm_pool2d_range(const size_t o, const size_t stride, const size_t padding, const size_t kernel, const size_t in, size_t *const from, size_t *const to);
+static void prsm_pool2d_max_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t oh, const size_t o0, const size_t lanes);
+static void prsm_pool2d_avg_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t oh, const size_t o0, const size_t lanes);
+static void prsm_pool2d_global_avg_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t o0, const size_t lanes);
+static void prsm_pool2d_max_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_pool2d_avg_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_pool2d_global_avg_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_pool2d_max_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_pool2d_avg_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_pool2d_global_avg_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+
+prsm_pool_indices_t *prsm_pool_indices_create(struct VitaBaseAllocatorType *const alloctr, const size_t size, const size_t window) {
+    // check for invalid input
+    VT_ENFORCE(window > 0 && window <= PRSM_POOL_WINDOW_2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate at least one byte, so that the storage is never null
+    const size_t width = prsm_pool_indices_width(window);
+    const size_t capacity = (size * width > 0) ? size * width : 1;
+    uint8_t *data = (alloctr == NULL)
+        ? VT_CALLOC(capacity)
+        : VT_ALLOCATOR_ALLOC(alloctr, capacity);
+
+    // allocate for argmax storage
+    prsm_pool_indices_t *idx = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_pool_indices_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_pool_indices_t));
+
+    // create argmax storage
+    *idx = (prsm_pool_indices_t) {
+        .size = size,
+        .width = width,
+        .capacity = capacity,
+        .data = data,
+        .alloctr = alloctr
+    };
+
+    return idx;
+}
+
+void prsm_pool_indices_destroy(prsm_pool_indices_t *idx) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free offsets, storage
+    (idx->alloctr) ? VT_ALLOCATOR_FREE(idx->alloctr, idx->data) : VT_FREE(idx->data);
+    (idx->alloctr) ? VT_ALLOCATOR_FREE(idx->alloctr, idx) : VT_FREE(idx);
+}
+
+size_t prsm_pool_indices_get(const prsm_pool_indices_t *const idx, const size_t at) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(at < idx->size, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return (idx->width == 1) ? idx->data[at] : ((const uint16_t*)idx->data)[at];
+}
+
+prsm_tensor_t *prsm_pool2d_max(prsm_tensor_t *out, prsm_pool_indices_t *const idx, const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params) {
+    // check for invalid input
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(in, params, &s);
+
+    // create tensor
+    prsm_tensor_t *ret = prsm_pool2d_create(out, in, &s, s.oh, s.ow);
+
+    // check argmax size
+    if (idx != NULL) {
+        prsm_pool_indices_reserve(idx, prsm_tensor_size(ret), params->kernel[0] * params->kernel[1]);
+    }
+
+    // every task computes output rows of one plane
+    struct PrismaPoolContext ctx = {
+        .out = ret->data,
+        .in = in->data,
+        .idx = (idx == NULL) ? NULL : idx->data,
+        .idx_width = (idx == NULL) ? 0 : idx->width,
+        .s = s,
+        .params = params
+    };
+    const size_t row_work = s.ow * s.block * params->kernel[0] * params->kernel[1];
+    const size_t grain = (row_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / row_work;
+    prsm_parallel_for(s.n * s.cb * s.oh, grain, prsm_pool2d_max_kernel, &ctx);
+
+    return ret;
+}
+
+void prsm_pool2d_max_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout, const prsm_pool_indices_t *const idx, const prsm_pool2d_params_t *const params) {
+    // check for invalid input
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(dx, params, &s);
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(prsm_tensor_size(dout) == s.n * s.cb * s.oh * s.ow * s.block, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(idx->size == prsm_tensor_size(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_ENFORCE(idx->width == prsm_pool_indices_width(params->kernel[0] * params->kernel[1]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // windows of one plane overlap: every task owns whole planes
+    struct PrismaPoolContext ctx = {
+        .out = dx->data,
+        .in = dout->data,
+        .idx = idx->data,
+        .idx_width = idx->width,
+        .s = s,
+        .params = params
+    };
+    const size_t plane_work = s.h * s.w * s.block;
+    const size_t grain = (plane_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / plane_work;
+    prsm_parallel_for(s.n * s.cb, grain, prsm_pool2d_max_backward_kernel, &ctx);
+}
+
+prsm_tensor_t *prsm_pool2d_avg(prsm_tensor_t *out, const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params) {
+    // check for invalid input
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(in, params, &s);
+
+    // create tensor
+    prsm_tensor_t *ret = prsm_pool2d_create(out, in, &s, s.oh, s.ow);
+
+    // every task computes output rows of one plane
+    struct PrismaPoolContext ctx = {
+        .out = ret->data,
+        .in = in->data,
+        .s = s,
+        .params = params
+    };
+    const size_t row_work = s.ow * s.block * params->kernel[0] * params->kernel[1];
+    const size_t grain = (row_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / row_work;
+    prsm_parallel_for(s.n * s.cb * s.oh, grain, prsm_pool2d_avg_kernel, &ctx);
+
+    return ret;
+}
+
+void prsm_pool2d_avg_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout, const prsm_pool2d_params_t *const params) {
+    // check for invalid input
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(dx, params, &s);
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(prsm_tensor_size(dout) == s.n * s.cb * s.oh * s.ow * s.block, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // windows of one plane overlap: every task owns whole planes
+    struct PrismaPoolContext ctx = {
+        .out = dx->data,
+        .in = dout->data,
+        .s = s,
+        .params = params
+    };
+    const size_t plane_work = s.oh * s.ow * s.block * params->kernel[0] * params->kernel[1];
+    const size_t grain = (plane_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / plane_work;
+    prsm_parallel_for(s.n * s.cb, grain, prsm_pool2d_avg_backward_kernel, &ctx);
+}
+
+prsm_tensor_t *prsm_pool2d_global_avg(prsm_tensor_t *out, const prsm_tensor_t *const in) {
+    // check for invalid input: a window covering the whole image
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4 || in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    const prsm_pool2d_params_t params = { .kernel = {in->shape[2], in->shape[3]}, .stride = {1, 1}, .padding = {0, 0} };
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(in, &params, &s);
+
+    // create tensor
+    prsm_tensor_t *ret = prsm_pool2d_create(out, in, &s, 1, 1);
+
+    // every task reduces whole planes
+    struct PrismaPoolContext ctx = {
+        .out = ret->data,
+        .in = in->data,
+        .s = s,
+        .params = &params
+    };
+    const size_t plane_work = s.h * s.w * s.block;
+    const size_t grain = (plane_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / plane_work;
+    prsm_parallel_for(s.n * s.cb, grain, prsm_pool2d_global_avg_kernel, &ctx);
+
+    return ret;
+}
+
+void prsm_pool2d_global_avg_backward(prsm_tensor_t *const dx, const prsm_tensor_t *const dout) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dx), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(dout), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(dx->ndim == 4 || dx->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    const prsm_pool2d_params_t params = { .kernel = {dx->shape[2], dx->shape[3]}, .stride = {1, 1}, .padding = {0, 0} };
+    struct PrismaPoolShape s;
+    prsm_pool2d_shape(dx, &params, &s);
+    VT_ENFORCE(prsm_tensor_size(dout) == s.n * s.cb * s.block, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // dx = dout / (H * W) everywhere in the plane
+    struct PrismaPoolContext ctx = {
+        .out = dx->data,
+        .in = dout->data,
+        .s = s,
+        .params = &params
+    };
+    const size_t plane_work = s.h * s.w * s.block;
+    const size_t grain = (plane_work >= PRSM_POOL_GRAIN) ? 1 : PRSM_POOL_GRAIN / plane_work;
+    prsm_parallel_for(s.n * s.cb, grain, prsm_pool2d_global_avg_backward_kernel, &ctx);
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Checks pooling arguments and calculates shapes
+ * @param  in input tensor of shape (N, C, H, W) or (N, CB, H, W, block)
+ * @param  params pooling parameters
+ * @param  s calculated shapes
+ * @returns None
+ */
+static void prsm_pool2d_shape(const prsm_tensor_t *const in, const prsm_pool2d_params_t *const params, struct PrismaPoolShape *const s) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 4 || in->ndim == 5, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(
+        params->kernel[0] > 0 && params->kernel[1] > 0 && params->stride[0] > 0 && params->stride[1] > 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+
+    // every window must overlap the input
+    VT_ENFORCE(
+        2 * params->padding[0] <= params->kernel[0] && 2 * params->padding[1] <= params->kernel[1],
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+
+    *s = (struct PrismaPoolShape) {
+        .n = in->shape[0],
+        .cb = in->shape[1],
+        .block = (in->ndim == 5) ? in->shape[4] : 1,
+        .h = in->shape[2],
+        .w = in->shape[3],
+        .oh = prsm_conv2d_out_dim(in->shape[2], params->kernel[0], params->stride[0], params->padding[0], 1),
+        .ow = prsm_conv2d_out_dim(in->shape[3], params->kernel[1], params->stride[1], params->padding[1], 1)
+    };
+    VT_ENFORCE(s->oh > 0 && s->ow > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+}
+
+/**
+ * @brief  Creates or resizes a pooling output with the layout of the input
+ * @param  out output tensor or `NULL`
+ * @param  in input tensor
+ * @param  s pooling shapes
+ * @param  oh output height
+ * @param  ow output width
+ * @returns prsm_tensor_t*
+ */
+static prsm_tensor_t *prsm_pool2d_create(prsm_tensor_t *out, const prsm_tensor_t *const in, const struct PrismaPoolShape *const s, const size_t oh, const size_t ow) {
+    const size_t shape[] = {s->n, s->cb, oh, ow, s->block};
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_ex(in->alloctr, in->ndim, shape)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, in->ndim, shape)) {
+        prsm_tensor_resize_ex(ret, in->ndim, shape);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief  Makes argmax storage hold `size` offsets of a window with `window` elements
+ * @param  idx argmax storage
+ * @param  size number of output elements
+ * @param  window number of elements per window
+ * @returns None
+ */
+static void prsm_pool_indices_reserve(prsm_pool_indices_t *const idx, const size_t size, const size_t window) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL && idx->data != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(window <= PRSM_POOL_WINDOW_2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // reallocate offsets
+    const size_t width = prsm_pool_indices_width(window);
+    if (size * width > idx->capacity) {
+        idx->data = (idx->alloctr == NULL)
+            ? VT_REALLOC(idx->data, size * width)
+            : VT_ALLOCATOR_REALLOC(idx->alloctr, idx->data, size * width);
+        idx->capacity = size * width;
+    }
+
+    // update size
+    idx->size = size;
+    idx->width = width;
+}
+
+/**
+ * @brief  Returns the number of bytes per offset for a window with `window` elements
+ * @param  window number of elements per window
+ * @returns size_t
+ */
+static size_t prsm_pool_indices_width(const size_t window) {
+    return (window <= PRSM_POOL_WINDOW_1) ? 1 : 2;
+}
+
+/**
+ * @brief  Calculates the kernel taps [from, to) of an output position that fall inside the input
+ * @param  o output position
+ * @param  stride stride
+ * @param  padding padding
+ * @param  kernel kernel size
+ * @param  in input size
+ * @param  from first tap
+ * @param  to last tap (exclusive)
+ * @returns None
+ */
+static void prsm_pool2d_range(const size_t o, const size_t stride, const size_t padding, const size_t kernel, const size_t in, size_t *const from, size_t *const to) {
+    const size_t i_pad = o * stride;
+    *from = (i_pad < padding) ? padding - i_pad : 0;
+    *to = (i_pad + kernel > in + padding) ? in + padding - i_pad : kernel;
+}
+
+/**
+ * @brief  Max pools one output row for `lanes` channels of a block
+ * @param  c pooling context
+ * @param  plane plane: n * CB + cb
+ * @param  oh output row
+ * @param  o0 first channel of the block
+ * @param  lanes number of channels: PRSM_POOL_NR or 1
+ * @returns None
+ */
+static void prsm_pool2d_max_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t oh, const size_t o0, const size_t lanes) {
+    const struct PrismaPoolShape *const s = &c->s;
+    const prsm_pool2d_params_t *const p = c->params;
+    const size_t block = s->block, kw_size = p->kernel[1];
+    const prsm_float *const in_plane = c->in + plane * s->h * s->w * block + o0;
+    const size_t out_row = ((plane * s->oh + oh) * s->ow) * block + o0;
+
+    size_t kh_from, kh_to;
+    prsm_pool2d_range(oh, p->stride[0], p->padding[0], p->kernel[0], s->h, &kh_from, &kh_to);
+    const size_t ih0 = oh * p->stride[0] + kh_from - p->padding[0];
+    VT_FOREACH(ow, 0, s->ow) {
+        size_t kw_from, kw_to;
+        prsm_pool2d_range(ow, p->stride[1], p->padding[1], kw_size, s->w, &kw_from, &kw_to);
+        const size_t iw0 = ow * p->stride[1] + kw_from - p->padding[1];
+
+        // the first tap inside the input starts the maximum; every further tap is one compare across channels
+        prsm_float best[PRSM_POOL_NR];
+        uint32_t arg[PRSM_POOL_NR];
+        const prsm_float *const first = in_plane + (ih0 * s->w + iw0) * block;
+        VT_FOREACH(o, 0, lanes) {
+            best[o] = first[o];
+            arg[o] = (uint32_t)(kh_from * kw_size + kw_from);
+        }
+        VT_FOREACH(kh, kh_from, kh_to) {
+            const prsm_float *const in_row = in_plane + (ih0 + kh - kh_from) * s->w * block;
+            VT_FOREACH(kw, kw_from, kw_to) {
+                const prsm_float *const x = in_row + (iw0 + kw - kw_from) * block;
+                const uint32_t offset = (uint32_t)(kh * kw_size + kw);
+                if (lanes == PRSM_POOL_NR) {
+                    // fixed width and branch-free: compiled to vector compares and masks
+                    VT_FOREACH(o, 0, PRSM_POOL_NR) {
+                        const prsm_float v = x[o], b = best[o];
+                        const uint32_t mask = (uint32_t)0 - (uint32_t)(v > b);
+                        best[o] = (v > b) ? v : b;
+                        arg[o] = (offset & mask) | (arg[o] & ~mask);
+                    }
+                } else if (x[0] > best[0]) {
+                    best[0] = x[0];
+                    arg[0] = offset;
+                }
+            }
+        }
+
+        // store maxima and their window offsets
+        const size_t at = out_row + ow * block;
+        VT_FOREACH(o, 0, lanes) {
+            c->out[at + o] = best[o];
+        }
+        if (c->idx == NULL) {
+            continue;
+        } else if (c->idx_width == 1) {
+            VT_FOREACH(o, 0, lanes) {
+                c->idx[at + o] = (uint8_t)arg[o];
+            }
+        } else {
+            VT_FOREACH(o, 0, lanes) {
+                ((uint16_t*)c->idx)[at + o] = (uint16_t)arg[o];
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Average pools one output row for `lanes` channels of a block
+ * @param  c pooling context
+ * @param  plane plane: n * CB + cb
+ * @param  oh output row
+ * @param  o0 first channel of the block
+ * @param  lanes number of channels: PRSM_POOL_NR or 1
+ * @returns None
+ */
+static void prsm_pool2d_avg_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t oh, const size_t o0, const size_t lanes) {
+    const struct PrismaPoolShape *const s = &c->s;
+    const prsm_pool2d_params_t *const p = c->params;
+    const size_t block = s->block;
+    const prsm_float *const in_plane = c->in + plane * s->h * s->w * block + o0;
+    prsm_float *const out_row = c->out + ((plane * s->oh + oh) * s->ow) * block + o0;
+
+    size_t kh_from, kh_to;
+    prsm_pool2d_range(oh, p->stride[0], p->padding[0], p->kernel[0], s->h, &kh_from, &kh_to);
+    const size_t ih0 = oh * p->stride[0] + kh_from - p->padding[0];
+    VT_FOREACH(ow, 0, s->ow) {
+        size_t kw_from, kw_to;
+        prsm_pool2d_range(ow, p->stride[1], p->padding[1], p->kernel[1], s->w, &kw_from, &kw_to);
+        const size_t iw0 = ow * p->stride[1] + kw_from - p->padding[1];
+
+        // sum every tap inside the input across channels
+        prsm_float acc[PRSM_POOL_NR] = {0};
+        VT_FOREACH(ih, ih0, ih0 + kh_to - kh_from) {
+            const prsm_float *const in_row = in_plane + ih * s->w * block;
+            VT_FOREACH(iw, iw0, iw0 + kw_to - kw_from) {
+                const prsm_float *const x = in_row + iw * block;
+                if (lanes == PRSM_POOL_NR) {
+                    // fixed width: compiled to vector adds
+                    VT_FOREACH(o, 0, PRSM_POOL_NR) {
+                        acc[o] += x[o];
+                    }
+                } else {
+                    acc[0] += x[0];
+                }
+            }
+        }
+
+        // padded positions are not counted
+        const prsm_float scale = 1 / (prsm_float)((kh_to - kh_from) * (kw_to - kw_from));
+        prsm_float *const y = out_row + ow * block;
+        VT_FOREACH(o, 0, lanes) {
+            y[o] = acc[o] * scale;
+        }
+    }
+}
+
+/**
+ * @brief  Averages one plane for `lanes` channels of a block
+ * @param  c pooling context
+ * @param  plane plane: n * CB + cb
+ * @param  o0 first channel of the block
+ * @param  lanes number of channels: PRSM_POOL_NR or 1
+ * @returns None
+ */
+static void prsm_pool2d_global_avg_lanes(const struct PrismaPoolContext *const c, const size_t plane, const size_t o0, const size_t lanes) {
+    const struct PrismaPoolShape *const s = &c->s;
+    const size_t block = s->block, hw = s->h * s->w;
+    const prsm_float *const in_plane = c->in + plane * hw * block + o0;
+
+    prsm_float acc[PRSM_POOL_NR] = {0};
+    VT_FOREACH(px, 0, hw) {
+        const prsm_float *const x = in_plane + px * block;
+        if (lanes == PRSM_POOL_NR) {
+            // fixed width: compiled to vector adds
+            VT_FOREACH(o, 0, PRSM_POOL_NR) {
+                acc[o] += x[o];
+            }
+        } else {
+            acc[0] += x[0];
+        }
+    }
+
+    const prsm_float scale = 1 / (prsm_float)hw;
+    prsm_float *const y = c->out + plane * block + o0;
+    VT_FOREACH(o, 0, lanes) {
+        y[o] = acc[o] * scale;
+    }
+}
+
+/**
+ * @brief  Computes max pooling output rows [from, to)
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first row: (n * CB + cb) * OH + oh
+ * @param  to last row (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_max_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const size_t block = c->s.block;
+    VT_FOREACH(r, from, to) {
+        const size_t plane = r / c->s.oh, oh = r % c->s.oh;
+        if (block % PRSM_POOL_NR == 0) {
+            VT_FOREACH_STEP(o0, 0, block, PRSM_POOL_NR) {
+                prsm_pool2d_max_lanes(c, plane, oh, o0, PRSM_POOL_NR);
+            }
+        } else {
+            VT_FOREACH(o0, 0, block) {
+                prsm_pool2d_max_lanes(c, plane, oh, o0, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Computes average pooling output rows [from, to)
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first row: (n * CB + cb) * OH + oh
+ * @param  to last row (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_avg_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const size_t block = c->s.block;
+    VT_FOREACH(r, from, to) {
+        const size_t plane = r / c->s.oh, oh = r % c->s.oh;
+        if (block % PRSM_POOL_NR == 0) {
+            VT_FOREACH_STEP(o0, 0, block, PRSM_POOL_NR) {
+                prsm_pool2d_avg_lanes(c, plane, oh, o0, PRSM_POOL_NR);
+            }
+        } else {
+            VT_FOREACH(o0, 0, block) {
+                prsm_pool2d_avg_lanes(c, plane, oh, o0, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Computes global average pooling of planes [from, to)
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first plane: n * CB + cb
+ * @param  to last plane (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_global_avg_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const size_t block = c->s.block;
+    VT_FOREACH(plane, from, to) {
+        if (block % PRSM_POOL_NR == 0) {
+            VT_FOREACH_STEP(o0, 0, block, PRSM_POOL_NR) {
+                prsm_pool2d_global_avg_lanes(c, plane, o0, PRSM_POOL_NR);
+            }
+        } else {
+            VT_FOREACH(o0, 0, block) {
+                prsm_pool2d_global_avg_lanes(c, plane, o0, 1);
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Routes output gradients of planes [from, to) to the maxima of their windows
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first plane: n * CB + cb
+ * @param  to last plane (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_max_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const struct PrismaPoolShape *const s = &c->s;
+    const prsm_pool2d_params_t *const p = c->params;
+    const size_t block = s->block, kw_size = p->kernel[1], out_plane = s->oh * s->ow * block;
+    VT_FOREACH(plane, from, to) {
+        prsm_float *const dx = c->out + plane * s->h * s->w * block;
+        VT_FOREACH(i, 0, s->h * s->w * block) {
+            dx[i] = 0;
+        }
+
+        // dx[argmax] += dout
+        VT_FOREACH(oh, 0, s->oh) {
+            VT_FOREACH(ow, 0, s->ow) {
+                const size_t at = plane * out_plane + (oh * s->ow + ow) * block;
+                VT_FOREACH(o, 0, block) {
+                    const size_t offset = (c->idx_width == 1) ? c->idx[at + o] : ((const uint16_t*)c->idx)[at + o];
+                    const size_t ih = oh * p->stride[0] + offset / kw_size - p->padding[0];
+                    const size_t iw = ow * p->stride[1] + offset % kw_size - p->padding[1];
+                    dx[(ih * s->w + iw) * block + o] += c->in[at + o];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Spreads output gradients of planes [from, to) evenly over their windows
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first plane: n * CB + cb
+ * @param  to last plane (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_avg_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const struct PrismaPoolShape *const s = &c->s;
+    const prsm_pool2d_params_t *const p = c->params;
+    const size_t block = s->block;
+    VT_FOREACH(plane, from, to) {
+        prsm_float *const dx = c->out + plane * s->h * s->w * block;
+        VT_FOREACH(i, 0, s->h * s->w * block) {
+            dx[i] = 0;
+        }
+
+        // dx[window] += dout / count
+        VT_FOREACH(oh, 0, s->oh) {
+            size_t kh_from, kh_to;
+            prsm_pool2d_range(oh, p->stride[0], p->padding[0], p->kernel[0], s->h, &kh_from, &kh_to);
+            const size_t ih0 = oh * p->stride[0] + kh_from - p->padding[0];
+            VT_FOREACH(ow, 0, s->ow) {
+                size_t kw_from, kw_to;
+                prsm_pool2d_range(ow, p->stride[1], p->padding[1], p->kernel[1], s->w, &kw_from, &kw_to);
+                const size_t iw0 = ow * p->stride[1] + kw_from - p->padding[1];
+
+                const prsm_float scale = 1 / (prsm_float)((kh_to - kh_from) * (kw_to - kw_from));
+                const prsm_float *const g = c->in + ((plane * s->oh + oh) * s->ow + ow) * block;
+                VT_FOREACH(ih, ih0, ih0 + kh_to - kh_from) {
+                    VT_FOREACH(iw, iw0, iw0 + kw_to - kw_from) {
+                        prsm_float *const d = dx + (ih * s->w + iw) * block;
+                        VT_FOREACH(o, 0, block) {
+                            d[o] += g[o] * scale;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Broadcasts output gradients of planes [from, to) over the planes
+ * @param  ctx struct PrismaPoolContext*
+ * @param  from first plane: n * CB + cb
+ * @param  to last plane (exclusive)
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_pool2d_global_avg_backward_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaPoolContext *const c = ctx;
+    const struct PrismaPoolShape *const s = &c->s;
+    const size_t block = s->block, hw = s->h * s->w;
+    const prsm_float scale = 1 / (prsm_float)hw;
+    VT_FOREACH(plane, from, to) {
+        const prsm_float *const g = c->in + plane * block;
+        prsm_float *const dx = c->out + plane * hw * block;
+        VT_FOREACH(px, 0, hw) {
+            VT_FOREACH(o, 0, block) {
+                dx[px * block + o] = g[o] * scale;
+            }
+        }
+    }
+}
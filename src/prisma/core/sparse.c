@@ -0,0 +1,377 @@
+#include "prisma/core/sparse.h"
+
+static size_t prsm_sparse_ptr_len(const enum PrismaSparseFormat format, const size_t rows, const size_t cols);
+static void prsm_sparse_reserve(prsm_sparse_t *const sp, const enum PrismaSparseFormat format, const size_t rows, const size_t cols, const size_t capacity);
+
+/*
+    Sparse creation/destruction
+*/
+
+prsm_sparse_t *prsm_sparse_create(struct VitaBaseAllocatorType *const alloctr, const enum PrismaSparseFormat format, const size_t rows, const size_t cols, const size_t capacity) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(format < PRSM_SPARSE_FORMAT_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(rows > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(cols > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // allocate at least one element, so that the sparse matrix is never null
+    const size_t cap = capacity > 0 ? capacity : 1;
+    const size_t ptr_len = prsm_sparse_ptr_len(format, rows, cols);
+
+    // allocate for compressed pointers
+    size_t *ptr = (alloctr == NULL)
+        ? VT_CALLOC(ptr_len * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, ptr_len * sizeof(size_t));
+
+    // allocate for indices
+    size_t *idx = (alloctr == NULL)
+        ? VT_CALLOC(cap * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, cap * sizeof(size_t));
+
+    // allocate for values
+    prsm_float *data = (alloctr == NULL)
+        ? VT_CALLOC(cap * sizeof(prsm_float))
+        : VT_ALLOCATOR_ALLOC(alloctr, cap * sizeof(prsm_float));
+
+    // allocate for sparse matrix
+    prsm_sparse_t *sp = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_sparse_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_sparse_t));
+
+    // create sparse matrix
+    *sp = (prsm_sparse_t) {
+        .format = format,
+        .rows = rows,
+        .cols = cols,
+        .nnz = 0,
+        .capacity = cap,
+        .ptr = ptr,
+        .idx = idx,
+        .data = data,
+        .alloctr = alloctr
+    };
+
+    return sp;
+}
+
+void prsm_sparse_destroy(prsm_sparse_t *sp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(sp != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free pointers, indices, data, sparse matrix
+    (sp->alloctr) ? VT_ALLOCATOR_FREE(sp->alloctr, sp->ptr) : VT_FREE(sp->ptr);
+    (sp->alloctr) ? VT_ALLOCATOR_FREE(sp->alloctr, sp->idx) : VT_FREE(sp->idx);
+    (sp->alloctr) ? VT_ALLOCATOR_FREE(sp->alloctr, sp->data) : VT_FREE(sp->data);
+    (sp->alloctr) ? VT_ALLOCATOR_FREE(sp->alloctr, sp) : VT_FREE(sp);
+}
+
+/*
+    Sparse properties
+*/
+
+bool prsm_sparse_is_null(const prsm_sparse_t *const sp) {
+    return (sp == NULL || sp->ptr == NULL || sp->idx == NULL || sp->data == NULL);
+}
+
+size_t prsm_sparse_nnz(const prsm_sparse_t *const sp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(sp), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    return sp->nnz;
+}
+
+prsm_float prsm_sparse_density(const prsm_sparse_t *const sp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(sp), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    return (prsm_float)sp->nnz / (prsm_float)(sp->rows * sp->cols);
+}
+
+/*
+    Sparse conversion
+*/
+
+prsm_sparse_t *prsm_sparse_from_dense(prsm_sparse_t *out, const prsm_tensor_t *const in, const enum PrismaSparseFormat format, const prsm_float threshold) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(format < PRSM_SPARSE_FORMAT_COUNT, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(in->ndim == 2, "%s: Only 2D tensors can be compressed!\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    const size_t rows = in->shape[0];
+    const size_t cols = in->shape[1];
+
+    // count non-zero elements
+    size_t nnz = 0;
+    const size_t size = rows * cols;
+    VT_FOREACH(i, 0, size) {
+        nnz += PRSM_ABS(in->data[i]) > threshold;
+    }
+
+    // create sparse matrix or make sure it can hold the result
+    prsm_sparse_t *ret = (out == NULL)
+        ? prsm_sparse_create(in->alloctr, format, rows, cols, nnz)
+        : out;
+    prsm_sparse_reserve(ret, format, rows, cols, nnz);
+
+    if (format == PRSM_SPARSE_FORMAT_CSR) {
+        // rows are stored contiguously: a single pass fills everything
+        size_t k = 0;
+        ret->ptr[0] = 0;
+        VT_FOREACH(i, 0, rows) {
+            const prsm_float *row = in->data + i * cols;
+            VT_FOREACH(j, 0, cols) {
+                if (PRSM_ABS(row[j]) > threshold) {
+                    ret->idx[k] = j;
+                    ret->data[k] = row[j];
+                    k++;
+                }
+            }
+            ret->ptr[i + 1] = k;
+        }
+    } else {
+        // count elements per column
+        vt_memset(ret->ptr, 0, (cols + 1) * sizeof(*ret->ptr));
+        VT_FOREACH(i, 0, rows) {
+            const prsm_float *row = in->data + i * cols;
+            VT_FOREACH(j, 0, cols) {
+                ret->ptr[j + 1] += PRSM_ABS(row[j]) > threshold;
+            }
+        }
+
+        // prefix sum into column pointers
+        VT_FOREACH(j, 0, cols) {
+            ret->ptr[j + 1] += ret->ptr[j];
+        }
+
+        // scatter values: rows are visited in order, so row indices are sorted within each column
+        VT_FOREACH(i, 0, rows) {
+            const prsm_float *row = in->data + i * cols;
+            VT_FOREACH(j, 0, cols) {
+                if (PRSM_ABS(row[j]) > threshold) {
+                    const size_t k = ret->ptr[j]++;
+                    ret->idx[k] = i;
+                    ret->data[k] = row[j];
+                }
+            }
+        }
+
+        // undo the shift introduced by the scatter pass
+        VT_FOREACH_R(j, 0, cols) {
+            ret->ptr[j] = ret->ptr[j - 1];
+        }
+        ret->ptr[0] = 0;
+    }
+    ret->nnz = nnz;
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_sparse_to_dense(prsm_tensor_t *out, const prsm_sparse_t *const sp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(sp), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_mat(sp->alloctr, sp->rows, sp->cols)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 2, (size_t[]){sp->rows, sp->cols})) {
+        prsm_tensor_resize(ret, 2, sp->rows, sp->cols);
+    }
+
+    // zero out the values
+    prsm_tensor_set_zeros(ret);
+
+    // decompress
+    if (sp->format == PRSM_SPARSE_FORMAT_CSR) {
+        VT_FOREACH(i, 0, sp->rows) {
+            VT_FOREACH(k, sp->ptr[i], sp->ptr[i + 1]) {
+                ret->data[vt_index_2d_to_1d(i, sp->idx[k], sp->cols)] = sp->data[k];
+            }
+        }
+    } else {
+        VT_FOREACH(j, 0, sp->cols) {
+            VT_FOREACH(k, sp->ptr[j], sp->ptr[j + 1]) {
+                ret->data[vt_index_2d_to_1d(sp->idx[k], j, sp->cols)] = sp->data[k];
+            }
+        }
+    }
+
+    return ret;
+}
+
+/*
+    Sparse-dense operations
+*/
+
+prsm_tensor_t *prsm_sparse_spmv(prsm_tensor_t *out, const prsm_sparse_t *const lhs, const prsm_tensor_t *const rhs) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(lhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(rhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(rhs->ndim == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(lhs->cols == rhs->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create tensor
+    const size_t size = lhs->rows;
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_vec(rhs->alloctr, size)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 1, (size_t[]){size})) {
+        prsm_tensor_resize(ret, 1, size);
+    }
+
+    // zero out the values
+    prsm_tensor_set_zeros(ret);
+
+    // calculate sparse matrix-vector product
+    const prsm_float *x = rhs->data;
+    if (lhs->format == PRSM_SPARSE_FORMAT_CSR) {
+        // gather: one sparse dot product per row
+        VT_FOREACH(i, 0, lhs->rows) {
+            prsm_float sum = 0;
+            VT_FOREACH(k, lhs->ptr[i], lhs->ptr[i + 1]) {
+                sum += lhs->data[k] * x[lhs->idx[k]];
+            }
+            ret->data[i] = sum;
+        }
+    } else {
+        // scatter: each column is scaled by the matching vector value, empty columns are skipped
+        VT_FOREACH(j, 0, lhs->cols) {
+            const prsm_float xj = x[j];
+            VT_FOREACH(k, lhs->ptr[j], lhs->ptr[j + 1]) {
+                ret->data[lhs->idx[k]] += lhs->data[k] * xj;
+            }
+        }
+    }
+
+    return ret;
+}
+
+prsm_tensor_t *prsm_sparse_spmm(prsm_tensor_t *out, const prsm_sparse_t *const lhs, const prsm_tensor_t *const rhs) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(lhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(rhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(rhs->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(lhs->cols == rhs->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+
+    // create tensor
+    const size_t rows = lhs->rows;
+    const size_t cols = rhs->shape[1];
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create_mat(rhs->alloctr, rows, cols)
+        : out;
+
+    // check size
+    if (!prsm_tensor_shapes_match_ex(ret, 2, (size_t[]){rows, cols})) {
+        prsm_tensor_resize(ret, 2, rows, cols);
+    }
+
+    // zero out the values
+    prsm_tensor_set_zeros(ret);
+
+    /*
+     * Every stored element (i, k, v) contributes v * rhs[k, :] to out[i, :].
+     * Both rows are contiguous, so the inner loop is a plain axpy the compiler can vectorize.
+     */
+    if (lhs->format == PRSM_SPARSE_FORMAT_CSR) {
+        VT_FOREACH(i, 0, lhs->rows) {
+            prsm_float *c = ret->data + i * cols;
+            VT_FOREACH(k, lhs->ptr[i], lhs->ptr[i + 1]) {
+                const prsm_float v = lhs->data[k];
+                const prsm_float *b = rhs->data + lhs->idx[k] * cols;
+                VT_FOREACH(j, 0, cols) {
+                    c[j] += v * b[j];
+                }
+            }
+        }
+    } else {
+        VT_FOREACH(kk, 0, lhs->cols) {
+            const prsm_float *b = rhs->data + kk * cols;
+            VT_FOREACH(k, lhs->ptr[kk], lhs->ptr[kk + 1]) {
+                const prsm_float v = lhs->data[k];
+                prsm_float *c = ret->data + lhs->idx[k] * cols;
+                VT_FOREACH(j, 0, cols) {
+                    c[j] += v * b[j];
+                }
+            }
+        }
+    }
+
+    return ret;
+}
+
+/*
+    Pretty printing
+*/
+
+void prsm_sparse_display(const prsm_sparse_t *const sp) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(sp), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // print stored elements as (row, col): value
+    const bool is_csr = sp->format == PRSM_SPARSE_FORMAT_CSR;
+    const size_t outer = is_csr ? sp->rows : sp->cols;
+    VT_FOREACH(o, 0, outer) {
+        VT_FOREACH(k, sp->ptr[o], sp->ptr[o + 1]) {
+            printf("  (%zu, %zu): %.2f\n", is_csr ? o : sp->idx[k], is_csr ? sp->idx[k] : o, sp->data[k]);
+        }
+    }
+
+    // print shape
+    printf("Shape: (%zu, %zu) | Format: %s | NNZ: %zu\n", sp->rows, sp->cols, is_csr ? "CSR" : "CSC", sp->nnz);
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Returns the number of compressed pointers for the given format
+ * @param  format storage format
+ * @param  rows number of rows
+ * @param  cols number of cols
+ * @returns rows+1 (CSR) or cols+1 (CSC)
+ */
+static size_t prsm_sparse_ptr_len(const enum PrismaSparseFormat format, const size_t rows, const size_t cols) {
+    return (format == PRSM_SPARSE_FORMAT_CSR ? rows : cols) + 1;
+}
+
+/**
+ * @brief  Makes sure sparse matrix buffers can hold the requested shape and number of elements
+ * @param  sp sparse matrix
+ * @param  format storage format
+ * @param  rows number of rows
+ * @param  cols number of cols
+ * @param  capacity number of stored elements
+ * @returns None
+ */
+static void prsm_sparse_reserve(prsm_sparse_t *const sp, const enum PrismaSparseFormat format, const size_t rows, const size_t cols, const size_t capacity) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_sparse_is_null(sp), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // reallocate compressed pointers
+    const size_t ptr_len_old = prsm_sparse_ptr_len(sp->format, sp->rows, sp->cols);
+    const size_t ptr_len = prsm_sparse_ptr_len(format, rows, cols);
+    if (ptr_len > ptr_len_old) {
+        sp->ptr = (sp->alloctr == NULL)
+            ? VT_REALLOC(sp->ptr, ptr_len * sizeof(*sp->ptr))
+            : VT_ALLOCATOR_REALLOC(sp->alloctr, sp->ptr, ptr_len * sizeof(*sp->ptr));
+    }
+
+    // reallocate indices and values
+    if (capacity > sp->capacity) {
+        sp->idx = (sp->alloctr == NULL)
+            ? VT_REALLOC(sp->idx, capacity * sizeof(*sp->idx))
+            : VT_ALLOCATOR_REALLOC(sp->alloctr, sp->idx, capacity * sizeof(*sp->idx));
+        sp->data = (sp->alloctr == NULL)
+            ? VT_REALLOC(sp->data, capacity * sizeof(*sp->data))
+            : VT_ALLOCATOR_REALLOC(sp->alloctr, sp->data, capacity * sizeof(*sp->data));
+        sp->capacity = capacity;
+    }
+
+    // update shape
+    sp->format = format;
+    sp->rows = rows;
+    sp->cols = cols;
+}
+
@@ -0,0 +1,315 @@
+#include "prisma/core/storage.h"
+
+// native prsm_float type
+#if defined(PRISMA_USE_TYPE_DOUBLE)
+    #define PRSM_STORAGE_DTYPE_NATIVE PRSM_STORAGE_DTYPE_FLOAT64
+#elif defined(PRISMA_USE_TYPE_LONG_DOUBLE)
+    #define PRSM_STORAGE_DTYPE_NATIVE PRSM_STORAGE_DTYPE_FLOAT80
+#else
+    #define PRSM_STORAGE_DTYPE_NATIVE PRSM_STORAGE_DTYPE_FLOAT32
+#endif
+
+// on-disk layout
+#define PRSM_STORAGE_MAGIC "PRSMTNSR"
+#define PRSM_STORAGE_BYTE_ORDER 0x01020304u
+
+struct PrismaStorageHeader {
+    char magic[8];          // PRSM_STORAGE_MAGIC
+    uint32_t version;       // PRSM_STORAGE_VERSION
+    uint32_t byte_order;    // PRSM_STORAGE_BYTE_ORDER as written by the producer
+    uint64_t count;         // number of entries
+    uint64_t alignment;     // data alignment
+    uint8_t reserved[32];
+};
+
+struct PrismaStorageEntry {
+    char name[PRSM_STORAGE_MAX_NAME_LEN];   // zero-terminated
+    uint32_t dtype;                         // enum PrismaStorageDtype
+    uint32_t ndim;                          // number of dimensions
+    uint64_t shape[PRSM_STORAGE_MAX_DIMS];  // tensor shape
+    uint64_t offset;                        // data offset from the beginning of the file
+    uint64_t nbytes;                        // data size in bytes
+    uint8_t reserved[8];
+};
+
+_Static_assert(sizeof(struct PrismaStorageHeader) == 64, "storage header must be 64 bytes");
+_Static_assert(sizeof(struct PrismaStorageEntry) == 160, "storage entry must be 160 bytes");
+
+static size_t prsm_storage_dtype_size(const enum PrismaStorageDtype dtype);
+static size_t prsm_storage_align(const size_t offset);
+static bool prsm_storage_write_padding(FILE *fp, const size_t from, const size_t to);
+
+enum PrismaStatus prsm_storage_save(const char *const filename, const size_t count, const char *const names[], const prsm_tensor_t *const tensors[]) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(filename != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(names != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(tensors != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, count) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(tensors[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(tensors[i]->ndim <= PRSM_STORAGE_MAX_DIMS, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(
+            names[i] != NULL && strlen(names[i]) < PRSM_STORAGE_MAX_NAME_LEN,
+            "%s: Tensor name must be shorter than %d characters.\n",
+            prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS),
+            PRSM_STORAGE_MAX_NAME_LEN
+        );
+    }
+
+    // open file
+    FILE *fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        return PRSM_STATUS_ERROR_IO;
+    }
+
+    // write header
+    struct PrismaStorageHeader header = {
+        .magic = PRSM_STORAGE_MAGIC,
+        .version = PRSM_STORAGE_VERSION,
+        .byte_order = PRSM_STORAGE_BYTE_ORDER,
+        .count = count,
+        .alignment = PRSM_STORAGE_ALIGNMENT
+    };
+    bool ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+
+    // write entry table: data offsets are known upfront
+    size_t offset = prsm_storage_align(sizeof(header) + count * sizeof(struct PrismaStorageEntry));
+    VT_FOREACH(i, 0, count) {
+        if (!ok) break;
+
+        const prsm_tensor_t *t = tensors[i];
+        struct PrismaStorageEntry entry = {
+            .dtype = PRSM_STORAGE_DTYPE_NATIVE,
+            .ndim = (uint32_t)t->ndim,
+            .offset = offset,
+            .nbytes = prsm_tensor_size(t) * sizeof(prsm_float)
+        };
+        vt_memcopy(entry.name, names[i], strlen(names[i]));
+        VT_FOREACH(d, 0, t->ndim) {
+            entry.shape[d] = t->shape[d];
+        }
+
+        ok = fwrite(&entry, sizeof(entry), 1, fp) == 1;
+        offset = prsm_storage_align(offset + entry.nbytes);
+    }
+
+    // write data
+    size_t written = sizeof(header) + count * sizeof(struct PrismaStorageEntry);
+    VT_FOREACH(i, 0, count) {
+        if (!ok) break;
+
+        // pad to alignment
+        const size_t aligned = prsm_storage_align(written);
+        ok = prsm_storage_write_padding(fp, written, aligned);
+        written = aligned;
+
+        // write tensor data
+        const size_t size = prsm_tensor_size(tensors[i]);
+        ok = ok && fwrite(tensors[i]->data, sizeof(prsm_float), size, fp) == size;
+        written += size * sizeof(prsm_float);
+    }
+
+    // close file
+    ok = (fclose(fp) == 0) && ok;
+
+    return ok ? PRSM_STATUS_OPERATION_SUCCESS : PRSM_STATUS_ERROR_IO;
+}
+
+prsm_storage_t *prsm_storage_open(struct VitaBaseAllocatorType *const alloctr, const char *const filename) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(filename != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // map file
+    prsm_mmap_t map = {0};
+    if (prsm_mmap_open(&map, filename) != PRSM_STATUS_OPERATION_SUCCESS) {
+        VT_CHECK(false, "%s: Failed to map <%s>.\n", prsm_status_to_str(PRSM_STATUS_ERROR_IO), filename);
+        return NULL;
+    }
+
+    // validate header
+    const struct PrismaStorageHeader *header = (const struct PrismaStorageHeader*)map.data;
+    const bool header_ok = map.size >= sizeof(*header)
+        && vt_memcmp(header->magic, PRSM_STORAGE_MAGIC, sizeof(header->magic))
+        && header->version <= PRSM_STORAGE_VERSION
+        && header->byte_order == PRSM_STORAGE_BYTE_ORDER
+        && header->count <= (map.size - sizeof(*header)) / sizeof(struct PrismaStorageEntry);
+    if (!header_ok) {
+        VT_CHECK(false, "%s: <%s> is not a prisma tensor container.\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_FORMAT), filename);
+        prsm_mmap_close(&map);
+        return NULL;
+    }
+
+    // allocate for items
+    const size_t len = header->count;
+    struct PrismaStorageItem *items = (alloctr == NULL)
+        ? VT_CALLOC((len + 1) * sizeof(struct PrismaStorageItem))
+        : VT_ALLOCATOR_ALLOC(alloctr, (len + 1) * sizeof(struct PrismaStorageItem));
+
+    // parse and validate the entry table
+    const struct PrismaStorageEntry *entries = (const struct PrismaStorageEntry*)(map.data + sizeof(*header));
+    bool entries_ok = true;
+    VT_FOREACH(i, 0, len) {
+        const struct PrismaStorageEntry *e = &entries[i];
+        if (
+            e->dtype >= PRSM_STORAGE_DTYPE_COUNT || e->ndim == 0 || e->ndim > PRSM_STORAGE_MAX_DIMS ||
+            memchr(e->name, '\0', sizeof(e->name)) == NULL ||
+            e->offset % PRSM_STORAGE_ALIGNMENT != 0 || e->offset > map.size || e->nbytes > map.size - e->offset
+        ) {
+            entries_ok = false;
+            break;
+        }
+
+        // find size from shape
+        size_t size = 1;
+        struct PrismaStorageItem *item = &items[i];
+        VT_FOREACH(d, 0, e->ndim) {
+            item->shape[d] = e->shape[d];
+            size *= e->shape[d];
+        }
+
+        if (size * prsm_storage_dtype_size(e->dtype) != e->nbytes) {
+            entries_ok = false;
+            break;
+        }
+
+        item->name = e->name;
+        item->dtype = e->dtype;
+        item->ndim = e->ndim;
+        item->data = map.data + e->offset;
+    }
+
+    if (!entries_ok) {
+        VT_CHECK(false, "%s: <%s> has a corrupted entry table.\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_FORMAT), filename);
+        (alloctr) ? VT_ALLOCATOR_FREE(alloctr, items) : VT_FREE(items);
+        prsm_mmap_close(&map);
+        return NULL;
+    }
+
+    // allocate for storage
+    prsm_storage_t *st = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_storage_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_storage_t));
+
+    // create storage
+    *st = (prsm_storage_t) {
+        .map = map,
+        .len = len,
+        .items = items,
+        .alloctr = alloctr
+    };
+
+    return st;
+}
+
+void prsm_storage_close(prsm_storage_t *st) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // unmap file
+    prsm_mmap_close(&st->map);
+
+    // free items, storage
+    (st->alloctr) ? VT_ALLOCATOR_FREE(st->alloctr, st->items) : VT_FREE(st->items);
+    (st->alloctr) ? VT_ALLOCATOR_FREE(st->alloctr, st) : VT_FREE(st);
+}
+
+size_t prsm_storage_len(const prsm_storage_t *const st) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    return st->len;
+}
+
+const char *prsm_storage_name(const prsm_storage_t *const st, const size_t at) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(at < st->len, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return st->items[at].name;
+}
+
+enum PrismaStorageDtype prsm_storage_dtype(const prsm_storage_t *const st, const size_t at) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(at < st->len, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return st->items[at].dtype;
+}
+
+prsm_tensor_t prsm_storage_get(const prsm_storage_t *const st, const char *const name) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(name != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // find tensor by name
+    VT_FOREACH(i, 0, st->len) {
+        if (strcmp(st->items[i].name, name) == 0) {
+            return prsm_storage_get_at(st, i);
+        }
+    }
+
+    return (prsm_tensor_t) { .is_view = true };
+}
+
+prsm_tensor_t prsm_storage_get_at(const prsm_storage_t *const st, const size_t at) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(st != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(at < st->len, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // only the native type can be viewed without conversion
+    const struct PrismaStorageItem *item = &st->items[at];
+    if (item->dtype != PRSM_STORAGE_DTYPE_NATIVE) {
+        return (prsm_tensor_t) { .is_view = true };
+    }
+
+    // create view into the mapping
+    prsm_tensor_t tview = {
+        .ndim = item->ndim,
+        .shape = (size_t*)item->shape,
+        .data = (prsm_float*)item->data,
+        .is_view = true
+    };
+
+    return tview;
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Returns element size of a data type
+ * @param  dtype data type
+ * @returns size in bytes
+ */
+static size_t prsm_storage_dtype_size(const enum PrismaStorageDtype dtype) {
+    switch (dtype) {
+        case PRSM_STORAGE_DTYPE_FLOAT32:
+            return sizeof(float);
+        case PRSM_STORAGE_DTYPE_FLOAT64:
+            return sizeof(double);
+        case PRSM_STORAGE_DTYPE_FLOAT80:
+            return sizeof(long double);
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief  Rounds offset up to PRSM_STORAGE_ALIGNMENT
+ * @param  offset offset in bytes
+ * @returns aligned offset
+ */
+static size_t prsm_storage_align(const size_t offset) {
+    return (offset + PRSM_STORAGE_ALIGNMENT - 1) / PRSM_STORAGE_ALIGNMENT * PRSM_STORAGE_ALIGNMENT;
+}
+
+/**
+ * @brief  Writes zero bytes to advance the file position
+ * @param  fp file
+ * @param  from current offset
+ * @param  to target offset
+ * @returns true upon success
+ */
+static bool prsm_storage_write_padding(FILE *fp, const size_t from, const size_t to) {
+    static const uint8_t zeros[PRSM_STORAGE_ALIGNMENT] = {0};
+    return (to == from) || fwrite(zeros, 1, to - from, fp) == to - from;
+}
+
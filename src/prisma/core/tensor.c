@@ -1,9 +1,68 @@
 #include "prisma/core/tensor.h"
+#include "prisma/core/parallel.h"
+
+// software prefetch (a no-op on compilers without the builtin)
+#if defined(__GNUC__) || defined(__clang__)
+    #define PRSM_TENSOR_PREFETCH(addr, rw) __builtin_prefetch((addr), (rw), 1)
+#else
+    #define PRSM_TENSOR_PREFETCH(addr, rw) ((void)(addr))
+#endif
+
+// indexing: rows ahead to prefetch, elements per scatter task column block, minimum elements per task
+#define PRSM_TENSOR_INDEX_PREFETCH_DIST 8
+#define PRSM_TENSOR_INDEX_BLOCK 256
+#define PRSM_TENSOR_INDEX_GRAIN (16 * 1024)
+
+// gemm: register tile (rows x columns of accumulators), rows per cache block, minimum multiply-adds per task
+#define PRSM_TENSOR_GEMM_MR 4
+#define PRSM_TENSOR_GEMM_NR 8
+#define PRSM_TENSOR_GEMM_MC 64
+#define PRSM_TENSOR_GEMM_GRAIN (64 * 1024)
+
+// shared state of a parallel gemm
+struct PrismaTensorGemmContext {
+    prsm_float *out;
+    const prsm_float *lhs;
+    const prsm_float *rhs;
+    size_t m, n, k;                     // op(lhs): (m, k), op(rhs): (k, n)
+    size_t lhs_si, lhs_sp;              // op(lhs)[i, p] = lhs[i * lhs_si + p * lhs_sp]
+    size_t rhs_sp, rhs_sj;              // op(rhs)[p, j] = rhs[p * rhs_sp + j * rhs_sj]
+    prsm_float alpha;
+    prsm_float beta;
+
+    // epilogue
+    const prsm_float *scale;            // n elements or NULL
+    const prsm_float *bias;             // n elements or NULL
+    const prsm_float *residual;         // (m, n) or NULL
+    prsm_float (*func)(prsm_float);     // element-wise function or NULL
+};
+
+// shared state of a parallel gather/scatter
+struct PrismaTensorIndexContext {
+    prsm_float *out;
+    const prsm_float *in;
+    const size_t *idx;
+    size_t idx_size;
+    size_t in_dim;      // in->shape[axis]
+    size_t out_dim;     // out->shape[axis]
+    size_t inner;       // elements per slice after axis
+    size_t num_blocks;  // column blocks per slice (scatter)
+    size_t num_ranges;  // destination index ranges per column block (scatter)
+    bool add;           // accumulate instead of overwrite
+};
 
 static prsm_tensor_t *prsm_tensor_dot_vec_by_vec(prsm_tensor_t *const out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
 static prsm_tensor_t *prsm_tensor_dot_vec_by_mat(prsm_tensor_t *const out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
 static prsm_tensor_t *prsm_tensor_dot_mat_by_vec(prsm_tensor_t *const out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
 static prsm_tensor_t *prsm_tensor_dot_mat_by_mat(prsm_tensor_t *const out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs);
+static void prsm_tensor_gemm_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_tensor_gemm_tile(const struct PrismaTensorGemmContext *const c, const size_t i0, const size_t j0, const size_t mr, const size_t nr);
+static void prsm_tensor_index_split(const prsm_tensor_t *const t, const uint8_t axis, size_t *const outer, size_t *const inner);
+static void prsm_tensor_index_check(const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const uint8_t axis, const size_t *const idx, const size_t idx_size, const size_t bound);
+static void prsm_tensor_gather_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_tensor_scatter_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static prsm_tensor_t *prsm_tensor_gather_impl(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis, const bool add);
+static prsm_tensor_t *prsm_tensor_scatter_impl(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis, const bool add);
 
 /* 
     Tensor creation/destruction
@@ -809,6 +868,74 @@ prsm_tensor_t *prsm_tensor_dot(prsm_tensor_t *out, const prsm_tensor_t *const lh
     }
 }
 
+prsm_tensor_t *prsm_tensor_gemm(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const bool trans_lhs, const bool trans_rhs, const prsm_float alpha, const prsm_float beta) {
+    return prsm_tensor_gemm_ex(out, lhs, rhs, trans_lhs, trans_rhs, alpha, beta, NULL);
+}
+
+prsm_tensor_t *prsm_tensor_gemm_ex(prsm_tensor_t *out, const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const bool trans_lhs, const bool trans_rhs, const prsm_float alpha, const prsm_float beta, const struct PrismaTensorEpilogue *const ep) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(lhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(rhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(lhs->ndim == 2 && rhs->ndim == 2, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+
+    // op(lhs): (m, k), op(rhs): (k, n)
+    const size_t m = trans_lhs ? lhs->shape[1] : lhs->shape[0];
+    const size_t k = trans_lhs ? lhs->shape[0] : lhs->shape[1];
+    const size_t n = trans_rhs ? rhs->shape[0] : rhs->shape[1];
+    VT_ENFORCE(k == (trans_rhs ? rhs->shape[1] : rhs->shape[0]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    if (ep != NULL && ep->scale != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(ep->scale), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(ep->scale) == n, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    if (ep != NULL && ep->bias != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(ep->bias), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(ep->bias) == n, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    if (ep != NULL && ep->residual != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(ep->residual), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+        VT_ENFORCE(prsm_tensor_size(ep->residual) == m * n, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // create tensor
+    prsm_tensor_t *ret = (out == NULL)
+        ? prsm_tensor_create(lhs->alloctr, 2, m, n)
+        : out;
+
+    // check size: resizing discards values, which only makes sense if they are not used
+    if (!prsm_tensor_shapes_match_ex(ret, 2, (size_t[]){m, n})) {
+        VT_ENFORCE(beta == 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        prsm_tensor_resize(ret, 2, m, n);
+    }
+
+    // calculate multiplication
+    struct PrismaTensorGemmContext ctx = {
+        .out = ret->data,
+        .lhs = lhs->data,
+        .rhs = rhs->data,
+        .m = m,
+        .n = n,
+        .k = k,
+        .lhs_si = trans_lhs ? 1 : k,
+        .lhs_sp = trans_lhs ? m : 1,
+        .rhs_sp = trans_rhs ? 1 : n,
+        .rhs_sj = trans_rhs ? k : 1,
+        .alpha = alpha,
+        .beta = beta,
+        .scale = (ep == NULL || ep->scale == NULL) ? NULL : ep->scale->data,
+        .bias = (ep == NULL || ep->bias == NULL) ? NULL : ep->bias->data,
+        .residual = (ep == NULL || ep->residual == NULL) ? NULL : ep->residual->data,
+        .func = (ep == NULL) ? NULL : ep->func
+    };
+
+    // tasks are made of whole row tiles
+    const size_t tiles = (m + PRSM_TENSOR_GEMM_MR - 1) / PRSM_TENSOR_GEMM_MR;
+    const size_t tile_work = PRSM_TENSOR_GEMM_MR * n * k;
+    const size_t grain = (tile_work == 0 || tile_work >= PRSM_TENSOR_GEMM_GRAIN) ? 1 : PRSM_TENSOR_GEMM_GRAIN / tile_work;
+    prsm_parallel_for(tiles, grain, prsm_tensor_gemm_kernel, &ctx);
+
+    return ret;
+}
+
 prsm_float prsm_tensor_vdot(const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs) {
     // check for invalid input
     VT_DEBUG_ASSERT(!prsm_tensor_is_null(lhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
@@ -852,6 +979,41 @@ prsm_tensor_t *prsm_tensor_mul(prsm_tensor_t *out, const prsm_tensor_t *const lh
     return ret;
 }
 
+/* 
+    Tensor indexing operations
+*/
+
+prsm_tensor_t *prsm_tensor_gather(prsm_tensor_t *out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(in), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(axis < in->ndim, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    // create tensor
+    prsm_tensor_t *ret = out;
+    if (ret == NULL) {
+        // same shape as input, except along axis
+        size_t *shape = VT_CALLOC(in->ndim * sizeof(size_t));
+        vt_memcopy(shape, in->shape, in->ndim * sizeof(size_t));
+        shape[axis] = idx_size;
+        ret = prsm_tensor_create_ex(in->alloctr, in->ndim, shape);
+        VT_FREE(shape);
+    }
+
+    return prsm_tensor_gather_impl(ret, in, idx, idx_size, axis, false);
+}
+
+prsm_tensor_t *prsm_tensor_gather_add(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis) {
+    return prsm_tensor_gather_impl(out, in, idx, idx_size, axis, true);
+}
+
+prsm_tensor_t *prsm_tensor_scatter(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis) {
+    return prsm_tensor_scatter_impl(out, in, idx, idx_size, axis, false);
+}
+
+prsm_tensor_t *prsm_tensor_scatter_add(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis) {
+    return prsm_tensor_scatter_impl(out, in, idx, idx_size, axis, true);
+}
+
 /* 
     Tensor element-wise operations
 */
@@ -1135,6 +1297,31 @@ void prsm_tensor_rand_normal(prsm_tensor_t *const t, const prsm_float mu, const
     }
 }
 
+void prsm_tensor_rand_permutation(size_t idx[], const size_t size, uint64_t *const state) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(idx != NULL || size == 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(state == NULL || *state != 0, "%s: Random state must be non-zero.\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // Fisher-Yates: swap each element with a random one in [0, i]
+    for (size_t i = size; i > 1; i--) {
+        uint64_t r;
+        if (state != NULL) {
+            // xorshift64*
+            *state ^= *state >> 12;
+            *state ^= *state << 25;
+            *state ^= *state >> 27;
+            r = *state * 0x2545F4914F6CDD1Dull;
+        } else {
+            r = vt_math_random_u64();
+        }
+
+        const size_t j = (size_t)(r % i);
+        const size_t tmp = idx[i - 1];
+        idx[i - 1] = idx[j];
+        idx[j] = tmp;
+    }
+}
+
 /* 
     Pretty printing
 */
@@ -1334,19 +1521,315 @@ static prsm_tensor_t *prsm_tensor_dot_mat_by_mat(prsm_tensor_t *const out, const
         prsm_tensor_resize(ret, 2, rows, cols);
     }
 
-    // zero out the values
-    prsm_tensor_set_zeros(ret);
-
     // calculate multiplication
-    VT_FOREACH(i, 0, rows) {
-        VT_FOREACH(j, 0, cols) {
-            VT_FOREACH(k, 0, rhs->shape[0]) {
-                ret->data[vt_index_2d_to_1d(i, j, cols)] += lhs->data[vt_index_2d_to_1d(i, k, cols)] * rhs->data[vt_index_2d_to_1d(k, j, cols)];
+    return prsm_tensor_gemm(ret, lhs, rhs, false, false, 1, 0);
+}
+
+/**
+ * @brief  Computes row tiles [from, to) of a gemm
+ * @param  ctx struct PrismaTensorGemmContext*
+ * @param  from first row tile
+ * @param  to last row tile (exclusive)
+ * @param  tid worker id
+ * @returns None
+ *
+ * @note rows are processed in blocks of MC; within a block, each NR-column panel of op(rhs) is reused by all
+ *  row tiles while it is in cache
+ */
+static void prsm_tensor_gemm_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaTensorGemmContext *const c = ctx;
+    const size_t row_from = from * PRSM_TENSOR_GEMM_MR;
+    const size_t row_to = (to * PRSM_TENSOR_GEMM_MR < c->m) ? to * PRSM_TENSOR_GEMM_MR : c->m;
+
+    VT_FOREACH_STEP(ic, row_from, row_to, PRSM_TENSOR_GEMM_MC) {
+        const size_t ic_end = (ic + PRSM_TENSOR_GEMM_MC < row_to) ? ic + PRSM_TENSOR_GEMM_MC : row_to;
+        VT_FOREACH_STEP(j0, 0, c->n, PRSM_TENSOR_GEMM_NR) {
+            const size_t nr = (c->n - j0 < PRSM_TENSOR_GEMM_NR) ? c->n - j0 : PRSM_TENSOR_GEMM_NR;
+            VT_FOREACH_STEP(i0, ic, ic_end, PRSM_TENSOR_GEMM_MR) {
+                const size_t mr = (ic_end - i0 < PRSM_TENSOR_GEMM_MR) ? ic_end - i0 : PRSM_TENSOR_GEMM_MR;
+                prsm_tensor_gemm_tile(c, i0, j0, mr, nr);
             }
         }
     }
+}
 
-    return ret;
+/**
+ * @brief  Computes an (mr, nr) output tile in registers, applies the epilogue and stores it
+ * @param  c gemm context
+ * @param  i0 first row
+ * @param  j0 first column
+ * @param  mr number of rows (<= MR)
+ * @param  nr number of columns (<= NR)
+ * @returns None
+ *
+ * @note full tiles use fixed trip counts, so the accumulators stay in registers and the column loop is vectorized
+ *  when rows of op(rhs) are contiguous
+ */
+static void prsm_tensor_gemm_tile(const struct PrismaTensorGemmContext *const c, const size_t i0, const size_t j0, const size_t mr, const size_t nr) {
+    prsm_float acc[PRSM_TENSOR_GEMM_MR][PRSM_TENSOR_GEMM_NR] = {{0}};
+    const prsm_float *const a = c->lhs + i0 * c->lhs_si;    // op(lhs)[i0, 0]
+    const prsm_float *const b = c->rhs + j0 * c->rhs_sj;    // op(rhs)[0, j0]
+    const size_t lhs_si = c->lhs_si, lhs_sp = c->lhs_sp;
+    const size_t rhs_sp = c->rhs_sp, rhs_sj = c->rhs_sj;
+
+    if (mr == PRSM_TENSOR_GEMM_MR && nr == PRSM_TENSOR_GEMM_NR && rhs_sj == 1) {
+        // full tile, contiguous rows of op(rhs)
+        VT_FOREACH(p, 0, c->k) {
+            const prsm_float *const b_row = b + p * rhs_sp;
+            VT_FOREACH(r, 0, PRSM_TENSOR_GEMM_MR) {
+                const prsm_float a_rp = a[r * lhs_si + p * lhs_sp];
+                VT_FOREACH(col, 0, PRSM_TENSOR_GEMM_NR) {
+                    acc[r][col] += a_rp * b_row[col];
+                }
+            }
+        }
+    } else if (mr == PRSM_TENSOR_GEMM_MR && nr == PRSM_TENSOR_GEMM_NR) {
+        // full tile, strided rows of op(rhs)
+        VT_FOREACH(p, 0, c->k) {
+            VT_FOREACH(r, 0, PRSM_TENSOR_GEMM_MR) {
+                const prsm_float a_rp = a[r * lhs_si + p * lhs_sp];
+                VT_FOREACH(col, 0, PRSM_TENSOR_GEMM_NR) {
+                    acc[r][col] += a_rp * b[p * rhs_sp + col * rhs_sj];
+                }
+            }
+        }
+    } else {
+        // edge tile
+        VT_FOREACH(p, 0, c->k) {
+            VT_FOREACH(r, 0, mr) {
+                const prsm_float a_rp = a[r * lhs_si + p * lhs_sp];
+                VT_FOREACH(col, 0, nr) {
+                    acc[r][col] += a_rp * b[p * rhs_sp + col * rhs_sj];
+                }
+            }
+        }
+    }
+
+    // epilogue: out = func(scale * (alpha * acc + beta * out) + bias + residual), every element is stored once
+    VT_FOREACH(r, 0, mr) {
+        prsm_float *const out_row = c->out + (i0 + r) * c->n + j0;
+        const prsm_float *const res_row = (c->residual == NULL) ? NULL : c->residual + (i0 + r) * c->n + j0;
+        VT_FOREACH(col, 0, nr) {
+            prsm_float v = c->alpha * acc[r][col];
+            if (c->beta != 0) v += c->beta * out_row[col];
+            if (c->scale != NULL) v *= c->scale[j0 + col];
+            if (c->bias != NULL) v += c->bias[j0 + col];
+            if (res_row != NULL) v += res_row[col];
+            out_row[col] = (c->func == NULL) ? v : c->func(v);
+        }
+    }
+}
+
+/**
+ * @brief  Splits a tensor around an axis into (outer, shape[axis], inner)
+ * @param  t tensor
+ * @param  axis axis
+ * @param  outer product of dimensions before axis
+ * @param  inner product of dimensions after axis
+ * @returns None
+ */
+static void prsm_tensor_index_split(const prsm_tensor_t *const t, const uint8_t axis, size_t *const outer, size_t *const inner) {
+    *outer = 1;
+    *inner = 1;
+    VT_FOREACH(i, 0, axis) {
+        *outer *= t->shape[i];
+    }
+    VT_FOREACH(i, axis + 1, t->ndim) {
+        *inner *= t->shape[i];
+    }
+}
+
+/**
+ * @brief  Checks that two tensors differ only along an axis and that indices are in range
+ * @param  lhs tensor indexed by position (`lhs->shape[axis] == idx_size`)
+ * @param  rhs tensor indexed by `idx`
+ * @param  axis axis
+ * @param  idx indices
+ * @param  idx_size number of indices
+ * @param  bound exclusive upper bound for indices
+ * @returns None
+ */
+static void prsm_tensor_index_check(const prsm_tensor_t *const lhs, const prsm_tensor_t *const rhs, const uint8_t axis, const size_t *const idx, const size_t idx_size, const size_t bound) {
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(lhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(rhs), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(idx != NULL || idx_size == 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(lhs->ndim == rhs->ndim, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(axis < lhs->ndim, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+    VT_ENFORCE(lhs->shape[axis] == idx_size, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    VT_FOREACH(i, 0, lhs->ndim) {
+        VT_ENFORCE(i == axis || lhs->shape[i] == rhs->shape[i], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    VT_FOREACH(i, 0, idx_size) {
+        VT_ENFORCE(idx[i] < bound, "%s: %zu < %zu\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS), idx[i], bound);
+    }
+}
+
+/**
+ * @brief  Gathers slices [from, to) of the output, numbered as (outer, idx_size)
+ * @param  ctx struct PrismaTensorIndexContext*
+ * @param  from first slice
+ * @param  to last slice (exclusive)
+ * @param  tid worker id
+ * @returns None
+ *
+ * @note every output slice is written by one worker, so no synchronization is needed
+ */
+static void prsm_tensor_gather_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaTensorIndexContext *const c = ctx;
+    const size_t inner = c->inner;
+
+    VT_FOREACH(w, from, to) {
+        // prefetch a source slice a few iterations ahead: indexed reads defeat the hardware prefetcher
+        const size_t ahead = w + PRSM_TENSOR_INDEX_PREFETCH_DIST;
+        if (ahead < to) {
+            PRSM_TENSOR_PREFETCH(c->in + ((ahead / c->idx_size) * c->in_dim + c->idx[ahead % c->idx_size]) * inner, 0);
+        }
+
+        const size_t o = w / c->idx_size;
+        const size_t k = w % c->idx_size;
+        const prsm_float *const src = c->in + (o * c->in_dim + c->idx[k]) * inner;
+        prsm_float *const dst = c->out + w * inner;
+        if (c->add) {
+            VT_FOREACH(i, 0, inner) {
+                dst[i] += src[i];
+            }
+        } else {
+            memcpy(dst, src, inner * sizeof(prsm_float));
+        }
+    }
+}
+
+/**
+ * @brief  Scatters work units [from, to), numbered as (outer, num_blocks, num_ranges)
+ * @param  ctx struct PrismaTensorIndexContext*
+ * @param  from first unit
+ * @param  to last unit (exclusive)
+ * @param  tid worker id
+ * @returns None
+ *
+ * @note a unit owns a column block of a contiguous range of destination slices and writes only the indices
+ *  that fall into it: repeated indices then touch the same elements from one worker only, in index order
+ */
+static void prsm_tensor_scatter_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaTensorIndexContext *const c = ctx;
+    const size_t inner = c->inner;
+
+    VT_FOREACH(w, from, to) {
+        const size_t range = w % c->num_ranges;
+        const size_t block = w / c->num_ranges;
+        const size_t o = block / c->num_blocks;
+        const size_t col_from = (block % c->num_blocks) * PRSM_TENSOR_INDEX_BLOCK;
+        const size_t col_to = (col_from + PRSM_TENSOR_INDEX_BLOCK < inner) ? col_from + PRSM_TENSOR_INDEX_BLOCK : inner;
+        const size_t dst_from = range * c->out_dim / c->num_ranges;
+        const size_t dst_to = (range + 1) * c->out_dim / c->num_ranges;
+        const prsm_float *const in = c->in + o * c->idx_size * inner;
+        prsm_float *const out = c->out + o * c->out_dim * inner;
+
+        VT_FOREACH(k, 0, c->idx_size) {
+            if (c->idx[k] < dst_from || c->idx[k] >= dst_to) {
+                continue;
+            }
+
+            // prefetch a destination slice a few iterations ahead
+            if (k + PRSM_TENSOR_INDEX_PREFETCH_DIST < c->idx_size) {
+                PRSM_TENSOR_PREFETCH(out + c->idx[k + PRSM_TENSOR_INDEX_PREFETCH_DIST] * inner + col_from, 1);
+            }
+
+            const prsm_float *const src = in + k * inner;
+            prsm_float *const dst = out + c->idx[k] * inner;
+            if (c->add) {
+                VT_FOREACH(i, col_from, col_to) {
+                    dst[i] += src[i];
+                }
+            } else {
+                memcpy(dst + col_from, src + col_from, (col_to - col_from) * sizeof(prsm_float));
+            }
+        }
+    }
 }
 
+/**
+ * @brief  Gather implementation
+ * @param  out output tensor
+ * @param  in tensor
+ * @param  idx indices
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @param  add accumulate instead of overwrite
+ * @returns out
+ */
+static prsm_tensor_t *prsm_tensor_gather_impl(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis, const bool add) {
+    // check for invalid input
+    prsm_tensor_index_check(out, in, axis, idx, idx_size, (axis < in->ndim) ? in->shape[axis] : 0);
+
+    size_t outer, inner;
+    prsm_tensor_index_split(in, axis, &outer, &inner);
+
+    struct PrismaTensorIndexContext ctx = {
+        .out = out->data,
+        .in = in->data,
+        .idx = idx,
+        .idx_size = idx_size,
+        .in_dim = in->shape[axis],
+        .out_dim = idx_size,
+        .inner = inner,
+        .add = add
+    };
+    const size_t grain = (inner == 0 || inner >= PRSM_TENSOR_INDEX_GRAIN) ? 1 : PRSM_TENSOR_INDEX_GRAIN / inner;
+    prsm_parallel_for(outer * idx_size, grain, prsm_tensor_gather_kernel, &ctx);
+
+    return out;
+}
+
+/**
+ * @brief  Scatter implementation
+ * @param  out output tensor
+ * @param  in tensor
+ * @param  idx indices
+ * @param  idx_size number of indices
+ * @param  axis axis to index
+ * @param  add accumulate instead of overwrite
+ * @returns out
+ */
+static prsm_tensor_t *prsm_tensor_scatter_impl(prsm_tensor_t *const out, const prsm_tensor_t *const in, const size_t idx[], const size_t idx_size, const uint8_t axis, const bool add) {
+    // check for invalid input
+    prsm_tensor_index_check(in, out, axis, idx, idx_size, (axis < out->ndim) ? out->shape[axis] : 0);
+
+    size_t outer, inner;
+    prsm_tensor_index_split(in, axis, &outer, &inner);
+
+    struct PrismaTensorIndexContext ctx = {
+        .out = out->data,
+        .in = in->data,
+        .idx = idx,
+        .idx_size = idx_size,
+        .in_dim = idx_size,
+        .out_dim = out->shape[axis],
+        .inner = inner,
+        .num_blocks = (inner + PRSM_TENSOR_INDEX_BLOCK - 1) / PRSM_TENSOR_INDEX_BLOCK,
+        .num_ranges = 1,
+        .add = add
+    };
+
+    // too few column blocks for the threads: split them into destination ranges, so a narrow slice
+    // (e.g. axis 0 of a matrix with few columns) is still scattered in parallel; every range scans all
+    // indices, so there are no more ranges than threads
+    const size_t block_work = idx_size * ((inner < PRSM_TENSOR_INDEX_BLOCK) ? inner : PRSM_TENSOR_INDEX_BLOCK);
+    const size_t num_threads = prsm_parallel_get_num_threads();
+    const size_t num_units = outer * ctx.num_blocks;
+    if (block_work > PRSM_TENSOR_INDEX_GRAIN && num_units > 0 && num_units < num_threads) {
+        const size_t by_work = (block_work + PRSM_TENSOR_INDEX_GRAIN - 1) / PRSM_TENSOR_INDEX_GRAIN;
+        const size_t by_threads = (num_threads + num_units - 1) / num_units;
+        const size_t num_ranges = (by_work < by_threads) ? by_work : by_threads;
+        ctx.num_ranges = (num_ranges < ctx.out_dim) ? num_ranges : ctx.out_dim;
+    }
+    const size_t unit_work = block_work / ctx.num_ranges;
+    const size_t grain = (unit_work >= PRSM_TENSOR_INDEX_GRAIN || unit_work == 0) ? 1 : PRSM_TENSOR_INDEX_GRAIN / unit_work;
+    prsm_parallel_for(num_units * ctx.num_ranges, grain, prsm_tensor_scatter_kernel, &ctx);
+
+    return out;
+}
 
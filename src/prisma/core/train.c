@@ -0,0 +1,578 @@
+#include "prisma/core/train.h"
+
+// minimum elements per all-reduce task
+#define PRSM_TRAIN_GRAIN (16 * 1024)
+
+// elements reduced across all shards at once; the tile of every shard stays in cache
+#define PRSM_TRAIN_TILE 1024
+
+// hogwild worker statistics
+struct PrismaTrainHogwildWorker {
+    size_t updates;
+    size_t staleness;               // sum over updates
+    size_t max_staleness;
+    prsm_float loss;                // sum of minibatch losses weighted by rows
+};
+
+// shared state of a hogwild epoch
+struct PrismaTrainHogwildContext {
+    prsm_train_t *train;
+    const prsm_tensor_t *x;
+    const prsm_tensor_t *y;
+    size_t batch_size;
+    const prsm_optim_params_t *params;
+    struct PrismaTrainHogwildWorker *workers;
+};
+
+static void prsm_train_shard_views(prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y);
+static void prsm_train_view_rows(struct PrismaTrainShard *const shard, const prsm_tensor_t *const x, const prsm_tensor_t *const y, const size_t from, const size_t len);
+static prsm_tensor_t prsm_train_rows(size_t shape[], const prsm_tensor_t *const t, const size_t from, const size_t len);
+static void prsm_train_shard_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_train_reduce(const prsm_train_t *const train, const size_t t, const size_t from, const size_t to);
+static void prsm_train_reduce_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static void prsm_train_hogwild_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid);
+static prsm_float prsm_train_load_relaxed(const prsm_float *const ptr);
+static void prsm_train_store_relaxed(prsm_float *const ptr, const prsm_float value);
+
+prsm_train_t *prsm_train_create(
+    struct VitaBaseAllocatorType *const alloctr, prsm_tensor_t *const params[], const size_t count,
+    const size_t num_shards, prsm_train_model_fn model, void *const ctx
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(params != NULL && count > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(model != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_FOREACH(i, 0, count) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(params[i]), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    }
+
+    // allocate trainer
+    prsm_train_t *train = (alloctr == NULL)
+        ? VT_CALLOC(sizeof(prsm_train_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, sizeof(prsm_train_t));
+    train->count = count;
+    train->num_shards = (num_shards == 0) ? prsm_parallel_get_num_threads() : num_shards;
+    train->model = model;
+    train->ctx = ctx;
+    train->alloctr = alloctr;
+
+    // parameters and their offsets in the concatenated gradients
+    train->params = (alloctr == NULL)
+        ? VT_CALLOC(count * sizeof(prsm_tensor_t*))
+        : VT_ALLOCATOR_ALLOC(alloctr, count * sizeof(prsm_tensor_t*));
+    train->grads = (alloctr == NULL)
+        ? VT_CALLOC(count * sizeof(prsm_tensor_t*))
+        : VT_ALLOCATOR_ALLOC(alloctr, count * sizeof(prsm_tensor_t*));
+    train->offsets = (alloctr == NULL)
+        ? VT_CALLOC((count + 1) * sizeof(size_t))
+        : VT_ALLOCATOR_ALLOC(alloctr, (count + 1) * sizeof(size_t));
+    VT_FOREACH(i, 0, count) {
+        train->params[i] = params[i];
+        train->offsets[i + 1] = train->offsets[i] + prsm_tensor_size(params[i]);
+    }
+
+    // shards
+    train->shards = (alloctr == NULL)
+        ? VT_CALLOC(train->num_shards * sizeof(struct PrismaTrainShard))
+        : VT_ALLOCATOR_ALLOC(alloctr, train->num_shards * sizeof(struct PrismaTrainShard));
+    VT_FOREACH(s, 0, train->num_shards) {
+        train->shards[s].tape = prsm_autograd_create(alloctr);
+    }
+
+    return train;
+}
+
+void prsm_train_destroy(prsm_train_t *train) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    // free shards
+    struct VitaBaseAllocatorType *const alloctr = train->alloctr;
+    VT_FOREACH(s, 0, train->num_shards) {
+        prsm_autograd_destroy(train->shards[s].tape);
+    }
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train->shards) : VT_FREE(train->shards);
+    if (train->accum != NULL) {
+        VT_FOREACH(i, 0, train->count) {
+            prsm_tensor_destroy(train->accum[i]);
+        }
+        (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train->accum) : VT_FREE(train->accum);
+    }
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train->params) : VT_FREE(train->params);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train->grads) : VT_FREE(train->grads);
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train->offsets) : VT_FREE(train->offsets);
+
+    // free trainer
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, train) : VT_FREE(train);
+    train = NULL;
+}
+
+prsm_float prsm_train_step(prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y, prsm_optim_t *const optim) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(x), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(x->ndim <= PRSM_TRAIN_MAX_DIMS && x->shape[0] > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    if (y != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(y), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(y->ndim <= PRSM_TRAIN_MAX_DIMS, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(y->shape[0] == x->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // split the minibatch into row ranges
+    prsm_train_shard_views(train, x, y);
+
+    // forward and backward: every shard on its own tape
+    prsm_parallel_for(train->active, 1, prsm_train_shard_kernel, train);
+
+    // minibatch loss, summed in shard order
+    prsm_float loss = 0;
+    VT_FOREACH(s, 0, train->active) {
+        const struct PrismaTrainShard *const shard = &train->shards[s];
+        const prsm_tensor_t *const value = prsm_autograd_value(shard->tape, shard->loss);
+        VT_ENFORCE(prsm_tensor_size(value) == 1, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+        loss += shard->weight * value->data[0];
+    }
+
+    // every parameter must receive a gradient
+    VT_FOREACH(i, 0, train->count) {
+        train->grads[i] = prsm_autograd_grad(train->shards[0].tape, i);
+        VT_ENFORCE(train->grads[i] != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_REQUIRED));
+    }
+
+    // all-reduce the gradients into the first shard
+    if (train->active > 1) {
+        prsm_parallel_for(train->offsets[train->count], PRSM_TRAIN_GRAIN, prsm_train_reduce_kernel, train);
+    }
+
+    // update
+    if (optim != NULL) {
+        prsm_optim_step(optim, train->params, (const prsm_tensor_t *const *)train->grads, train->count);
+    }
+
+    return loss;
+}
+
+prsm_float prsm_train_step_accumulate(
+    prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y,
+    const size_t micro_batch, prsm_optim_t *const optim
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(x), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(x->ndim <= PRSM_TRAIN_MAX_DIMS && x->shape[0] > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    VT_ENFORCE(micro_batch > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    if (y != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(y), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(y->ndim <= PRSM_TRAIN_MAX_DIMS, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(y->shape[0] == x->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+
+    // accumulated gradients
+    struct VitaBaseAllocatorType *const alloctr = train->alloctr;
+    if (train->accum == NULL) {
+        train->accum = (alloctr == NULL)
+            ? VT_CALLOC(train->count * sizeof(prsm_tensor_t*))
+            : VT_ALLOCATOR_ALLOC(alloctr, train->count * sizeof(prsm_tensor_t*));
+        VT_FOREACH(i, 0, train->count) {
+            train->accum[i] = prsm_tensor_create_ex(alloctr, train->params[i]->ndim, train->params[i]->shape);
+        }
+    }
+
+    // micro-batches one after another: every step reuses the tape buffers of the previous one
+    const size_t n = x->shape[0];
+    prsm_float loss = 0;
+    for (size_t from = 0; from < n; from += micro_batch) {
+        const size_t len = (n - from < micro_batch) ? n - from : micro_batch;
+        size_t x_shape[PRSM_TRAIN_MAX_DIMS], y_shape[PRSM_TRAIN_MAX_DIMS];
+        const prsm_tensor_t xm = prsm_train_rows(x_shape, x, from, len);
+        const prsm_tensor_t ym = (y == NULL) ? (prsm_tensor_t) {0} : prsm_train_rows(y_shape, y, from, len);
+        const prsm_float micro_loss = prsm_train_step(train, &xm, (y == NULL) ? NULL : &ym, NULL);
+
+        // the minibatch loss is a mean over rows: weight the micro-batch by its share of the rows
+        const prsm_float weight = (prsm_float)len / (prsm_float)n;
+        loss += weight * micro_loss;
+        VT_FOREACH(i, 0, train->count) {
+            prsm_float *const acc = train->accum[i]->data;
+            const prsm_float *const grad = train->grads[i]->data;
+            const size_t size = prsm_tensor_size(train->accum[i]);
+            if (from == 0) {
+                VT_FOREACH(j, 0, size) {
+                    acc[j] = weight * grad[j];
+                }
+            } else {
+                VT_FOREACH(j, 0, size) {
+                    acc[j] += weight * grad[j];
+                }
+            }
+        }
+    }
+
+    // gradients of the minibatch
+    VT_FOREACH(i, 0, train->count) {
+        train->grads[i] = train->accum[i];
+    }
+
+    // update
+    if (optim != NULL) {
+        prsm_optim_step(optim, train->params, (const prsm_tensor_t *const *)train->grads, train->count);
+    }
+
+    return loss;
+}
+
+prsm_tensor_t *prsm_train_grad(const prsm_train_t *const train, const size_t i) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(i < train->count, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_OUT_OF_BOUNDS_ACCESS));
+
+    return train->grads[i];
+}
+
+prsm_autograd_checkpoint_stats_t prsm_train_checkpoint_stats(const prsm_train_t *const train) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+
+    prsm_autograd_checkpoint_stats_t stats = {0};
+    VT_FOREACH(s, 0, train->active) {
+        const prsm_autograd_checkpoint_stats_t shard = prsm_autograd_checkpoint_stats(train->shards[s].tape);
+        stats.stored_bytes += shard.stored_bytes;
+        stats.saved_bytes += shard.saved_bytes;
+        stats.forward_flops += shard.forward_flops;
+        stats.recompute_flops += shard.recompute_flops;
+        stats.stashed_bytes += shard.stashed_bytes;
+    }
+
+    return stats;
+}
+
+prsm_train_hogwild_stats_t prsm_train_hogwild(
+    prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y,
+    const size_t batch_size, const prsm_optim_params_t *const params
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(params != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_tensor_is_null(x), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+    VT_ENFORCE(x->ndim <= PRSM_TRAIN_MAX_DIMS && x->shape[0] > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+    if (y != NULL) {
+        VT_DEBUG_ASSERT(!prsm_tensor_is_null(y), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+        VT_ENFORCE(y->ndim <= PRSM_TRAIN_MAX_DIMS, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_DIMENSIONS));
+        VT_ENFORCE(y->shape[0] == x->shape[0], "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INCOMPATIBLE_SHAPES));
+    }
+    VT_ENFORCE(batch_size > 0, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_ENFORCE(
+        params->type == PRSM_OPTIM_SGD && params->momentum == 0 && params->lr > 0 && params->weight_decay >= 0 && params->clip >= 0,
+        "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS)
+    );
+
+    // worker statistics
+    struct VitaBaseAllocatorType *const alloctr = train->alloctr;
+    struct PrismaTrainHogwildWorker *const workers = (alloctr == NULL)
+        ? VT_CALLOC(train->num_shards * sizeof(struct PrismaTrainHogwildWorker))
+        : VT_ALLOCATOR_ALLOC(alloctr, train->num_shards * sizeof(struct PrismaTrainHogwildWorker));
+
+    // run workers
+    struct PrismaTrainHogwildContext ctx = {
+        .train = train,
+        .x = x,
+        .y = y,
+        .batch_size = batch_size,
+        .params = params,
+        .workers = workers
+    };
+    prsm_parallel_for(train->num_shards, 1, prsm_train_hogwild_kernel, &ctx);
+
+    // gather statistics
+    prsm_train_hogwild_stats_t stats = {0};
+    size_t staleness = 0;
+    VT_FOREACH(s, 0, train->num_shards) {
+        stats.updates += workers[s].updates;
+        stats.loss += workers[s].loss;
+        staleness += workers[s].staleness;
+        if (workers[s].max_staleness > stats.max_staleness) stats.max_staleness = workers[s].max_staleness;
+    }
+    stats.loss /= (prsm_float)x->shape[0];
+    stats.mean_staleness = (stats.updates == 0) ? 0 : (prsm_float)staleness / (prsm_float)stats.updates;
+    (alloctr) ? VT_ALLOCATOR_FREE(alloctr, workers) : VT_FREE(workers);
+
+    return stats;
+}
+
+prsm_float prsm_train_step_distributed(
+    prsm_train_t *const train, prsm_comm_t *const comm, const prsm_tensor_t *const x,
+    const prsm_tensor_t *const y, prsm_optim_t *const optim
+) {
+    // check for invalid input
+    VT_DEBUG_ASSERT(train != NULL, "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_INVALID_ARGUMENTS));
+    VT_DEBUG_ASSERT(!prsm_comm_is_null(comm), "%s\n", prsm_status_to_str(PRSM_STATUS_ERROR_IS_NULL));
+
+    // gradients of the local rows
+    const prsm_float loss = prsm_train_step(train, x, y, NULL);
+
+    // global rows and loss
+    const prsm_float rows = (prsm_float)x->shape[0];
+    prsm_float totals_data[] = { loss * rows, rows };
+    size_t totals_shape[] = { 2 };
+    prsm_tensor_t totals = { .ndim = 1, .shape = totals_shape, .data = totals_data, .is_view = true };
+    prsm_tensor_t *const totals_list[] = { &totals };
+    prsm_comm_allreduce(comm, totals_list, 1);
+
+    // weight the local gradients by their share of the rows, then sum them over processes
+    VT_FOREACH(i, 0, train->count) {
+        prsm_tensor_apply_scale_add(train->grads[i], rows / totals_data[1], 0);
+    }
+    prsm_comm_allreduce(comm, train->grads, train->count);
+
+    // update: same parameters and gradients in every process
+    if (optim != NULL) {
+        prsm_optim_step(optim, train->params, (const prsm_tensor_t *const *)train->grads, train->count);
+    }
+
+    return totals_data[0] / totals_data[1];
+}
+
+// -------------------------- PRIVATE -------------------------- //
+
+/**
+ * @brief  Splits the minibatch rows evenly across the shards; the first shards get one extra row
+ * @param  train trainer
+ * @param  x minibatch inputs
+ * @param  y minibatch targets or `NULL`
+ * @returns None
+ */
+static void prsm_train_shard_views(prsm_train_t *const train, const prsm_tensor_t *const x, const prsm_tensor_t *const y) {
+    const size_t n = x->shape[0];
+    train->active = (n < train->num_shards) ? n : train->num_shards;
+
+    const size_t block = n / train->active;
+    const size_t rem = n % train->active;
+    size_t from = 0;
+    VT_FOREACH(s, 0, train->active) {
+        struct PrismaTrainShard *const shard = &train->shards[s];
+        const size_t len = block + (s < rem);
+        prsm_train_view_rows(shard, x, y, from, len);
+        shard->weight = (prsm_float)len / (prsm_float)n;
+        from += len;
+    }
+}
+
+/**
+ * @brief  Points the shard views at rows [from, from + len) of the inputs and targets
+ * @param  shard shard
+ * @param  x inputs
+ * @param  y targets or `NULL`
+ * @param  from first row
+ * @param  len number of rows
+ * @returns None
+ */
+static void prsm_train_view_rows(struct PrismaTrainShard *const shard, const prsm_tensor_t *const x, const prsm_tensor_t *const y, const size_t from, const size_t len) {
+    shard->x = prsm_train_rows(shard->x_shape, x, from, len);
+    shard->y = (y == NULL) ? (prsm_tensor_t) {0} : prsm_train_rows(shard->y_shape, y, from, len);
+}
+
+/**
+ * @brief  Makes a view of rows [from, from + len) of a tensor
+ * @param  shape view shape storage of `t->ndim` elements
+ * @param  t tensor
+ * @param  from first row
+ * @param  len number of rows
+ * @returns prsm_tensor_t view
+ */
+static prsm_tensor_t prsm_train_rows(size_t shape[], const prsm_tensor_t *const t, const size_t from, const size_t len) {
+    // views share all but the first dimension with the source
+    VT_FOREACH(d, 0, t->ndim) {
+        shape[d] = t->shape[d];
+    }
+    shape[0] = len;
+    return (prsm_tensor_t) {
+        .ndim = t->ndim,
+        .shape = shape,
+        .data = t->data + from * (prsm_tensor_size(t) / t->shape[0]),
+        .is_view = true
+    };
+}
+
+/**
+ * @brief  Runs forward and backward passes of shards [from, to)
+ * @param  ctx `prsm_train_t`
+ * @param  from first shard
+ * @param  to one past the last shard
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_train_shard_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    prsm_train_t *const train = ctx;
+    const bool has_y = train->shards[0].y.data != NULL;
+    VT_FOREACH(s, from, to) {
+        struct PrismaTrainShard *const shard = &train->shards[s];
+
+        // replay the tape: parameters are leaves 0..count-1
+        prsm_autograd_reset(shard->tape);
+        VT_FOREACH(i, 0, train->count) {
+            prsm_autograd_leaf(shard->tape, train->params[i], true);
+        }
+        shard->loss = train->model(shard->tape, &shard->x, has_y ? &shard->y : NULL, train->ctx);
+        prsm_autograd_backward(shard->tape, shard->loss);
+    }
+}
+
+/**
+ * @brief  Reduces elements [from, to) of one gradient tensor across all shards into the first shard
+ * @param  train trainer
+ * @param  t tensor index
+ * @param  from first element
+ * @param  to one past the last element
+ * @returns None
+ *
+ * @note the tree is fixed: leaves are weighted pairwise (0, 1), (2, 3), ..., then partial sums are added
+ *       at strides 2, 4, ... into the lower shard
+ */
+static void prsm_train_reduce(const prsm_train_t *const train, const size_t t, const size_t from, const size_t to) {
+    const struct PrismaTrainShard *const shards = train->shards;
+    const size_t active = train->active;
+    for (size_t lo = from; lo < to; lo += PRSM_TRAIN_TILE) {
+        const size_t hi = (to - lo < PRSM_TRAIN_TILE) ? to : lo + PRSM_TRAIN_TILE;
+
+        // leaves: weighted sum of neighbouring shards
+        for (size_t s = 0; s < active; s += 2) {
+            prsm_float *const dst = shards[s].tape->nodes[t].grad->data;
+            if (s + 1 < active) {
+                const prsm_float *const src = shards[s + 1].tape->nodes[t].grad->data;
+                VT_FOREACH(i, lo, hi) {
+                    dst[i] = shards[s].weight * dst[i] + shards[s + 1].weight * src[i];
+                }
+            } else {
+                VT_FOREACH(i, lo, hi) {
+                    dst[i] *= shards[s].weight;
+                }
+            }
+        }
+
+        // inner levels
+        for (size_t stride = 2; stride < active; stride *= 2) {
+            for (size_t s = 0; s + stride < active; s += 2 * stride) {
+                prsm_float *const dst = shards[s].tape->nodes[t].grad->data;
+                const prsm_float *const src = shards[s + stride].tape->nodes[t].grad->data;
+                VT_FOREACH(i, lo, hi) {
+                    dst[i] += src[i];
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Reduces elements [from, to) of the concatenated gradients
+ * @param  ctx `prsm_train_t`
+ * @param  from first element
+ * @param  to one past the last element
+ * @param  tid worker id
+ * @returns None
+ */
+static void prsm_train_reduce_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const prsm_train_t *const train = ctx;
+    const size_t *const offsets = train->offsets;
+
+    // walk the tensors the chunk spans
+    size_t at = from;
+    for (size_t t = prsm_optim_find(offsets, train->count, from); at < to; t++) {
+        const size_t end = (offsets[t + 1] < to) ? offsets[t + 1] : to;
+        prsm_train_reduce(train, t, at - offsets[t], end - offsets[t]);
+        at = end;
+    }
+}
+
+/**
+ * @brief  Runs hogwild workers [from, to): each walks its part of the rows in minibatches
+ * @param  ctx `struct PrismaTrainHogwildContext`
+ * @param  from first worker
+ * @param  to one past the last worker
+ * @param  tid thread id
+ * @returns None
+ */
+static void prsm_train_hogwild_kernel(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    (void)tid;
+    const struct PrismaTrainHogwildContext *const c = ctx;
+    prsm_train_t *const train = c->train;
+    const prsm_optim_params_t *const p = c->params;
+    const prsm_float lr = p->lr, wd = p->weight_decay;
+    const prsm_float clip = (p->clip > 0) ? p->clip : (prsm_float)INFINITY;
+
+    // rows are split like minibatches across shards
+    const size_t n = c->x->shape[0];
+    const size_t block = n / train->num_shards;
+    const size_t rem = n % train->num_shards;
+    VT_FOREACH(s, from, to) {
+        struct PrismaTrainShard *const shard = &train->shards[s];
+        struct PrismaTrainHogwildWorker *const worker = &c->workers[s];
+        const size_t first = s * block + ((s < rem) ? s : rem);
+        const size_t last = first + block + (s < rem);
+        for (size_t row = first; row < last; row += c->batch_size) {
+            const size_t len = (last - row < c->batch_size) ? last - row : c->batch_size;
+            prsm_train_view_rows(shard, c->x, c->y, row, len);
+
+            // gradients read the shared parameters in place instead of a per-minibatch copy; values written by
+            // other workers meanwhile are part of the staleness
+            const size_t seen = prsm_atomic_load(&train->version);
+            prsm_autograd_reset(shard->tape);
+            VT_FOREACH(i, 0, train->count) {
+                prsm_autograd_leaf(shard->tape, train->params[i], true);
+            }
+            const size_t loss = train->model(shard->tape, &shard->x, (c->y == NULL) ? NULL : &shard->y, train->ctx);
+            prsm_autograd_backward(shard->tape, loss);
+            worker->loss += (prsm_float)len * prsm_autograd_value(shard->tape, loss)->data[0];
+
+            // staleness: updates made by other workers since the parameters were read
+            const size_t staleness = prsm_atomic_fetch_add(&train->version, 1) - seen;
+            worker->staleness += staleness;
+            if (staleness > worker->max_staleness) worker->max_staleness = staleness;
+            worker->updates++;
+
+            // w -= lr * (clip(g) + wd * w) on the shared parameters; zero gradients leave w untouched, but the
+            // gradients are dense, so every update still scans all parameters
+            VT_FOREACH(i, 0, train->count) {
+                const prsm_tensor_t *const grad = prsm_autograd_grad(shard->tape, i);
+                if (grad == NULL) continue;
+                prsm_float *const w = train->params[i]->data;
+                const prsm_float *const g = grad->data;
+                VT_FOREACH(j, 0, train->offsets[i + 1] - train->offsets[i]) {
+                    if (g[j] == 0 && wd == 0) continue;
+                    const prsm_float gc = (g[j] > clip) ? clip : (g[j] < -clip) ? -clip : g[j];
+                    const prsm_float wj = prsm_train_load_relaxed(&w[j]);
+                    prsm_train_store_relaxed(&w[j], wj - lr * (gc + wd * wj));
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief  Loads a shared value without ordering guarantees, but without tearing
+ * @param  ptr value
+ * @returns prsm_float
+ */
+static prsm_float prsm_train_load_relaxed(const prsm_float *const ptr) {
+#if defined(_MSC_VER)
+    return *(const volatile prsm_float *)ptr;
+#else
+    prsm_float value;
+    __atomic_load(ptr, &value, __ATOMIC_RELAXED);
+    return value;
+#endif
+}
+
+/**
+ * @brief  Stores a shared value without ordering guarantees, but without tearing
+ * @param  ptr value
+ * @param  value new value
+ * @returns None
+ */
+static void prsm_train_store_relaxed(prsm_float *const ptr, const prsm_float value) {
+#if defined(_MSC_VER)
+    *(volatile prsm_float *)ptr = value;
+#else
+    prsm_float tmp = value;
+    __atomic_store(ptr, &tmp, __ATOMIC_RELAXED);
+#endif
+}
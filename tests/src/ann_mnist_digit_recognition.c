@@ -5,11 +5,9 @@
 #define MNIST_TEST "mnist_test.csv"
 
 void ann_download_csv(const char *const url, const char *const filepath);
-void ann_read_mnist_data(const char *const file, prsm_tensor_t *x, prsm_tensor_t *y);
-vt_vec_t *ann_model_init_params(const size_t N, const size_t n_x, const size_t n_h, const size_t n_y);
-vt_vec_t *ann_model_forward(vt_vec_t *params, prsm_tensor_t *x);
-vt_vec_t *ann_model_backward(prsm_tensor_t *x, prsm_tensor_t *y, vt_vec_t *params);
-vt_vec_t *ann_model_update(vt_vec_t *params, const prsm_float learning_rate);
+vt_vec_t *ann_model_init_params(const size_t n_x, const size_t n_h, const size_t n_y);
+size_t ann_model_forward(prsm_autograd_t *tape, vt_vec_t *params, prsm_tensor_t *x, prsm_tensor_t *y, size_t *yhat);
+vt_vec_t *ann_model_update(prsm_autograd_t *tape, vt_vec_t *params, prsm_optim_t *optim);
 prsm_float ann_cost(const prsm_tensor_t *const pred, const prsm_tensor_t *const target);
 prsm_float ann_accuracy(prsm_tensor_t *const pred, const prsm_tensor_t *const target, const bool round);
 
@@ -48,58 +46,78 @@ void run_ann_mnist_digit_recognition(void) {
     y_test = prsm_tensor_create_mat(alloctr, (size_t)(num_rows/2), output_size);
 
     VT_LOG_INFO("Loading data into memory: %zu instances", num_rows);
-    ann_read_mnist_data(CACHE_FOLDER MNIST_TRAIN, x_train, y_train);
-    ann_read_mnist_data(CACHE_FOLDER MNIST_TEST, x_test, y_test);
+    VT_ENFORCE(prsm_dataset_read_csv(x_train, y_train, CACHE_FOLDER MNIST_TRAIN, ',', false, 0) == PRSM_STATUS_OPERATION_SUCCESS, "Failed to read %s", MNIST_TRAIN);
+    VT_ENFORCE(prsm_dataset_read_csv(x_test, y_test, CACHE_FOLDER MNIST_TEST, ',', false, 0) == PRSM_STATUS_OPERATION_SUCCESS, "Failed to read %s", MNIST_TEST);
 
     VT_LOG_INFO("Normalize the data...");
     prsm_tensor_apply_scale_add(x_train, 1.0/255.0, 0);
     prsm_tensor_apply_scale_add(x_test, 1.0/255.0, 0);
 
+    VT_LOG_INFO("Creating a dataloader...");
+    const size_t batch_size = 90;
+    prsm_dataloader_t *train_loader = prsm_dataloader_create(alloctr, x_train, y_train, batch_size, 3, true);
+
     VT_LOG_INFO("Initializing parameters...");
     const size_t layer_hidden_size = 100;
-    vt_vec_t *params = ann_model_init_params(num_rows, num_features, layer_hidden_size, output_size);
+    vt_vec_t *params = ann_model_init_params(num_features, layer_hidden_size, output_size);
+    prsm_autograd_t *tape = prsm_autograd_create(alloctr);
+    prsm_autograd_set_stash(tape, PRSM_AUTOGRAD_STASH_FP16);
 
     VT_LOG_INFO("Initializing model options...");
     const size_t epochs = 810;
     const prsm_float alpha = 0.09;
+    prsm_optim_t *optim = prsm_optim_create(alloctr, &(prsm_optim_params_t){ .type = PRSM_OPTIM_SGD, .lr = alpha, .clip = 1 });
 
     VT_LOG_INFO("\talpha         = %.2f", alpha);
     VT_LOG_INFO("\tactivation l2 = %s", VT_STRING_OF(prsm_activate_sigmoid));
-    VT_LOG_INFO("\tactivation l3 = %s", VT_STRING_OF(prsm_activate_ssoftmax));
-    VT_LOG_INFO("\tloss          = %s", VT_STRING_OF(prsm_loss_cce));
+    VT_LOG_INFO("\tactivation l3 = %s", VT_STRING_OF(prsm_autograd_softmax));
+    VT_LOG_INFO("\tloss          = %s", VT_STRING_OF(prsm_autograd_softmax_cce));
+    VT_LOG_INFO("\tstash         = %s", VT_STRING_OF(PRSM_AUTOGRAD_STASH_FP16));
     VT_LOG_INFO("\tepochs        = %zu", epochs);
+    VT_LOG_INFO("\tbatch size    = %zu", batch_size);
 
     VT_LOG_INFO("Start training...");
     VT_FOREACH(epoch, 0, epochs) {
-        /* -----------------------
-        * FORWARD
-        */
-        params = ann_model_forward(params, x_train);
-
-        /* -----------------------
-        * COST AND ACCURACY
-        */
+        prsm_float cost = 0, accuracy = 0;
+        prsm_tensor_t x_batch, y_batch;
+        while (prsm_dataloader_next(train_loader, &x_batch, &y_batch)) {
+            /* -----------------------
+            * FORWARD
+            */
+            size_t yhat = 0;
+            const size_t loss = ann_model_forward(tape, params, &x_batch, &y_batch, &yhat);
+
+            /* -----------------------
+            * COST AND ACCURACY
+            */
+            if (epoch % 10 == 0) {
+                cost += ann_cost(prsm_autograd_value(tape, yhat), &y_batch);
+                accuracy += ann_accuracy(prsm_autograd_value(tape, yhat), &y_batch, true);
+            }
+
+            /* -----------------------
+            * BACKWARD
+            */
+            prsm_autograd_backward(tape, loss);
+
+            /* -----------------------
+            * UPDATE
+            */
+            params = ann_model_update(tape, params, optim);
+        }
+
         if (epoch % 10 == 0) {
-            prsm_tensor_t *yhat = dict_find_val(params, "a2");
-            const prsm_float cost = ann_cost(yhat, y_train);
-            const prsm_float accuracy = ann_accuracy(yhat, y_train, true);
-            VT_LOG_INFO("\tEpoch %3zu | Error: %.4f | Accuracy: %.4f", epoch, cost, accuracy);
+            const size_t num_batches = prsm_dataloader_len(train_loader);
+            VT_LOG_INFO("\tEpoch %3zu | Error: %.4f | Accuracy: %.4f", epoch, cost/num_batches, accuracy/num_batches);
 
             if (!cost) {
                 break;
             }
         }
-
-        /* -----------------------
-        * BACKWARD
-        */
-        params = ann_model_backward(x_train, y_train, params);
-
-        /* -----------------------
-        * UPDATE
-        */
-        params = ann_model_update(params, alpha);
     }
+    prsm_dataloader_destroy(train_loader);
+    prsm_autograd_destroy(tape);
+    prsm_optim_destroy(optim);
 
     // VT_FOREACH(k, 0, 5) {
     //     // y (label) value
@@ -141,47 +159,7 @@ void ann_download_csv(const char *const url, const char *const filepath) {
     fp = NULL;
 }
 
-void ann_read_mnist_data(const char *const file, prsm_tensor_t *x, prsm_tensor_t *y) {
-    char buffer[2048];
-    size_t current_row = 0;
-    const size_t read_rows = prsm_tensor_shape(x)[0];
-    const size_t read_cols = prsm_tensor_shape(x)[1];
-    vt_plist_t *line_items = vt_plist_create(read_cols, alloctr);
-
-    /**
-     * READING TRAIN DATA
-     */
-    VT_LOG_INFO("Reading %s", file);
-    FILE *fp = fopen(file, "r"); 
-    {
-        while(current_row < read_rows && fgets(buffer, sizeof(buffer), fp)) {
-            // split
-            vt_str_t line = vt_str_create_static(buffer);
-
-            // ----------------
-            line_items = vt_str_split(line_items, &line, ",");
-            VT_FOREACH(i, 0, vt_plist_len(line_items)) {
-                // get item
-                vt_str_t *item = (vt_str_t*)vt_plist_get(line_items, i);
-                vt_str_strip(item);
-
-                // convert to prsm_float
-                const prsm_float value = vt_conv_str_to_f(vt_str_z(item));
-                
-                // save values
-                if (i == 0) prsm_tensor_set_val(y, vt_index_2d_to_1d(current_row, value, 10), 1);
-                else prsm_tensor_set_val(x, vt_index_2d_to_1d(current_row, i-1, read_cols), value);
-            }
-            // ----------------
-
-            // update
-            current_row++;
-        }
-    } 
-    fclose(fp);
-}
-
-vt_vec_t *ann_model_init_params(const size_t N, const size_t n_x, const size_t n_h, const size_t n_y) {
+vt_vec_t *ann_model_init_params(const size_t n_x, const size_t n_h, const size_t n_y) {
     VT_LOG_INFO("\tCreating weights and biases...");
     prsm_tensor_t *w1, *w2, *b1, *b2;
     w1 = prsm_tensor_create_mat(alloctr, n_x, n_h);
@@ -197,244 +175,69 @@ vt_vec_t *ann_model_init_params(const size_t N, const size_t n_x, const size_t n
     prsm_tensor_set_ones(b1);
     prsm_tensor_set_ones(b2);
 
-    VT_LOG_INFO("\tFinalizing...");
-    prsm_tensor_t *z1, *a1, *z2, *a2;
-    z1 = prsm_tensor_create_mat(alloctr, N, n_h);
-    a1 = prsm_tensor_create_mat(alloctr, N, n_h);
-    z2 = prsm_tensor_create_mat(alloctr, N, n_y);
-    a2 = prsm_tensor_create_mat(alloctr, N, n_y);
-
-    // add to dict
+    // add to dict; activations and gradients are owned by the autograd tape
     vt_vec_t *params = vt_vec_create(10, sizeof(dict_keyval_t), alloctr);
     dict_update_val(params, "w1", w1);
     dict_update_val(params, "b1", b1);
     dict_update_val(params, "w2", w2);
     dict_update_val(params, "b2", b2);
-    dict_update_val(params, "z1", z1);
-    dict_update_val(params, "a1", a1);
-    dict_update_val(params, "z2", z2);
-    dict_update_val(params, "a2", a2);
 
     return params;
 }
 
-vt_vec_t *ann_model_forward(vt_vec_t *params, prsm_tensor_t *x) {
-    // get params
-    prsm_tensor_t *w1, *w2, *b1, *b2, *z1, *a1, *z2, *a2;
-    w1 = dict_find_val(params, "w1");
-    b1 = dict_find_val(params, "b1");
-    w2 = dict_find_val(params, "w2");
-    b2 = dict_find_val(params, "b2");
-    z1 = dict_find_val(params, "z1");
-    a1 = dict_find_val(params, "a1");
-    z2 = dict_find_val(params, "z2");
-    a2 = dict_find_val(params, "a2");
+size_t ann_model_forward(prsm_autograd_t *tape, vt_vec_t *params, prsm_tensor_t *x, prsm_tensor_t *y, size_t *yhat) {
+    // replay the tape: buffers recorded for the previous batch are reused
+    prsm_autograd_reset(tape);
+
+    // parameters are recorded first, so their node ids are 0..3
+    const size_t w1 = prsm_autograd_leaf(tape, dict_find_val(params, "w1"), true);
+    const size_t b1 = prsm_autograd_leaf(tape, dict_find_val(params, "b1"), true);
+    const size_t w2 = prsm_autograd_leaf(tape, dict_find_val(params, "w2"), true);
+    const size_t b2 = prsm_autograd_leaf(tape, dict_find_val(params, "b2"), true);
+    const size_t x_id = prsm_autograd_leaf(tape, x, false);
+    const size_t y_id = prsm_autograd_leaf(tape, y, false);
 
     /**
      * LAYER 2
-     * 
+     *
      * note: layer 1 is the inputs itself
      */
 
-    // z1 = x * w1 + b1
-    z1 = prsm_tensor_dot(z1, x, w1);
-
-    // add bias
-    VT_FOREACH(i, 0, prsm_tensor_shape(z1)[0]) {
-        prsm_tensor_t tview = prsm_tensor_make_view_vec(z1, i);
-        prsm_tensor_add(&tview, &tview, b1);
-    }
-
-    // activate: a1 = relu(z1)
-    a1 = prsm_activate_sigmoid(a1, z1);
+    // a1 = sigmoid(x * w1 + b1): bias and activation are fused into the gemm
+    const size_t a1 = prsm_autograd_dense(tape, x_id, w1, b1, PRSM_ACTIVATION_SIGMOID);
 
     /**
      * LAYER 3
      */
 
     // z2 = a1 * w2 + b2
-    z2 = prsm_tensor_dot(z2, a1, w2);
+    const size_t z2 = prsm_autograd_dense(tape, a1, w2, b2, PRSM_ACTIVATION_LINEAR);
 
-    // add bias
-    VT_FOREACH(i, 0, prsm_tensor_shape(z2)[0]) {
-        prsm_tensor_t tview = prsm_tensor_make_view_vec(z2, i);
-        prsm_tensor_add(&tview, &tview, b2);
-    }
+    // loss = cce(softmax(z2), y)
+    const size_t loss = prsm_autograd_softmax_cce(tape, z2, y_id);
 
-    // activate: a2 = softmax(z2)
-    prsm_tensor_assign(a2, z2);
-    VT_FOREACH(i, 0, prsm_tensor_shape(a2)[0]) {
-        prsm_tensor_t tview = prsm_tensor_make_view_vec(a2, i);
-        prsm_activate_ssoftmax(&tview, &tview);
-    }
+    // a2 = softmax(z2): recorded after the loss, so backward does not visit it
+    *yhat = prsm_autograd_softmax(tape, z2);
 
-    return params;
+    return loss;
 }
 
-vt_vec_t *ann_model_backward(prsm_tensor_t *x, prsm_tensor_t *y, vt_vec_t *params) {
+vt_vec_t *ann_model_update(prsm_autograd_t *tape, vt_vec_t *params, prsm_optim_t *optim) {
     // get params
-    prsm_tensor_t *w1, *w2, *b1, *b2, *a1, *a2, *z1, *z2;
-    w1 = dict_find_val(params, "w1");
-    b1 = dict_find_val(params, "b1");
-    w2 = dict_find_val(params, "w2");
-    b2 = dict_find_val(params, "b2");
-    a1 = dict_find_val(params, "a1");
-    a2 = dict_find_val(params, "a2");
-    z1 = dict_find_val(params, "z1");
-    z2 = dict_find_val(params, "z2");
-
-    // number of observations
-    const prsm_float N = prsm_tensor_shape(x)[0];
-
-    /**
-     * LAYER 3
-     */
-    
-    // DC2 = dc/da2 | (N, 10)
-    prsm_tensor_t *DC2 = dict_find_val(params, "DC2");
-    if (!DC2) {
-        DC2 = prsm_tensor_dup(a2);
-        dict_update_val(params, "DC2", DC2);
-    } else { prsm_tensor_set_zeros(DC2); }
-    VT_FOREACH(i, 0, N) { // for each example
-        prsm_tensor_t y_view = prsm_tensor_make_view_vec(y, i);
-        prsm_tensor_t a2_view = prsm_tensor_make_view_vec(a2, i);
-        prsm_tensor_t DC_view = prsm_tensor_make_view_vec(DC2, i);
-        prsm_loss_cce_d(&DC_view, &a2_view, &y_view);
-        prsm_activate_softmax_d(&DC_view, &DC_view);
-    }
-    prsm_tensor_apply_clip(DC2, -1, 1);
-    
-    // DZ2_a1 = dz2/dw2 = a1 | (N, 100)
-    prsm_tensor_t *DZ2_a1 = a1;
-    
-    // DW2 = 1/N * DZ2_a1_T * DC2 | (100, 10)
-    prsm_tensor_t *DW2 = dict_find_val(params, "DW2");
-    if (!DW2) {
-        DW2 = prsm_tensor_dup(w2);
-        dict_update_val(params, "DW2", DW2);
-    } else { prsm_tensor_set_zeros(DW2); }
-
-    prsm_tensor_transpose(DZ2_a1);
-    {   
-        DW2 = prsm_tensor_dot(DW2, DZ2_a1, DC2);
-    }
-    prsm_tensor_transpose(DZ2_a1);
-
-    // clip
-    prsm_tensor_apply_clip(DW2, -1, 1);
-
-    // DB2 = DC2 * 1_T = sum(DC2, 1) => column-wise summation | (100, 1)
-    prsm_tensor_t *DB2 = dict_find_val(params, "DB2");
-    if (!DB2) {
-        DB2 = prsm_tensor_dup(b2);
-        dict_update_val(params, "DB2", DB2);
-    } else { prsm_tensor_set_zeros(DB2); }
-    DB2 = prsm_tensor_sum(DB2, DC2, 0); // we do the reverse since DC2 shape(N, 10) => 0 [DC_T shape(10, N) => 1]
-
-    // clip
-    prsm_tensor_apply_clip(DB2, -1, 1);
+    prsm_tensor_t *p[4];
+    p[0] = dict_find_val(params, "w1");
+    p[1] = dict_find_val(params, "b1");
+    p[2] = dict_find_val(params, "w2");
+    p[3] = dict_find_val(params, "b2");
 
     /**
-     * LAYER 2
+     * UPDATE: w_i = w_i - lr * clip(D) (gradients), all parameters in one pass
      */
-
-    // DZ2_w2 = dz2/da1 = w2 | (100, 10)
-    prsm_tensor_t *DZ2_w2 = w2;
-
-    // DA1 = da1/dz1 = relu'(z1) | (N, 100)
-    prsm_tensor_t *DA1 = dict_find_val(params, "DA1");
-    if (!DA1) {
-        DA1 = prsm_tensor_dup(z1);
-        dict_update_val(params, "DA1", DA1);
-    } else { prsm_tensor_set_zeros(DA1); }
-    VT_FOREACH(i, 0, N) { // for each example
-        prsm_tensor_t z1_view = prsm_tensor_make_view_vec(z1, i);
-        prsm_tensor_t DA1_view = prsm_tensor_make_view_vec(DA1, i);
-        prsm_activate_sigmoid_d(&DA1_view, &z1_view);
-    }
-    prsm_tensor_apply_clip(DA1, -1, 1);
-
-    // DZ1_x = dz1/dw1 = x | (N, 784)
-    prsm_tensor_t *DZ1_x = x;
-
-    // DC1 = (DC2 * DZ2_w2_T) el-wise * DA1 | (N, 100)
-    prsm_tensor_t *DC1 = dict_find_val(params, "DC1");
-    if (!DC1) {
-        DC1 = prsm_tensor_dup(a1);
-        dict_update_val(params, "DC1", DC1);
-    } else { prsm_tensor_set_zeros(DC1); }
-
-    prsm_tensor_transpose(DZ2_w2);
-    {
-        DC1 = prsm_tensor_dot(DC1, DC2, DZ2_w2);
-        DC1 = prsm_tensor_mul(DC1, DC1, DA1);
+    const prsm_tensor_t *D[4];
+    VT_FOREACH(i, 0, 4) {
+        D[i] = prsm_autograd_grad(tape, i);
     }
-    prsm_tensor_transpose(DZ2_w2);
-
-    // clip
-    prsm_tensor_apply_clip(DC1, -1, 1);
-
-    // DW1 = DC1 * DZ1_x_T | (784, 100)
-    prsm_tensor_t *DW1 = dict_find_val(params, "DW1");
-    if (!DW1) {
-        DW1 = prsm_tensor_dup(w1);
-        dict_update_val(params, "DW1", DW1);
-    } else { prsm_tensor_set_zeros(DW1); }
-
-    prsm_tensor_transpose(DZ1_x);
-    {
-        DW1 = prsm_tensor_dot(DW1, DZ1_x, DC1);
-    }
-    prsm_tensor_transpose(DZ1_x);
-
-    // clip
-    prsm_tensor_apply_clip(DW1, -1, 1);
-
-    // DB1 = DC1 * 1_T = sum(DC1, 1) => column-wise summation | (100, 1)
-    prsm_tensor_t *DB1 = dict_find_val(params, "DB1");
-    if (!DB1) {
-        DB1 = prsm_tensor_dup(b1);
-        dict_update_val(params, "DB1", DB1);
-    } else { prsm_tensor_set_zeros(DB1); }
-    DB1 = prsm_tensor_sum(DB1, DC1, 0); // we do the reverse since DC1 shape(N, 100) => 0 [DC_T shape(100, N) => 1]
-
-    // clip
-    prsm_tensor_apply_clip(DB1, -1, 1);
-
-    return params;
-}
-
-vt_vec_t *ann_model_update(vt_vec_t *params, const prsm_float learning_rate) {
-    // get params
-    prsm_tensor_t *w1, *w2, *b1, *b2;
-    w1 = dict_find_val(params, "w1");
-    b1 = dict_find_val(params, "b1");
-    w2 = dict_find_val(params, "w2");
-    b2 = dict_find_val(params, "b2");
-
-    // get gradients
-    prsm_tensor_t *DW1, *DW2, *DB1, *DB2;
-    DW1 = dict_find_val(params, "DW1");
-    DB1 = dict_find_val(params, "DB1");
-    DW2 = dict_find_val(params, "DW2");
-    DB2 = dict_find_val(params, "DB2");
-
-    /**
-     * UPDATE: w_i = w_i - lr  * D (gradients)
-     */
-
-    // apply: lr * D
-    prsm_tensor_apply_scale_add(DW1, learning_rate, 0);
-    prsm_tensor_apply_scale_add(DB1, learning_rate, 0);
-    prsm_tensor_apply_scale_add(DW2, learning_rate, 0);
-    prsm_tensor_apply_scale_add(DB2, learning_rate, 0);
-
-    // w_i -= lr_D
-    prsm_tensor_sub(w1, w1, DW1);
-    prsm_tensor_sub(b1, b1, DB1);
-    prsm_tensor_sub(w2, w2, DW2);
-    prsm_tensor_sub(b2, b2, DB2);
+    prsm_optim_step(optim, p, D, 4);
 
     return params;
 }
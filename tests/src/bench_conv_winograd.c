@@ -0,0 +1,126 @@
+#include "main.h"
+#include <time.h>
+
+#define BENCH_CONV_REPEATS 5
+
+double bench_conv_now_ms(void);
+double bench_conv_im2col(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params);
+double bench_conv_winograd(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, const size_t m, prsm_tensor_t *const workspace);
+double bench_conv_forward_ex(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace);
+double bench_conv_layer(const prsm_tensor_t *const x, const prsm_conv2d_params_t *const params);
+
+void run_bench_conv_winograd(void) {
+    // 3x3 stride 1 layers of a typical backbone: (channels, spatial size)
+    const size_t layers[][2] = {{32, 64}, {64, 32}, {128, 16}, {256, 8}};
+    const size_t batch = 4;
+
+    printf(
+        "%-22s %12s %12s %12s %10s %10s %16s %10s\n",
+        "layer (N, C, H, W)", "im2col, ms", "F(2x2), ms", "F(4x4), ms", "speedup", "selected", "forward_ex, ms", "layer, ms"
+    );
+    VT_FOREACH(l, 0, sizeof(layers) / sizeof(layers[0])) {
+        const size_t c = layers[l][0], hw = layers[l][1];
+        const prsm_conv2d_params_t params = {
+            .in_channels = c, .out_channels = c, .groups = 1,
+            .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1}
+        };
+
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, batch, c, hw, hw);
+        prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, c, c, 3, 3);
+        prsm_tensor_t *out = prsm_tensor_create(alloctr, 4, batch, c, hw, hw);
+        prsm_tensor_t *workspace = prsm_tensor_create_vec(alloctr, prsm_conv2d_workspace_size(&params, hw, hw));
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_rand_uniform(w, -1, 1);
+
+        // time each path
+        const double t_im2col = bench_conv_im2col(out, x, w, &params);
+        const double t_f2 = bench_conv_winograd(out, x, w, &params, 2, workspace);
+        const double t_f4 = bench_conv_winograd(out, x, w, &params, 4, workspace);
+        const double t_best = (t_f2 < t_f4) ? t_f2 : t_f4;
+
+        // the selected algorithm as used by models: forward_ex transforms the weights on every call,
+        // the layer only after they change
+        const double t_forward_ex = bench_conv_forward_ex(out, x, w, &params, workspace);
+        const double t_layer = bench_conv_layer(x, &params);
+
+        char name[32];
+        snprintf(name, sizeof(name), "(%zu, %zu, %zu, %zu)", batch, c, hw, hw);
+        const enum PrismaConvAlgorithm algorithm = prsm_conv2d_select_algorithm(&params, hw, hw);
+        printf(
+            "%-22s %12.2f %12.2f %12.2f %9.2fx %10s %16.2f %10.2f\n", name, t_im2col, t_f2, t_f4, t_im2col / t_best,
+            (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_4) ? "F(4x4)" : (algorithm == PRSM_CONV_ALGORITHM_WINOGRAD_2) ? "F(2x2)" : "other",
+            t_forward_ex, t_layer
+        );
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(w);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(workspace);
+    }
+}
+
+double bench_conv_now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+double bench_conv_im2col(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params) {
+    const size_t n = x->shape[0], c = x->shape[1], oc = w->shape[0];
+    const size_t ohw = out->shape[2] * out->shape[3];
+    prsm_tensor_t *col = prsm_tensor_create_mat(alloctr, c * 9, ohw);
+
+    // out_n = w * im2col(x_n)
+    size_t img_shape[] = {c, x->shape[2], x->shape[3]}, w_shape[] = {oc, c * 9}, out_shape[] = {oc, ohw};
+    const double start = bench_conv_now_ms();
+    VT_FOREACH(r, 0, BENCH_CONV_REPEATS) {
+        VT_FOREACH(i, 0, n) {
+            prsm_tensor_t img = { .ndim = 3, .shape = img_shape, .data = x->data + i * c * img_shape[1] * img_shape[2], .is_view = true };
+            prsm_tensor_t w_mat = { .ndim = 2, .shape = w_shape, .data = w->data, .is_view = true };
+            prsm_tensor_t out_mat = { .ndim = 2, .shape = out_shape, .data = out->data + i * oc * ohw, .is_view = true };
+            prsm_conv2d_im2col(col, &img, params);
+            prsm_tensor_gemm(&out_mat, &w_mat, col, false, false, 1, 0);
+        }
+    }
+    const double elapsed = (bench_conv_now_ms() - start) / BENCH_CONV_REPEATS;
+
+    prsm_tensor_destroy(col);
+    return elapsed;
+}
+
+double bench_conv_winograd(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, const size_t m, prsm_tensor_t *const workspace) {
+    // weights are transformed once, as in inference
+    prsm_tensor_t *u = prsm_conv2d_winograd_weights(NULL, w, m);
+
+    const double start = bench_conv_now_ms();
+    VT_FOREACH(r, 0, BENCH_CONV_REPEATS) {
+        prsm_conv2d_winograd(out, x, u, NULL, PRSM_ACTIVATION_LINEAR, params, m, workspace);
+    }
+    const double elapsed = (bench_conv_now_ms() - start) / BENCH_CONV_REPEATS;
+
+    prsm_tensor_destroy(u);
+    return elapsed;
+}
+
+double bench_conv_forward_ex(prsm_tensor_t *out, const prsm_tensor_t *const x, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const params, prsm_tensor_t *const workspace) {
+    const double start = bench_conv_now_ms();
+    VT_FOREACH(r, 0, BENCH_CONV_REPEATS) {
+        prsm_conv2d_forward_ex(out, x, w, NULL, PRSM_ACTIVATION_LINEAR, params, workspace, false);
+    }
+    return (bench_conv_now_ms() - start) / BENCH_CONV_REPEATS;
+}
+
+double bench_conv_layer(const prsm_tensor_t *const x, const prsm_conv2d_params_t *const params) {
+    prsm_layer_conv2d_t *layer = prsm_layer_conv2d_create(alloctr, params, PRSM_ACTIVATION_LINEAR);
+
+    // the first call sizes the buffers and transforms the weights
+    prsm_layer_conv2d_forward(layer, x);
+    const double start = bench_conv_now_ms();
+    VT_FOREACH(r, 0, BENCH_CONV_REPEATS) {
+        prsm_layer_conv2d_forward(layer, x);
+    }
+    const double elapsed = (bench_conv_now_ms() - start) / BENCH_CONV_REPEATS;
+
+    prsm_layer_conv2d_destroy(layer);
+    return elapsed;
+}
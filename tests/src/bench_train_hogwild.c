@@ -0,0 +1,89 @@
+#include "main.h"
+#include <time.h>
+
+#define BENCH_TRAIN_EPOCHS 3
+
+double bench_train_now_ms(void);
+size_t bench_train_model(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const y, void *const ctx);
+
+void run_bench_train_hogwild(void) {
+    // sparse linear regression: few non-zero features per row
+    const size_t rows = 16384, features = 4096, nnz = 16;
+    const size_t sync_batch = 256, hogwild_batch = 16;
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, rows, features);
+    prsm_tensor_t *y = prsm_tensor_create_mat(alloctr, rows, 1);
+    prsm_tensor_t *w_true = prsm_tensor_create_mat(alloctr, features, 1);
+    prsm_tensor_t *w = prsm_tensor_create_mat(alloctr, features, 1);
+    prsm_tensor_rand_uniform(w_true, -1, 1);
+    prsm_tensor_set_zeros(x);
+    VT_FOREACH(r, 0, rows) {
+        VT_FOREACH(k, 0, nnz) {
+            x->data[r * features + (size_t)rand() % features] = 1;
+        }
+    }
+    prsm_tensor_gemm(y, x, w_true, false, false, 1, 0);
+
+    printf("%-8s %16s %10s %16s %10s %12s %12s\n", "threads", "sync, rows/s", "sync loss", "hogwild, rows/s", "loss", "staleness", "max stale");
+    const size_t threads[] = {1, 2, 4, 8};
+    VT_FOREACH(t, 0, sizeof(threads) / sizeof(threads[0])) {
+        prsm_parallel_set_num_threads(threads[t]);
+        const prsm_optim_params_t sgd = { .type = PRSM_OPTIM_SGD, .lr = 0.05 };
+
+        // synchronous: minibatches sharded across threads, all-reduce, one update per minibatch
+        prsm_tensor_set_zeros(w);
+        prsm_train_t *train = prsm_train_create(NULL, &w, 1, threads[t], bench_train_model, NULL);
+        prsm_optim_t *optim = prsm_optim_create(NULL, &sgd);
+        prsm_float sync_loss = 0;
+        double start = bench_train_now_ms();
+        VT_FOREACH(epoch, 0, BENCH_TRAIN_EPOCHS) {
+            sync_loss = 0;
+            for (size_t r = 0; r < rows; r += sync_batch) {
+                size_t x_shape[] = {sync_batch, features}, y_shape[] = {sync_batch, 1};
+                const prsm_tensor_t xb = { .ndim = 2, .shape = x_shape, .data = x->data + r * features, .is_view = true };
+                const prsm_tensor_t yb = { .ndim = 2, .shape = y_shape, .data = y->data + r, .is_view = true };
+                sync_loss += prsm_train_step(train, &xb, &yb, optim) * sync_batch / rows;
+            }
+        }
+        const double sync_ms = bench_train_now_ms() - start;
+        prsm_optim_destroy(optim);
+        prsm_train_destroy(train);
+
+        // hogwild: one worker per thread, lock-free updates after every small minibatch
+        prsm_tensor_set_zeros(w);
+        train = prsm_train_create(NULL, &w, 1, threads[t], bench_train_model, NULL);
+        prsm_train_hogwild_stats_t stats = {0};
+        start = bench_train_now_ms();
+        VT_FOREACH(epoch, 0, BENCH_TRAIN_EPOCHS) {
+            stats = prsm_train_hogwild(train, x, y, hogwild_batch, &sgd);
+        }
+        const double hogwild_ms = bench_train_now_ms() - start;
+        prsm_train_destroy(train);
+
+        printf(
+            "%-8zu %16.0f %10.4f %16.0f %10.4f %12.2f %12zu\n", threads[t],
+            rows * BENCH_TRAIN_EPOCHS / sync_ms * 1e3, sync_loss,
+            rows * BENCH_TRAIN_EPOCHS / hogwild_ms * 1e3, stats.loss, stats.mean_staleness, stats.max_staleness
+        );
+    }
+    prsm_parallel_set_num_threads(0);
+
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(y);
+    prsm_tensor_destroy(w_true);
+    prsm_tensor_destroy(w);
+}
+
+double bench_train_now_ms(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+size_t bench_train_model(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const y, void *const ctx) {
+    (void)ctx;
+
+    // y = x * w: the parameter is leaf 0
+    const size_t x_id = prsm_autograd_leaf(tape, x, false);
+    const size_t y_id = prsm_autograd_leaf(tape, y, false);
+    return prsm_autograd_mse(tape, prsm_autograd_matmul(tape, x_id, 0), y_id);
+}
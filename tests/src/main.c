@@ -1,16 +1,34 @@
 #include "main.h"
 #include "perceptron.c"
 #include "ann_mnist_digit_recognition.c"
+#include "bench_conv_winograd.c"
+#include "bench_train_hogwild.c"
+#if !defined(_WIN32) && !defined(_WIN64)
+    #include <unistd.h>
+    #include <sys/wait.h>
+#endif
 
 static int test_num = 0;
 #define TEST(func) { printf("(%d) ---> TESTING: %s\n", test_num, #func); func(); test_num++; }
 
 void test_custom(void);
 void test_tensor(void);
+void test_sparse(void);
+void test_storage(void);
+void test_parallel(void);
+void test_dataset(void);
+void test_dataloader(void);
 void test_math(void);
 void test_activation(void);
 void test_loss(void);
 void test_layers(void);
+void test_autograd(void);
+void test_conv(void);
+void test_pool(void);
+void test_optim(void);
+void test_train(void);
+void test_comm(void);
+void test_pipeline(void);
 
 int main(void) {
     vt_version_t 
@@ -24,10 +42,22 @@ int main(void) {
 
         TEST(test_custom);
         // TEST(test_tensor);
+        // TEST(test_sparse);
+        // TEST(test_storage);
+        // TEST(test_parallel);
+        // TEST(test_dataset);
+        // TEST(test_dataloader);
         // TEST(test_math);
         // TEST(test_activation);
         // TEST(test_loss);
         // TEST(test_layers);
+        // TEST(test_autograd);
+        // TEST(test_conv);
+        // TEST(test_pool);
+        // TEST(test_optim);
+        // TEST(test_train);
+        // TEST(test_comm);
+        // TEST(test_pipeline);
     }
     vt_mallocator_print_stats(alloctr->stats);
     vt_mallocator_destroy(alloctr);
@@ -39,6 +69,8 @@ int main(void) {
 void test_custom(void) {
     // run_perceptron();
     run_ann_mnist_digit_recognition();
+    // run_bench_conv_winograd();
+    // run_bench_train_hogwild();
 }
 
 void test_tensor(void) {
@@ -244,6 +276,482 @@ void test_tensor(void) {
         0, 0,  0,  0, 9, 0, 
         0, 0,  0,  0, 0, 3
     }, prsm_tensor_size(nd3m_sum)));
+
+    // gather rows
+    prsm_tensor_t *rows = prsm_tensor_create_mat(alloctr, 4, 3);
+    prsm_tensor_assign_array(rows, (prsm_float[]) {
+        0, 1, 2,
+        3, 4, 5,
+        6, 7, 8,
+        9, 10, 11
+    }, prsm_tensor_size(rows));
+    const size_t row_idx[] = {3, 0, 3};
+    prsm_tensor_t *rows_gathered = prsm_tensor_gather(NULL, rows, row_idx, 3, 0);
+    assert(prsm_tensor_shape(rows_gathered)[0] == 3 && prsm_tensor_shape(rows_gathered)[1] == 3);
+    assert(prsm_tensor_equals_array(rows_gathered, (prsm_float[]){9, 10, 11, 0, 1, 2, 9, 10, 11}, 9));
+    prsm_tensor_gather_add(rows_gathered, rows, row_idx, 3, 0);
+    assert(prsm_tensor_equals_array(rows_gathered, (prsm_float[]){18, 20, 22, 0, 2, 4, 18, 20, 22}, 9));
+
+    // gather columns
+    const size_t col_idx[] = {2, 0};
+    prsm_tensor_t *cols_gathered = prsm_tensor_gather(NULL, rows, col_idx, 2, 1);
+    assert(prsm_tensor_equals_array(cols_gathered, (prsm_float[]){2, 0, 5, 3, 8, 6, 11, 9}, 8));
+
+    // scatter rows: repeated indices accumulate
+    prsm_tensor_set_zeros(rows);
+    prsm_tensor_scatter_add(rows, rows_gathered, row_idx, 3, 0);
+    assert(prsm_tensor_equals_array(rows, (prsm_float[]){0, 2, 4, 0, 0, 0, 0, 0, 0, 36, 40, 44}, 12));
+    prsm_tensor_scatter(rows, cols_gathered, col_idx, 2, 1);
+    assert(prsm_tensor_equals_array(rows, (prsm_float[]){0, 2, 2, 3, 0, 5, 6, 0, 8, 9, 40, 11}, 12));
+
+    // large gather/scatter: parallel path, also for axis 0 with fewer columns than a scatter block
+    prsm_parallel_set_num_threads(4);
+    prsm_tensor_t *big = prsm_tensor_create_mat(alloctr, 5000, 64);
+    prsm_tensor_rand(big);
+    size_t *perm = VT_CALLOC(5000 * sizeof(size_t));
+    VT_FOREACH(i, 0, 5000) {
+        perm[i] = i;
+    }
+    uint64_t rng_state = 42;
+    prsm_tensor_rand_permutation(perm, 5000, &rng_state);
+    prsm_tensor_t *big_shuffled = prsm_tensor_gather(NULL, big, perm, 5000, 0);
+    prsm_tensor_t *big_restored = prsm_tensor_create_mat(alloctr, 5000, 64);
+    prsm_tensor_scatter(big_restored, big_shuffled, perm, 5000, 0);
+    assert(prsm_parallel_get_num_blocks() == 4);
+    assert(prsm_tensor_equals(big_restored, big));
+
+    // repeated indices accumulate in index order on every thread count
+    VT_FOREACH(i, 0, 5000) {
+        perm[i] = (i * 7) % 1000;
+    }
+    prsm_tensor_t *big_sum = prsm_tensor_create_mat(alloctr, 1000, 64);
+    prsm_tensor_t *big_sum_ref = prsm_tensor_create_mat(alloctr, 1000, 64);
+    prsm_tensor_set_zeros(big_sum);
+    prsm_tensor_set_zeros(big_sum_ref);
+    prsm_tensor_scatter_add(big_sum, big, perm, 5000, 0);
+    assert(prsm_parallel_get_num_blocks() == 4);
+    prsm_parallel_set_num_threads(1);
+    prsm_tensor_scatter_add(big_sum_ref, big, perm, 5000, 0);
+    assert(prsm_parallel_get_num_blocks() == 1);
+    assert(prsm_tensor_equals(big_sum, big_sum_ref));
+    prsm_parallel_set_num_threads(0);
+
+    prsm_tensor_destroy(rows);
+    prsm_tensor_destroy(rows_gathered);
+    prsm_tensor_destroy(cols_gathered);
+    prsm_tensor_destroy(big);
+    prsm_tensor_destroy(big_shuffled);
+    prsm_tensor_destroy(big_restored);
+    prsm_tensor_destroy(big_sum);
+    prsm_tensor_destroy(big_sum_ref);
+    VT_FREE(perm);
+
+    /*
+     * GEMM
+     */
+
+    // odd shapes exercise full and edge register tiles
+    const size_t gm = 70, gk = 13, gn = 19;
+    prsm_tensor_t *ga = prsm_tensor_create_mat(alloctr, gm, gk);
+    prsm_tensor_t *gb = prsm_tensor_create_mat(alloctr, gk, gn);
+    prsm_tensor_t *ga_t = prsm_tensor_create_mat(alloctr, gk, gm);
+    prsm_tensor_t *gb_t = prsm_tensor_create_mat(alloctr, gn, gk);
+    prsm_tensor_t *gref = prsm_tensor_create_mat(alloctr, gm, gn);
+    prsm_tensor_rand_uniform(ga, -1, 1);
+    prsm_tensor_rand_uniform(gb, -1, 1);
+    VT_FOREACH(i, 0, gm) VT_FOREACH(p, 0, gk) ga_t->data[p * gm + i] = ga->data[i * gk + p];
+    VT_FOREACH(p, 0, gk) VT_FOREACH(j, 0, gn) gb_t->data[j * gk + p] = gb->data[p * gn + j];
+    VT_FOREACH(i, 0, gm) VT_FOREACH(j, 0, gn) {
+        prsm_float acc = 0;
+        VT_FOREACH(p, 0, gk) acc += ga->data[i * gk + p] * gb->data[p * gn + j];
+        gref->data[i * gn + j] = acc;
+    }
+
+    prsm_parallel_set_num_threads(4);
+    VT_FOREACH(mode, 0, 4) {
+        const bool trans_lhs = mode & 1, trans_rhs = mode & 2;
+        prsm_tensor_t *gc = prsm_tensor_gemm(NULL, trans_lhs ? ga_t : ga, trans_rhs ? gb_t : gb, trans_lhs, trans_rhs, 1, 0);
+        assert(prsm_tensor_equals_approx(gc, gref, 1e-5));
+        prsm_tensor_destroy(gc);
+    }
+
+    // epilogue: out = relu(scale * (2 * a * b + out) + bias + residual)
+    prsm_tensor_t *gscale = prsm_tensor_create_vec(alloctr, gn);
+    prsm_tensor_t *gbias = prsm_tensor_create_vec(alloctr, gn);
+    prsm_tensor_t *gres = prsm_tensor_create_mat(alloctr, gm, gn);
+    prsm_tensor_t *gout = prsm_tensor_create_mat(alloctr, gm, gn);
+    prsm_tensor_rand_uniform(gscale, -1, 1);
+    prsm_tensor_rand_uniform(gbias, -1, 1);
+    prsm_tensor_rand_uniform(gres, -1, 1);
+    prsm_tensor_rand_uniform(gout, -1, 1);
+    VT_FOREACH(i, 0, gm) VT_FOREACH(j, 0, gn) {
+        const size_t ij = i * gn + j;
+        gref->data[ij] = prsm_math_relu(gscale->data[j] * (2 * gref->data[ij] + gout->data[ij]) + gbias->data[j] + gres->data[ij]);
+    }
+    const struct PrismaTensorEpilogue ep = { .scale = gscale, .bias = gbias, .residual = gres, .func = prsm_math_relu };
+    prsm_tensor_gemm_ex(gout, ga, gb_t, false, true, 2, 1, &ep);
+    assert(prsm_tensor_equals_approx(gout, gref, 1e-5));
+    prsm_parallel_set_num_threads(0);
+
+    prsm_tensor_destroy(ga);
+    prsm_tensor_destroy(gb);
+    prsm_tensor_destroy(ga_t);
+    prsm_tensor_destroy(gb_t);
+    prsm_tensor_destroy(gref);
+    prsm_tensor_destroy(gscale);
+    prsm_tensor_destroy(gbias);
+    prsm_tensor_destroy(gres);
+    prsm_tensor_destroy(gout);
+}
+
+void test_sparse(void) {
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, 3, 4);
+    prsm_tensor_assign_array(x, (prsm_float[]) {
+        0, 2, 0, 0.01,
+        1, 0, 0, 3,
+        0, 0, 0, 0
+    }, prsm_tensor_size(x));
+
+    prsm_tensor_t *w = prsm_tensor_create_mat(alloctr, 4, 2);
+    prsm_tensor_assign_array(w, (prsm_float[]) {
+        1, 2,
+        3, 4,
+        5, 6,
+        7, 8
+    }, prsm_tensor_size(w));
+
+    // expected output (with 0.01 dropped by the threshold)
+    prsm_tensor_t *expected = prsm_tensor_create_mat(alloctr, 3, 2);
+    prsm_tensor_assign_array(expected, (prsm_float[]) {
+        6, 8,
+        22, 26,
+        0, 0
+    }, prsm_tensor_size(expected));
+
+    // csr
+    prsm_sparse_t *csr = prsm_sparse_from_dense(NULL, x, PRSM_SPARSE_FORMAT_CSR, 0.1);
+    assert(prsm_sparse_nnz(csr) == 3);
+    assert(prsm_sparse_density(csr) == (prsm_float)0.25);
+
+    prsm_tensor_t *out = prsm_sparse_spmm(NULL, csr, w);
+    assert(prsm_tensor_equals(out, expected));
+
+    // csc
+    prsm_sparse_t *csc = prsm_sparse_from_dense(NULL, x, PRSM_SPARSE_FORMAT_CSC, 0.1);
+    assert(prsm_sparse_nnz(csc) == 3);
+
+    out = prsm_sparse_spmm(out, csc, w);
+    assert(prsm_tensor_equals(out, expected));
+
+    // round trip
+    prsm_tensor_t *dense = prsm_sparse_to_dense(NULL, csc);
+    prsm_tensor_set_val(x, 3, 0);
+    assert(prsm_tensor_equals(dense, x));
+
+    // spmv
+    prsm_tensor_t *v = prsm_tensor_create_vec(alloctr, 4);
+    prsm_tensor_assign_array(v, (prsm_float[]) {1, 1, 1, 1}, prsm_tensor_size(v));
+    prsm_tensor_t *mv = prsm_sparse_spmv(NULL, csr, v);
+    assert(prsm_tensor_equals_array(mv, (prsm_float[]){2, 4, 0}, prsm_tensor_size(mv)));
+    mv = prsm_sparse_spmv(mv, csc, v);
+    assert(prsm_tensor_equals_array(mv, (prsm_float[]){2, 4, 0}, prsm_tensor_size(mv)));
+
+    // reuse buffers
+    csr = prsm_sparse_from_dense(csr, x, PRSM_SPARSE_FORMAT_CSC, 0);
+    assert(prsm_sparse_nnz(csr) == 3);
+
+    prsm_sparse_destroy(csr);
+    prsm_sparse_destroy(csc);
+}
+
+void test_storage(void) {
+    const char *const filename = "test_storage.prsm";
+
+    prsm_tensor_t *w = prsm_tensor_create_mat(alloctr, 3, 5);
+    prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, 5);
+    prsm_tensor_rand(w);
+    prsm_tensor_rand(b);
+
+    // save
+    const enum PrismaStatus status = prsm_storage_save(filename, 2, (const char*[]){"w", "b"}, (const prsm_tensor_t*[]){w, b});
+    assert(status == PRSM_STATUS_OPERATION_SUCCESS);
+
+    // load
+    prsm_storage_t *st = prsm_storage_open(alloctr, filename);
+    assert(st != NULL);
+    assert(prsm_storage_len(st) == 2);
+    assert(vt_str_equals_z(prsm_storage_name(st, 1), "b"));
+
+    // views point into the mapping
+    const prsm_tensor_t w_view = prsm_storage_get(st, "w");
+    const prsm_tensor_t b_view = prsm_storage_get_at(st, 1);
+    assert(prsm_tensor_is_view(&w_view));
+    assert(((uintptr_t)prsm_tensor_data(&w_view)) % PRSM_STORAGE_ALIGNMENT == 0);
+    assert(prsm_tensor_equals(&w_view, w));
+    assert(prsm_tensor_equals(&b_view, b));
+
+    // missing tensor
+    const prsm_tensor_t missing = prsm_storage_get(st, "missing");
+    assert(prsm_tensor_is_null(&missing));
+
+    prsm_storage_close(st);
+    vt_path_remove(filename);
+}
+
+void test_parallel_sum(void *const ctx, const size_t from, const size_t to, const size_t tid) {
+    size_t *partial = ctx;
+    VT_FOREACH(i, from, to) {
+        partial[tid] += i;
+    }
+}
+
+void test_parallel_other(void *const arg) {
+    VT_FOREACH(r, 0, 20) {
+        prsm_parallel_for(100000, 1000, test_parallel_sum, arg);
+    }
+}
+
+void test_parallel(void) {
+    const size_t n = 100000;
+    size_t partial[256] = {0};
+
+    // all threads
+    prsm_parallel_for(n, 1000, test_parallel_sum, partial);
+    size_t sum = 0;
+    VT_FOREACH(i, 0, 256) {
+        sum += partial[i];
+    }
+    assert(sum == n * (n - 1) / 2);
+
+    // small range runs on the calling thread
+    memset(partial, 0, sizeof(partial));
+    prsm_parallel_for(10, 1000, test_parallel_sum, partial);
+    assert(partial[0] == 45);
+
+    // custom number of threads
+    prsm_parallel_set_num_threads(3);
+    assert(prsm_parallel_get_num_threads() == 3);
+
+    // workers are reused across loops, the pool grows and shrinks with the number of blocks
+    const size_t num_threads[] = {3, 8, 2, 5};
+    VT_FOREACH(r, 0, 40) {
+        prsm_parallel_set_num_threads(num_threads[r % 4]);
+        memset(partial, 0, sizeof(partial));
+        prsm_parallel_for(n, 1000, test_parallel_sum, partial);
+        assert(prsm_parallel_get_num_blocks() == num_threads[r % 4]);
+        sum = 0;
+        VT_FOREACH(i, 0, 256) {
+            sum += partial[i];
+        }
+        assert(sum == n * (n - 1) / 2);
+    }
+
+    // loops started by two threads at once
+    prsm_parallel_set_num_threads(4);
+    size_t partial_other[256] = {0};
+    prsm_thread_t other;
+    assert(prsm_thread_create(&other, test_parallel_other, partial_other));
+    memset(partial, 0, sizeof(partial));
+    VT_FOREACH(r, 0, 20) {
+        prsm_parallel_for(n, 1000, test_parallel_sum, partial);
+    }
+    prsm_thread_join(&other);
+    size_t sum_other = 0;
+    sum = 0;
+    VT_FOREACH(i, 0, 256) {
+        sum += partial[i];
+        sum_other += partial_other[i];
+    }
+    assert(sum == 20 * (n * (n - 1) / 2) && sum_other == sum);
+
+    prsm_parallel_set_num_threads(0);
+    assert(prsm_parallel_get_num_threads() >= 1);
+}
+
+void test_dataset(void) {
+    const char *const filename = "test_dataset.csv";
+
+    // small file: header, one-hot labels in the middle column, various number formats
+    FILE *fp = fopen(filename, "w");
+    fprintf(fp, "a,label,b\n");
+    fprintf(fp, "1.5,2,-3\r\n");
+    fprintf(fp, "\n");
+    fprintf(fp, " 12345678.25 , 0 ,1e-2\n");
+    fprintf(fp, "-0.125,1,+4.5E3");
+    fclose(fp);
+
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, 3, 2);
+    prsm_tensor_t *y = prsm_tensor_create_mat(alloctr, 3, 3);
+    assert(prsm_dataset_read_csv(x, y, filename, ',', true, 1) == PRSM_STATUS_OPERATION_SUCCESS);
+
+    const prsm_float x_expected[] = {1.5, -3, 12345678.25, 0.01, -0.125, 4500};
+    const prsm_float y_expected[] = {0, 0, 1, 1, 0, 0, 0, 1, 0};
+    assert(prsm_tensor_equals_array(x, x_expected, 6));
+    assert(prsm_tensor_equals_array(y, y_expected, 9));
+
+    // raw labels
+    prsm_tensor_t *y_raw = prsm_tensor_create_mat(alloctr, 3, 1);
+    assert(prsm_dataset_read_csv(x, y_raw, filename, ',', true, 1) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(y_raw->data[0] == 2 && y_raw->data[1] == 0 && y_raw->data[2] == 1);
+
+    // not enough rows
+    prsm_tensor_t *x_big = prsm_tensor_create_mat(alloctr, 4, 2);
+    prsm_tensor_t *y_big = prsm_tensor_create_mat(alloctr, 4, 3);
+    assert(prsm_dataset_read_csv(x_big, y_big, filename, ',', true, 1) == PRSM_STATUS_ERROR_INVALID_FORMAT);
+
+    // label out of range
+    prsm_tensor_t *y_small = prsm_tensor_create_mat(alloctr, 3, 2);
+    assert(prsm_dataset_read_csv(x, y_small, filename, ',', true, 1) == PRSM_STATUS_ERROR_INVALID_FORMAT);
+
+    // missing file
+    assert(prsm_dataset_read_csv(x, y, "missing.csv", ',', true, 1) == PRSM_STATUS_ERROR_IO);
+
+    // leading zeros are not significant digits: the digits after them are not dropped
+    fp = fopen(filename, "w");
+    fprintf(fp, "00000001.5,000000016777217.00000001\n");
+    fclose(fp);
+    prsm_tensor_t *x_zeros = prsm_tensor_create_mat(alloctr, 1, 2);
+    assert(prsm_dataset_read_csv(x_zeros, NULL, filename, ',', false, 0) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(x_zeros->data[0] == 1.5f);
+    assert(x_zeros->data[1] == 16777218.0f);
+
+    // large file: parsed in multiple chunks
+    prsm_parallel_set_num_threads(4);
+    const size_t rows = 40000;
+    fp = fopen(filename, "w");
+    VT_FOREACH(i, 0, rows) {
+        fprintf(fp, "%zu,%zu,%zu.5\n", i % 10, i, i);
+    }
+    fclose(fp);
+
+    prsm_tensor_t *x_large = prsm_tensor_create_mat(alloctr, rows, 2);
+    prsm_tensor_t *y_large = prsm_tensor_create_mat(alloctr, rows, 10);
+    assert(prsm_dataset_read_csv(x_large, y_large, filename, ',', false, 0) == PRSM_STATUS_OPERATION_SUCCESS);
+    VT_FOREACH(i, 0, rows) {
+        assert(x_large->data[i * 2] == (prsm_float)i);
+        assert(x_large->data[i * 2 + 1] == (prsm_float)i + 0.5f);
+        assert(y_large->data[i * 10 + i % 10] == 1);
+    }
+    prsm_parallel_set_num_threads(0);
+
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(y);
+    prsm_tensor_destroy(y_raw);
+    prsm_tensor_destroy(x_big);
+    prsm_tensor_destroy(y_big);
+    prsm_tensor_destroy(y_small);
+    prsm_tensor_destroy(x_zeros);
+    prsm_tensor_destroy(x_large);
+    prsm_tensor_destroy(y_large);
+    vt_path_remove(filename);
+
+    // IDX: 3 images of 2x2 pixels and 3 labels
+    const char *const images_file = "test_dataset_images.idx";
+    const char *const labels_file = "test_dataset_labels.idx";
+    const uint8_t images[] = {0, 0, 0x08, 3, 0, 0, 0, 3, 0, 0, 0, 2, 0, 0, 0, 2, 0, 255, 51, 102, 1, 2, 3, 4, 5, 6, 7, 8};
+    const uint8_t labels[] = {0, 0, 0x08, 1, 0, 0, 0, 3, 2, 0, 1};
+    fp = fopen(images_file, "wb");
+    fwrite(images, 1, sizeof(images), fp);
+    fclose(fp);
+    fp = fopen(labels_file, "wb");
+    fwrite(labels, 1, sizeof(labels), fp);
+    fclose(fp);
+
+    prsm_dataset_idx_t idx_images, idx_labels;
+    assert(prsm_dataset_idx_open(&idx_images, images_file) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(prsm_dataset_idx_open(&idx_labels, labels_file) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(prsm_dataset_idx_len(&idx_images) == 3);
+    assert(prsm_dataset_idx_sample_size(&idx_images) == 4);
+    assert(prsm_dataset_idx_get(&idx_images, 1)[3] == 4);
+
+    // normalized images
+    prsm_tensor_t *x_idx = prsm_tensor_create_mat(alloctr, 2, 4);
+    prsm_dataset_idx_to_tensor(x_idx, &idx_images, 0, 1.0/255.0);
+    assert(x_idx->data[1] == 1 && x_idx->data[2] == (prsm_float)(51 * (prsm_float)(1.0/255.0)));
+    prsm_dataset_idx_to_tensor(x_idx, &idx_images, 1, 1);
+    assert(prsm_tensor_equals_array(x_idx, (prsm_float[]){1, 2, 3, 4, 5, 6, 7, 8}, 8));
+
+    // one-hot and index labels
+    prsm_tensor_t *y_idx = prsm_tensor_create_mat(alloctr, 3, 3);
+    prsm_tensor_t *y_idx_raw = prsm_tensor_create_mat(alloctr, 3, 1);
+    assert(prsm_dataset_idx_to_labels(y_idx, &idx_labels, 0) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(prsm_tensor_equals_array(y_idx, (prsm_float[]){0, 0, 1, 1, 0, 0, 0, 1, 0}, 9));
+    assert(prsm_dataset_idx_to_labels(y_idx_raw, &idx_labels, 0) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(prsm_tensor_equals_array(y_idx_raw, (prsm_float[]){2, 0, 1}, 3));
+
+    prsm_dataset_idx_close(&idx_images);
+    prsm_dataset_idx_close(&idx_labels);
+
+    // truncated file
+    fp = fopen(images_file, "wb");
+    fwrite(images, 1, sizeof(images) - 1, fp);
+    fclose(fp);
+    assert(prsm_dataset_idx_open(&idx_images, images_file) == PRSM_STATUS_ERROR_INVALID_FORMAT);
+
+    prsm_tensor_destroy(x_idx);
+    prsm_tensor_destroy(y_idx);
+    prsm_tensor_destroy(y_idx_raw);
+    vt_path_remove(images_file);
+    vt_path_remove(labels_file);
+}
+
+void test_dataloader_fill(void *const ctx, prsm_tensor_t *const x, prsm_tensor_t *const y, const size_t indices[], const size_t count) {
+    (void)ctx;
+    assert(y == NULL);
+    VT_FOREACH(i, 0, count) {
+        x->data[i] = indices[i];
+    }
+}
+
+void test_dataloader(void) {
+    const size_t n = 10;
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, n, 2);
+    prsm_tensor_t *y = prsm_tensor_create_mat(alloctr, n, 1);
+    VT_FOREACH(i, 0, n) {
+        x->data[i * 2] = i;
+        x->data[i * 2 + 1] = -(prsm_float)i;
+        y->data[i] = i;
+    }
+
+    // shuffled batches: every sample is visited once per epoch
+    prsm_dataloader_t *dl = prsm_dataloader_create(alloctr, x, y, 4, 3, true);
+    assert(prsm_dataloader_len(dl) == 3);
+    VT_FOREACH(epoch, 0, 3) {
+        size_t seen[10] = {0};
+        size_t batches = 0;
+        prsm_tensor_t xb, yb;
+        while (prsm_dataloader_next(dl, &xb, &yb)) {
+            const size_t rows = prsm_tensor_shape(&xb)[0];
+            assert(rows == (batches < 2 ? 4 : 2));
+            assert(prsm_tensor_shape(&yb)[0] == rows);
+            VT_FOREACH(i, 0, rows) {
+                const size_t k = (size_t)yb.data[i];
+                assert(xb.data[i * 2] == (prsm_float)k && xb.data[i * 2 + 1] == -(prsm_float)k);
+                seen[k]++;
+            }
+            batches++;
+        }
+        assert(batches == 3);
+        VT_FOREACH(i, 0, n) {
+            assert(seen[i] == 1);
+        }
+    }
+    prsm_dataloader_destroy(dl);
+
+    // custom source, in order
+    dl = prsm_dataloader_create_ex(alloctr, 5, 1, 0, test_dataloader_fill, NULL, 2, 2, false);
+    prsm_tensor_t xb;
+    size_t expected = 0;
+    while (prsm_dataloader_next(dl, &xb, NULL)) {
+        VT_FOREACH(i, 0, prsm_tensor_shape(&xb)[0]) {
+            assert(xb.data[i] == expected++);
+        }
+    }
+    assert(expected == 5);
+    prsm_dataloader_destroy(dl);
+
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(y);
 }
 
 void test_math(void) {
@@ -415,9 +923,1738 @@ void test_loss(void) {
 }
 
 void test_layers(void) {
-    //
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, 4, 3);
+    prsm_tensor_t *t = prsm_tensor_create_mat(alloctr, 4, 2);
+    prsm_tensor_rand(x);
+    prsm_tensor_rand(t);
+
+    // dense
+    prsm_layer_dense_t *dense = prsm_layer_dense_create(alloctr, 3, 2, PRSM_ACTIVATION_SIGMOID);
+    prsm_tensor_rand_uniform(dense->b, -1, 1);
+    assert(prsm_tensor_shapes_match_ex(dense->w, 2, (size_t[]){3, 2}));
+
+    // forward: same as dot + bias + sigmoid
+    const prsm_tensor_t *out = prsm_layer_dense_forward(dense, x);
+    prsm_tensor_t *ref = prsm_tensor_dot(NULL, x, dense->w);
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_t row = prsm_tensor_make_view_vec(ref, i);
+        prsm_tensor_add(&row, &row, dense->b);
+    }
+    prsm_activate_sigmoid(ref, ref);
+    assert(prsm_tensor_equals_approx(out, ref, 1e-5));
+    prsm_tensor_destroy(ref);
+
+    // backward: compare with autograd
+    prsm_autograd_t *tape = prsm_autograd_create(alloctr);
+    const size_t x_id = prsm_autograd_leaf(tape, x, true);
+    const size_t w_id = prsm_autograd_leaf(tape, dense->w, true);
+    const size_t b_id = prsm_autograd_leaf(tape, dense->b, true);
+    const size_t a_id = prsm_autograd_sigmoid(tape, prsm_autograd_add_rows(tape, prsm_autograd_matmul(tape, x_id, w_id), b_id));
+    prsm_autograd_backward(tape, prsm_autograd_mse(tape, a_id, prsm_autograd_leaf(tape, t, false)));
+
+    const prsm_tensor_t *dx = prsm_layer_dense_backward(dense, prsm_autograd_grad(tape, a_id), true);
+    assert(prsm_tensor_equals_approx(dx, prsm_autograd_grad(tape, x_id), 1e-5));
+    assert(prsm_tensor_equals_approx(dense->dw, prsm_autograd_grad(tape, w_id), 1e-5));
+    assert(prsm_tensor_equals_approx(dense->db, prsm_autograd_grad(tape, b_id), 1e-5));
+    assert(prsm_layer_dense_backward(dense, prsm_autograd_grad(tape, a_id), false) == NULL);
+
+    // batch size change resizes buffers
+    prsm_tensor_t *x2 = prsm_tensor_create_mat(alloctr, 2, 3);
+    prsm_tensor_rand(x2);
+    out = prsm_layer_dense_forward(dense, x2);
+    assert(prsm_tensor_shapes_match_ex(out, 2, (size_t[]){2, 2}));
+    prsm_tensor_t *dout = prsm_tensor_create_mat(alloctr, 2, 2);
+    prsm_tensor_set_ones(dout);
+    dx = prsm_layer_dense_backward(dense, dout, true);
+    assert(prsm_tensor_shapes_match_ex(dx, 2, (size_t[]){2, 3}));
+    prsm_tensor_destroy(dout);
+    prsm_tensor_destroy(x2);
+
+    // batchnorm after conv: batch statistics, in place
+    const prsm_conv2d_params_t bn_params = {
+        .in_channels = 2, .out_channels = 3, .groups = 1,
+        .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1}
+    };
+    prsm_layer_conv2d_t *conv = prsm_layer_conv2d_create(alloctr, &bn_params, PRSM_ACTIVATION_LINEAR);
+    prsm_tensor_rand_uniform(conv->b, 1, 2);
+    prsm_tensor_t *img = prsm_tensor_create(alloctr, 4, 4, 2, 5, 5);
+    prsm_tensor_rand_uniform(img, -1, 1);
+    prsm_layer_batchnorm_t *bn = prsm_layer_batchnorm_create(alloctr, 3, 0.1, 1e-5);
+    const prsm_tensor_t *bn_in = prsm_layer_conv2d_forward(conv, img);
+    prsm_tensor_t *bn_ref = prsm_tensor_dup(bn_in);
+    assert(prsm_layer_batchnorm_forward_inplace(bn, conv->out, true) == conv->out);
+    VT_FOREACH(ch, 0, 3) {
+        prsm_float mean = 0, var = 0, ref_mean = 0;
+        VT_FOREACH(n, 0, 4) {
+            VT_FOREACH(k, 0, 25) {
+                mean += conv->out->data[(n * 3 + ch) * 25 + k] / 100;
+                ref_mean += bn_ref->data[(n * 3 + ch) * 25 + k] / 100;
+            }
+        }
+        VT_FOREACH(n, 0, 4) {
+            VT_FOREACH(k, 0, 25) {
+                var += (conv->out->data[(n * 3 + ch) * 25 + k] - mean) * (conv->out->data[(n * 3 + ch) * 25 + k] - mean) / 100;
+            }
+        }
+        assert(PRSM_ABS(mean) < 1e-4);
+        assert(PRSM_ABS(var - 1) < 1e-3);
+        assert(PRSM_ABS(bn->mean->data[ch] - ref_mean) < 1e-4);
+        assert(PRSM_ABS(bn->running_mean->data[ch] - (0.1 * ref_mean)) < 1e-4);
+    }
+
+    // backward: compare with finite differences of loss = sum(r * bn(x))
+    prsm_layer_batchnorm_t *bn_dense = prsm_layer_batchnorm_create(alloctr, 3, 0.1, 1e-5);
+    prsm_tensor_rand_uniform(bn_dense->gamma, 0.5, 2);
+    prsm_tensor_rand_uniform(bn_dense->beta, -1, 1);
+    prsm_tensor_t *fx = prsm_tensor_create_mat(alloctr, 6, 3);
+    prsm_tensor_t *fr = prsm_tensor_create_mat(alloctr, 6, 3);
+    prsm_tensor_rand_uniform(fx, -2, 2);
+    prsm_tensor_rand_uniform(fr, -1, 1);
+    prsm_tensor_t *fy = prsm_tensor_dup(fx);
+    const prsm_tensor_t *fy_out = prsm_layer_batchnorm_forward(bn_dense, fx, true);
+    prsm_layer_batchnorm_forward_inplace(bn_dense, fy, true);
+    assert(fy_out == bn_dense->out && prsm_tensor_equals(fy_out, fy));
+    const prsm_tensor_t *bn_dx = prsm_layer_batchnorm_backward(bn_dense, fr, true);
+    VT_FOREACH(i, 0, 18) {
+        prsm_float loss[2];
+        VT_FOREACH(side, 0, 2) {
+            prsm_tensor_dup_into(fy, fx);
+            fy->data[i] += side ? 1e-2 : -1e-2;
+            prsm_layer_batchnorm_forward_inplace(bn_dense, fy, true);
+            loss[side] = 0;
+            VT_FOREACH(j, 0, 18) {
+                loss[side] += fr->data[j] * fy->data[j];
+            }
+        }
+        assert(PRSM_ABS(bn_dx->data[i] - ((loss[1] - loss[0]) / 2e-2)) < 1e-2);
+    }
+    VT_FOREACH(ch, 0, 3) {
+        prsm_float dbeta = 0;
+        VT_FOREACH(n, 0, 6) {
+            dbeta += fr->data[n * 3 + ch];
+        }
+        assert(PRSM_ABS(bn_dense->dbeta->data[ch] - dbeta) < 1e-4);
+    }
+    assert(prsm_layer_batchnorm_backward(bn_dense, fr, false) == NULL);
+
+    // backward with a zero gamma: the channel passes no gradient to the input, dgamma still follows xhat
+    const prsm_float gamma0 = bn_dense->gamma->data[0];
+    bn_dense->gamma->data[0] = 0;
+    prsm_tensor_dup_into(fy, fx);
+    prsm_layer_batchnorm_forward_inplace(bn_dense, fy, true);
+    bn_dx = prsm_layer_batchnorm_backward(bn_dense, fr, true);
+    prsm_float loss_gamma[2];
+    VT_FOREACH(side, 0, 2) {
+        bn_dense->gamma->data[0] = side ? 1e-2 : -1e-2;
+        prsm_tensor_dup_into(fy, fx);
+        prsm_layer_batchnorm_forward_inplace(bn_dense, fy, true);
+        loss_gamma[side] = 0;
+        VT_FOREACH(j, 0, 18) {
+            loss_gamma[side] += fr->data[j] * fy->data[j];
+        }
+    }
+    assert(PRSM_ABS(bn_dense->dgamma->data[0] - ((loss_gamma[1] - loss_gamma[0]) / 2e-2)) < 1e-3);
+    assert(PRSM_ABS(bn_dense->dgamma->data[0]) > 1e-3);
+    VT_FOREACH(n, 0, 6) {
+        assert(bn_dx->data[n * 3] == 0);
+    }
+    bn_dense->gamma->data[0] = gamma0;
+
+    // folding into conv: inference output is unchanged
+    prsm_tensor_rand_uniform(bn->gamma, 0.5, 2);
+    prsm_tensor_rand_uniform(bn->beta, -1, 1);
+    prsm_tensor_rand_uniform(bn->running_var, 0.5, 2);
+    prsm_tensor_dup_into(bn_ref, prsm_layer_batchnorm_forward(bn, prsm_layer_conv2d_forward(conv, img), false));
+
+    // out of place: the conv output is left untouched and normalizes to the same values in place
+    prsm_tensor_t *bn_inplace = prsm_tensor_dup(conv->out);
+    assert(prsm_layer_batchnorm_forward_inplace(bn, bn_inplace, false) == bn_inplace);
+    assert(prsm_tensor_equals(bn_inplace, bn_ref));
+    prsm_tensor_destroy(bn_inplace);
+    prsm_layer_batchnorm_fold_conv2d(bn, conv);
+    assert(bn->folded);
+    const prsm_tensor_t *folded = prsm_layer_batchnorm_forward(bn, prsm_layer_conv2d_forward(conv, img), false);
+    assert(prsm_tensor_equals_approx(folded, bn_ref, 1e-4));
+
+    // folding into dense
+    prsm_layer_dense_t *dense_lin = prsm_layer_dense_create(alloctr, 3, 3, PRSM_ACTIVATION_LINEAR);
+    prsm_tensor_rand_uniform(dense_lin->b, -1, 1);
+    prsm_tensor_rand_uniform(bn_dense->running_mean, -1, 1);
+    prsm_tensor_rand_uniform(bn_dense->running_var, 0.5, 2);
+    prsm_tensor_dup_into(fy, prsm_layer_dense_forward(dense_lin, fx));
+    prsm_layer_batchnorm_forward_inplace(bn_dense, fy, false);
+    prsm_layer_batchnorm_fold_dense(bn_dense, dense_lin);
+    assert(prsm_tensor_equals_approx(prsm_layer_dense_forward(dense_lin, fx), fy, 1e-4));
+
+    prsm_layer_dense_destroy(dense_lin);
+    prsm_layer_batchnorm_destroy(bn_dense);
+    prsm_layer_batchnorm_destroy(bn);
+    prsm_layer_conv2d_destroy(conv);
+    prsm_tensor_destroy(fx);
+    prsm_tensor_destroy(fr);
+    prsm_tensor_destroy(fy);
+    prsm_tensor_destroy(img);
+    prsm_tensor_destroy(bn_ref);
+
+    prsm_autograd_destroy(tape);
+    prsm_layer_dense_destroy(dense);
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(t);
+}
+
+size_t test_autograd_model(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const t, prsm_tensor_t *const w1, prsm_tensor_t *const b1, prsm_tensor_t *const w2, size_t params[3]) {
+    prsm_autograd_reset(tape);
+
+    // leaves
+    const size_t x_id = prsm_autograd_leaf(tape, x, false);
+    const size_t t_id = prsm_autograd_leaf(tape, t, false);
+    params[0] = prsm_autograd_leaf(tape, w1, true);
+    params[1] = prsm_autograd_leaf(tape, b1, true);
+    params[2] = prsm_autograd_leaf(tape, w2, true);
+
+    // hidden layer
+    const size_t a1 = prsm_autograd_tanh(tape, prsm_autograd_add_rows(tape, prsm_autograd_matmul(tape, x_id, params[0]), params[1]));
+    const size_t z2 = prsm_autograd_matmul(tape, a1, params[2]);
+
+    // loss = cce(softmax(z2), t) + mse(sigmoid(z2)^2 - softmax(z2), t)
+    const size_t s1 = prsm_autograd_sigmoid(tape, z2);
+    const size_t s2 = prsm_autograd_softmax(tape, z2);
+    const size_t l1 = prsm_autograd_softmax_cce(tape, z2, t_id);
+    const size_t l2 = prsm_autograd_mse(tape, prsm_autograd_sub(tape, prsm_autograd_mul(tape, s1, s1), s2), t_id);
+
+    return prsm_autograd_add(tape, l1, l2);
+}
+
+size_t test_autograd_deep(prsm_autograd_t *const tape, prsm_tensor_t *const params[], const size_t depth, prsm_tensor_t *const x, prsm_tensor_t *const y, const size_t segment) {
+    // parameters first: weights and biases of every layer
+    prsm_autograd_reset(tape);
+    VT_FOREACH(i, 0, 2 * depth) {
+        prsm_autograd_leaf(tape, params[i], true);
+    }
+    size_t h = prsm_autograd_leaf(tape, x, false);
+    const size_t y_id = prsm_autograd_leaf(tape, y, false);
+
+    // tanh layers, `segment` layers per checkpointed segment; 0 disables checkpointing
+    VT_FOREACH(l, 0, depth) {
+        if (segment > 0 && l % segment == 0) prsm_autograd_checkpoint_begin(tape);
+        h = prsm_autograd_dense(tape, h, 2 * l, 2 * l + 1, PRSM_ACTIVATION_TANH);
+        if (segment > 0 && (l % segment == segment - 1 || l == depth - 1)) prsm_autograd_checkpoint_end(tape);
+    }
+
+    return prsm_autograd_mse(tape, h, y_id);
+}
+
+void test_autograd(void) {
+    prsm_tensor_t *x = prsm_tensor_create_mat(alloctr, 4, 3);
+    prsm_tensor_t *t = prsm_tensor_create_mat(alloctr, 4, 2);
+    prsm_tensor_t *w1 = prsm_tensor_create_mat(alloctr, 3, 5);
+    prsm_tensor_t *b1 = prsm_tensor_create_vec(alloctr, 5);
+    prsm_tensor_t *w2 = prsm_tensor_create_mat(alloctr, 5, 2);
+    prsm_tensor_rand(x);
+    prsm_tensor_rand(w1);
+    prsm_tensor_rand(b1);
+    prsm_tensor_rand(w2);
+    prsm_tensor_apply_scale_add(w1, 2, -1);
+    prsm_tensor_apply_scale_add(w2, 2, -1);
+    prsm_tensor_set_zeros(t);
+    VT_FOREACH(i, 0, 4) prsm_tensor_set_val(t, i * 2 + i % 2, 1);
+
+    // forward and backward
+    size_t params[3];
+    prsm_autograd_t *tape = prsm_autograd_create(alloctr);
+    size_t loss = test_autograd_model(tape, x, t, w1, b1, w2, params);
+    prsm_autograd_backward(tape, loss);
+    assert(prsm_autograd_grad(tape, 0) == NULL);
+    assert(prsm_tensor_shapes_match(prsm_autograd_grad(tape, params[0]), w1));
+    assert(prsm_tensor_shapes_match(prsm_autograd_grad(tape, params[1]), b1));
+    assert(prsm_tensor_shapes_match(prsm_autograd_grad(tape, params[2]), w2));
+
+    // compare with numerical gradients; replaying the tape must not reallocate
+    const size_t len = tape->len;
+    const prsm_tensor_t *const loss_value = prsm_autograd_value(tape, loss);
+    prsm_tensor_t *const tensors[3] = { w1, b1, w2 };
+    const prsm_float h = 1e-2;
+    VT_FOREACH(k, 0, 3) {
+        prsm_tensor_t *const p = tensors[k];
+        const prsm_tensor_t *const grad = prsm_autograd_grad(tape, params[k]);
+        VT_FOREACH(i, 0, prsm_tensor_size(p)) {
+            const prsm_float v = p->data[i];
+            p->data[i] = v + h;
+            loss = test_autograd_model(tape, x, t, w1, b1, w2, params);
+            const prsm_float loss_plus = prsm_autograd_value(tape, loss)->data[0];
+            p->data[i] = v - h;
+            loss = test_autograd_model(tape, x, t, w1, b1, w2, params);
+            const prsm_float loss_minus = prsm_autograd_value(tape, loss)->data[0];
+            p->data[i] = v;
+
+            const prsm_float numeric = (loss_plus - loss_minus) / (2 * h);
+            assert(PRSM_ABS(numeric - grad->data[i]) < 1e-2);
+        }
+    }
+    assert(tape->len == len);
+    assert(prsm_autograd_value(tape, loss) == loss_value);
+
+    // repeated backward overwrites gradients
+    prsm_tensor_t *const grad_w2 = prsm_tensor_dup(prsm_autograd_grad(tape, params[2]));
+    loss = test_autograd_model(tape, x, t, w1, b1, w2, params);
+    prsm_autograd_backward(tape, loss);
+    prsm_autograd_backward(tape, loss);
+    assert(prsm_tensor_equals(prsm_autograd_grad(tape, params[2]), grad_w2));
+    prsm_tensor_destroy(grad_w2);
+
+    // fused dense matches the unfused graph
+    prsm_autograd_reset(tape);
+    {
+        const size_t x_id = prsm_autograd_leaf(tape, x, true);
+        const size_t w_id = prsm_autograd_leaf(tape, w1, true);
+        const size_t b_id = prsm_autograd_leaf(tape, b1, true);
+        const size_t fused = prsm_autograd_dense(tape, x_id, w_id, b_id, PRSM_ACTIVATION_TANH);
+        const size_t unfused = prsm_autograd_tanh(tape, prsm_autograd_add_rows(tape, prsm_autograd_matmul(tape, x_id, w_id), b_id));
+        assert(prsm_tensor_equals_approx(prsm_autograd_value(tape, fused), prsm_autograd_value(tape, unfused), 1e-5));
+
+        // backward through each branch separately: the other branch receives no gradient
+        prsm_autograd_backward(tape, prsm_autograd_mul(tape, fused, fused));
+        prsm_tensor_t *const gw = prsm_tensor_dup(prsm_autograd_grad(tape, w_id));
+        prsm_tensor_t *const gb = prsm_tensor_dup(prsm_autograd_grad(tape, b_id));
+        prsm_tensor_t *const gx = prsm_tensor_dup(prsm_autograd_grad(tape, x_id));
+        prsm_autograd_backward(tape, prsm_autograd_mul(tape, unfused, unfused));
+        assert(prsm_tensor_equals_approx(prsm_autograd_grad(tape, w_id), gw, 1e-4));
+        assert(prsm_tensor_equals_approx(prsm_autograd_grad(tape, b_id), gb, 1e-4));
+        assert(prsm_tensor_equals_approx(prsm_autograd_grad(tape, x_id), gx, 1e-4));
+        prsm_tensor_destroy(gw);
+        prsm_tensor_destroy(gb);
+        prsm_tensor_destroy(gx);
+    }
+
+    // a different graph is re-recorded from the first mismatch
+    prsm_autograd_reset(tape);
+    {
+        const size_t a = prsm_autograd_leaf(tape, x, true);
+        const size_t r = prsm_autograd_relu(tape, prsm_autograd_sub(tape, a, prsm_autograd_leaf(tape, x, false)));
+        const size_t m = prsm_autograd_mse(tape, prsm_autograd_add(tape, a, r), prsm_autograd_leaf(tape, x, false));
+        prsm_autograd_backward(tape, m);
+        assert(tape->len == 7);
+        assert(prsm_autograd_value(tape, m)->data[0] == 0);
+        assert(prsm_tensor_calc_sum(prsm_autograd_grad(tape, a)) == 0);
+    }
+
+
+    // checkpointing: recomputed segments give the same gradients with fewer stored activations
+    {
+        const size_t depth = 9, n = 16, f = 12;
+        prsm_tensor_t *params[18];
+        VT_FOREACH(l, 0, depth) {
+            params[2 * l] = prsm_tensor_create_mat(NULL, f, f);
+            params[2 * l + 1] = prsm_tensor_create_vec(NULL, f);
+            prsm_tensor_rand_uniform(params[2 * l], -0.5, 0.5);
+            prsm_tensor_rand_uniform(params[2 * l + 1], -0.1, 0.1);
+        }
+        prsm_tensor_t *xd = prsm_tensor_create_mat(NULL, n, f);
+        prsm_tensor_t *yd = prsm_tensor_create_mat(NULL, n, f);
+        prsm_tensor_rand_uniform(xd, -1, 1);
+        prsm_tensor_rand_uniform(yd, -1, 1);
+
+        // reference without checkpoints
+        prsm_autograd_t *ref = prsm_autograd_create(NULL);
+        const size_t ref_loss = test_autograd_deep(ref, params, depth, xd, yd, 0);
+        prsm_autograd_backward(ref, ref_loss);
+        const prsm_autograd_checkpoint_stats_t ref_stats = prsm_autograd_checkpoint_stats(ref);
+        assert(ref_stats.saved_bytes == 0 && ref_stats.recompute_flops == 0);
+
+        // segments of sqrt(depth) layers; the second pass replays the tape
+        prsm_autograd_t *ckpt = prsm_autograd_create(NULL);
+        VT_FOREACH(pass, 0, 2) {
+            const size_t loss = test_autograd_deep(ckpt, params, depth, xd, yd, 3);
+            assert(prsm_autograd_value(ckpt, loss)->data[0] == prsm_autograd_value(ref, ref_loss)->data[0]);
+            assert(prsm_autograd_value(ckpt, 2 * depth + 2) == NULL);
+            prsm_autograd_backward(ckpt, loss);
+            VT_FOREACH(i, 0, 2 * depth) {
+                assert(prsm_tensor_equals(prsm_autograd_grad(ckpt, i), prsm_autograd_grad(ref, i)));
+            }
+            assert(prsm_autograd_grad(ckpt, 2 * depth + 2) == NULL);
+
+            // two of every three layers are recomputed
+            const prsm_autograd_checkpoint_stats_t stats = prsm_autograd_checkpoint_stats(ckpt);
+            assert(stats.forward_flops == ref_stats.forward_flops);
+            assert(stats.recompute_flops > 0 && stats.recompute_flops < stats.forward_flops);
+            assert(stats.saved_bytes == 6 * n * f * sizeof(prsm_float));
+            assert(stats.stored_bytes < ref_stats.stored_bytes);
+        }
+
+        prsm_autograd_destroy(ckpt);
+        prsm_autograd_destroy(ref);
+        prsm_tensor_destroy(xd);
+        prsm_tensor_destroy(yd);
+        VT_FOREACH(i, 0, 2 * depth) {
+            prsm_tensor_destroy(params[i]);
+        }
+    }
+
+
+    // stash: compressed activations give close gradients; relu outputs keep a mask, unread values nothing
+    {
+        const size_t n = 24, f = 40, h = 70, c = 10;
+        prsm_tensor_t *xs = prsm_tensor_create_mat(NULL, n, f);
+        prsm_tensor_t *ts = prsm_tensor_create_mat(NULL, n, c);
+        prsm_tensor_t *p[4] = {
+            prsm_tensor_create_mat(NULL, f, h), prsm_tensor_create_vec(NULL, h),
+            prsm_tensor_create_mat(NULL, h, c), prsm_tensor_create_vec(NULL, c)
+        };
+        prsm_tensor_rand_uniform(xs, -1, 1);
+        prsm_tensor_set_zeros(ts);
+        VT_FOREACH(r, 0, n) {
+            ts->data[r * c + r % c] = 1;
+        }
+        VT_FOREACH(i, 0, 4) {
+            prsm_tensor_rand_uniform(p[i], -0.3, 0.3);
+        }
+
+        const enum PrismaAutogradStashFormat formats[] = {PRSM_AUTOGRAD_STASH_FLOAT, PRSM_AUTOGRAD_STASH_FP16, PRSM_AUTOGRAD_STASH_INT8};
+        const prsm_float tols[] = {0, 2e-3, 2e-2};
+        prsm_autograd_t *tapes[3];
+        VT_FOREACH(k, 0, 3) {
+            tapes[k] = prsm_autograd_create(NULL);
+            prsm_autograd_set_stash(tapes[k], formats[k]);
+
+            // the first pass learns the readers of every value, the second one stashes
+            VT_FOREACH(pass, 0, 2) {
+                prsm_autograd_t *const ts_tape = tapes[k];
+                prsm_autograd_reset(ts_tape);
+                VT_FOREACH(i, 0, 4) {
+                    prsm_autograd_leaf(ts_tape, p[i], true);
+                }
+                const size_t x_id = prsm_autograd_leaf(ts_tape, xs, false);
+                const size_t t_id = prsm_autograd_leaf(ts_tape, ts, false);
+                const size_t h1 = prsm_autograd_dense(ts_tape, x_id, 0, 1, PRSM_ACTIVATION_RELU);
+                const size_t a2 = prsm_autograd_tanh(ts_tape, prsm_autograd_add_rows(ts_tape, prsm_autograd_matmul(ts_tape, h1, 2), 3));
+                const size_t loss = prsm_autograd_softmax_cce(ts_tape, a2, t_id);
+                prsm_autograd_backward(ts_tape, loss);
+                assert(prsm_autograd_value(ts_tape, loss) != NULL);
+            }
+
+            // gradients close to full precision
+            VT_FOREACH(i, 0, 4) {
+                assert(prsm_tensor_equals_approx(prsm_autograd_grad(tapes[k], i), prsm_autograd_grad(tapes[0], i), tols[k] + 1e-6));
+            }
+        }
+
+        // full precision keeps everything; compressed tapes keep what backward reads
+        const prsm_autograd_checkpoint_stats_t ref = prsm_autograd_checkpoint_stats(tapes[0]);
+        assert(ref.stashed_bytes == 0 && ref.saved_bytes == 0);
+        VT_FOREACH(k, 1, 3) {
+            const prsm_autograd_t *const ts_tape = tapes[k];
+            assert(ts_tape->nodes[6].stashed && ts_tape->nodes[6].stash.format == formats[k]);
+            assert(ts_tape->nodes[7].stashed && ts_tape->nodes[7].stash.format == PRSM_AUTOGRAD_STASH_DROP);
+            assert(ts_tape->nodes[8].stashed && ts_tape->nodes[8].stash.format == PRSM_AUTOGRAD_STASH_DROP);
+            assert(ts_tape->nodes[9].stashed && ts_tape->nodes[9].stash.format == formats[k]);
+            assert(prsm_autograd_value(ts_tape, 6) == NULL);
+
+            const prsm_autograd_checkpoint_stats_t stats = prsm_autograd_checkpoint_stats(ts_tape);
+            assert(stats.stashed_bytes > 0 && stats.stashed_bytes <= (n * h + n * c) * sizeof(prsm_float) / 2);
+            assert(stats.stored_bytes < ref.stored_bytes);
+            assert(stats.saved_bytes > 0);
+        }
+
+        // a relu read only by an addition keeps one bit per value
+        prsm_autograd_t *mask = prsm_autograd_create(NULL);
+        prsm_autograd_set_stash(mask, PRSM_AUTOGRAD_STASH_INT8);
+        VT_FOREACH(pass, 0, 2) {
+            prsm_autograd_reset(mask);
+            const size_t x_id = prsm_autograd_leaf(mask, xs, true);
+            const size_t r = prsm_autograd_relu(mask, x_id);
+            const size_t m = prsm_autograd_mul(mask, prsm_autograd_add(mask, r, x_id), x_id);
+            prsm_autograd_backward(mask, m);
+        }
+        assert(mask->nodes[1].stashed && mask->nodes[1].stash.format == PRSM_AUTOGRAD_STASH_MASK);
+        assert(mask->nodes[1].stash.bytes == (n * f + 7) / 8);
+        VT_FOREACH(i, 0, n * f) {
+            // d/dx (relu(x) + x) * x = (relu'(x) + 1) * x + relu(x) + x
+            const prsm_float xv = xs->data[i];
+            const prsm_float expected = (xv > 0) ? 4 * xv : 2 * xv;
+            assert(PRSM_ABS(prsm_autograd_grad(mask, 0)->data[i] - expected) < 5e-2);
+        }
+
+        prsm_autograd_destroy(mask);
+        VT_FOREACH(k, 0, 3) {
+            prsm_autograd_destroy(tapes[k]);
+        }
+        VT_FOREACH(i, 0, 4) {
+            prsm_tensor_destroy(p[i]);
+        }
+        prsm_tensor_destroy(xs);
+        prsm_tensor_destroy(ts);
+    }
+    prsm_autograd_destroy(tape);
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(t);
+    prsm_tensor_destroy(w1);
+    prsm_tensor_destroy(b1);
+    prsm_tensor_destroy(w2);
 }
 
+void test_conv_naive(prsm_tensor_t *const out, prsm_tensor_t *const dx, prsm_tensor_t *const dw, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_tensor_t *const w, const prsm_conv2d_params_t *const p) {
+    // direct convolution: forward into `out` or, if `dout != NULL`, backward into `dx` and `dw`
+    const size_t n_ = in->shape[0], c_ = in->shape[1], h_ = in->shape[2], w_ = in->shape[3];
+    const size_t oc_ = p->out_channels, cg = c_ / p->groups, ocg = oc_ / p->groups;
+    const size_t oh_ = prsm_conv2d_out_dim(h_, p->kernel[0], p->stride[0], p->padding[0], p->dilation[0]);
+    const size_t ow_ = prsm_conv2d_out_dim(w_, p->kernel[1], p->stride[1], p->padding[1], p->dilation[1]);
+    if (dout == NULL) prsm_tensor_set_zeros(out);
+    else { prsm_tensor_set_zeros(dx); prsm_tensor_set_zeros(dw); }
+
+    VT_FOREACH(n, 0, n_) VT_FOREACH(oc, 0, oc_) VT_FOREACH(oh, 0, oh_) VT_FOREACH(ow, 0, ow_) {
+        const size_t o = ((n * oc_ + oc) * oh_ + oh) * ow_ + ow;
+        VT_FOREACH(ci, 0, cg) VT_FOREACH(kh, 0, p->kernel[0]) VT_FOREACH(kw, 0, p->kernel[1]) {
+            const long ih = (long)(oh * p->stride[0] + kh * p->dilation[0]) - (long)p->padding[0];
+            const long iw = (long)(ow * p->stride[1] + kw * p->dilation[1]) - (long)p->padding[1];
+            if (ih < 0 || iw < 0 || ih >= (long)h_ || iw >= (long)w_) continue;
+
+            const size_t c = (oc / ocg) * cg + ci;
+            const size_t i = ((n * c_ + c) * h_ + (size_t)ih) * w_ + (size_t)iw;
+            const size_t k = ((oc * cg + ci) * p->kernel[0] + kh) * p->kernel[1] + kw;
+            if (dout == NULL) {
+                out->data[o] += in->data[i] * w->data[k];
+            } else {
+                dx->data[i] += w->data[k] * dout->data[o];
+                dw->data[k] += in->data[i] * dout->data[o];
+            }
+        }
+    }
+}
 
+void test_conv_upsample_naive(prsm_tensor_t *const up, const prsm_tensor_t *const in, const enum PrismaConvUpsample mode, const size_t scale) {
+    // materialized upsampling: nearest repeats pixels, bilinear interpolates pixel centers clamped to the image
+    const size_t nc = in->shape[0] * in->shape[1], h_ = in->shape[2], w_ = in->shape[3];
+    VT_FOREACH(i, 0, nc) VT_FOREACH(y, 0, h_ * scale) VT_FOREACH(x, 0, w_ * scale) {
+        const prsm_float *const img = in->data + i * h_ * w_;
+        prsm_float v = img[(y / scale) * w_ + x / scale];
+        if (mode == PRSM_CONV_UPSAMPLE_BILINEAR) {
+            const double ry = ((double)y + 0.5) / scale - 0.5, rx = ((double)x + 0.5) / scale - 0.5;
+            const double sy = (ry < 0) ? 0 : ry, sx = (rx < 0) ? 0 : rx;
+            const size_t y0 = (size_t)sy, x0 = (size_t)sx;
+            const size_t y1 = (y0 + 1 < h_) ? y0 + 1 : y0, x1 = (x0 + 1 < w_) ? x0 + 1 : x0;
+            const double ly = sy - (double)y0, lx = sx - (double)x0;
+            v = (1 - ly) * ((1 - lx) * img[y0 * w_ + x0] + lx * img[y0 * w_ + x1]) + ly * ((1 - lx) * img[y1 * w_ + x0] + lx * img[y1 * w_ + x1]);
+        }
+        up->data[(i * h_ * scale + y) * w_ * scale + x] = v;
+    }
+}
 
+void test_conv(void) {
+    prsm_parallel_set_num_threads(4);
+
+    // out_dim
+    assert(prsm_conv2d_out_dim(5, 3, 1, 0, 1) == 3);
+    assert(prsm_conv2d_out_dim(5, 3, 2, 1, 1) == 3);
+    assert(prsm_conv2d_out_dim(7, 3, 1, 0, 2) == 3);
+    assert(prsm_conv2d_out_dim(2, 3, 1, 0, 1) == 0);
+
+    // im2col of a 1-channel 3x3 image with 2x2 kernel
+    {
+        const prsm_conv2d_params_t p = { .in_channels = 1, .out_channels = 1, .groups = 1, .kernel = {2, 2}, .stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1} };
+        prsm_tensor_t *img = prsm_tensor_create(alloctr, 3, 1, 3, 3);
+        prsm_tensor_assign_array(img, (prsm_float[]){1, 2, 3, 4, 5, 6, 7, 8, 9}, 9);
+        prsm_tensor_t *col = prsm_conv2d_im2col(NULL, img, &p);
+        assert(prsm_tensor_shapes_match_ex(col, 2, (size_t[]){4, 4}));
+        assert(prsm_tensor_equals_array(col, (prsm_float[]){1, 2, 4, 5, 2, 3, 5, 6, 4, 5, 7, 8, 5, 6, 8, 9}, 16));
+
+        // col2im accumulates overlapping positions
+        prsm_tensor_set_ones(col);
+        prsm_tensor_set_zeros(img);
+        prsm_conv2d_col2im(img, col, &p);
+        assert(prsm_tensor_equals_array(img, (prsm_float[]){1, 2, 1, 2, 4, 2, 1, 2, 1}, 9));
+        prsm_tensor_destroy(col);
+        prsm_tensor_destroy(img);
+    }
+
+    // NCHWc layout round trip: the last block is zero padded
+    {
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 5, 3, 4);
+        prsm_tensor_rand(x);
+        prsm_tensor_t *xc = prsm_conv2d_to_nchwc(NULL, x, 8);
+        assert(prsm_tensor_shapes_match_ex(xc, 5, (size_t[]){2, 1, 3, 4, 8}));
+        assert(xc->data[8 + 2] == x->data[2 * 12 + 1] && xc->data[8 + 5] == 0);
+        prsm_tensor_t *y = prsm_conv2d_from_nchwc(NULL, xc, 5);
+        assert(prsm_tensor_equals(x, y));
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(xc);
+        prsm_tensor_destroy(y);
+    }
+
+    // algorithm selection
+    {
+        prsm_conv2d_params_t p = { .in_channels = 3, .out_channels = 32, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} };
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_DIRECT);
+        p.in_channels = 64;
+        assert(prsm_conv2d_select_algorithm(&p, 9, 7) == PRSM_CONV_ALGORITHM_WINOGRAD_2);
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_WINOGRAD_4);
+        p.out_channels = 64;
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_WINOGRAD_4);
+        prsm_conv2d_set_winograd_tolerance(1e-9);
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_IM2COL);
+        prsm_conv2d_set_winograd_tolerance(1e-3);
+        p.dilation[0] = 2;
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_IM2COL);
+        assert(prsm_conv2d_select_algorithm(&p, 256, 256) == PRSM_CONV_ALGORITHM_DIRECT);
+        p.groups = 2;
+        assert(prsm_conv2d_select_algorithm(&p, 256, 256) == PRSM_CONV_ALGORITHM_IM2COL);
+        p = (prsm_conv2d_params_t){ .in_channels = 3, .out_channels = 32, .groups = 1, .kernel = {1, 1}, .stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1} };
+        assert(prsm_conv2d_select_algorithm(&p, 32, 32) == PRSM_CONV_ALGORITHM_IM2COL);
+    }
 
+    // direct convolution on NCHW16c with partial channel blocks
+    {
+        const prsm_conv2d_params_t p = { .in_channels = 18, .out_channels = 20, .groups = 1, .kernel = {3, 3}, .stride = {2, 1}, .padding = {1, 2}, .dilation = {2, 1} };
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 18, 9, 11);
+        prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, 20, 18, 3, 3);
+        prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, 20);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_rand_uniform(w, -1, 1);
+        prsm_tensor_rand_uniform(b, -1, 1);
+
+        prsm_tensor_t *xc = prsm_conv2d_to_nchwc(NULL, x, 16);
+        prsm_tensor_t *wc = prsm_conv2d_pack_weights(NULL, w, 16);
+        prsm_tensor_t *yc = prsm_conv2d_direct(NULL, xc, wc, b, PRSM_ACTIVATION_TANH, &p);
+        prsm_tensor_t *y = prsm_conv2d_from_nchwc(NULL, yc, 20);
+
+        const size_t oh = prsm_conv2d_out_dim(9, 3, 2, 1, 2), ow = prsm_conv2d_out_dim(11, 3, 1, 2, 1);
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, 20, oh, ow);
+        test_conv_naive(ref, NULL, NULL, NULL, x, w, &p);
+        VT_FOREACH(i, 0, prsm_tensor_size(ref)) {
+            ref->data[i] = PRSM_TANH(ref->data[i] + b->data[(i / (oh * ow)) % 20]);
+        }
+        assert(prsm_tensor_equals_approx(y, ref, 1e-4));
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(w);
+        prsm_tensor_destroy(b);
+        prsm_tensor_destroy(xc);
+        prsm_tensor_destroy(wc);
+        prsm_tensor_destroy(yc);
+        prsm_tensor_destroy(y);
+        prsm_tensor_destroy(ref);
+    }
+
+    // Winograd F(2x2,3x3) and F(4x4,3x3) with partial edge tiles
+    VT_FOREACH(pad, 0, 2) {
+        const prsm_conv2d_params_t p = { .in_channels = 5, .out_channels = 3, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {pad, pad}, .dilation = {1, 1} };
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 5, 11, 10);
+        prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, 3, 5, 3, 3);
+        prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, 3);
+        prsm_tensor_t *workspace = prsm_tensor_create_vec(alloctr, 1);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_rand_uniform(w, -1, 1);
+        prsm_tensor_rand_uniform(b, -1, 1);
+
+        const size_t oh = 9 + 2 * pad, ow = 8 + 2 * pad;
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, 3, oh, ow);
+        test_conv_naive(ref, NULL, NULL, NULL, x, w, &p);
+        VT_FOREACH(i, 0, prsm_tensor_size(ref)) {
+            const prsm_float z = ref->data[i] + b->data[(i / (oh * ow)) % 3];
+            ref->data[i] = (z > 0) ? z : 0;
+        }
+
+        prsm_tensor_t *out = NULL;
+        prsm_tensor_t *u = NULL;
+        for (size_t m = 2; m <= 4; m += 2) {
+            u = prsm_conv2d_winograd_weights(u, w, m);
+            assert(prsm_tensor_shapes_match_ex(u, 3, (size_t[]){(m + 2) * (m + 2), 3, 5}));
+            out = prsm_conv2d_winograd(out, x, u, b, PRSM_ACTIVATION_RELU, &p, m, workspace);
+            assert(prsm_tensor_equals_approx(out, ref, 1e-4));
+        }
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(w);
+        prsm_tensor_destroy(b);
+        prsm_tensor_destroy(workspace);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(u);
+    }
+
+    // forward and backward against a direct convolution
+    const prsm_conv2d_params_t cases[] = {
+        { .in_channels = 4, .out_channels = 6, .groups = 2, .kernel = {3, 2}, .stride = {2, 1}, .padding = {1, 2}, .dilation = {2, 1} },
+        { .in_channels = 3, .out_channels = 5, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} },
+        { .in_channels = 4, .out_channels = 8, .groups = 4, .kernel = {1, 1}, .stride = {1, 1}, .padding = {0, 0}, .dilation = {1, 1} },
+        { .in_channels = 32, .out_channels = 32, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} },
+        { .in_channels = 12, .out_channels = 12, .groups = 12, .kernel = {3, 3}, .stride = {2, 2}, .padding = {1, 1}, .dilation = {1, 1} },
+        { .in_channels = 5, .out_channels = 5, .groups = 5, .kernel = {3, 2}, .stride = {1, 1}, .padding = {2, 0}, .dilation = {2, 1} },
+    };
+    VT_FOREACH(t, 0, sizeof(cases) / sizeof(cases[0])) {
+        const prsm_conv2d_params_t *const p = &cases[t];
+        const size_t oh = prsm_conv2d_out_dim(9, p->kernel[0], p->stride[0], p->padding[0], p->dilation[0]);
+        const size_t ow = prsm_conv2d_out_dim(7, p->kernel[1], p->stride[1], p->padding[1], p->dilation[1]);
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, p->in_channels, 9, 7);
+        prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, p->out_channels, p->in_channels / p->groups, p->kernel[0], p->kernel[1]);
+        prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, p->out_channels);
+        const size_t ws_size = prsm_conv2d_workspace_size(p, 9, 7);
+        prsm_tensor_t *workspace = prsm_tensor_create_vec(alloctr, (ws_size == 0) ? 1 : ws_size);
+        const prsm_float *const ws_data = workspace->data;
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_rand_uniform(w, -1, 1);
+        prsm_tensor_rand_uniform(b, -1, 1);
+
+        // forward
+        prsm_tensor_t *out = prsm_conv2d_forward(NULL, x, w, b, PRSM_ACTIVATION_LINEAR, p, workspace);
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, p->out_channels, oh, ow);
+        assert(prsm_tensor_shapes_match(out, ref));
+        test_conv_naive(ref, NULL, NULL, NULL, x, w, p);
+        VT_FOREACH(i, 0, prsm_tensor_size(ref)) {
+            ref->data[i] += b->data[(i / (oh * ow)) % p->out_channels];
+        }
+        assert(prsm_tensor_equals_approx(out, ref, 1e-4));
+
+        // steady state: a workspace of `prsm_conv2d_workspace_size()` is never reallocated
+        assert(workspace->data == ws_data);
+        prsm_conv2d_forward(out, x, w, NULL, PRSM_ACTIVATION_RELU, p, workspace);
+        assert(workspace->data == ws_data);
+        VT_FOREACH(i, 0, prsm_tensor_size(ref)) {
+            const prsm_float z = ref->data[i] - b->data[(i / (oh * ow)) % p->out_channels];
+            assert(PRSM_ABS(out->data[i] - ((z > 0) ? z : 0)) < 1e-4);
+        }
+
+        // backward
+        prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 2, p->out_channels, oh, ow);
+        prsm_tensor_t *dx = prsm_tensor_create(alloctr, 4, 2, p->in_channels, 9, 7);
+        prsm_tensor_t *dw = prsm_tensor_create_ex(alloctr, 4, w->shape);
+        prsm_tensor_t *db = prsm_tensor_create_vec(alloctr, p->out_channels);
+        prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 2, p->in_channels, 9, 7);
+        prsm_tensor_t *ref_dw = prsm_tensor_create_ex(alloctr, 4, w->shape);
+        prsm_tensor_rand_uniform(dout, -1, 1);
+        prsm_tensor_set_ones(dw);
+        prsm_conv2d_backward(dx, dw, db, dout, x, w, p, workspace);
+        assert(workspace->data == ws_data);
+        test_conv_naive(NULL, ref_dx, ref_dw, dout, x, w, p);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-4));
+        assert(prsm_tensor_equals_approx(dw, ref_dw, 1e-4));
+        VT_FOREACH(oc, 0, p->out_channels) {
+            prsm_float sum = 0;
+            VT_FOREACH(n, 0, 2) VT_FOREACH(j, 0, oh * ow) sum += dout->data[(n * p->out_channels + oc) * oh * ow + j];
+            assert(PRSM_ABS(db->data[oc] - sum) < 1e-4);
+        }
+
+        // training: forward keeps the columns of the batch, backward reads them instead of unfolding the input
+        prsm_tensor_resize(workspace, 1, prsm_conv2d_workspace_size_ex(p, 2, 9, 7, true));
+        const prsm_float *const ws_train = workspace->data;
+        prsm_conv2d_forward_ex(out, x, w, b, PRSM_ACTIVATION_LINEAR, p, workspace, true);
+        assert(prsm_tensor_equals_approx(out, ref, 1e-4));
+        prsm_tensor_set_ones(dx);
+        prsm_tensor_set_ones(dw);
+        prsm_conv2d_backward_ex(dx, dw, NULL, dout, x, w, p, workspace, true);
+        assert(workspace->data == ws_train);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-4));
+        assert(prsm_tensor_equals_approx(dw, ref_dw, 1e-4));
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(w);
+        prsm_tensor_destroy(b);
+        prsm_tensor_destroy(workspace);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(dout);
+        prsm_tensor_destroy(dx);
+        prsm_tensor_destroy(dw);
+        prsm_tensor_destroy(db);
+        prsm_tensor_destroy(ref_dx);
+        prsm_tensor_destroy(ref_dw);
+    }
+
+    // weight gradient split over threads: reused columns, reproducible results
+    {
+        const prsm_conv2d_params_t p = { .in_channels = 8, .out_channels = 40, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} };
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 3, 8, 16, 16);
+        prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, 40, 8, 3, 3);
+        prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 3, 40, 16, 16);
+        prsm_tensor_t *dw = prsm_tensor_create_ex(alloctr, 4, w->shape);
+        prsm_tensor_t *dw_reuse = prsm_tensor_create_ex(alloctr, 4, w->shape);
+        prsm_tensor_t *ref_dw = prsm_tensor_create_ex(alloctr, 4, w->shape);
+        prsm_tensor_t *ref_dx = prsm_tensor_create_ex(alloctr, 4, x->shape);
+        prsm_tensor_t *workspace = prsm_tensor_create_vec(alloctr, prsm_conv2d_workspace_size_ex(&p, 3, 16, 16, true));
+        const prsm_float *const ws_data = workspace->data;
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_rand_uniform(w, -1, 1);
+        prsm_tensor_rand_uniform(dout, -1, 1);
+        test_conv_naive(NULL, ref_dx, ref_dw, dout, x, w, &p);
+
+        // unfolding per image and reusing the forward columns split the work the same way
+        prsm_conv2d_backward(NULL, dw, NULL, dout, x, w, &p, workspace);
+        assert(prsm_tensor_equals_approx(dw, ref_dw, 1e-3));
+        prsm_tensor_t *out = prsm_conv2d_forward_ex(NULL, x, w, NULL, PRSM_ACTIVATION_LINEAR, &p, workspace, true);
+        prsm_conv2d_backward_ex(NULL, dw_reuse, NULL, dout, x, w, &p, workspace, true);
+        assert(prsm_tensor_equals_approx(dw_reuse, ref_dw, 1e-3));
+
+        // the same thread count gives bitwise identical gradients
+        prsm_conv2d_backward_ex(NULL, dw, NULL, dout, x, w, &p, workspace, true);
+        VT_FOREACH(i, 0, prsm_tensor_size(dw)) {
+            assert(dw->data[i] == dw_reuse->data[i]);
+        }
+        assert(workspace->data == ws_data);
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(w);
+        prsm_tensor_destroy(dout);
+        prsm_tensor_destroy(dw);
+        prsm_tensor_destroy(dw_reuse);
+        prsm_tensor_destroy(ref_dw);
+        prsm_tensor_destroy(ref_dx);
+        prsm_tensor_destroy(workspace);
+        prsm_tensor_destroy(out);
+    }
+
+    // depthwise separable block: fused forward against two direct convolutions, backward through the layer
+    {
+        const size_t kernel[] = {3, 3}, stride[] = {1, 2}, padding[] = {1, 1};
+        prsm_layer_separable_t *sep = prsm_layer_separable_create(alloctr, 10, 6, kernel, stride, padding, PRSM_ACTIVATION_RELU, PRSM_ACTIVATION_SIGMOID);
+        prsm_tensor_rand_uniform(sep->depthwise_b, -1, 1);
+        prsm_tensor_rand_uniform(sep->pointwise_b, -1, 1);
+        assert(prsm_conv2d_select_algorithm(&sep->depthwise_params, 7, 9) == PRSM_CONV_ALGORITHM_DEPTHWISE);
+
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 10, 7, 9);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        const prsm_tensor_t *out = prsm_layer_separable_forward(sep, x);
+        assert(prsm_tensor_shapes_match_ex(out, 4, (size_t[]){2, 6, 7, 5}));
+
+        // reference: mid = relu(depthwise(x) + b), out = sigmoid(conv1x1(mid) + b)
+        prsm_tensor_t *mid = prsm_tensor_create(alloctr, 4, 2, 10, 7, 5);
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, 6, 7, 5);
+        test_conv_naive(mid, NULL, NULL, NULL, x, sep->depthwise_w, &sep->depthwise_params);
+        VT_FOREACH(i, 0, prsm_tensor_size(mid)) {
+            const prsm_float z = mid->data[i] + sep->depthwise_b->data[(i / 35) % 10];
+            mid->data[i] = (z > 0) ? z : 0;
+        }
+        test_conv_naive(ref, NULL, NULL, NULL, mid, sep->pointwise_w, &sep->pointwise_params);
+        VT_FOREACH(i, 0, prsm_tensor_size(ref)) {
+            ref->data[i] = 1 / (1 + PRSM_EXP(-(ref->data[i] + sep->pointwise_b->data[(i / 35) % 6])));
+        }
+        assert(prsm_tensor_equals_approx(out, ref, 1e-4));
+
+        // same block on NCHW16c through the public kernels
+        prsm_tensor_t *workspace = prsm_tensor_create_vec(alloctr, 1);
+        prsm_tensor_t *xc = prsm_conv2d_to_nchwc(NULL, x, 16);
+        prsm_tensor_t *dw_c = prsm_conv2d_pack_depthwise(NULL, sep->depthwise_w, 16);
+        prsm_tensor_t *pw_c = prsm_conv2d_pack_weights(NULL, sep->pointwise_w, 16);
+        prsm_tensor_t *mid_c = prsm_conv2d_depthwise(NULL, xc, dw_c, sep->depthwise_b, PRSM_ACTIVATION_RELU, &sep->depthwise_params);
+        prsm_tensor_t *out_c = prsm_conv2d_depthwise_pointwise(
+            NULL, xc, dw_c, sep->depthwise_b, PRSM_ACTIVATION_RELU, pw_c, sep->pointwise_b, PRSM_ACTIVATION_SIGMOID, &sep->depthwise_params, 6, workspace
+        );
+        prsm_tensor_t *mid_nchw = prsm_conv2d_from_nchwc(NULL, mid_c, 10);
+        prsm_tensor_t *out_nchw = prsm_conv2d_from_nchwc(NULL, out_c, 6);
+        assert(prsm_tensor_equals_approx(mid_nchw, mid, 1e-4));
+        assert(prsm_tensor_equals_approx(out_nchw, ref, 1e-4));
+        prsm_tensor_destroy(workspace);
+        prsm_tensor_destroy(xc);
+        prsm_tensor_destroy(dw_c);
+        prsm_tensor_destroy(pw_c);
+        prsm_tensor_destroy(mid_c);
+        prsm_tensor_destroy(out_c);
+        prsm_tensor_destroy(mid_nchw);
+        prsm_tensor_destroy(out_nchw);
+
+        // backward: chain rule through both reference convolutions
+        prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 2, 6, 7, 5);
+        prsm_tensor_t *dz = prsm_tensor_create(alloctr, 4, 2, 6, 7, 5);
+        prsm_tensor_t *dmid = prsm_tensor_create(alloctr, 4, 2, 10, 7, 5);
+        prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 2, 10, 7, 9);
+        prsm_tensor_t *ref_pw_dw = prsm_tensor_create(alloctr, 4, 6, 10, 1, 1);
+        prsm_tensor_t *ref_dw_dw = prsm_tensor_create(alloctr, 4, 10, 1, 3, 3);
+        prsm_tensor_rand_uniform(dout, -1, 1);
+        VT_FOREACH(i, 0, prsm_tensor_size(dz)) {
+            dz->data[i] = dout->data[i] * ref->data[i] * (1 - ref->data[i]);
+        }
+        test_conv_naive(NULL, dmid, ref_pw_dw, dz, mid, sep->pointwise_w, &sep->pointwise_params);
+        VT_FOREACH(i, 0, prsm_tensor_size(dmid)) {
+            dmid->data[i] *= (mid->data[i] > 0) ? 1 : 0;
+        }
+        test_conv_naive(NULL, ref_dx, ref_dw_dw, dmid, x, sep->depthwise_w, &sep->depthwise_params);
+
+        const prsm_tensor_t *dx = prsm_layer_separable_backward(sep, dout, true);
+        assert(prsm_tensor_equals_approx(sep->mid, mid, 1e-4));
+        assert(prsm_tensor_equals_approx(sep->pointwise_dw, ref_pw_dw, 1e-4));
+        assert(prsm_tensor_equals_approx(sep->depthwise_dw, ref_dw_dw, 1e-4));
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-4));
+        assert(prsm_layer_separable_backward(sep, dout, false) == NULL);
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(mid);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(dout);
+        prsm_tensor_destroy(dz);
+        prsm_tensor_destroy(dmid);
+        prsm_tensor_destroy(ref_dx);
+        prsm_tensor_destroy(ref_pw_dw);
+        prsm_tensor_destroy(ref_dw_dw);
+        prsm_layer_separable_destroy(sep);
+    }
+
+    // layer: sigmoid activation and batch size change
+    {
+        const prsm_conv2d_params_t p = { .in_channels = 2, .out_channels = 3, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} };
+        prsm_layer_conv2d_t *conv = prsm_layer_conv2d_create(alloctr, &p, PRSM_ACTIVATION_SIGMOID);
+        assert(prsm_tensor_shapes_match_ex(conv->w, 4, (size_t[]){3, 2, 3, 3}));
+
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 3, 2, 5, 5);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        const prsm_tensor_t *out = prsm_layer_conv2d_forward(conv, x);
+        assert(prsm_tensor_shapes_match_ex(out, 4, (size_t[]){3, 3, 5, 5}));
+
+        // backward through sigmoid: dz = dout * y * (1 - y)
+        prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 3, 3, 5, 5);
+        prsm_tensor_t *dz = prsm_tensor_create(alloctr, 4, 3, 3, 5, 5);
+        prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 3, 2, 5, 5);
+        prsm_tensor_t *ref_dw = prsm_tensor_create(alloctr, 4, 3, 2, 3, 3);
+        prsm_tensor_rand_uniform(dout, -1, 1);
+        VT_FOREACH(i, 0, prsm_tensor_size(dz)) {
+            dz->data[i] = dout->data[i] * out->data[i] * (1 - out->data[i]);
+        }
+        const prsm_tensor_t *dx = prsm_layer_conv2d_backward(conv, dout, true);
+        test_conv_naive(NULL, ref_dx, ref_dw, dz, x, conv->w, &p);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-4));
+        assert(prsm_tensor_equals_approx(conv->dw, ref_dw, 1e-4));
+        assert(prsm_layer_conv2d_backward(conv, dout, false) == NULL);
+
+        // smaller batch reuses the workspace
+        const prsm_float *const ws_data = conv->workspace->data;
+        prsm_tensor_resize(x, 4, 1, 2, 5, 5);
+        out = prsm_layer_conv2d_forward(conv, x);
+        assert(prsm_tensor_shapes_match_ex(out, 4, (size_t[]){1, 3, 5, 5}));
+        assert(conv->workspace->data == ws_data);
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(dout);
+        prsm_tensor_destroy(dz);
+        prsm_tensor_destroy(ref_dx);
+        prsm_tensor_destroy(ref_dw);
+        prsm_layer_conv2d_destroy(conv);
+    }
+
+    // layer: Winograd weights are transformed once and reused until they change
+    {
+        const prsm_conv2d_params_t p = { .in_channels = 32, .out_channels = 32, .groups = 1, .kernel = {3, 3}, .stride = {1, 1}, .padding = {1, 1}, .dilation = {1, 1} };
+        assert(prsm_conv2d_select_algorithm(&p, 16, 16) == PRSM_CONV_ALGORITHM_WINOGRAD_4);
+        prsm_layer_conv2d_t *conv = prsm_layer_conv2d_create(alloctr, &p, PRSM_ACTIVATION_LINEAR);
+        prsm_tensor_rand_uniform(conv->b, -1, 1);
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 32, 16, 16);
+        prsm_tensor_t *ws = prsm_tensor_create_vec(alloctr, 1);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_t *ref = prsm_conv2d_forward(NULL, x, conv->w, conv->b, PRSM_ACTIVATION_LINEAR, &p, ws);
+        assert(prsm_tensor_equals_approx(prsm_layer_conv2d_forward(conv, x), ref, 1e-4));
+        assert(conv->u_tile == 4);
+
+        // weights edited behind the layer's back: the cached transform is still used
+        prsm_tensor_t *w0 = prsm_tensor_dup(conv->w);
+        prsm_tensor_apply_scale_add(conv->w, 2, 0);
+        const prsm_float *const u_data = conv->u->data;
+        assert(prsm_tensor_equals_approx(prsm_layer_conv2d_forward(conv, x), ref, 1e-4));
+        assert(conv->u->data == u_data);
+
+        // after a change is reported, the weights are transformed again
+        prsm_layer_conv2d_weights_changed(conv);
+        assert(conv->u_tile == 0);
+        prsm_conv2d_forward(ref, x, conv->w, conv->b, PRSM_ACTIVATION_LINEAR, &p, ws);
+        assert(prsm_tensor_equals_approx(prsm_layer_conv2d_forward(conv, x), ref, 1e-4));
+        assert(conv->u_tile == 4);
+
+        // backward: the optimizer changes the weights next
+        prsm_tensor_t *dout = prsm_tensor_dup(ref);
+        prsm_layer_conv2d_backward(conv, dout, false);
+        assert(conv->u_tile == 0);
+        prsm_tensor_assign(conv->w, w0);
+        prsm_conv2d_forward(ref, x, conv->w, conv->b, PRSM_ACTIVATION_LINEAR, &p, ws);
+        assert(prsm_tensor_equals_approx(prsm_layer_conv2d_forward(conv, x), ref, 1e-4));
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(ws);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(w0);
+        prsm_tensor_destroy(dout);
+        prsm_layer_conv2d_destroy(conv);
+    }
+
+    // transposed convolution: gathered phases match the input gradient of the mirrored convolution
+    {
+        assert(prsm_conv2d_transpose_out_dim(4, 3, 2, 1, 1, 1) == 8);
+        assert(prsm_conv2d_transpose_out_dim(4, 4, 2, 1, 1, 0) == 8);
+        assert(prsm_conv2d_transpose_out_dim(1, 1, 1, 1, 1, 0) == 0);
+
+        // (C, OC, groups, K, stride, padding, dilation, output padding)
+        const size_t cases[][8] = {
+            {3, 4, 1, 3, 2, 1, 1, 1},
+            {3, 2, 1, 4, 2, 1, 1, 0},
+            {4, 6, 2, 3, 3, 0, 2, 2},
+            {2, 3, 1, 1, 2, 0, 1, 1},
+            {2, 2, 1, 3, 1, 1, 1, 0}
+        };
+        prsm_tensor_t *ws = prsm_tensor_create(alloctr, 1, 1);
+        VT_FOREACH(t, 0, sizeof(cases) / sizeof(cases[0])) {
+            const size_t *const cs = cases[t];
+            const prsm_conv2d_params_t p = {
+                .in_channels = cs[0], .out_channels = cs[1], .groups = cs[2], .kernel = {cs[3], cs[3]},
+                .stride = {cs[4], cs[4]}, .padding = {cs[5], cs[5]}, .dilation = {cs[6], cs[6]}
+            };
+            const size_t op[2] = {cs[7], cs[7]};
+            const size_t oh = prsm_conv2d_transpose_out_dim(5, cs[3], cs[4], cs[5], cs[6], cs[7]);
+            const size_t ow = prsm_conv2d_transpose_out_dim(4, cs[3], cs[4], cs[5], cs[6], cs[7]);
+            prsm_conv2d_params_t mirror = p;
+            mirror.in_channels = p.out_channels;
+            mirror.out_channels = p.in_channels;
+
+            prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, cs[0], 5, 4);
+            prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, cs[0], cs[1] / cs[2], cs[3], cs[3]);
+            prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, cs[1]);
+            prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, cs[1], oh, ow);
+            prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 2, cs[0], 5, 4);
+            prsm_tensor_t *ref_dw = prsm_tensor_create(alloctr, 4, cs[0], cs[1] / cs[2], cs[3], cs[3]);
+            prsm_tensor_t *tmp_w = prsm_tensor_create(alloctr, 4, cs[0], cs[1] / cs[2], cs[3], cs[3]);
+            prsm_tensor_rand_uniform(x, -1, 1);
+            prsm_tensor_rand_uniform(w, -1, 1);
+            prsm_tensor_rand_uniform(b, -1, 1);
+
+            // forward = dx of the mirrored convolution with x as its output gradient, plus bias
+            test_conv_naive(NULL, ref, tmp_w, x, ref, w, &mirror);
+            prsm_tensor_t *out = prsm_conv2d_transpose(NULL, x, w, NULL, PRSM_ACTIVATION_LINEAR, &p, op, ws);
+            assert(prsm_tensor_shapes_match(out, ref));
+            assert(prsm_tensor_equals_approx(out, ref, 1e-4));
+
+            prsm_conv2d_transpose(out, x, w, b, PRSM_ACTIVATION_RELU, &p, op, ws);
+            VT_FOREACH(i, 0, prsm_tensor_size(out)) {
+                const prsm_float z = ref->data[i] + b->data[(i / (oh * ow)) % cs[1]];
+                assert(PRSM_ABS(out->data[i] - ((z > 0) ? z : 0)) < 1e-4);
+            }
+
+            // backward: dx is the mirrored forward, dw its weight gradient
+            prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 2, cs[1], oh, ow);
+            prsm_tensor_t *dx = prsm_tensor_create(alloctr, 4, 2, cs[0], 5, 4);
+            prsm_tensor_t *dw = prsm_tensor_create(alloctr, 4, cs[0], cs[1] / cs[2], cs[3], cs[3]);
+            prsm_tensor_t *db = prsm_tensor_create_vec(alloctr, cs[1]);
+            prsm_tensor_rand_uniform(dout, -1, 1);
+            prsm_conv2d_transpose_backward(dx, dw, db, dout, x, w, &p, ws);
+            test_conv_naive(ref_dx, NULL, NULL, NULL, dout, w, &mirror);
+            test_conv_naive(NULL, ref, ref_dw, x, dout, w, &mirror);
+            assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-4));
+            assert(prsm_tensor_equals_approx(dw, ref_dw, 1e-4));
+            VT_FOREACH(oc, 0, cs[1]) {
+                prsm_float sum = 0;
+                VT_FOREACH(n, 0, 2) VT_FOREACH(i, 0, oh * ow) sum += dout->data[(n * cs[1] + oc) * oh * ow + i];
+                assert(PRSM_ABS(db->data[oc] - sum) < 1e-4);
+            }
+
+            prsm_tensor_destroy(x);
+            prsm_tensor_destroy(w);
+            prsm_tensor_destroy(b);
+            prsm_tensor_destroy(ref);
+            prsm_tensor_destroy(ref_dx);
+            prsm_tensor_destroy(ref_dw);
+            prsm_tensor_destroy(tmp_w);
+            prsm_tensor_destroy(out);
+            prsm_tensor_destroy(dout);
+            prsm_tensor_destroy(dx);
+            prsm_tensor_destroy(dw);
+            prsm_tensor_destroy(db);
+        }
+        prsm_tensor_destroy(ws);
+    }
+
+    // fused upsampling and convolution match a convolution of the materialized upsampled tensor
+    {
+        // (mode, scale, C, OC, groups, K, padding)
+        const size_t cases[][7] = {
+            {PRSM_CONV_UPSAMPLE_NEAREST, 2, 3, 4, 1, 3, 1},
+            {PRSM_CONV_UPSAMPLE_NEAREST, 3, 2, 3, 1, 3, 1},
+            {PRSM_CONV_UPSAMPLE_NEAREST, 2, 4, 6, 2, 5, 2},
+            {PRSM_CONV_UPSAMPLE_NEAREST, 2, 2, 2, 1, 3, 0},
+            {PRSM_CONV_UPSAMPLE_BILINEAR, 2, 3, 4, 1, 3, 1},
+            {PRSM_CONV_UPSAMPLE_BILINEAR, 3, 4, 2, 2, 3, 0}
+        };
+        prsm_tensor_t *ws = prsm_tensor_create(alloctr, 1, 1);
+        VT_FOREACH(t, 0, sizeof(cases) / sizeof(cases[0])) {
+            const size_t *const cs = cases[t];
+            const enum PrismaConvUpsample mode = (enum PrismaConvUpsample)cs[0];
+            const size_t scale = cs[1];
+            const prsm_conv2d_params_t p = {
+                .in_channels = cs[2], .out_channels = cs[3], .groups = cs[4], .kernel = {cs[5], cs[5]},
+                .stride = {1, 1}, .padding = {cs[6], cs[6]}, .dilation = {1, 1}
+            };
+            prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, cs[2], 5, 6);
+            prsm_tensor_t *up = prsm_tensor_create(alloctr, 4, 2, cs[2], 5 * scale, 6 * scale);
+            prsm_tensor_t *w = prsm_tensor_create(alloctr, 4, cs[3], cs[2] / cs[4], cs[5], cs[5]);
+            prsm_tensor_t *b = prsm_tensor_create_vec(alloctr, cs[3]);
+            prsm_tensor_rand_uniform(x, -1, 1);
+            prsm_tensor_rand_uniform(w, -1, 1);
+            prsm_tensor_rand_uniform(b, -1, 1);
+            test_conv_upsample_naive(up, x, mode, scale);
+
+            const size_t oh = prsm_conv2d_out_dim(5 * scale, cs[5], 1, cs[6], 1), ow = prsm_conv2d_out_dim(6 * scale, cs[5], 1, cs[6], 1);
+            prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, cs[3], oh, ow);
+            test_conv_naive(ref, NULL, NULL, NULL, up, w, &p);
+            prsm_tensor_t *out = prsm_conv2d_upsample_conv(NULL, x, w, b, PRSM_ACTIVATION_LINEAR, &p, mode, scale, ws);
+            assert(prsm_tensor_shapes_match(out, ref));
+            VT_FOREACH(i, 0, prsm_tensor_size(out)) {
+                assert(PRSM_ABS(out->data[i] - ref->data[i] - b->data[(i / (oh * ow)) % cs[3]]) < 1e-4);
+            }
+            assert(prsm_tensor_size(ws) >= prsm_conv2d_upsample_workspace_size(&p, mode, scale, 5, 6));
+
+            prsm_tensor_destroy(x);
+            prsm_tensor_destroy(up);
+            prsm_tensor_destroy(w);
+            prsm_tensor_destroy(b);
+            prsm_tensor_destroy(ref);
+            prsm_tensor_destroy(out);
+        }
+        prsm_tensor_destroy(ws);
+    }
+
+    prsm_parallel_set_num_threads(0);
+}
+
+void test_pool_naive(prsm_tensor_t *const out, prsm_tensor_t *const dx, const prsm_tensor_t *const dout, const prsm_tensor_t *const in, const prsm_pool2d_params_t *const p, const bool max) {
+    // direct pooling on NCHW: forward into `out` or, if `dout != NULL`, backward into `dx`
+    const size_t n_ = in->shape[0], c_ = in->shape[1], h_ = in->shape[2], w_ = in->shape[3];
+    const size_t oh_ = prsm_conv2d_out_dim(h_, p->kernel[0], p->stride[0], p->padding[0], 1);
+    const size_t ow_ = prsm_conv2d_out_dim(w_, p->kernel[1], p->stride[1], p->padding[1], 1);
+    if (dout != NULL) prsm_tensor_set_zeros(dx);
+
+    VT_FOREACH(n, 0, n_) VT_FOREACH(c, 0, c_) VT_FOREACH(oh, 0, oh_) VT_FOREACH(ow, 0, ow_) {
+        const size_t o = ((n * c_ + c) * oh_ + oh) * ow_ + ow;
+        prsm_float best = 0, sum = 0;
+        size_t arg = 0, count = 0;
+        VT_FOREACH(kh, 0, p->kernel[0]) VT_FOREACH(kw, 0, p->kernel[1]) {
+            const long ih = (long)(oh * p->stride[0] + kh) - (long)p->padding[0];
+            const long iw = (long)(ow * p->stride[1] + kw) - (long)p->padding[1];
+            if (ih < 0 || iw < 0 || ih >= (long)h_ || iw >= (long)w_) continue;
+
+            const size_t i = ((n * c_ + c) * h_ + (size_t)ih) * w_ + (size_t)iw;
+            if (count == 0 || in->data[i] > best) {
+                best = in->data[i];
+                arg = i;
+            }
+            sum += in->data[i];
+            count++;
+        }
+        if (dout == NULL) {
+            out->data[o] = max ? best : sum / (prsm_float)count;
+        } else {
+            dx->data[arg] += dout->data[o];
+        }
+    }
+}
+
+void test_pool(void) {
+    prsm_parallel_set_num_threads(4);
+
+    // max and average pooling against a direct implementation, on NCHW and NCHW8c
+    const prsm_pool2d_params_t cases[] = {
+        { .kernel = {3, 3}, .stride = {2, 2}, .padding = {1, 1} },
+        { .kernel = {2, 2}, .stride = {2, 2}, .padding = {0, 0} },
+        { .kernel = {3, 2}, .stride = {1, 2}, .padding = {1, 1} },
+    };
+    VT_FOREACH(t, 0, sizeof(cases) / sizeof(cases[0])) {
+        const prsm_pool2d_params_t *const p = &cases[t];
+        const size_t oh = prsm_conv2d_out_dim(9, p->kernel[0], p->stride[0], p->padding[0], 1);
+        const size_t ow = prsm_conv2d_out_dim(8, p->kernel[1], p->stride[1], p->padding[1], 1);
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 2, 11, 9, 8);
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 2, 11, oh, ow);
+        prsm_pool_indices_t *idx = prsm_pool_indices_create(alloctr, 0, 1);
+        prsm_tensor_rand_uniform(x, -1, 1);
+
+        // max: values and the window offsets of the maxima
+        prsm_tensor_t *out = prsm_pool2d_max(NULL, idx, x, p);
+        test_pool_naive(ref, NULL, NULL, x, p, true);
+        assert(prsm_tensor_equals_approx(out, ref, 0));
+        assert(idx->size == prsm_tensor_size(out) && idx->width == 1);
+        VT_FOREACH(i, 0, prsm_tensor_size(out)) {
+            const size_t offset = prsm_pool_indices_get(idx, i);
+            const size_t plane = i / (oh * ow), oh_ = (i / ow) % oh, ow_ = i % ow;
+            const size_t ih = oh_ * p->stride[0] + offset / p->kernel[1] - p->padding[0];
+            const size_t iw = ow_ * p->stride[1] + offset % p->kernel[1] - p->padding[1];
+            assert(x->data[(plane * 9 + ih) * 8 + iw] == out->data[i]);
+        }
+
+        // max backward: gradients go to the maxima
+        prsm_tensor_t *dout = prsm_tensor_create(alloctr, 4, 2, 11, oh, ow);
+        prsm_tensor_t *dx = prsm_tensor_create(alloctr, 4, 2, 11, 9, 8);
+        prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 2, 11, 9, 8);
+        prsm_tensor_rand_uniform(dout, -1, 1);
+        prsm_tensor_set_ones(dx);
+        prsm_pool2d_max_backward(dx, dout, idx, p);
+        test_pool_naive(NULL, ref_dx, dout, x, p, true);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-5));
+
+        // NCHW8c gives the same maxima, vectorized across channels
+        prsm_tensor_t *xc = prsm_conv2d_to_nchwc(NULL, x, 8);
+        prsm_tensor_t *outc = prsm_pool2d_max(NULL, idx, xc, p);
+        prsm_tensor_t *res = prsm_conv2d_from_nchwc(NULL, outc, 11);
+        assert(outc->ndim == 5 && outc->shape[1] == 2 && outc->shape[4] == 8);
+        assert(prsm_tensor_equals_approx(res, ref, 0));
+        prsm_tensor_t *doutc = prsm_conv2d_to_nchwc(NULL, dout, 8);
+        prsm_tensor_t *dxc = prsm_tensor_create_ex(alloctr, 5, xc->shape);
+        prsm_pool2d_max_backward(dxc, doutc, idx, p);
+        prsm_conv2d_from_nchwc(dx, dxc, 11);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-5));
+
+        // average over the elements inside the input
+        prsm_pool2d_avg(out, x, p);
+        test_pool_naive(ref, NULL, NULL, x, p, false);
+        assert(prsm_tensor_equals_approx(out, ref, 1e-5));
+        prsm_pool2d_avg(outc, xc, p);
+        prsm_conv2d_from_nchwc(res, outc, 11);
+        assert(prsm_tensor_equals_approx(res, ref, 1e-5));
+
+        // average backward is the adjoint of the forward pass: <avg(x), dout> == <x, avg_backward(dout)>
+        prsm_pool2d_avg_backward(dx, dout, p);
+        assert(PRSM_ABS(prsm_tensor_vdot(out, dout) - prsm_tensor_vdot(x, dx)) < 1e-4);
+        prsm_pool2d_avg_backward(dxc, doutc, p);
+        prsm_conv2d_from_nchwc(ref_dx, dxc, 11);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 1e-5));
+
+        // views are pooled in place: the second image of the batch
+        prsm_tensor_t img = { .ndim = 4, .shape = (size_t[]){1, 11, 9, 8}, .data = x->data + 11 * 9 * 8, .is_view = true };
+        prsm_tensor_t *out_img = prsm_pool2d_max(NULL, NULL, &img, p);
+        test_pool_naive(ref, NULL, NULL, x, p, true);
+        VT_FOREACH(i, 0, prsm_tensor_size(out_img)) {
+            assert(out_img->data[i] == ref->data[11 * oh * ow + i]);
+        }
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(dout);
+        prsm_tensor_destroy(dx);
+        prsm_tensor_destroy(ref_dx);
+        prsm_tensor_destroy(xc);
+        prsm_tensor_destroy(outc);
+        prsm_tensor_destroy(res);
+        prsm_tensor_destroy(doutc);
+        prsm_tensor_destroy(dxc);
+        prsm_tensor_destroy(out_img);
+        prsm_pool_indices_destroy(idx);
+    }
+
+    // windows of more than 256 elements store 2-byte offsets
+    {
+        const prsm_pool2d_params_t p = { .kernel = {17, 17}, .stride = {3, 3}, .padding = {0, 0} };
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 1, 3, 20, 20);
+        prsm_tensor_t *ref = prsm_tensor_create(alloctr, 4, 1, 3, 2, 2);
+        prsm_pool_indices_t *idx = prsm_pool_indices_create(alloctr, 1, 9);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_t *out = prsm_pool2d_max(NULL, idx, x, &p);
+        test_pool_naive(ref, NULL, NULL, x, &p, true);
+        assert(prsm_tensor_equals_approx(out, ref, 0));
+        assert(idx->width == 2 && idx->size == 12);
+
+        prsm_tensor_t *dx = prsm_tensor_create(alloctr, 4, 1, 3, 20, 20);
+        prsm_tensor_t *ref_dx = prsm_tensor_create(alloctr, 4, 1, 3, 20, 20);
+        prsm_tensor_set_ones(ref);
+        prsm_pool2d_max_backward(dx, ref, idx, &p);
+        test_pool_naive(NULL, ref_dx, ref, x, &p, true);
+        assert(prsm_tensor_equals_approx(dx, ref_dx, 0));
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(ref);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(dx);
+        prsm_tensor_destroy(ref_dx);
+        prsm_pool_indices_destroy(idx);
+    }
+
+    // global average pooling on NCHW and NCHW16c
+    {
+        prsm_tensor_t *x = prsm_tensor_create(alloctr, 4, 3, 20, 5, 7);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_t *out = prsm_pool2d_global_avg(NULL, x);
+        assert(prsm_tensor_shapes_match_ex(out, 4, (size_t[]){3, 20, 1, 1}));
+        VT_FOREACH(i, 0, 3 * 20) {
+            prsm_float sum = 0;
+            VT_FOREACH(j, 0, 35) sum += x->data[i * 35 + j];
+            assert(PRSM_ABS(out->data[i] - sum / 35) < 1e-5);
+        }
+
+        prsm_tensor_t *xc = prsm_conv2d_to_nchwc(NULL, x, 16);
+        prsm_tensor_t *outc = prsm_pool2d_global_avg(NULL, xc);
+        prsm_tensor_t *res = prsm_conv2d_from_nchwc(NULL, outc, 20);
+        assert(prsm_tensor_equals_approx(res, out, 1e-5));
+
+        // backward: dx = dout / (H * W)
+        prsm_tensor_t *dx = prsm_tensor_create(alloctr, 4, 3, 20, 5, 7);
+        prsm_pool2d_global_avg_backward(dx, out);
+        VT_FOREACH(i, 0, prsm_tensor_size(dx)) {
+            assert(PRSM_ABS(dx->data[i] - out->data[i / 35] / 35) < 1e-6);
+        }
+
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(out);
+        prsm_tensor_destroy(xc);
+        prsm_tensor_destroy(outc);
+        prsm_tensor_destroy(res);
+        prsm_tensor_destroy(dx);
+    }
+
+    prsm_parallel_set_num_threads(0);
+}
+
+void test_optim_naive(prsm_float *const w, prsm_float *const m, prsm_float *const v, const prsm_float *const g, const size_t size, const prsm_optim_params_t *const p, const size_t step) {
+    // one element at a time, in the order of the textbook formulas
+    VT_FOREACH(i, 0, size) {
+        prsm_float gc = g[i];
+        if (p->clip > 0) gc = (gc > p->clip) ? p->clip : (gc < -p->clip) ? -p->clip : gc;
+        if (p->type == PRSM_OPTIM_SGD) {
+            gc += p->weight_decay * w[i];
+            if (p->momentum > 0) {
+                m[i] = p->momentum * m[i] + gc;
+                gc = m[i];
+            }
+            w[i] -= p->lr * gc;
+            continue;
+        }
+        if (p->type == PRSM_OPTIM_ADAMW) w[i] -= p->lr * p->weight_decay * w[i];
+        else gc += p->weight_decay * w[i];
+        m[i] = p->beta1 * m[i] + (1 - p->beta1) * gc;
+        v[i] = p->beta2 * v[i] + (1 - p->beta2) * gc * gc;
+        const prsm_float m_hat = m[i] / (1 - PRSM_POW(p->beta1, step));
+        const prsm_float v_hat = v[i] / (1 - PRSM_POW(p->beta2, step));
+        w[i] -= p->lr * m_hat / (PRSM_SQRT(v_hat) + p->eps);
+    }
+}
+
+void test_optim(void) {
+    prsm_parallel_set_num_threads(4);
+
+    // parameters of very different sizes, so that chunks span several tensors
+    const size_t sizes[] = {3, 70000, 1, 129, 40000};
+    const size_t count = sizeof(sizes) / sizeof(sizes[0]);
+    const prsm_optim_params_t cases[] = {
+        { .type = PRSM_OPTIM_SGD, .lr = 0.1 },
+        { .type = PRSM_OPTIM_SGD, .lr = 0.05, .momentum = 0.9, .weight_decay = 0.01, .clip = 0.5 },
+        { .type = PRSM_OPTIM_ADAM, .lr = 0.01, .beta1 = 0.9, .beta2 = 0.999, .eps = 1e-8, .weight_decay = 0.1, .clip = 0.8 },
+        { .type = PRSM_OPTIM_ADAMW, .lr = 0.01, .beta1 = 0.9, .beta2 = 0.99, .eps = 1e-8, .weight_decay = 0.1 }
+    };
+    VT_FOREACH(k, 0, sizeof(cases) / sizeof(cases[0])) {
+        prsm_tensor_t *params[5], *grads[5], *ref[5], *ref_m[5], *ref_v[5];
+        VT_FOREACH(i, 0, count) {
+            params[i] = prsm_tensor_create_vec(alloctr, sizes[i]);
+            grads[i] = prsm_tensor_create_vec(alloctr, sizes[i]);
+            ref_m[i] = prsm_tensor_create_vec(alloctr, sizes[i]);
+            ref_v[i] = prsm_tensor_create_vec(alloctr, sizes[i]);
+            prsm_tensor_rand_uniform(params[i], -1, 1);
+            prsm_tensor_set_zeros(ref_m[i]);
+            prsm_tensor_set_zeros(ref_v[i]);
+            ref[i] = prsm_tensor_dup(params[i]);
+        }
+
+        // several steps with fresh gradients; gradients are left untouched
+        prsm_optim_t *optim = prsm_optim_create(alloctr, &cases[k]);
+        VT_FOREACH(step, 1, 4) {
+            VT_FOREACH(i, 0, count) {
+                prsm_tensor_rand_uniform(grads[i], -1, 1);
+            }
+            prsm_tensor_t *grads_copy = prsm_tensor_dup(grads[1]);
+            prsm_optim_step(optim, params, (const prsm_tensor_t *const *)grads, count);
+            assert(prsm_tensor_equals(grads[1], grads_copy));
+            prsm_tensor_destroy(grads_copy);
+
+            VT_FOREACH(i, 0, count) {
+                test_optim_naive(ref[i]->data, ref_m[i]->data, ref_v[i]->data, grads[i]->data, sizes[i], &cases[k], step);
+                assert(prsm_tensor_equals_approx(params[i], ref[i], 1e-5));
+            }
+        }
+        assert(optim->step == 3);
+        assert((optim->m == NULL) == (cases[k].type == PRSM_OPTIM_SGD && cases[k].momentum == 0));
+        assert((optim->v == NULL) == (cases[k].type == PRSM_OPTIM_SGD));
+
+        // reset frees the state and allows a different set of tensors
+        prsm_optim_reset(optim);
+        assert(optim->step == 0 && optim->count == 0);
+        prsm_optim_step(optim, params, (const prsm_tensor_t *const *)grads, 2);
+        assert(optim->count == 2);
+
+        prsm_optim_destroy(optim);
+        VT_FOREACH(i, 0, count) {
+            prsm_tensor_destroy(params[i]);
+            prsm_tensor_destroy(grads[i]);
+            prsm_tensor_destroy(ref[i]);
+            prsm_tensor_destroy(ref_m[i]);
+            prsm_tensor_destroy(ref_v[i]);
+        }
+    }
+
+    prsm_parallel_set_num_threads(0);
+}
+
+size_t test_train_model(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const y, void *const ctx) {
+    (void)ctx;
+
+    // parameters are leaves 0..3: w1, b1, w2, b2
+    const size_t x_id = prsm_autograd_leaf(tape, x, false);
+    const size_t y_id = prsm_autograd_leaf(tape, y, false);
+    const size_t a1 = prsm_autograd_dense(tape, x_id, 0, 1, PRSM_ACTIVATION_TANH);
+    const size_t z2 = prsm_autograd_dense(tape, a1, 2, 3, PRSM_ACTIVATION_LINEAR);
+    return prsm_autograd_softmax_cce(tape, z2, y_id);
+}
+
+size_t test_train_linear(prsm_autograd_t *const tape, prsm_tensor_t *const x, prsm_tensor_t *const y, void *const ctx) {
+    (void)ctx;
+
+    // linear regression: parameter is leaf 0
+    const size_t x_id = prsm_autograd_leaf(tape, x, false);
+    const size_t y_id = prsm_autograd_leaf(tape, y, false);
+    return prsm_autograd_mse(tape, prsm_autograd_matmul(tape, x_id, 0), y_id);
+}
+
+void test_train(void) {
+    const size_t n_x = 20, n_h = 33, n_y = 5;
+    prsm_tensor_t *params[4];
+    params[0] = prsm_tensor_create_mat(NULL, n_x, n_h);
+    params[1] = prsm_tensor_create_vec(NULL, n_h);
+    params[2] = prsm_tensor_create_mat(NULL, n_h, n_y);
+    params[3] = prsm_tensor_create_vec(NULL, n_y);
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_rand_uniform(params[i], -0.5, 0.5);
+    }
+
+    // batch sizes: uneven shards and fewer rows than shards
+    const size_t batches[] = {37, 8, 3};
+    VT_FOREACH(k, 0, sizeof(batches) / sizeof(batches[0])) {
+        const size_t n = batches[k];
+        prsm_tensor_t *x = prsm_tensor_create_mat(NULL, n, n_x);
+        prsm_tensor_t *y = prsm_tensor_create_mat(NULL, n, n_y);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_set_zeros(y);
+        VT_FOREACH(r, 0, n) {
+            y->data[r * n_y + r % n_y] = 1;
+        }
+
+        // reference: the whole minibatch on one tape
+        prsm_autograd_t *tape = prsm_autograd_create(NULL);
+        VT_FOREACH(i, 0, 4) {
+            prsm_autograd_leaf(tape, params[i], true);
+        }
+        const size_t loss_id = test_train_model(tape, x, y, NULL);
+        prsm_autograd_backward(tape, loss_id);
+        const prsm_float ref_loss = prsm_autograd_value(tape, loss_id)->data[0];
+
+        // sharded gradients match the minibatch gradients
+        prsm_parallel_set_num_threads(4);
+        prsm_train_t *train = prsm_train_create(NULL, params, 4, 4, test_train_model, NULL);
+        const prsm_float loss = prsm_train_step(train, x, y, NULL);
+        assert(train->active == ((n < 4) ? n : 4));
+        assert(PRSM_ABS(loss - ref_loss) < 1e-5);
+        prsm_tensor_t *grads[4];
+        VT_FOREACH(i, 0, 4) {
+            assert(prsm_tensor_equals_approx(prsm_train_grad(train, i), prsm_autograd_grad(tape, i), 1e-5));
+            grads[i] = prsm_tensor_dup(prsm_train_grad(train, i));
+        }
+
+        // the same step on one thread gives bit-identical results
+        prsm_parallel_set_num_threads(1);
+        assert(prsm_train_step(train, x, y, NULL) == loss);
+        VT_FOREACH(i, 0, 4) {
+            assert(prsm_tensor_equals(prsm_train_grad(train, i), grads[i]));
+        }
+
+        // micro-batches: accumulated gradients match the minibatch gradients
+        const size_t micro_batches[] = {1, 5, 64};
+        VT_FOREACH(m, 0, sizeof(micro_batches) / sizeof(micro_batches[0])) {
+            assert(PRSM_ABS(prsm_train_step_accumulate(train, x, y, micro_batches[m], NULL) - ref_loss) < 1e-5);
+            VT_FOREACH(i, 0, 4) {
+                assert(prsm_tensor_equals_approx(prsm_train_grad(train, i), grads[i], 1e-5));
+            }
+        }
+
+#if !defined(_WIN32) && !defined(_WIN64)
+        // micro-batches: targets with fewer rows than inputs are rejected before the first micro-batch
+        prsm_tensor_t *y_short = prsm_tensor_create_mat(NULL, n - 1, n_y);
+        const pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0) {
+            fclose(stderr);
+            prsm_train_step_accumulate(train, x, y_short, 1, NULL);
+            _exit(0);
+        }
+        int status = 0;
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(!WIFEXITED(status) || WEXITSTATUS(status) != 0);
+        prsm_tensor_destroy(y_short);
+#endif
+
+        // update: the optimizer receives the all-reduced gradients
+        prsm_tensor_t *ref[4];
+        VT_FOREACH(i, 0, 4) {
+            ref[i] = prsm_tensor_dup(params[i]);
+        }
+        prsm_optim_t *optim = prsm_optim_create(NULL, &(prsm_optim_params_t){ .type = PRSM_OPTIM_SGD, .lr = 0.1 });
+        prsm_parallel_set_num_threads(3);
+        prsm_train_step(train, x, y, optim);
+        VT_FOREACH(i, 0, 4) {
+            VT_FOREACH(j, 0, prsm_tensor_size(ref[i])) {
+                assert(PRSM_ABS(params[i]->data[j] - (ref[i]->data[j] - 0.1f * grads[i]->data[j])) < 1e-6);
+            }
+            prsm_tensor_destroy(ref[i]);
+            prsm_tensor_destroy(grads[i]);
+        }
+
+        prsm_optim_destroy(optim);
+        prsm_train_destroy(train);
+        prsm_autograd_destroy(tape);
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(y);
+    }
+
+    // stash: shard tapes compress their activations, the trainer reports the sum over the shards
+    {
+        const size_t n = 24;
+        prsm_tensor_t *x = prsm_tensor_create_mat(NULL, n, n_x);
+        prsm_tensor_t *y = prsm_tensor_create_mat(NULL, n, n_y);
+        prsm_tensor_rand_uniform(x, -1, 1);
+        prsm_tensor_set_zeros(y);
+        VT_FOREACH(r, 0, n) {
+            y->data[r * n_y + r % n_y] = 1;
+        }
+
+        prsm_parallel_set_num_threads(2);
+        prsm_train_t *train = prsm_train_create(NULL, params, 4, 2, test_train_model, NULL);
+        VT_FOREACH(s, 0, train->num_shards) {
+            prsm_autograd_set_stash(train->shards[s].tape, PRSM_AUTOGRAD_STASH_FP16);
+        }
+
+        // the first step learns the readers of every value, the second one stashes
+        prsm_train_step(train, x, y, NULL);
+        prsm_train_step(train, x, y, NULL);
+        const prsm_autograd_checkpoint_stats_t stats = prsm_train_checkpoint_stats(train);
+        size_t stashed_bytes = 0;
+        VT_FOREACH(s, 0, train->active) {
+            stashed_bytes += prsm_autograd_checkpoint_stats(train->shards[s].tape).stashed_bytes;
+        }
+        assert(train->active == 2);
+        assert(stats.stashed_bytes > 0 && stats.stashed_bytes == stashed_bytes);
+
+        prsm_train_destroy(train);
+        prsm_tensor_destroy(x);
+        prsm_tensor_destroy(y);
+    }
+
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_destroy(params[i]);
+    }
+
+    // hogwild: sparse linear regression converges
+    const size_t n = 600, d = 16;
+    prsm_tensor_t *x = prsm_tensor_create_mat(NULL, n, d);
+    prsm_tensor_t *y = prsm_tensor_create_mat(NULL, n, 1);
+    prsm_tensor_t *w_true = prsm_tensor_create_mat(NULL, d, 1);
+    prsm_tensor_t *w = prsm_tensor_create_mat(NULL, d, 1);
+    prsm_tensor_rand_uniform(w_true, -1, 1);
+    prsm_tensor_set_zeros(x);
+    VT_FOREACH(r, 0, n) {
+        x->data[r * d + r % d] = 1;
+        x->data[r * d + (r * 7 + 3) % d] = 0.5;
+    }
+    prsm_tensor_gemm(y, x, w_true, false, false, 1, 0);
+
+    const prsm_optim_params_t sgd = { .type = PRSM_OPTIM_SGD, .lr = 0.5 };
+    VT_FOREACH(threads, 1, 5) {
+        prsm_parallel_set_num_threads(threads);
+        prsm_tensor_set_zeros(w);
+        prsm_train_t *train = prsm_train_create(NULL, &w, 1, 4, test_train_linear, NULL);
+        prsm_train_hogwild_stats_t stats = {0};
+        VT_FOREACH(epoch, 0, 30) {
+            stats = prsm_train_hogwild(train, x, y, 8, &sgd);
+        }
+
+        // 4 workers with 150 rows each: 19 updates per worker
+        assert(stats.updates == 4 * 19);
+        assert(train->version == 30 * 4 * 19);
+        assert(stats.loss < 1e-3);
+        assert(threads > 1 || stats.max_staleness == 0);
+        assert(stats.mean_staleness <= (prsm_float)stats.max_staleness);
+        VT_FOREACH(j, 0, d) {
+            assert(PRSM_ABS(w->data[j] - w_true->data[j]) < 0.05);
+        }
+        prsm_train_destroy(train);
+    }
+
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(y);
+    prsm_tensor_destroy(w_true);
+    prsm_tensor_destroy(w);
+    prsm_parallel_set_num_threads(0);
+}
+
+void test_comm(void) {
+#if !defined(_WIN32) && !defined(_WIN64)
+    const char *const name = "/prisma_test_comm";
+    const size_t ranks = 3, rows = 31, steps = 3;
+    const size_t n_x = 20, n_h = 33, n_y = 5;
+    prsm_comm_unlink(name);
+
+    // shared data and initial parameters: forked ranks inherit them
+    prsm_tensor_t *params[4], *init[4];
+    params[0] = prsm_tensor_create_mat(NULL, n_x, n_h);
+    params[1] = prsm_tensor_create_vec(NULL, n_h);
+    params[2] = prsm_tensor_create_mat(NULL, n_h, n_y);
+    params[3] = prsm_tensor_create_vec(NULL, n_y);
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_rand_uniform(params[i], -0.5, 0.5);
+        init[i] = prsm_tensor_dup(params[i]);
+    }
+    prsm_tensor_t *x = prsm_tensor_create_mat(NULL, rows, n_x);
+    prsm_tensor_t *y = prsm_tensor_create_mat(NULL, rows, n_y);
+    prsm_tensor_rand_uniform(x, -1, 1);
+    prsm_tensor_set_zeros(y);
+    VT_FOREACH(r, 0, rows) {
+        y->data[r * n_y + r % n_y] = 1;
+    }
+
+    // reference: one process trains on the whole minibatch
+    const prsm_optim_params_t sgd = { .type = PRSM_OPTIM_SGD, .lr = 0.1, .momentum = 0.9 };
+    prsm_train_t *train = prsm_train_create(NULL, params, 4, 2, test_train_model, NULL);
+    prsm_optim_t *optim = prsm_optim_create(NULL, &sgd);
+    prsm_float ref_loss = 0;
+    VT_FOREACH(step, 0, steps) {
+        ref_loss = prsm_train_step(train, x, y, optim);
+    }
+    prsm_tensor_t *ref[4];
+    VT_FOREACH(i, 0, 4) {
+        ref[i] = prsm_tensor_dup(params[i]);
+        prsm_tensor_assign(params[i], init[i]);
+    }
+    prsm_optim_destroy(optim);
+
+    // ranks: rank 0 is this process
+    size_t rank = 0;
+    pid_t pids[3] = {0};
+    VT_FOREACH(r, 1, ranks) {
+        pids[r] = fork();
+        assert(pids[r] >= 0);
+        if (pids[r] == 0) {
+            rank = r;
+            break;
+        }
+    }
+
+    // slots smaller than the parameters, so collectives take several rounds
+    prsm_comm_t comm;
+    assert(prsm_comm_open(&comm, name, rank, ranks, 100) == PRSM_STATUS_OPERATION_SUCCESS);
+    assert(!prsm_comm_is_null(&comm) && prsm_comm_buffer(&comm, rank).shape[0] == 100);
+
+    // all-reduce sums rank values
+    prsm_tensor_t *a = prsm_tensor_create_vec(NULL, 257);
+    VT_FOREACH(i, 0, 257) {
+        a->data[i] = (prsm_float)(rank + 1) + (prsm_float)i * 0.25f;
+    }
+    prsm_comm_allreduce(&comm, &a, 1);
+    VT_FOREACH(i, 0, 257) {
+        assert(a->data[i] == 6 + 3 * (prsm_float)i * 0.25f);
+    }
+
+    // broadcast copies the root tensors
+    prsm_tensor_t *b = prsm_tensor_create_vec(NULL, 150);
+    prsm_tensor_set_all(b, (prsm_float)rank);
+    prsm_comm_broadcast(&comm, &b, 1, 2);
+    VT_FOREACH(i, 0, 150) {
+        assert(b->data[i] == 2);
+    }
+
+    // distributed training: every rank trains on its rows and matches the single-process run
+    const size_t from = rows * rank / ranks, to = rows * (rank + 1) / ranks;
+    size_t x_shape[] = {to - from, n_x}, y_shape[] = {to - from, n_y};
+    const prsm_tensor_t xr = { .ndim = 2, .shape = x_shape, .data = x->data + from * n_x, .is_view = true };
+    const prsm_tensor_t yr = { .ndim = 2, .shape = y_shape, .data = y->data + from * n_y, .is_view = true };
+    optim = prsm_optim_create(NULL, &sgd);
+    prsm_float loss = 0;
+    VT_FOREACH(step, 0, steps) {
+        loss = prsm_train_step_distributed(train, &comm, &xr, &yr, optim);
+    }
+    assert(PRSM_ABS(loss - ref_loss) < 1e-5);
+    VT_FOREACH(i, 0, 4) {
+        assert(prsm_tensor_equals_approx(params[i], ref[i], 1e-5));
+    }
+
+    // parameters are bit-identical in all ranks
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_t *copy = prsm_tensor_dup(params[i]);
+        prsm_comm_broadcast(&comm, &copy, 1, 0);
+        assert(prsm_tensor_equals(copy, params[i]));
+        prsm_tensor_destroy(copy);
+    }
+    prsm_comm_close(&comm);
+    assert(prsm_comm_is_null(&comm));
+
+    // forked ranks report through their exit status
+    if (rank != 0) {
+        _exit(0);
+    }
+    VT_FOREACH(r, 1, ranks) {
+        int status = 0;
+        assert(waitpid(pids[r], &status, 0) == pids[r]);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    prsm_comm_unlink(name);
+
+    prsm_optim_destroy(optim);
+    prsm_train_destroy(train);
+    prsm_tensor_destroy(a);
+    prsm_tensor_destroy(b);
+    prsm_tensor_destroy(x);
+    prsm_tensor_destroy(y);
+    VT_FOREACH(i, 0, 4) {
+        prsm_tensor_destroy(params[i]);
+        prsm_tensor_destroy(init[i]);
+        prsm_tensor_destroy(ref[i]);
+    }
+#endif
+}
+
+const prsm_tensor_t *test_pipeline_dense(void *const ctx, const prsm_tensor_t *const in) {
+    return prsm_layer_dense_forward(ctx, in);
+}
+
+void test_pipeline(void) {
+    const size_t rows = 37, n_x = 13, n_h = 24, n_y = 7;
+    prsm_layer_dense_t *layers[3] = {
+        prsm_layer_dense_create(NULL, n_x, n_h, PRSM_ACTIVATION_TANH),
+        prsm_layer_dense_create(NULL, n_h, n_h, PRSM_ACTIVATION_RELU),
+        prsm_layer_dense_create(NULL, n_h, n_y, PRSM_ACTIVATION_LINEAR),
+    };
+    prsm_tensor_t *x = prsm_tensor_create_mat(NULL, rows, n_x);
+    prsm_tensor_rand_uniform(x, -1, 1);
+
+    // reference: layers in sequence on the whole batch
+    const prsm_tensor_t *h = x;
+    VT_FOREACH(i, 0, 3) {
+        h = prsm_layer_dense_forward(layers[i], h);
+    }
+    prsm_tensor_t *ref = prsm_tensor_dup(h);
+
+    // one stage per layer; micro-batch sizes that do and do not divide the batch
+    const prsm_pipeline_stage_t stages[3] = {
+        { .fn = test_pipeline_dense, .ctx = layers[0] },
+        { .fn = test_pipeline_dense, .ctx = layers[1] },
+        { .fn = test_pipeline_dense, .ctx = layers[2] },
+    };
+    const size_t depths[] = {1, 2, 4};
+    const size_t micro_batches[] = {1, 5, 37, 64};
+    prsm_tensor_t *out = NULL;
+    VT_FOREACH(d, 0, sizeof(depths) / sizeof(depths[0])) {
+        prsm_pipeline_t *pipeline = prsm_pipeline_create(NULL, stages, 3, depths[d], d % 2 == 0);
+        VT_FOREACH(m, 0, sizeof(micro_batches) / sizeof(micro_batches[0])) {
+            out = prsm_pipeline_run(out, pipeline, x, micro_batches[m]);
+            assert(out->ndim == 2 && out->shape[0] == rows && out->shape[1] == n_y);
+            assert(prsm_tensor_equals_approx(out, ref, 1e-5));
+        }
+        prsm_pipeline_destroy(pipeline);
+    }
+
+    // a single stage holding all layers
+    const prsm_pipeline_stage_t all = { .fn = test_pipeline_dense, .ctx = layers[0] };
+    prsm_pipeline_t *pipeline = prsm_pipeline_create(NULL, &all, 1, 2, false);
+    prsm_tensor_t *h1 = prsm_pipeline_run(NULL, pipeline, x, 8);
+    prsm_pipeline_destroy(pipeline);
+    assert(h1->shape[0] == rows && h1->shape[1] == n_h);
+
+    prsm_tensor_destroy(h1);
+    prsm_tensor_destroy(out);
+    prsm_tensor_destroy(ref);
+    prsm_tensor_destroy(x);
+    VT_FOREACH(i, 0, 3) {
+        prsm_layer_dense_destroy(layers[i]);
+    }
+}